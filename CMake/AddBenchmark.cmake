@@ -0,0 +1,19 @@
+# Adds a benchmark executable.
+# Benchmarks are built along with the tests, but are not registered with ctest,
+# and are meant to be run manually.
+#
+# ags_add_benchmark(<target> SOURCES <sources...> LIBRARIES <libraries...>)
+
+function(ags_add_benchmark target)
+    cmake_parse_arguments(BENCHMARK "" "" "SOURCES;LIBRARIES" ${ARGN})
+
+    add_executable(${target} ${BENCHMARK_SOURCES})
+    set_target_properties(${target} PROPERTIES
+        CXX_STANDARD 11
+        CXX_EXTENSIONS NO
+        C_STANDARD 11
+        C_EXTENSIONS NO
+        INTERPROCEDURAL_OPTIMIZATION FALSE
+        )
+    target_link_libraries(${target} ${BENCHMARK_LIBRARIES})
+endfunction()
@@ -13,6 +13,13 @@
 //=============================================================================
 #include "core/platform.h"
 #include "ac/spritecache.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#if !defined(AGS_DISABLE_THREADS)
+#include <thread>
+#endif
 #include "ac/gamestructdefines.h"
 #include "debug/out.h"
 #include "gfx/bitmap.h"
@@ -30,6 +37,8 @@ using namespace AGS::Common;
 #define SPRCACHEFLAG_ERROR          0x04
 // Locked sprites are ones that should not be freed when out of cache space.
 #define SPRCACHEFLAG_LOCKED         0x08
+// Tells that the asset sprite is queued for the background loading
+#define SPRCACHEFLAG_PREFETCH       0x10
 
 // High-verbosity sprite cache log
 #if DEBUG_SPRITECACHE
@@ -44,6 +53,38 @@ namespace AGS
 namespace Common
 {
 
+// Shared state of the sprite prefetching: a queue of sprites to load,
+// and a list of sprites loaded by the prefetch thread.
+struct SpriteCache::PrefetchState
+{
+    struct Result
+    {
+        sprkey_t Index = -1;
+        std::unique_ptr<Bitmap> Image;
+        HError Err;
+
+        Result(sprkey_t index, Bitmap *image, const HError &err)
+            : Index(index), Image(image), Err(err) {}
+    };
+
+    // Guards access to the sprite file; game thread must lock this too
+    // while the prefetch thread is running
+    std::mutex FileMutex;
+    // Guards the queues and the state below
+    std::mutex Mutex;
+    // Signals that there's a new sprite in the queue, or thread should stop
+    std::condition_variable WorkCV;
+    // Signals that the current sprite has finished loading
+    std::condition_variable DoneCV;
+    std::deque<sprkey_t> Queue;
+    std::vector<Result> Ready;
+    sprkey_t Current = -1; // sprite being loaded right now
+    bool Stop = false;
+#if !defined(AGS_DISABLE_THREADS)
+    std::thread Thread;
+#endif
+};
+
 SpriteCache::SpriteCache(std::vector<SpriteInfo> &sprInfos, const Callbacks &callbacks)
     : ResourceCache(DEFAULTCACHESIZE_KB * 1024u)
     , _sprInfos(sprInfos)
@@ -57,6 +98,11 @@ SpriteCache::SpriteCache(std::vector<SpriteInfo> &sprInfos, const Callbacks &cal
     _placeholder.reset(BitmapHelper::CreateTransparentBitmap(1, 1));
 }
 
+SpriteCache::~SpriteCache()
+{
+    CancelPrefetch();
+}
+
 size_t SpriteCache::GetSpriteSlotCount() const
 {
     return _spriteData.size();
@@ -87,6 +133,7 @@ bool SpriteCache::IsAssetUnloaded(sprkey_t index) const
 
 void SpriteCache::Reset()
 {
+    CancelPrefetch();
     _file.Close();
     ResourceCache::Clear();
     _spriteData.clear();
@@ -267,6 +314,153 @@ void SpriteCache::PrecacheSprite(sprkey_t index)
     SprCacheLog("Precached %d", index);
 }
 
+void SpriteCache::PrefetchSprites(const std::vector<sprkey_t> &indexes)
+{
+#if defined(AGS_DISABLE_THREADS)
+    (void)indexes; // no background loading in this build
+#else
+    // Only prefetch as much as may fit into the free cache space, otherwise
+    // the installed sprites would push each other out of the cache;
+    // the size is estimated as if sprites were 32-bit, as the final color depth
+    // is not known until the sprite is initialized.
+    size_t free_size = (GetMaxCacheSize() > GetCacheSize()) ?
+        (GetMaxCacheSize() - GetCacheSize()) : 0u;
+    std::vector<sprkey_t> queue;
+    for (const auto index : indexes)
+    {
+        if (index < 0 || (size_t)index >= _spriteData.size())
+            continue;
+        SpriteData &spr = _spriteData[index];
+        if (!spr.IsAssetSprite() || spr.IsError() || (spr.Flags & SPRCACHEFLAG_PREFETCH) ||
+            ResourceCache::Exists(index))
+            continue; // not an asset, or loaded or queued already
+        const size_t size = _sprInfos[index].Width * _sprInfos[index].Height * sizeof(uint32_t);
+        if (size > free_size)
+            break;
+        free_size -= size;
+        spr.Flags |= SPRCACHEFLAG_PREFETCH;
+        queue.push_back(index);
+    }
+    if (queue.empty())
+        return;
+
+    if (!_prefetch)
+        _prefetch.reset(new PrefetchState());
+    {
+        std::lock_guard<std::mutex> lk(_prefetch->Mutex);
+        _prefetch->Queue.insert(_prefetch->Queue.end(), queue.begin(), queue.end());
+    }
+    if (!_prefetch->Thread.joinable())
+        _prefetch->Thread = std::thread(&SpriteCache::RunPrefetch, this);
+    _prefetch->WorkCV.notify_one();
+    SprCacheLog("Prefetch: queued %zu sprites", queue.size());
+#endif
+}
+
+void SpriteCache::ProcessPrefetched()
+{
+    if (!_prefetch)
+        return;
+
+    std::vector<PrefetchState::Result> ready;
+    {
+        std::lock_guard<std::mutex> lk(_prefetch->Mutex);
+        ready.swap(_prefetch->Ready);
+    }
+    for (auto &res : ready)
+    {
+        const sprkey_t index = res.Index;
+        // Skip sprites that were loaded, replaced or deleted meanwhile
+        if ((size_t)index >= _spriteData.size() ||
+            (_spriteData[index].Flags & SPRCACHEFLAG_PREFETCH) == 0)
+            continue;
+        _spriteData[index].Flags &= ~SPRCACHEFLAG_PREFETCH;
+        AddLoadedSprite(index, res.Image.release(), res.Err, false);
+        SprCacheLog("Prefetched %d", index);
+    }
+}
+
+void SpriteCache::CancelPrefetch()
+{
+    if (!_prefetch)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lk(_prefetch->Mutex);
+        _prefetch->Stop = true;
+        _prefetch->Queue.clear();
+    }
+    _prefetch->WorkCV.notify_all();
+#if !defined(AGS_DISABLE_THREADS)
+    if (_prefetch->Thread.joinable())
+        _prefetch->Thread.join();
+#endif
+    _prefetch->Ready.clear();
+    _prefetch->Stop = false;
+    for (auto &spr : _spriteData)
+        spr.Flags &= ~SPRCACHEFLAG_PREFETCH;
+}
+
+void SpriteCache::RunPrefetch()
+{
+    PrefetchState &pf = *_prefetch;
+    std::vector<uint8_t> data;
+    std::unique_lock<std::mutex> lk(pf.Mutex);
+    for (;;)
+    {
+        pf.WorkCV.wait(lk, [&pf]() { return pf.Stop || !pf.Queue.empty(); });
+        if (pf.Stop)
+            break;
+        const sprkey_t index = pf.Queue.front();
+        pf.Queue.pop_front();
+        pf.Current = index;
+        lk.unlock();
+
+        // Only reading from the stream has to be serialized with the game thread,
+        // the decompression and pixel conversion are done on the raw data copy
+        SpriteDatHeader hdr;
+        HError err;
+        {
+            std::lock_guard<std::mutex> file_lk(pf.FileMutex);
+            err = _file.LoadRawData(index, hdr, data);
+        }
+        Bitmap *image = nullptr;
+        if (err)
+            err = _file.DecodeRawData(index, hdr, data, image);
+
+        lk.lock();
+        pf.Ready.emplace_back(index, image, err);
+        pf.Current = -1;
+        pf.DoneCV.notify_all();
+    }
+}
+
+bool SpriteCache::TakePrefetched(sprkey_t index, Bitmap *&image, HError &err)
+{
+    if (!_prefetch || (_spriteData[index].Flags & SPRCACHEFLAG_PREFETCH) == 0)
+        return false;
+    _spriteData[index].Flags &= ~SPRCACHEFLAG_PREFETCH;
+
+    PrefetchState &pf = *_prefetch;
+    std::unique_lock<std::mutex> lk(pf.Mutex);
+    auto it_queued = std::find(pf.Queue.begin(), pf.Queue.end(), index);
+    if (it_queued != pf.Queue.end())
+    {
+        // not started yet, let the caller load it right away
+        pf.Queue.erase(it_queued);
+        return false;
+    }
+    pf.DoneCV.wait(lk, [&pf, index]() { return pf.Current != index; });
+    auto it_ready = std::find_if(pf.Ready.begin(), pf.Ready.end(),
+        [index](const PrefetchState::Result &res) { return res.Index == index; });
+    if (it_ready == pf.Ready.end())
+        return false;
+    image = it_ready->Image.release();
+    err = it_ready->Err;
+    pf.Ready.erase(it_ready);
+    return true;
+}
+
 std::unique_ptr<Bitmap> SpriteCache::LoadSpriteNoCache(sprkey_t index)
 {
     // invalid sprite slot
@@ -338,7 +532,19 @@ Bitmap *SpriteCache::LoadSprite(sprkey_t index, bool lock)
     assert((_spriteData[index].Flags & SPRCACHEFLAG_ISASSET) != 0);
 
     Bitmap *image{};
-    HError err = _file.LoadSprite(index, image);
+    HError err;
+    if (!TakePrefetched(index, image, err))
+    {
+        std::unique_lock<std::mutex> file_lk;
+        if (_prefetch)
+            file_lk = std::unique_lock<std::mutex>(_prefetch->FileMutex);
+        err = _file.LoadSprite(index, image);
+    }
+    return AddLoadedSprite(index, image, err, lock);
+}
+
+Bitmap *SpriteCache::AddLoadedSprite(sprkey_t index, Bitmap *image, const HError &err, bool lock)
+{
     if (!image)
     {
         Debug::Printf(kDbgGroup_SprCache, kDbgMsg_Warn,
@@ -401,6 +607,7 @@ int SpriteCache::SaveToFile(const String &filename, int store_flags, SpriteCompr
     // exists at all (either have a ready image, or found in a input file).
     // SaveSpriteFile will either use a ready image or load missing images
     // before saving to the destination.
+    CancelPrefetch(); // the file is read from while saving
     std::vector<std::pair<bool, Bitmap*>> sprites;
     for (size_t i = 0; i < _spriteData.size(); ++i)
     {
@@ -449,6 +656,7 @@ HError SpriteCache::InitFile(std::unique_ptr<Stream> &&sprite_file,
 
 void SpriteCache::DetachFile()
 {
+    CancelPrefetch();
     _file.Close();
 }
 
@@ -17,6 +17,11 @@
 // SpriteCache provides bitmaps by demand; it uses SpriteFile to load sprites
 // and does MRU (most-recent-use) caching.
 //
+// Asset sprites may also be prefetched: read and decompressed on a background
+// thread ahead of time, in which case the cache only has to install the ready
+// bitmaps when they are requested, or when ProcessPrefetched() is called.
+// All the public methods are still supposed to be called from the same thread.
+//
 // TODO: refactor engine code to allow store and return shared_ptr<Bitmap>.
 //
 // TODO: currently inherits ResourceCache<Bitmap> as protected, because sprites
@@ -86,7 +91,7 @@ public:
 
 
     SpriteCache(std::vector<SpriteInfo> &sprInfos, const Callbacks &callbacks);
-    ~SpriteCache() = default;
+    ~SpriteCache();
 
     // Loads sprite reference information and inits sprite stream
     HError      InitFile(std::unique_ptr<Stream> &&sprite_file,
@@ -134,6 +139,17 @@ public:
     // Loads sprite using SpriteFile if such index is known,
     // frees the space if cache size reaches the limit
     void        PrecacheSprite(sprkey_t index);
+    // Queues asset sprites for loading on a background thread. Skips sprites
+    // which are already loaded or queued, and stops queuing when the sprites
+    // would not fit into the free cache space. Does nothing if the engine
+    // is built without threads support.
+    void        PrefetchSprites(const std::vector<sprkey_t> &indexes);
+    // Puts sprites which were loaded on a background thread into the cache;
+    // this should be called regularly, e.g. once per game frame.
+    void        ProcessPrefetched();
+    // Cancels all the queued sprite loading, and discards sprites which
+    // were loaded but not put into the cache yet.
+    void        CancelPrefetch();
     // Loads the sprite if necessary and returns a *copy* of bitmap, passing
     // ownership to the caller. Skips storing the sprite in the cache
     // (unless it was already there).
@@ -186,8 +202,18 @@ protected:
     size_t CalcSize(const std::unique_ptr<Bitmap> &item) override;
 
 private:
+    struct PrefetchState;
+
     // Load sprite from game resource and put into the cache
     Bitmap *    LoadSprite(sprkey_t index, bool lock = false);
+    // Puts a sprite loaded from game resource into the cache, or remaps
+    // the sprite to placeholder if the loading has failed
+    Bitmap *    AddLoadedSprite(sprkey_t index, Bitmap *image, const HError &err, bool lock);
+    // Takes the sprite out of the prefetch queue; if the sprite is being loaded
+    // right now, then waits for it. Returns false if sprite was not queued.
+    bool        TakePrefetched(sprkey_t index, Bitmap *&image, HError &err);
+    // Runs the prefetch thread's loop
+    void        RunPrefetch();
     // Remap the given index to the sprite 0
     void        RemapSpriteToPlaceholder(sprkey_t index);
     // Initialize the empty sprite slot
@@ -229,6 +255,8 @@ private:
 
     Callbacks  _callbacks;
     SpriteFile _file;
+    // Background loading state; allocated on demand
+    std::unique_ptr<PrefetchState> _prefetch;
 };
 
 } // namespace Common
@@ -151,12 +151,18 @@ public:
     HError      LoadSprite(sprkey_t index, Bitmap *&sprite);
     // Loads a raw sprite element data into the buffer, stores header info separately
     HError      LoadRawData(sprkey_t index, SpriteDatHeader &hdr, std::vector<uint8_t> &data);
+    // Creates a ready bitmap from the raw sprite data, previously read by LoadRawData;
+    // does not access the sprite stream, and so may be called from another thread
+    HError      DecodeRawData(sprkey_t index, const SpriteDatHeader &hdr,
+                              const std::vector<uint8_t> &data, Bitmap *&sprite) const;
 
 private:
     // Rebuilds sprite index from the main sprite file
     HError      RebuildSpriteIndex(Stream *in, sprkey_t topmost, std::vector<Size> &metrics);
     // Seek stream to sprite
     void        SeekToSprite(sprkey_t index);
+    // Reads image data, following the sprite header, and creates a bitmap
+    HError      ReadSpriteImage(Stream *in, sprkey_t index, const SpriteDatHeader &hdr, Bitmap *&sprite) const;
 
     // Internal sprite reference
     struct SpriteRef
@@ -15,6 +15,8 @@
 #include <algorithm>
 #include <regex>
 #include "util/file.h"
+#include "util/mappedstream.h"
+#include "util/memory_compat.h"
 #include "util/multifilelib.h"
 #include "util/path.h"
 
@@ -87,6 +89,20 @@ AssetSearchPriority AssetManager::GetSearchPriority() const
     return _libsPriority;
 }
 
+void AssetManager::SetMemoryMapping(bool enable)
+{
+    if (_memoryMapping == enable)
+        return;
+    _memoryMapping = enable;
+    for (auto &lib : _libs)
+        MapLibraryFiles(lib.get(), enable);
+}
+
+bool AssetManager::GetMemoryMapping() const
+{
+    return _memoryMapping;
+}
+
 AssetError AssetManager::AddLibrary(const String &path, const AssetLibInfo **out_lib)
 {
     return AddLibrary(path, "", out_lib);
@@ -152,7 +168,11 @@ AssetLibEntry AssetManager::GetLibraryEntry(size_t index) const
 {
     if (index >= _libs.size())
         return {};
-    return AssetLibEntry(IsAssetLibDir(_libs[index].get()), _libs[index]->BasePath, _libs[index]->RealLibFiles, _libs[index]->FilterString);
+    const AssetLibEx *lib = _libs[index].get();
+    AssetLibEntry entry(IsAssetLibDir(lib), lib->BasePath, lib->RealLibFiles, lib->FilterString);
+    entry.IsMemoryMapped = std::any_of(lib->MappedFiles.begin(), lib->MappedFiles.end(),
+        [](const std::shared_ptr<MappedFile> &mf) { return mf != nullptr; });
+    return entry;
 }
 
 const AssetLibInfo *AssetManager::GetLibraryInfo(size_t index) const
@@ -333,6 +353,8 @@ AssetError AssetManager::RegisterAssetLib(const String &path, AssetLibEx *&out_l
         {
             lib->Lookup[lib->AssetInfos[i].FileName] = i;
         }
+
+        MapLibraryFiles(lib.get(), _memoryMapping);
     }
 
     out_lib = lib.get();
@@ -340,6 +362,20 @@ AssetError AssetManager::RegisterAssetLib(const String &path, AssetLibEx *&out_l
     return kAssetNoError;
 }
 
+/* static */ void AssetManager::MapLibraryFiles(AssetLibEx *lib, bool enable)
+{
+    lib->MappedFiles.clear();
+    if (!enable || IsAssetLibDir(lib) || !MappedFile::IsSupported())
+        return;
+    // The library files which fail to map are read as regular files
+    lib->MappedFiles.resize(lib->RealLibFiles.size());
+    for (size_t i = 0; i < lib->RealLibFiles.size(); ++i)
+    {
+        if (!lib->RealLibFiles[i].IsEmpty())
+            lib->MappedFiles[i] = MappedFile::Open(lib->RealLibFiles[i]);
+    }
+}
+
 std::unique_ptr<Stream> AssetManager::OpenAsset(const String &asset_name, const String &filter) const
 {
     for (const auto *lib : _activeLibs)
@@ -364,6 +400,11 @@ std::unique_ptr<Stream> AssetManager::OpenAssetFromLib(const AssetLibEx *lib, co
         return nullptr;
 
     const AssetInfo &a = lib->AssetInfos[it_found->second];
+    if (((size_t)a.LibUid < lib->MappedFiles.size()) && lib->MappedFiles[a.LibUid])
+    {
+        return std::make_unique<Stream>(
+            std::make_unique<MappedStream>(lib->MappedFiles[a.LibUid], a.Offset, a.Offset + a.Size));
+    }
     String libfile = lib->RealLibFiles[a.LibUid];
     if (libfile.IsEmpty())
         return nullptr;
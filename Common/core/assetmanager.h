@@ -50,6 +50,7 @@ namespace Common
 {
 
 struct MultiFileLib;
+class MappedFile;
 
 enum AssetSearchPriority
 {
@@ -82,6 +83,7 @@ struct AssetLibEntry
     String Path; // path to the asset library (either dir or head library file)
     std::vector<String> LibFiles; // registered library filenames
     String Filters; // filter string this library is matching
+    bool IsMemoryMapped = false; // whether any of the library files is mapped into memory
 
     AssetLibEntry() = default;
     AssetLibEntry(bool is_dir, const String &path, const std::vector<String> &files, const String filters)
@@ -104,6 +106,13 @@ public:
     void         SetSearchPriority(AssetSearchPriority priority);
     // Gets current asset search priority
     AssetSearchPriority GetSearchPriority() const;
+    // Sets whether the library files should be mapped into memory, where
+    // supported by the platform; the assets from the mapped libraries are
+    // read directly from the mapped memory (see MappedStream).
+    // This setting applies to the already registered libraries too.
+    void         SetMemoryMapping(bool enable);
+    // Tells whether the library files are mapped into memory when possible
+    bool         GetMemoryMapping() const;
 
     // Add library location to the list of asset locations
     AssetError   AddLibrary(const String &path, const AssetLibInfo **lib = nullptr);
@@ -152,6 +161,7 @@ private:
         String FilterString; // filter string, as received on input (for diagnostic purposes)
         std::vector<String> Filters; // asset filters this library is matching to
         std::vector<String> RealLibFiles; // fixed up library filenames
+        std::vector<std::shared_ptr<MappedFile>> MappedFiles; // optional memory mapped library files
         std::unordered_map<String, size_t, HashStrNoCase, StrEqNoCase> Lookup; // name to index asset lookup
 
         bool TestFilter(const String &filter) const;
@@ -159,6 +169,8 @@ private:
 
     // Loads library and registers its contents into the cache
     AssetError  RegisterAssetLib(const String &path, AssetLibEx *&lib);
+    // Maps or unmaps the library files into memory
+    static void MapLibraryFiles(AssetLibEx *lib, bool enable);
 
     // Tries to find asset in the given location, and then opens a stream for reading
     std::unique_ptr<Stream> OpenAssetFromLib(const AssetLibEx *lib, const String &asset_name) const;
@@ -167,6 +179,7 @@ private:
     std::vector<std::unique_ptr<AssetLibEx>> _libs;
     std::vector<AssetLibEx*> _activeLibs;
     AssetSearchPriority _libsPriority = kAssetPriorityDir;
+    bool _memoryMapping = false;
     // Sorting function, depends on priority setting
     std::function<bool(const AssetLibInfo*, const AssetLibInfo*)> _libsSorter;
 };
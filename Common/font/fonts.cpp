@@ -13,12 +13,15 @@
 //=============================================================================
 #include <algorithm>
 #include <cstdio>
+#include <memory>
+#include <string>
 #include <vector>
 #include <alfont.h>
 #include "ac/common.h" // set_our_eip
 #include "ac/gamestructdefines.h"
 #include "debug/out.h"
 #include "font/fonts.h"
+#include "font/textwidthcache.h"
 #include "font/ttffontrenderer.h"
 #include "font/wfnfontrenderer.h"
 #include "gfx/bitmap.h"
@@ -55,11 +58,12 @@ struct Font
     // Outline buffers
     Bitmap TextStencil, TextStencilSub;
     Bitmap OutlineStencil, OutlineStencilSub;
+    // Measured text widths, only used with the built-in TTF renderer,
+    // because the plugin renderers may return varied results
+    std::unique_ptr<TextWidthCache> WidthCache;
 
     Font() = default;
-    Font(const Font &font) = default;
     Font(Font &&font) = default;
-    Font &operator =(const Font &font) = default;
     Font &operator =(Font &&font) = default;
 };
 
@@ -108,6 +112,26 @@ inline bool assert_font_renderer(int font_number)
         && (fonts[font_number].Renderer != nullptr);
 }
 
+// Gets the text width from the font's renderer, or from the width cache
+static int get_renderer_text_width(const char *text, int font_number)
+{
+    Font &font = fonts[font_number];
+    if (!font.RendererInt || font.RendererInt->IsBitmapFont())
+        return font.Renderer->GetTextWidth(text, font_number);
+
+    if (!font.WidthCache)
+        font.WidthCache.reset(new TextWidthCache());
+    return font.WidthCache->GetWidth(text,
+        [&font, font_number](const char *t) { return font.Renderer->GetTextWidth(t, font_number); });
+}
+
+// Drops the measured text widths, must be called whenever
+// the font's renderer or any of its render parameters change
+static void reset_text_width_cache(int font_number)
+{
+    fonts[font_number].WidthCache.reset();
+}
+
 void adjust_y_coordinate_for_text(int* ypos, int font_number)
 {
     if (!assert_font_renderer(font_number))
@@ -184,6 +208,7 @@ static void font_post_init(int font_number)
 static void font_replace_renderer(int font_number,
     IAGSFontRenderer* renderer, IAGSFontRenderer2* renderer2)
 {
+    reset_text_width_cache(font_number);
     fonts[font_number].Renderer = renderer;
     fonts[font_number].Renderer2 = renderer2;
     // If this is one of our built-in font renderers, then correctly
@@ -225,6 +250,7 @@ void font_recalc_metrics(int font_number)
     if (!assert_font_number(font_number))
         return;
     fonts[font_number].Metrics = FontMetrics();
+    reset_text_width_cache(font_number);
     font_post_init(font_number);
 }
 
@@ -268,7 +294,7 @@ int get_text_width(const char *texx, int font_number)
 {
     if (!assert_font_renderer(font_number))
         return 0;
-    return fonts[font_number].Renderer->GetTextWidth(texx, font_number);
+    return get_renderer_text_width(texx, font_number);
 }
 
 int get_text_width_outlined(const char *text, int font_number)
@@ -278,13 +304,13 @@ int get_text_width_outlined(const char *text, int font_number)
     if(text == nullptr || text[0] == 0) // we ignore outline width since the text is empty
         return 0;
 
-    int self_width = fonts[font_number].Renderer->GetTextWidth(text, font_number);
+    int self_width = get_renderer_text_width(text, font_number);
     int outline = fonts[font_number].Info.Outline;
     if (outline < 0 || static_cast<uint32_t>(outline) > fonts.size())
     { // FONT_OUTLINE_AUTO or FONT_OUTLINE_NONE
         return self_width + 2 * fonts[font_number].Info.AutoOutlineThickness;
     }
-    int outline_width = fonts[outline].Renderer->GetTextWidth(text, outline);
+    int outline_width = get_renderer_text_width(text, outline);
     return std::max(self_width, outline_width);
 }
 
@@ -532,6 +558,7 @@ void set_fontinfo(int font_number, const FontInfo &finfo)
         return;
 
     fonts[font_number].Info = finfo;
+    reset_text_width_cache(font_number);
     font_post_init(font_number);
 }
 
@@ -649,6 +676,7 @@ void adjust_fonts_for_render_mode(bool aa_mode)
     {
         if (fonts[i].RendererInt)
             fonts[i].RendererInt->AdjustFontForAntiAlias(static_cast<int>(i), aa_mode);
+        reset_text_width_cache(static_cast<int>(i));
     }
 }
 
@@ -672,6 +700,8 @@ void movefont(int old_number, int new_number)
 
     fonts[new_number] = std::move(fonts[old_number]);
     fonts[old_number] = Font();
+    // renderers refer to fonts by number, so the widths may change
+    reset_text_width_cache(new_number);
 }
 
 void free_all_fonts()
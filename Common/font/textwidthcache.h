@@ -0,0 +1,73 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// TextWidthCache remembers widths of the recently measured texts of a font,
+// tracks use history with MRU list. The same texts (labels, list items,
+// speech, dialog options) are measured over and over again, and word wrapping
+// measures each beginning of a line, which is slow with TTF fonts.
+// Every item has size 1 here, so the cache's limit is a number of texts.
+//
+// The texts are decoded according to the current Allegro's text format
+// (see set_uformat), so the same text may have different width in ASCII
+// and UTF-8 modes. The cache remembers the format its texts were measured
+// with, and drops all of them when the format changes.
+//
+//=============================================================================
+#ifndef __AC_TEXTWIDTHCACHE_H
+#define __AC_TEXTWIDTHCACHE_H
+
+#include <string>
+#include <allegro.h> // get_uformat
+#include "util/resourcecache.h"
+
+namespace AGS
+{
+namespace Common
+{
+
+class TextWidthCache final : public ResourceCache<std::string, int>
+{
+public:
+    TextWidthCache(size_t max_texts = 4096) : ResourceCache(max_texts) {}
+
+    // Gets the text's width; if it's not cached, then measures the text
+    // by calling measure(text), and remembers the result
+    template <typename TMeasure>
+    int GetWidth(const char *text, TMeasure measure)
+    {
+        const int uformat = get_uformat();
+        if (uformat != _uformat)
+        {
+            Clear();
+            _uformat = uformat;
+        }
+        const std::string key = text;
+        if (Exists(key))
+            return Get(key);
+        const int width = measure(text);
+        Put(key, width);
+        return width;
+    }
+
+private:
+    size_t CalcSize(const int &/*width*/) override { return 1u; }
+
+    // Text format which the cached widths were measured with
+    int _uformat = 0;
+};
+
+} // namespace Common
+} // namespace AGS
+
+#endif // __AC_TEXTWIDTHCACHE_H
@@ -17,6 +17,7 @@
 #include "core/platform.h"
 #include "core/assetmanager.h"
 #include "font/fonts.h"
+#include "util/mappedstream.h"
 #include "util/stream.h"
 
 using namespace AGS::Common;
@@ -127,6 +128,11 @@ ALFONT_FONT *TTFFontRenderer::LoadTTF(const AGS::Common::String &filename, int f
     if (!reader)
         return nullptr;
 
+    // If the asset is mapped into memory, then pass the mapped data directly
+    const MappedStream *mapped = MappedStream::FromStream(reader.get());
+    if (mapped)
+        return LoadTTFFromMem(mapped->GetData(), mapped->GetSize(), font_size, alfont_flags);
+
     const size_t lenof = reader->GetLength();
     std::vector<uint8_t> buf(lenof);
     reader->Read(buf.data(), lenof);
@@ -22,9 +22,9 @@ using namespace AGS::Common;
 //
 int ccCompOptions = SCOPT_LEFTTORIGHT;
 // currently compiled or executed line
-int currentline;
+CC_THREAD_LOCAL int currentline;
 // name of currently compiling script or script section
-std::string ccCurScriptName;
+CC_THREAD_LOCAL std::string ccCurScriptName;
 
 void ccSetOption(int optbit, int onoroff)
 {
@@ -45,7 +45,7 @@ int ccGetOption(int optbit)
 // Returns current running script callstack as a human-readable text
 extern String cc_get_callstack(int max_lines = INT_MAX);
 
-static ScriptError ccError;
+static CC_THREAD_LOCAL ScriptError ccError;
 
 void cc_clear_error()
 {
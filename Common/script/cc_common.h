@@ -36,6 +36,15 @@
 #define SCOPT_UTF8          0x0100   // UTF-8 text mode
 #define SCOPT_HIGHEST       SCOPT_UTF8
 
+// The script compiler may be built to run several compilations at once, each
+// on its own thread; in that case the compilation state is kept per thread.
+// The options are shared, and must not be changed while compiling.
+#if defined(AGS_CC_THREADLOCAL_STATE)
+#define CC_THREAD_LOCAL thread_local
+#else
+#define CC_THREAD_LOCAL
+#endif
+
 extern void ccSetOption(int, int);
 extern int ccGetOption(int);
 
@@ -62,8 +71,8 @@ void cc_error(const ScriptError &err);
 AGS::Common::String cc_format_error(const AGS::Common::String &message);
 
 // currently compiled or executed line
-extern int currentline;
+extern CC_THREAD_LOCAL int currentline;
 // name of currently compiling script or script section
-extern std::string ccCurScriptName;
+extern CC_THREAD_LOCAL std::string ccCurScriptName;
 
 #endif // __CC_ERROR_H
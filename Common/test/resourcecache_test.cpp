@@ -0,0 +1,99 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "gtest/gtest.h"
+#include "util/resourcecache.h"
+
+using namespace AGS::Common;
+
+// A cache where each item's value is also its size
+class TestCache final : public ResourceCache<int, size_t>
+{
+public:
+    TestCache(size_t max_size) : ResourceCache(max_size) {}
+
+private:
+    size_t CalcSize(const size_t &item) override { return item; }
+};
+
+TEST(ResourceCache, DisposeLeastRecentlyUsed) {
+    TestCache cache(10);
+    cache.Put(1, 4);
+    cache.Put(2, 4);
+    ASSERT_EQ(cache.GetCacheSize(), 8u);
+    // Using item 1 makes item 2 the least recently used one
+    ASSERT_EQ(cache.Get(1), 4u);
+    cache.Put(3, 4);
+    ASSERT_TRUE(cache.Exists(1));
+    ASSERT_FALSE(cache.Exists(2));
+    ASSERT_TRUE(cache.Exists(3));
+    ASSERT_EQ(cache.GetCacheSize(), 8u);
+    // Item large enough to dispose everything else
+    cache.Put(4, 10);
+    ASSERT_FALSE(cache.Exists(1));
+    ASSERT_FALSE(cache.Exists(3));
+    ASSERT_TRUE(cache.Exists(4));
+    ASSERT_EQ(cache.GetCacheSize(), 10u);
+}
+
+TEST(ResourceCache, LockedItemsAreKept) {
+    TestCache cache(10);
+    cache.Put(1, 4);
+    cache.Put(2, 2);
+    cache.Lock(1);
+    ASSERT_EQ(cache.GetLockedSize(), 4u);
+    cache.Put(3, 4);
+    cache.Put(4, 2);
+    // The oldest free item is disposed, but not the locked one
+    ASSERT_TRUE(cache.Exists(1));
+    ASSERT_FALSE(cache.Exists(2));
+    ASSERT_TRUE(cache.Exists(3));
+    ASSERT_TRUE(cache.Exists(4));
+    // Released item becomes the most recently used one
+    cache.Release(1);
+    ASSERT_EQ(cache.GetLockedSize(), 0u);
+    cache.Put(5, 6);
+    ASSERT_TRUE(cache.Exists(1));
+    ASSERT_FALSE(cache.Exists(3));
+    ASSERT_FALSE(cache.Exists(4));
+    ASSERT_TRUE(cache.Exists(5));
+}
+
+TEST(ResourceCache, DisposeFreeItems) {
+    TestCache cache(100);
+    for (int i = 1; i <= 6; ++i)
+        cache.Put(i, 5);
+    cache.Lock(2);
+    cache.Lock(5);
+    cache.Put(7, 3, TestCache::kCacheItem_External);
+    ASSERT_EQ(cache.GetCacheSize(), 30u);
+    ASSERT_EQ(cache.GetLockedSize(), 10u);
+    ASSERT_EQ(cache.GetExternalSize(), 3u);
+
+    // Only the locked and external items remain
+    cache.DisposeFreeItems();
+    for (int i = 1; i <= 6; ++i)
+        ASSERT_EQ(cache.Exists(i), (i == 2) || (i == 5));
+    ASSERT_TRUE(cache.Exists(7));
+    ASSERT_EQ(cache.GetCacheSize(), 10u);
+    ASSERT_EQ(cache.GetLockedSize(), 10u);
+    ASSERT_EQ(cache.GetExternalSize(), 3u);
+
+    // The cache remains usable
+    cache.Release(2);
+    cache.DisposeFreeItems();
+    ASSERT_FALSE(cache.Exists(2));
+    ASSERT_TRUE(cache.Exists(5));
+    cache.Put(8, 5);
+    ASSERT_EQ(cache.GetCacheSize(), 10u);
+}
@@ -0,0 +1,96 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <string.h>
+#include <memory>
+#include <vector>
+#include "gtest/gtest.h"
+#include "ac/gamestructdefines.h"
+#include "ac/spritecache.h"
+#include "gfx/bitmap.h"
+#include "util/memory_compat.h"
+#include "util/memorystream.h"
+
+using namespace AGS::Common;
+
+// Creates 32-bit sprite, filled with a pattern unique for this sprite index
+static std::unique_ptr<Bitmap> MakeTestSprite(sprkey_t index)
+{
+    const int w = 8 + index % 13, h = 5 + index % 7;
+    std::unique_ptr<Bitmap> image(BitmapHelper::CreateBitmap(w, h, 32));
+    for (int y = 0; y < h; ++y)
+    {
+        uint32_t *line = reinterpret_cast<uint32_t*>(image->GetScanLineForWriting(y));
+        for (int x = 0; x < w; ++x)
+            line[x] = 0xFF000000 | (index << 16) | (y << 8) | x;
+    }
+    return image;
+}
+
+static bool IsSameImage(const Bitmap *a, const Bitmap *b)
+{
+    if (a->GetSize() != b->GetSize() || a->GetColorDepth() != b->GetColorDepth())
+        return false;
+    for (int y = 0; y < a->GetHeight(); ++y)
+    {
+        if (memcmp(a->GetScanLine(y), b->GetScanLine(y), a->GetLineLength()) != 0)
+            return false;
+    }
+    return true;
+}
+
+static void WriteTestSpriteFile(std::vector<uint8_t> &membuf, SpriteCompression compress, sprkey_t count)
+{
+    SpriteFileWriter writer(std::make_unique<Stream>(
+        std::make_unique<VectorStream>(membuf, kStream_Write)));
+    writer.Begin(0, compress, count - 1);
+    for (sprkey_t i = 0; i < count; ++i)
+        writer.WriteBitmap(MakeTestSprite(i).get());
+    writer.Finalize();
+}
+
+TEST(SpriteCache, Prefetch) {
+    const sprkey_t count = 40;
+    const SpriteCompression compressions[] = { kSprCompress_None, kSprCompress_RLE,
+        kSprCompress_LZW, kSprCompress_Deflate };
+    for (auto compress : compressions)
+    {
+        std::vector<uint8_t> membuf;
+        WriteTestSpriteFile(membuf, compress, count);
+        std::vector<SpriteInfo> infos;
+        SpriteCache cache(infos, SpriteCache::Callbacks());
+        ASSERT_TRUE(cache.InitFile(std::make_unique<Stream>(std::make_unique<VectorStream>(membuf)), nullptr));
+
+        std::vector<sprkey_t> indexes;
+        for (sprkey_t i = 0; i < count; ++i)
+            indexes.push_back(i);
+        cache.PrefetchSprites(indexes);
+        // Request a part of sprites right away, which may be still queued,
+        // or loading, or ready by this time; then install the remaining ones
+        for (sprkey_t i = count - 1; i >= count / 2; --i)
+            ASSERT_TRUE(IsSameImage(cache[i], MakeTestSprite(i).get())) << "compress " << compress << ", sprite " << i;
+        cache.ProcessPrefetched();
+        for (sprkey_t i = 0; i < count; ++i)
+            ASSERT_TRUE(IsSameImage(cache[i], MakeTestSprite(i).get())) << "compress " << compress << ", sprite " << i;
+
+        // Disposed sprites may be prefetched again, and then cancelled
+        cache.DisposeAllFreeCached();
+        cache.PrefetchSprites(indexes);
+        cache.CancelPrefetch();
+        cache.ProcessPrefetched();
+        for (sprkey_t i = 1; i < count; ++i)
+            ASSERT_FALSE(cache.IsSpriteLoaded(i));
+        for (sprkey_t i = 0; i < count; ++i)
+            ASSERT_TRUE(IsSameImage(cache[i], MakeTestSprite(i).get())) << "compress " << compress << ", sprite " << i;
+    }
+}
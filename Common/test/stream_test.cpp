@@ -20,6 +20,7 @@
 #include "util/deflatestream.h"
 #include "util/file.h"
 #include "util/filestream.h"
+#include "util/mappedstream.h"
 #include "util/memory_compat.h"
 #include "util/memorystream.h"
 #include "util/string_utils.h"
@@ -337,6 +338,26 @@ TEST(Stream, DeflateStream2) {
     TestDeflateStream_RandomNumericSeq(DeflateStream::BufferSize * 4);
 }
 
+TEST(Stream, DeflateStreamReadWhole) {
+    // Compressed data is read out in one call, and nothing is left after it
+    std::vector<uint8_t> src_buf(DeflateStream::BufferSize * 3);
+    for (size_t i = 0; i < src_buf.size(); ++i)
+        src_buf[i] = static_cast<uint8_t>(i % 251);
+    std::vector<uint8_t> comp_buf;
+    {
+        DeflateStream out(std::make_unique<VectorStream>(comp_buf, kStream_Write), kStream_Write);
+        out.Write(src_buf.data(), src_buf.size());
+        out.Finalize();
+    }
+
+    std::vector<uint8_t> dst_buf(src_buf.size());
+    DeflateStream in(std::make_unique<VectorStream>(comp_buf), 0, comp_buf.size());
+    ASSERT_EQ(in.Read(dst_buf.data(), dst_buf.size()), src_buf.size());
+    uint8_t extra;
+    ASSERT_EQ(in.Read(&extra, 1), 0u);
+    ASSERT_EQ(dst_buf, src_buf);
+}
+
 #if (AGS_PLATFORM_TEST_FILE_IO)
 
 static const char *DummyFile = "dummy.dat";
@@ -742,4 +763,64 @@ TEST_F(FileBasedTest, BufferedSectionStream) {
     File::DeleteFile(DummyFile);
 }
 
+TEST_F(FileBasedTest, MappedStream) {
+    {
+        Stream out(std::make_unique<FileStream>(DummyFile, kFile_CreateAlways, kStream_Write));
+        for (int32_t i = 0; i < 16; ++i)
+            out.WriteInt32(i);
+    }
+    if (!MappedFile::IsSupported())
+    {
+        File::DeleteFile(DummyFile);
+        return;
+    }
+
+    auto file = MappedFile::Open(DummyFile);
+    ASSERT_TRUE(file);
+    ASSERT_EQ(file->GetSize(), 16 * sizeof(int32_t));
+    int32_t value;
+    memcpy(&value, file->GetData() + 5 * sizeof(int32_t), sizeof(int32_t));
+    ASSERT_EQ(value, 5);
+
+    // Test reading a section
+    const soff_t section_start = 4 * sizeof(int32_t);
+    const soff_t section_end = 12 * sizeof(int32_t);
+    Stream in(std::make_unique<MappedStream>(file, section_start, section_end));
+    ASSERT_TRUE(in.CanRead());
+    ASSERT_TRUE(in.CanSeek());
+    ASSERT_FALSE(in.CanWrite());
+    ASSERT_EQ(in.GetLength(), section_end - section_start);
+    ASSERT_EQ(in.ReadInt32(), 4);
+    ASSERT_EQ(in.ReadInt32(), 5);
+    ASSERT_EQ(in.Seek(-4, kSeekEnd), section_end - section_start - 4);
+    ASSERT_EQ(in.ReadInt32(), 11);
+    ASSERT_TRUE(in.EOS());
+    ASSERT_EQ(in.Seek(0, kSeekBegin), 0);
+    ASSERT_EQ(in.ReadInt32(), 4);
+
+    // Test direct access to the mapped data
+    MappedStream *mapped = MappedStream::FromStream(&in);
+    ASSERT_NE(mapped, nullptr);
+    ASSERT_EQ(mapped->GetSize(), static_cast<size_t>(section_end - section_start));
+    ASSERT_EQ(mapped->GetData(), file->GetData() + section_start);
+    std::vector<uint8_t> membuf;
+    Stream vin(std::make_unique<VectorStream>(membuf));
+    ASSERT_EQ(MappedStream::FromStream(&vin), nullptr);
+
+    // Test that the section is clamped to the file's size
+    Stream in2(std::make_unique<MappedStream>(file, 14 * sizeof(int32_t), 100 * sizeof(int32_t)));
+    ASSERT_EQ(in2.GetLength(), 2 * sizeof(int32_t));
+    ASSERT_EQ(in2.ReadInt32(), 14);
+    ASSERT_EQ(in2.ReadInt32(), 15);
+    ASSERT_TRUE(in2.EOS());
+
+    // The mapping must be kept alive by the stream
+    file.reset();
+    ASSERT_EQ(in.ReadInt32(), 5);
+    in.Close();
+    in2.Close();
+
+    File::DeleteFile(DummyFile);
+}
+
 #endif // AGS_PLATFORM_TEST_FILE_IO
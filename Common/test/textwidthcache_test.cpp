@@ -0,0 +1,59 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "gtest/gtest.h"
+#include "font/textwidthcache.h"
+
+using namespace AGS::Common;
+
+// Measures text as a monospace font would, decoding the characters
+// in the current text format, same as TTF renderer does
+static int MeasureMonospace(const char *text, int &calls)
+{
+    calls++;
+    return ustrlen(text) * 10;
+}
+
+TEST(TextWidthCache, Cache) {
+    const int old_format = get_uformat();
+    set_uformat(U_ASCII);
+    TextWidthCache cache;
+    int calls = 0;
+    auto measure = [&calls](const char *text) { return MeasureMonospace(text, calls); };
+    ASSERT_EQ(cache.GetWidth("abc", measure), 30);
+    ASSERT_EQ(cache.GetWidth("abcd", measure), 40);
+    ASSERT_EQ(calls, 2);
+    // Same texts are not measured again
+    ASSERT_EQ(cache.GetWidth("abc", measure), 30);
+    ASSERT_EQ(cache.GetWidth("abcd", measure), 40);
+    ASSERT_EQ(calls, 2);
+    set_uformat(old_format);
+}
+
+TEST(TextWidthCache, TextFormatChange) {
+    const int old_format = get_uformat();
+    // 2 bytes, which make a single character in UTF-8
+    const char *text = "\xC3\xA9";
+    TextWidthCache cache;
+    int calls = 0;
+    auto measure = [&calls](const char *text) { return MeasureMonospace(text, calls); };
+    set_uformat(U_ASCII);
+    ASSERT_EQ(cache.GetWidth(text, measure), 20);
+    set_uformat(U_UTF8);
+    ASSERT_EQ(cache.GetWidth(text, measure), 10);
+    ASSERT_EQ(cache.GetWidth(text, measure), 10);
+    set_uformat(U_ASCII);
+    ASSERT_EQ(cache.GetWidth(text, measure), 20);
+    ASSERT_EQ(calls, 3);
+    set_uformat(old_format);
+}
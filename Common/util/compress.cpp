@@ -525,3 +525,8 @@ bool inflate_decompress(uint8_t* data, size_t data_sz, int /*image_bpp*/, Stream
     in->Read(in_buf.data(), in_sz);
     return z_inflate(in_buf.data(), in_sz, data, data_sz);
 }
+
+uint32_t crc32_checksum(const uint8_t *data, size_t data_sz, uint32_t crc)
+{
+    return static_cast<uint32_t>(mz_crc32(crc, data, data_sz));
+}
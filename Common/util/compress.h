@@ -45,4 +45,8 @@ std::unique_ptr<Common::Bitmap> load_lzw(Common::Stream *in, int dst_bpp, RGB (*
 bool deflate_compress(const uint8_t* data, size_t data_sz, int image_bpp, Common::Stream* out);
 bool inflate_decompress(uint8_t* data, size_t data_sz, int image_bpp, Common::Stream* in, size_t in_sz);
 
+// Calculates CRC-32 checksum of the data; pass the previous result as "crc"
+// to continue calculating over the next piece of data
+uint32_t crc32_checksum(const uint8_t *data, size_t data_sz, uint32_t crc = 0u);
+
 #endif // __AC_COMPRESS_H
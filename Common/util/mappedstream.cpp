@@ -0,0 +1,149 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "util/mappedstream.h"
+#include <algorithm>
+#include <limits>
+#include "util/stdio_compat.h"
+
+#if AGS_PLATFORM_OS_WINDOWS
+#include "platform/windows/windows.h"
+#define AGS_HAS_MEMORY_MAPPING 1
+#elif !AGS_PLATFORM_OS_EMSCRIPTEN && !AGS_PLATFORM_OS_PSP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define AGS_HAS_MEMORY_MAPPING 1
+#endif
+
+namespace AGS
+{
+namespace Common
+{
+
+MappedFile::~MappedFile()
+{
+#if AGS_PLATFORM_OS_WINDOWS
+    if (_data)
+        UnmapViewOfFile(_data);
+    if (_mapping)
+        CloseHandle(static_cast<HANDLE>(_mapping));
+#elif defined(AGS_HAS_MEMORY_MAPPING)
+    if (_data)
+        munmap(const_cast<uint8_t*>(_data), _size);
+#endif
+}
+
+bool MappedFile::IsSupported()
+{
+#if defined(AGS_HAS_MEMORY_MAPPING)
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::shared_ptr<MappedFile> MappedFile::Open(const String &filename)
+{
+    std::shared_ptr<MappedFile> mf(new MappedFile());
+    mf->_path = filename;
+#if AGS_PLATFORM_OS_WINDOWS
+    WCHAR wpath[MAX_PATH_SZ];
+    MultiByteToWideChar(CP_UTF8, 0, filename.GetCStr(), -1, wpath, MAX_PATH_SZ);
+    HANDLE file = CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return nullptr;
+    LARGE_INTEGER file_size;
+    // NOTE: empty files cannot be mapped
+    if (!GetFileSizeEx(file, &file_size) || (file_size.QuadPart <= 0) ||
+        (static_cast<uint64_t>(file_size.QuadPart) > std::numeric_limits<size_t>::max()))
+    {
+        CloseHandle(file);
+        return nullptr;
+    }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file); // the mapping object keeps the file open
+    if (!mapping)
+        return nullptr;
+    mf->_mapping = mapping;
+    mf->_data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!mf->_data)
+        return nullptr;
+    mf->_size = static_cast<size_t>(file_size.QuadPart);
+    return mf;
+#elif defined(AGS_HAS_MEMORY_MAPPING)
+    int fd = open(filename.GetCStr(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+    struct stat st;
+    // NOTE: empty files cannot be mapped
+    if ((fstat(fd, &st) != 0) || !S_ISREG(st.st_mode) || (st.st_size <= 0) ||
+        (static_cast<uint64_t>(st.st_size) > std::numeric_limits<size_t>::max()))
+    {
+        close(fd);
+        return nullptr;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping keeps the file open
+    if (data == MAP_FAILED)
+        return nullptr;
+    mf->_data = static_cast<const uint8_t*>(data);
+    mf->_size = size;
+    return mf;
+#else
+    return nullptr;
+#endif
+}
+
+
+// Returns the valid section of the mapped file's memory
+static const uint8_t *GetSectionData(const MappedFile *file, soff_t start_pos, soff_t end_pos, size_t &size)
+{
+    const soff_t file_size = static_cast<soff_t>(file->GetSize());
+    start_pos = std::min(std::max<soff_t>(0, start_pos), file_size);
+    end_pos = std::min(std::max(start_pos, end_pos), file_size);
+    size = static_cast<size_t>(end_pos - start_pos);
+    return file->GetData() + start_pos;
+}
+
+MappedStream::MappedStream(std::shared_ptr<MappedFile> file, soff_t start_pos, soff_t end_pos)
+    : MemoryStream(nullptr, 0u)
+    , _file(file)
+{
+    if (!_file)
+        return;
+    size_t size;
+    const uint8_t *data = GetSectionData(_file.get(), start_pos, end_pos, size);
+    _cbuf = data;
+    _buf_sz = size;
+    _len = size;
+    _mode = static_cast<StreamMode>(kStream_Read | kStream_Seek);
+    _path = _file->GetPath();
+}
+
+MappedStream *MappedStream::FromStream(Stream *in)
+{
+    return in ? dynamic_cast<MappedStream*>(in->GetStreamBase()) : nullptr;
+}
+
+void MappedStream::Close()
+{
+    MemoryStream::Close();
+    _file.reset();
+}
+
+} // namespace Common
+} // namespace AGS
@@ -0,0 +1,98 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// MappedFile is a read-only memory mapping of a whole file.
+//
+// MappedStream is a read-only stream over a section of the mapped file.
+// Reading from it only copies the data from the mapped memory, and the users
+// which need the whole data at once may access the mapped bytes directly,
+// without copying them anywhere. The stream shares the ownership over the
+// mapping, so the mapped memory persists as long as any stream is open.
+//
+// Memory mapping is not supported on some platforms, in which case
+// MappedFile::Open always fails, and the user should fallback to
+// the regular file streams.
+//
+//=============================================================================
+#ifndef __AGS_CN_UTIL__MAPPEDSTREAM_H
+#define __AGS_CN_UTIL__MAPPEDSTREAM_H
+
+#include <memory>
+#include "core/platform.h"
+#include "util/memorystream.h"
+#include "util/string.h"
+
+namespace AGS
+{
+namespace Common
+{
+
+class MappedFile
+{
+public:
+    ~MappedFile();
+
+    // Tells if memory mapping is supported on this platform
+    static bool IsSupported();
+    // Maps the whole file into memory for reading;
+    // returns null if file could not be mapped
+    static std::shared_ptr<MappedFile> Open(const String &filename);
+
+    const String   &GetPath() const { return _path; }
+    const uint8_t  *GetData() const { return _data; }
+    size_t          GetSize() const { return _size; }
+
+private:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile &operator =(const MappedFile&) = delete;
+
+    String   _path;
+    const uint8_t *_data = nullptr;
+    size_t   _size = 0u;
+#if AGS_PLATFORM_OS_WINDOWS
+    void    *_mapping = nullptr; // file mapping object handle
+#endif
+};
+
+
+class MappedStream : public MemoryStream
+{
+public:
+    // Constructs a stream over the section of the mapped file;
+    // the section is clamped to the file's size
+    MappedStream(std::shared_ptr<MappedFile> file, soff_t start_pos, soff_t end_pos);
+    ~MappedStream() override = default;
+
+    // Returns the MappedStream used by the given stream object, or null
+    static MappedStream *FromStream(Stream *in);
+
+    // Gets the mapped file, which this stream is reading from
+    const std::shared_ptr<MappedFile> &GetFile() const { return _file; }
+    // Gets the pointer to this stream's data in the mapped memory;
+    // the memory is valid for as long as the mapped file is kept
+    const uint8_t *GetData() const { return _cbuf; }
+    // Gets the size of this stream's data
+    size_t   GetSize() const { return _len; }
+
+    void    Close() override;
+
+private:
+    std::shared_ptr<MappedFile> _file;
+};
+
+} // namespace Common
+} // namespace AGS
+
+#endif // __AGS_CN_UTIL__MAPPEDSTREAM_H
@@ -0,0 +1,267 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <cctype>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "compilecache.h"
+#include "compiler.h"
+#include "core/def_version.h"
+#include "script/cc_internal.h"
+#include "util/directory.h"
+#include "util/file.h"
+#include "util/path.h"
+#include "util/stream.h"
+#include "util/string_utils.h"
+
+using namespace AGS::Common;
+
+// Increment whenever the cache entries' format changes, or the compiler changes
+// in a way which affects its output without the change of the compiler's
+// version, for the older cache entries to be ignored
+static const int CacheFormatVersion = 2;
+static const char *CacheEntrySig = "AGSCCACHE";
+// Entries are named KEY.agscache, where KEY is 16 hex digits,
+// and their temporary files are KEY.agscache.*.tmp
+static const size_t CacheKeyLen = 16;
+static const char *CacheEntryExt = ".agscache";
+static const char *CacheTempExt = ".tmp";
+static const char *CacheStatsFile = "stats.agscache";
+
+
+void CompileCacheKey::Add(const void *data, size_t len)
+{
+    const uint8_t *bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = _hash;
+    uint64_t check = _check;
+    for (size_t i = 0; i < len; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+        // the check hash uses a different multiplier and mixing,
+        // so that its collisions are not correlated with the main hash
+        check = ((check << 7) | (check >> 57)) ^ bytes[i];
+        check *= 0xC2B2AE3D27D4EB4Full;
+    }
+    _hash = hash;
+    _check = check;
+}
+
+void CompileCacheKey::Add(const char *str)
+{
+    Add(str, strlen(str) + 1);
+}
+
+void CompileCacheKey::Add(int value)
+{
+    const uint8_t bytes[4] = { static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8),
+        static_cast<uint8_t>(value >> 16), static_cast<uint8_t>(value >> 24) };
+    Add(bytes, sizeof(bytes));
+}
+
+void CompileCacheKey::AddOptions(const CompilerOptions &comp_opts)
+{
+    Add(CacheFormatVersion);
+    // the entries made by a different compiler build must not be reused
+    std::string opts = "compiler: " SCOM_VERSIONSTR ", engine: " ACI_VERSION_STR " " SPECIAL_VERSION "\n";
+    opts += "version: " + comp_opts.Version + "\n";
+    opts += "api: " + comp_opts.ScriptAPI.ScriptAPIVersion + ", compat: " + comp_opts.ScriptAPI.ScriptCompatLevel + "\n";
+    const bool flags[] = {
+        comp_opts.DebugMode,
+        comp_opts.Flags.ExportAll,
+        comp_opts.Flags.LineNumbers,
+        comp_opts.Flags.AutoImport,
+        comp_opts.Flags.DebugRun,
+        comp_opts.Flags.NoImportOverride,
+        comp_opts.Flags.EnforceObjectBasedScript,
+        comp_opts.Flags.LeftToRightPrecedence,
+        comp_opts.Flags.EnforceNewStrings,
+        comp_opts.Flags.EnforceNewAudio,
+        comp_opts.Flags.UseOldCustomDialogOptionsAPI
+    };
+    opts += "flags: ";
+    for (bool flag : flags)
+        opts += flag ? '1' : '0';
+    opts += "\n";
+    for (const auto &macro : comp_opts.Macros)
+        opts += "macro: " + macro.first + "=" + macro.second + "\n";
+    _options = opts;
+    Add(static_cast<int>(comp_opts.Macros.size()));
+    Add(_options);
+}
+
+
+CompileCache::CompileCache(const std::string &dir)
+    : _dir(dir)
+{
+}
+
+bool CompileCache::Init()
+{
+    if (Directory::CreateDirectory(_dir.c_str()))
+        return true;
+    fprintf(stderr, "Error: failed to create cache directory: %s\n", _dir.c_str());
+    return false;
+}
+
+std::string CompileCache::GetEntryPath(uint64_t key) const
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016" PRIx64 "%s", key, CacheEntryExt);
+    return Path::ConcatPaths(_dir.c_str(), name).GetCStr();
+}
+
+std::unique_ptr<ccScript> CompileCache::Load(const CompileCacheKey &key) const
+{
+    std::unique_ptr<Stream> in(File::OpenFileRead(GetEntryPath(key.Get()).c_str()));
+    if (!in)
+        return nullptr;
+    // Test that the entry was made for this exact key, and not for another one
+    // with the same hash; otherwise treat this as a miss, and let it be replaced
+    char sig[16]{};
+    in->Read(sig, strlen(CacheEntrySig));
+    if ((strcmp(sig, CacheEntrySig) != 0) || (in->ReadInt32() != CacheFormatVersion))
+        return nullptr;
+    const uint64_t hash = static_cast<uint64_t>(in->ReadInt64());
+    const uint64_t check = static_cast<uint64_t>(in->ReadInt64());
+    const String options = StrUtil::ReadString(in.get());
+    if ((hash != key.Get()) || (check != key.GetCheck()) || (options != key.GetOptions().c_str()))
+        return nullptr;
+    return std::unique_ptr<ccScript>(ccScript::CreateFromStream(in.get()));
+}
+
+bool CompileCache::Store(const CompileCacheKey &key, ccScript *script) const
+{
+    // Write under a unique temporary name first, so that no one could read
+    // an incomplete entry; the temp name must not clash with the other threads
+    // or processes which may be storing the same entry right now
+    const std::string path = GetEntryPath(key.Get());
+    const uint64_t stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+    const uint64_t thread_id = std::hash<std::thread::id>()(std::this_thread::get_id());
+    char suffix[48];
+    snprintf(suffix, sizeof(suffix), ".%" PRIx64 ".%" PRIx64 "%s", thread_id, stamp, CacheTempExt);
+    const std::string temp_path = path + suffix;
+    {
+        std::unique_ptr<Stream> out(File::CreateFile(temp_path.c_str()));
+        if (!out || !out->CanWrite())
+            return false;
+        out->Write(CacheEntrySig, strlen(CacheEntrySig));
+        out->WriteInt32(CacheFormatVersion);
+        out->WriteInt64(static_cast<int64_t>(key.Get()));
+        out->WriteInt64(static_cast<int64_t>(key.GetCheck()));
+        StrUtil::WriteString(key.GetOptions().c_str(), out.get());
+        script->Write(out.get());
+    }
+
+    if (File::RenameFile(temp_path.c_str(), path.c_str()))
+        return true;
+    // may fail if the same entry was stored by someone else meanwhile
+    File::DeleteFile(temp_path.c_str());
+    return File::IsFile(path.c_str());
+}
+
+// Tells if the name begins with the 16 hex digits key and the entry's extension
+static bool IsEntryNamePrefix(const String &name)
+{
+    if (name.GetLength() < CacheKeyLen + strlen(CacheEntryExt))
+        return false;
+    for (size_t i = 0; i < CacheKeyLen; ++i)
+    {
+        if (!isxdigit(static_cast<unsigned char>(name[i])))
+            return false;
+    }
+    return strncmp(name.GetCStr() + CacheKeyLen, CacheEntryExt, strlen(CacheEntryExt)) == 0;
+}
+
+void CompileCache::GetCacheFiles(std::vector<std::string> &entries, std::vector<std::string> &temp_files) const
+{
+    std::vector<FileEntry> files;
+    Directory::GetFiles(_dir.c_str(), files, String::FromFormat("*%s*", CacheEntryExt));
+    for (const auto &file : files)
+    {
+        if (!IsEntryNamePrefix(file.Name))
+            continue;
+        if (file.Name.GetLength() == CacheKeyLen + strlen(CacheEntryExt))
+            entries.push_back(file.Name.GetCStr());
+        else if ((file.Name[CacheKeyLen + strlen(CacheEntryExt)] == '.') && file.Name.EndsWith(CacheTempExt))
+            temp_files.push_back(file.Name.GetCStr());
+    }
+}
+
+CompileCache::Stats CompileCache::ReadStats() const
+{
+    Stats stats;
+    std::unique_ptr<Stream> in(File::OpenFileRead(Path::ConcatPaths(_dir.c_str(), CacheStatsFile)));
+    if (in)
+    {
+        stats.Hits = in->ReadInt32();
+        stats.Misses = in->ReadInt32();
+    }
+    return stats;
+}
+
+void CompileCache::AddStats(uint32_t hits, uint32_t misses) const
+{
+    // NOTE: this is not synchronized with the other processes,
+    // so the statistics may be off if they are updated at the same time
+    Stats stats = ReadStats();
+    stats.Hits += hits;
+    stats.Misses += misses;
+    std::unique_ptr<Stream> out(File::CreateFile(Path::ConcatPaths(_dir.c_str(), CacheStatsFile)));
+    if (out)
+    {
+        out->WriteInt32(stats.Hits);
+        out->WriteInt32(stats.Misses);
+    }
+}
+
+void CompileCache::PrintStats() const
+{
+    std::vector<std::string> entries, temp_files;
+    GetCacheFiles(entries, temp_files);
+    uint64_t total_size = 0u;
+    for (const auto &entry : entries)
+    {
+        const soff_t size = File::GetFileSize(Path::ConcatPaths(_dir.c_str(), entry.c_str()));
+        if (size > 0)
+            total_size += size;
+    }
+
+    const Stats stats = ReadStats();
+    const uint32_t lookups = stats.Hits + stats.Misses;
+    printf("Cache directory: %s\n", _dir.c_str());
+    printf("Cached scripts: %zu, total size: %" PRIu64 " bytes\n", entries.size(), total_size);
+    printf("Hits: %u, misses: %u, hit rate: %.1f%%\n", stats.Hits, stats.Misses,
+        lookups > 0 ? 100.0 * stats.Hits / lookups : 0.0);
+}
+
+size_t CompileCache::Clean() const
+{
+    size_t removed = 0u;
+    std::vector<std::string> entries, temp_files;
+    GetCacheFiles(entries, temp_files);
+    for (const auto &entry : entries)
+    {
+        if (File::DeleteFile(Path::ConcatPaths(_dir.c_str(), entry.c_str())))
+            removed++;
+    }
+    for (const auto &temp_file : temp_files)
+        File::DeleteFile(Path::ConcatPaths(_dir.c_str(), temp_file.c_str()));
+    File::DeleteFile(Path::ConcatPaths(_dir.c_str(), CacheStatsFile));
+    return removed;
+}
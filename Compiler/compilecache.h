@@ -0,0 +1,111 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// CompileCache keeps compiled scripts on disk, and lets reuse them when
+// a script is compiled again with the same inputs.
+//
+// Each cached script is stored in its own file, named after the key. The key
+// is a hash of everything that may affect the compilation result: the
+// compiler's version, the preprocessed script text and name, the preprocessed
+// headers, the macros and the compiler options. Since every header is a part
+// of every script's key, a change in any header invalidates all the scripts;
+// but the key is made of the preprocessed texts, so changes which do not
+// affect them (such as comments) do not invalidate anything.
+//
+// Each entry also has a header, which holds a second hash of the same data,
+// computed by a different function, and the description of the compiler's
+// version and options; an entry is only used if all of them match. This makes
+// a wrong cache hit very unlikely, but not impossible, as neither of the hashes
+// is cryptographic, and the full input is not stored.
+//
+// The entries are written to a temporary file first, and then renamed,
+// so that the cache may be shared by several compiler processes.
+// The cache only ever touches the files of its own naming pattern, so that
+// it would not delete anything else if pointed to a non-empty directory.
+//
+//=============================================================================
+#ifndef __AGS_CC_COMPILECACHE_H
+#define __AGS_CC_COMPILECACHE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "script/cc_script.h"
+
+class CompilerOptions;
+
+// Calculates the cache key, using the 64-bit FNV-1a hash,
+// and a second, independent hash for checking the entries
+class CompileCacheKey
+{
+public:
+    void Add(const void *data, size_t len);
+    // Adds a string, including its terminator, which separates it from the next field
+    void Add(const char *str);
+    void Add(const std::string &str) { Add(str.c_str(), str.size() + 1); }
+    void Add(int value);
+    // Adds the compiler's version, and all the compiler options
+    // which affect the compilation
+    void AddOptions(const CompilerOptions &comp_opts);
+    // Gets the hash which the entry is named after
+    uint64_t Get() const { return _hash; }
+    // Gets the second hash of the same data
+    uint64_t GetCheck() const { return _check; }
+    // Gets the description of the compiler's version and options, see AddOptions
+    const std::string &GetOptions() const { return _options; }
+
+private:
+    uint64_t _hash = 14695981039346656037ull;
+    uint64_t _check = 0x9E3779B97F4A7C15ull;
+    std::string _options;
+};
+
+class CompileCache
+{
+public:
+    // Lifetime cache statistics, stored along with the entries
+    struct Stats
+    {
+        uint32_t Hits = 0u;
+        uint32_t Misses = 0u;
+    };
+
+    explicit CompileCache(const std::string &dir);
+
+    // Creates the cache directory, if it does not exist yet
+    bool Init();
+    // Loads the script stored under the given key; returns null if there's none,
+    // or if the stored entry was made for a different key with the same hash
+    std::unique_ptr<ccScript> Load(const CompileCacheKey &key) const;
+    // Stores the compiled script under the given key
+    bool Store(const CompileCacheKey &key, ccScript *script) const;
+    // Adds the results of the current compilation to the lifetime statistics
+    void AddStats(uint32_t hits, uint32_t misses) const;
+    // Prints the number and size of the stored entries, and the lifetime statistics
+    void PrintStats() const;
+    // Removes all the entries, and resets the statistics;
+    // returns the number of removed entries
+    size_t Clean() const;
+
+private:
+    std::string GetEntryPath(uint64_t key) const;
+    // Gets the names of the cache's files in the cache directory
+    void GetCacheFiles(std::vector<std::string> &entries, std::vector<std::string> &temp_files) const;
+    Stats ReadStats() const;
+
+    const std::string _dir;
+};
+
+#endif // __AGS_CC_COMPILECACHE_H
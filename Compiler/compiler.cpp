@@ -11,10 +11,15 @@
 // https://opensource.org/license/artistic-2-0/
 //
 //=============================================================================
-#include <utility>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <memory>
+#include <thread>
+#include <utility>
 
 #include "compiler.h"
+#include "compilecache.h"
 #include "script/cs_compiler.h"
 #include "script/cc_common.h"
 #include "script/cc_internal.h"
@@ -65,8 +70,17 @@ std::vector<const char *> GetScriptAPIs()
 
 void CompilerOptions::PrintToStdout() const {
     printf("\n--- Compiler Settings ---\n");
-    printf("Input: %s\n", InputScriptFile.c_str());
-    printf("Output: %s\n", OutputObjFile.c_str());
+    if (InputScriptFiles.empty())
+    {
+        printf("Input: %s\n", InputScriptFile.c_str());
+        printf("Output: %s\n", OutputObjFile.c_str());
+    }
+    else
+    {
+        printf("Inputs: %zu scripts\n", InputScriptFiles.size());
+        if (Jobs > 0)
+            printf("Jobs: %d\n", Jobs);
+    }
     printf("Headers:");
     bool comma = false;
     for (const auto& header : HeaderFiles)
@@ -99,13 +113,13 @@ void CompilerOptions::PrintToStdout() const {
     if (Flags.EnforceNewAudio) printf("EnforceNewAudio; ");
     if (Flags.UseOldCustomDialogOptionsAPI) printf("UseOldCustomDialogOptionsAPI; ");
     if(DebugMode) printf("\nDebugMode\n");
+    if(!CacheDir.empty()) printf("\nCache: %s\n", CacheDir.c_str());
 }
 
 
-int Compile(const CompilerOptions& comp_opts)
+// Defines the predefined and the custom macros
+static void ConfigurePreprocessor(AGS::Preprocessor::Preprocessor &pp, const CompilerOptions &comp_opts)
 {
-    comp_opts.PrintToStdout();
-    AGS::Preprocessor::Preprocessor pp = AGS::Preprocessor::Preprocessor();
     std::vector<std::string> scriptAPIVersionMacros;
     std::vector<std::string> scriptCompatLevelMacros;
 
@@ -115,9 +129,6 @@ int Compile(const CompilerOptions& comp_opts)
         scriptCompatLevelMacros.emplace_back(std::string(PREFIX_SCRIPT_COMPAT) + ScriptAPIs[i]);
     }
 
-    //-----------------------------------------------------------------------//
-    // Configure macros
-    //-----------------------------------------------------------------------//
     pp.DefineMacro("AGS_NEW_STRINGS", "1");
     pp.DefineMacro("AGS_SUPPORTS_IFVER", "1");
 
@@ -167,10 +178,11 @@ int Compile(const CompilerOptions& comp_opts)
     {
         pp.DefineMacro(macro.first.c_str(), macro.second.c_str());
     }
+}
 
-    //-----------------------------------------------------------------------//
-    // Configure compiler
-    //-----------------------------------------------------------------------//
+// Sets the compiler options
+static void ConfigureCompiler(const CompilerOptions &comp_opts)
+{
     ccSetSoftwareVersion(comp_opts.Version.c_str());
 
     ccSetOption(SCOPT_EXPORTALL, comp_opts.Flags.ExportAll);
@@ -180,26 +192,24 @@ int Compile(const CompilerOptions& comp_opts)
 
     ccSetOption(SCOPT_LEFTTORIGHT, comp_opts.Flags.LeftToRightPrecedence);
     ccSetOption(SCOPT_OLDSTRINGS, !comp_opts.Flags.EnforceNewStrings);
+}
 
-    ccRemoveDefaultHeaders();
-
-    //-----------------------------------------------------------------------//
-    // Read input files
-    //-----------------------------------------------------------------------//
-    std::vector<std::pair<String, String>> heads;
+// Reads all the header files, as pairs of text and header name
+static bool ReadHeaders(const CompilerOptions &comp_opts, std::vector<std::pair<String, String>> &heads)
+{
     for(const auto& header: comp_opts.HeaderFiles)
     {
         if (header.empty())
         {
             std::cerr << "Error: empty header filename. Do you have a trailing `:` or `;`? "<< std::endl;
-            return -1;
+            return false;
         }
 
         std::unique_ptr<Stream> in (File::OpenFileRead(header.c_str()));
         if (!in)
         {
             std::cerr << "Error: failed to open header for reading: " << header << std::endl;
-            return -1;
+            return false;
         }
 
         String headername = Path::GetFilename(header.c_str());
@@ -208,30 +218,36 @@ int Compile(const CompilerOptions& comp_opts)
         TextStreamReader sr(std::move(in));
         heads.emplace_back(sr.ReadAll(), headername);
     }
+    return true;
+}
 
-    String script_input;
-    const char* src = nullptr;
-
-    if (comp_opts.InputScriptFile.empty())
+static bool ReadScript(const std::string &filename, String &script_input)
+{
+    if (filename.empty())
     {
         std::cerr << "Error: empty script filename." << std::endl;
-        return -1;
+        return false;
     }
 
-    src = comp_opts.InputScriptFile.c_str();
+    const char *src = filename.c_str();
     std::unique_ptr<Stream> in (File::OpenFileRead(src));
     if (!in)
     {
         std::cerr << "Error: failed to open script for reading: " << src << std::endl;
-        return -1;
+        return false;
     }
     TextStreamReader sr(std::move(in));
     script_input = sr.ReadAll();
+    return true;
+}
 
-    //-----------------------------------------------------------------------//
-    // Preprocess headers and set them for use when compiling
-    //-----------------------------------------------------------------------//
-    std::vector<std::pair<String, String>> preprocessed_heads;
+// Preprocesses headers and sets them for use when compiling;
+// the preprocessed texts are kept in the given list, as compiler only stores pointers to them
+static void PreprocessHeaders(AGS::Preprocessor::Preprocessor &pp, const std::vector<std::pair<String, String>> &heads,
+    std::vector<std::pair<String, String>> &preprocessed_heads)
+{
+    ccRemoveDefaultHeaders();
+    preprocessed_heads.reserve(heads.size());
     for(const auto& head: heads)
     {
         String preprocessed_header = pp.Preprocess(head.first,head.second);
@@ -239,6 +255,103 @@ int Compile(const CompilerOptions& comp_opts)
 
         ccAddDefaultHeader((char *) preprocessed_heads.back().first.GetCStr(), (char *) preprocessed_heads.back().second.GetCStr());
     }
+}
+
+static bool PreprocessScript(AGS::Preprocessor::Preprocessor &pp, const String &script_input, const String &script_name, String &script_pp)
+{
+    script_pp = pp.Preprocess(script_input,script_name);
+    if ((script_pp == nullptr) || (cc_has_error()))
+    {
+        const auto &error = cc_get_error();
+        std::cerr << "Error: preprocessor failed at " << script_name.GetCStr() <<
+            ", line " << error.Line << " : " << error.ErrorString.GetCStr() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool WritePreprocessed(const String &script_pp, const std::string &filename)
+{
+    std::unique_ptr<Stream> out (File::CreateFile(filename.c_str()));
+    if (!out || !(out->CanWrite())) {
+        std::cerr << "Error: failed to open for writing: " << filename << std::endl;
+        return false;
+    }
+    script_pp.Write(out.get());
+    return true;
+}
+
+// Writes the compiled script; returns an error message on failure
+static std::string WriteScript(ccScript *script, const std::string &filename)
+{
+    std::unique_ptr<Stream> out (File::CreateFile(filename.c_str()));
+    if (!out || !(out->CanWrite())) {
+        return "Error: failed to open for writing: " + filename;
+    }
+    script->Write(out.get());
+    return std::string();
+}
+
+// Makes an error message from the last compilation error
+static std::string GetCompileError()
+{
+    const auto &error = cc_get_error();
+    return "Error: compile failed at " + ccCurScriptName + ", line " + std::to_string(error.Line) +
+        " : " + error.ErrorString.GetCStr();
+}
+
+// Makes the cache key common for all scripts compiled with these options and headers
+static CompileCacheKey MakeBaseCacheKey(const CompilerOptions &comp_opts,
+    const std::vector<std::pair<String, String>> &preprocessed_heads)
+{
+    CompileCacheKey key;
+    key.AddOptions(comp_opts);
+    key.Add(static_cast<int>(preprocessed_heads.size()));
+    for (const auto &head : preprocessed_heads)
+    {
+        key.Add(head.second.GetCStr());
+        key.Add(head.first.GetCStr());
+    }
+    return key;
+}
+
+static CompileCacheKey MakeScriptCacheKey(const CompileCacheKey &base_key, const String &script_name, const String &script_pp)
+{
+    CompileCacheKey key = base_key;
+    key.Add(script_name.GetCStr());
+    key.Add(script_pp.GetCStr());
+    return key;
+}
+
+static void PrintCacheResults(const CompileCache &cache, uint32_t hits, uint32_t misses)
+{
+    printf("\nCache: %u hit(s), %u miss(es)\n", hits, misses);
+    cache.AddStats(hits, misses);
+}
+
+// Compiles a single script
+static int CompileScript(const CompilerOptions& comp_opts, const CompileCache *cache)
+{
+    AGS::Preprocessor::Preprocessor pp = AGS::Preprocessor::Preprocessor();
+    ConfigurePreprocessor(pp, comp_opts);
+    ConfigureCompiler(comp_opts);
+
+    //-----------------------------------------------------------------------//
+    // Read input files
+    //-----------------------------------------------------------------------//
+    std::vector<std::pair<String, String>> heads;
+    if (!ReadHeaders(comp_opts, heads))
+        return -1;
+
+    String script_input;
+    if (!ReadScript(comp_opts.InputScriptFile, script_input))
+        return -1;
+
+    //-----------------------------------------------------------------------//
+    // Preprocess headers and set them for use when compiling
+    //-----------------------------------------------------------------------//
+    std::vector<std::pair<String, String>> preprocessed_heads;
+    PreprocessHeaders(pp, heads, preprocessed_heads);
     heads.clear();
 
     //-----------------------------------------------------------------------//
@@ -248,35 +361,36 @@ int Compile(const CompilerOptions& comp_opts)
     String filename = Path::GetFilename(comp_opts.InputScriptFile.c_str());
     String script_name = Path::RemoveExtension(filename);
 
-    script_pp = pp.Preprocess(script_input,script_name);
-    if ((script_pp == nullptr) || (cc_has_error()))
-    {
-        const auto &error = cc_get_error();
-        std::cerr << "Error: preprocessor failed at " << script_name.GetCStr() <<
-            ", line " << error.Line << " : " << error.ErrorString.GetCStr() << std::endl;
+    if (!PreprocessScript(pp, script_input, script_name, script_pp))
         return -1;
-    }
 
     if(comp_opts.PreprocessOnly)
     {
-        std::unique_ptr<Stream> out (File::CreateFile(comp_opts.OutputObjFile.c_str()));
-        if (!out || !(out->CanWrite())) {
-            std::cerr << "Error: failed to open for writing: " << comp_opts.OutputObjFile << std::endl;
-            return -1;
-        }
-        script_pp.Write(out.get());
-        return 0;
+        return WritePreprocessed(script_pp, comp_opts.OutputObjFile) ? 0 : -1;
     }
 
     //-----------------------------------------------------------------------//
-    // Compile script
+    // Compile script, or get the one compiled earlier from the cache
     //-----------------------------------------------------------------------//
-    ccScript* script = ccCompileText(script_pp.GetCStr(), script_name.GetCStr());
-    if ((script == nullptr) || (cc_has_error()))
+    CompileCacheKey cache_key;
+    std::unique_ptr<ccScript> script;
+    if (cache)
     {
-        const auto &error = cc_get_error();
-        std::cerr << "Error: compile failed at " << ccCurScriptName << ", line " << error.Line << " : " << error.ErrorString.GetCStr() << std::endl;
-        return -1;
+        cache_key = MakeScriptCacheKey(MakeBaseCacheKey(comp_opts, preprocessed_heads), script_name, script_pp);
+        script = cache->Load(cache_key);
+        PrintCacheResults(*cache, script ? 1u : 0u, script ? 0u : 1u);
+    }
+
+    if (!script)
+    {
+        script.reset(ccCompileText(script_pp.GetCStr(), script_name.GetCStr()));
+        if ((script == nullptr) || (cc_has_error()))
+        {
+            std::cerr << GetCompileError() << std::endl;
+            return -1;
+        }
+        if (cache && !cache->Store(cache_key, script.get()))
+            std::cerr << "Warning: failed to store script in the cache" << std::endl;
     }
 
     //-----------------------------------------------------------------------//
@@ -284,13 +398,198 @@ int Compile(const CompilerOptions& comp_opts)
     //-----------------------------------------------------------------------//
     if(!comp_opts.OutputObjFile.empty())
     {
-        std::unique_ptr<Stream> out (File::CreateFile(comp_opts.OutputObjFile.c_str()));
-        if (!out || !(out->CanWrite())) {
-            std::cerr << "Error: failed to open for writing: " << comp_opts.OutputObjFile << std::endl;
+        std::string err = WriteScript(script.get(), comp_opts.OutputObjFile);
+        if (!err.empty())
+        {
+            std::cerr << err << std::endl;
             return -1;
         }
-        script->Write(out.get());
     }
 
     return 0;
-}
\ No newline at end of file
+}
+
+// A script compiled in the batch mode
+struct BatchScript
+{
+    std::string OutputFile;
+    std::string ScriptName;
+    std::string Source; // preprocessed script
+    CompileCacheKey CacheKey;
+    std::string Error; // error message, if compilation failed
+    std::string Warning;
+};
+
+// Compiles the batch script, using the previously compiled headers
+static void CompileBatchScript(const ccCompiledHeaders &headers, const CompileCache *cache, BatchScript &job)
+{
+    std::unique_ptr<ccScript> script(ccCompileText(headers, job.Source.c_str(), job.ScriptName.c_str()));
+    if (!script || cc_has_error())
+    {
+        job.Error = GetCompileError();
+        return;
+    }
+    job.Error = WriteScript(script.get(), job.OutputFile);
+    if (job.Error.empty() && cache && !cache->Store(job.CacheKey, script.get()))
+        job.Warning = "Warning: failed to store script in the cache: " + job.ScriptName;
+}
+
+// Compiles many scripts with the same headers and options. The headers are
+// preprocessed and compiled only once, and then the scripts are compiled
+// in parallel, each starting with a copy of the compiled headers' state.
+// The resulting objects are same as if compiling each script separately.
+static int CompileBatch(const CompilerOptions& comp_opts, const CompileCache *cache)
+{
+    AGS::Preprocessor::Preprocessor pp = AGS::Preprocessor::Preprocessor();
+    ConfigurePreprocessor(pp, comp_opts);
+    ConfigureCompiler(comp_opts);
+
+    std::vector<std::pair<String, String>> heads;
+    if (!ReadHeaders(comp_opts, heads))
+        return -1;
+    std::vector<std::pair<String, String>> preprocessed_heads;
+    PreprocessHeaders(pp, heads, preprocessed_heads);
+    heads.clear();
+
+    //-----------------------------------------------------------------------//
+    // Preprocess all scripts; this is done on this thread, because
+    // the preprocessor's strings may not be shared between threads
+    //-----------------------------------------------------------------------//
+    int result = 0;
+    std::vector<BatchScript> jobs;
+    const CompileCacheKey base_cache_key = MakeBaseCacheKey(comp_opts, preprocessed_heads);
+    uint32_t cache_hits = 0u;
+    for (const auto &input : comp_opts.InputScriptFiles)
+    {
+        String script_input;
+        if (!ReadScript(input, script_input))
+        {
+            result = -1;
+            continue;
+        }
+
+        String script_name = Path::RemoveExtension(Path::GetFilename(input.c_str()));
+        std::string output_file = std::string(Path::RemoveExtension(input.c_str()).GetCStr()) + ".o";
+        // each script starts with the macros defined by the headers
+        AGS::Preprocessor::Preprocessor script_pp = pp;
+        String script_text;
+        cc_clear_error();
+        if (!PreprocessScript(script_pp, script_input, script_name, script_text))
+        {
+            result = -1;
+            continue;
+        }
+
+        if (comp_opts.PreprocessOnly)
+        {
+            if (!WritePreprocessed(script_text, output_file))
+                result = -1;
+            continue;
+        }
+
+        CompileCacheKey cache_key;
+        if (cache)
+        {
+            cache_key = MakeScriptCacheKey(base_cache_key, script_name, script_text);
+            std::unique_ptr<ccScript> script = cache->Load(cache_key);
+            if (script)
+            {
+                cache_hits++;
+                std::string err = WriteScript(script.get(), output_file);
+                if (!err.empty())
+                {
+                    std::cerr << err << std::endl;
+                    result = -1;
+                }
+                continue;
+            }
+        }
+
+        BatchScript job;
+        job.OutputFile = output_file;
+        job.ScriptName = script_name.GetCStr();
+        job.Source = script_text.GetCStr();
+        job.CacheKey = cache_key;
+        jobs.push_back(std::move(job));
+    }
+
+    if (cache && !comp_opts.PreprocessOnly)
+        PrintCacheResults(*cache, cache_hits, static_cast<uint32_t>(jobs.size()));
+    if (jobs.empty())
+        return result;
+
+    //-----------------------------------------------------------------------//
+    // Compile headers once, and then all the scripts
+    //-----------------------------------------------------------------------//
+    std::shared_ptr<ccCompiledHeaders> headers = ccCompileDefaultHeaders();
+    if (!headers)
+    {
+        std::cerr << GetCompileError() << std::endl;
+        return -1;
+    }
+
+#if defined(AGS_CC_THREADLOCAL_STATE)
+    size_t thread_count = comp_opts.Jobs > 0 ? comp_opts.Jobs : std::thread::hardware_concurrency();
+    thread_count = std::max<size_t>(1u, std::min(thread_count, jobs.size()));
+#else
+    // the compiler state is shared, so the scripts may only be compiled one by one
+    const size_t thread_count = 1u;
+#endif
+    std::atomic<size_t> next_job(0u);
+    auto compile_jobs = [&]()
+    {
+        for (size_t i = next_job++; i < jobs.size(); i = next_job++)
+            CompileBatchScript(*headers, cache, jobs[i]);
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < thread_count; ++i)
+        threads.emplace_back(compile_jobs);
+    compile_jobs();
+    for (auto &thread : threads)
+        thread.join();
+
+    for (const auto &job : jobs)
+    {
+        if (!job.Warning.empty())
+            std::cerr << job.Warning << std::endl;
+        if (!job.Error.empty())
+        {
+            std::cerr << job.Error << std::endl;
+            result = -1;
+        }
+    }
+    printf("\nCompiled %zu script(s) using %zu thread(s)\n", jobs.size(), thread_count);
+    return result;
+}
+
+int Compile(const CompilerOptions& comp_opts)
+{
+    comp_opts.PrintToStdout();
+
+    std::unique_ptr<CompileCache> cache;
+    if (!comp_opts.CacheDir.empty())
+    {
+        cache.reset(new CompileCache(comp_opts.CacheDir));
+        if (comp_opts.CacheClean)
+            printf("\nRemoved %zu cached script(s)\n", cache->Clean());
+    }
+
+    int result = 0;
+    const bool has_input = !comp_opts.InputScriptFiles.empty() || !comp_opts.InputScriptFile.empty();
+    if (has_input)
+    {
+        if (cache && !comp_opts.PreprocessOnly && !cache->Init())
+            return -1;
+        if (!comp_opts.InputScriptFiles.empty())
+            result = CompileBatch(comp_opts, cache.get());
+        else
+            result = CompileScript(comp_opts, cache.get());
+    }
+
+    if (cache && comp_opts.CacheStats)
+    {
+        printf("\n");
+        cache->PrintStats();
+    }
+    return result;
+}
@@ -54,6 +54,12 @@ public:
     std::vector<std::string> HeaderFiles{};
     std::string InputScriptFile{};
     std::string OutputObjFile{};
+    // batch mode: several input scripts, each is compiled into INPUT.o
+    std::vector<std::string> InputScriptFiles{};
+    int Jobs = 0; // number of scripts compiled in parallel, 0 = number of CPU cores
+    std::string CacheDir{}; // directory of the compiled scripts cache, none if empty
+    bool CacheStats = false; // print cache statistics
+    bool CacheClean = false; // remove all the cached scripts
     std::string Version{};
     CompilerOptions() = default;
     ~CompilerOptions() = default;
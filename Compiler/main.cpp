@@ -18,13 +18,14 @@
 #include <map>
 #include "util/path.h"
 #include "util/cmdlineopts.h"
+#include "util/string_utils.h"
 #include "compiler.h"
 #include "core/def_version.h"
 
 using namespace AGS::Common;
 using namespace AGS::Common::CmdLineOpts;
 
-const char *HELP_STRING = R"EOS(Usage: agscc [options] <INPUT.asc>
+const char *HELP_STRING = R"EOS(Usage: agscc [options] <INPUT.asc> [<INPUT2.asc>...]
 -A <version>                 Script API Version               (default:Highest)
 -C <version>                 Script API Compatibility version (default:Highest)
 -H, --Headers <H1>[:<H2>...] Header Files in order  (; as separator in cmd.exe)
@@ -42,9 +43,17 @@ const char *HELP_STRING = R"EOS(Usage: agscc [options] <INPUT.asc>
 -fforcenewaudio[=0]          Enforce new audio system               (default:1)
 -foldcustomdialogopt[=0]     Use old custom dialog API
 -g                           Generate debug information
+-j <N>                       Compile up to N scripts in parallel    (default:CPU cores)
 --tell-api-versions          Returns supported Script API Versions
 -o <OUT.o>, --output <OUT.o> Place output in specified file.  (default:INPUT.o)
+                             Not allowed when there are several inputs:
+                             the headers are then compiled only once, and
+                             each INPUT.asc is compiled into INPUT.o
 --override-version <VERSION> Overrides editor version
+--cache-dir <DIR>            Keep compiled scripts in DIR, and reuse them if
+                             the script, headers and options did not change
+--cache-stats                Print cache statistics      (requires --cache-dir)
+--cache-clean                Remove all cached scripts   (requires --cache-dir)
 -h, --help                   Print this usage message
 )EOS";
 
@@ -92,7 +101,11 @@ ParsedOptions parser_to_compiler_opts(const ParseResult& parseResult)
         return ParsedOptions(0); // display help and bail out
     }
 
-    if(parseResult.PosArgs.size() < 1) {
+    compilerOptions.CacheStats = parseResult.Opt.count("--cache-stats");
+    compilerOptions.CacheClean = parseResult.Opt.count("--cache-clean");
+    const bool cache_command = compilerOptions.CacheStats || compilerOptions.CacheClean;
+
+    if(parseResult.PosArgs.size() < 1 && !cache_command) {
         std::cerr << "Error: not enough arguments" << std::endl;
         printf("%s", HELP_STRING);
         return ParsedOptions(-1);
@@ -173,12 +186,28 @@ ParsedOptions parser_to_compiler_opts(const ParseResult& parseResult)
             continue;
         }
 
+        if(opt_with_value.first == "-j")
+        {
+            compilerOptions.Jobs = StrUtil::StringToInt(opt_with_value.second, 0);
+            if(compilerOptions.Jobs <= 0) {
+                std::cerr << "Error: invalid number of jobs " << opt_with_value.second.GetCStr() << std::endl;
+                return ParsedOptions(-1);
+            }
+            continue;
+        }
+
         if(opt_with_value.first == "--override-version")
         {
             compilerOptions.Version = opt_with_value.second.GetCStr();
             continue;
         }
 
+        if(opt_with_value.first == "--cache-dir")
+        {
+            compilerOptions.CacheDir = opt_with_value.second.GetCStr();
+            continue;
+        }
+
         if(opt_with_value.first == "-f") // compiler flag
         {
             std::string flag_str = opt_with_value.second.GetCStr();
@@ -240,12 +269,28 @@ ParsedOptions parser_to_compiler_opts(const ParseResult& parseResult)
         }
     }
 
-    compilerOptions.InputScriptFile = parseResult.PosArgs[0].GetCStr();
+    if(cache_command && compilerOptions.CacheDir.empty()) {
+        std::cerr << "Error: cache directory is not set, use --cache-dir" << std::endl;
+        return ParsedOptions(-1);
+    }
+
+    if(parseResult.PosArgs.size() > 1) {
+        // batch mode, each script is compiled into its own INPUT.o
+        if(!compilerOptions.OutputObjFile.empty()) {
+            std::cerr << "Error: output file cannot be set when compiling several scripts" << std::endl;
+            return ParsedOptions(-1);
+        }
+        for(const auto &arg : parseResult.PosArgs)
+            compilerOptions.InputScriptFiles.push_back(arg.GetCStr());
+    }
+    else if(parseResult.PosArgs.size() == 1) {
+        compilerOptions.InputScriptFile = parseResult.PosArgs[0].GetCStr();
 
-    if(compilerOptions.OutputObjFile.empty()) {
-        // no output file explicitly set, let's use input.o instead
-        std::string filename = Path::RemoveExtension(compilerOptions.InputScriptFile.c_str()).GetCStr();
-        compilerOptions.OutputObjFile = filename + ".o";
+        if(compilerOptions.OutputObjFile.empty()) {
+            // no output file explicitly set, let's use input.o instead
+            std::string filename = Path::RemoveExtension(compilerOptions.InputScriptFile.c_str()).GetCStr();
+            compilerOptions.OutputObjFile = filename + ".o";
+        }
     }
 
     if(compilerOptions.Version.empty()) {
@@ -266,7 +311,7 @@ Copyright (c) 2021 AGS Team and contributors
 )EOS"
     );
 
-    ParseResult parseResult = Parse(argc,argv,{"-D", "-H", "--Headers", "-A", "-C", "-f"});
+    ParseResult parseResult = Parse(argc,argv,{"-D", "-H", "--Headers", "-A", "-C", "-f", "-j", "-o", "--output", "--override-version", "--cache-dir"});
     ParsedOptions parsedOptions = parser_to_compiler_opts(parseResult);
 
     if(parsedOptions.Exit) return parsedOptions.ErrorCode;
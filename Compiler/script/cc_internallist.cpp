@@ -13,8 +13,7 @@
 //=============================================================================
 #include <stdlib.h>
 #include "cc_internallist.h"
-
-extern int currentline;  // in script_common
+#include "script/cc_common.h" // currentline
 
 void ccInternalList::startread() {
     pos=0;
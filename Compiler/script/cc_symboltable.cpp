@@ -27,6 +27,40 @@ symbolTable::symbolTable() {
     stringStructSym = 0;
 }
 
+symbolTable::symbolTable(const symbolTable &other)
+    : symbolTable() {
+    *this = other;
+}
+
+symbolTable &symbolTable::operator=(const symbolTable &other) {
+    if (this == &other)
+        return *this;
+
+    normalIntSym = other.normalIntSym;
+    normalStringSym = other.normalStringSym;
+    normalFloatSym = other.normalFloatSym;
+    normalVoidSym = other.normalVoidSym;
+    nullSym = other.nullSym;
+    stringStructSym = other.stringStructSym;
+    entries = other.entries;
+    localVars = other.localVars;
+
+    // the name lookups point into the arenas, so rebuild them from entries;
+    // the caches will be refilled on demand
+    nameGenCache.clear();
+    memberSymCache.clear();
+    symbolNames.clear();
+    nameArena.clear();
+    symbolTree.clear();
+    symbolNames.reserve(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const char *name = entries[i].sname.c_str();
+        const char *stored_name = symbolTree.addEntry(name, static_cast<int>(i));
+        symbolNames.push_back(stored_name ? stored_name : nameArena.add(name));
+    }
+    return *this;
+}
+
 int SymbolTableEntry::get_num_args() {
 	// TODO: assert is func?
     return sscope % 100;
@@ -63,12 +97,13 @@ int SymbolTableEntry::get_propset() {
 }
 
 void symbolTable::reset() {
-	for (std::map<int, char*>::iterator it = nameGenCache.begin(); it != nameGenCache.end(); ++it) {
-		free(it->second);
-	}
 	nameGenCache.clear();
+	memberSymCache.clear();
+	symbolNames.clear();
+	nameArena.clear();
 
 	entries.clear();
+	localVars.clear();
 
     stringStructSym = 0;
     symbolTree.clear();
@@ -206,20 +241,65 @@ std::string symbolTable::get_name_string(int idx) {
 }
 
 const char *symbolTable::get_name(int idx) {
-	if (nameGenCache.count(idx) > 0) {
-		return nameGenCache[idx];
-	}
-
 	int actualIdx = idx & STYPE_MASK;
 	if (actualIdx < 0 || (size_t)actualIdx >= entries.size()) { return NULL; }
+	if (actualIdx == idx) {
+		return symbolNames[idx];
+	}
+
+	auto it = nameGenCache.find(idx);
+	if (it != nameGenCache.end()) {
+		return it->second;
+	}
 
 	std::string resultString = get_name_string(idx);
-	char *result = (char *)malloc(resultString.length() + 1);
-	strcpy(result, resultString.c_str());
+	const char *result = nameArena.add(resultString.c_str(), resultString.length());
 	nameGenCache[idx] = result;
 	return result;
 }
 
+std::string symbolTable::get_member_name(int structSym, int memberSym) {
+    const char *memberName = get_name(memberSym);
+    // de-mangle name, if appropriate
+    if (memberName[0] == '.')
+        memberName = &memberName[1];
+    return std::string(get_name(structSym)) + "::" + memberName;
+}
+
+int symbolTable::find_member(int structSym, int memberSym) {
+    const uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(structSym)) << 32) | static_cast<uint32_t>(memberSym);
+    auto it = memberSymCache.find(key);
+    if (it != memberSymCache.end()) {
+        return it->second;
+    }
+
+    // symbols are never removed, so only the found ones are remembered
+    int idx = find(get_member_name(structSym, memberSym).c_str());
+    if (idx >= 0) {
+        memberSymCache[key] = idx;
+    }
+    return idx;
+}
+
+int symbolTable::find_or_add_member(int structSym, int memberSym) {
+    int idx = find_member(structSym, memberSym);
+    if (idx >= 0) {
+        return idx;
+    }
+
+    idx = add(get_member_name(structSym, memberSym).c_str());
+    if (idx >= 0) {
+        const uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(structSym)) << 32) | static_cast<uint32_t>(memberSym);
+        memberSymCache[key] = idx;
+    }
+    return idx;
+}
+
+void symbolTable::set_local_var(int idx) {
+    entries[idx].stype = SYM_LOCALVAR;
+    localVars.push_back(idx);
+}
+
 int symbolTable::add(const char*nta) {
     return add_ex(nta,0,0);
 }
@@ -243,7 +323,8 @@ int symbolTable::add_ex(const char*nta,int typo,char sizee) {
 	entry.funcparams = std::vector<FuncParamInfo>(MAX_FUNCTION_PARAMETERS + 1);
 	entries.push_back(entry);
 
-    symbolTree.addEntry(nta, p_value);
+    const char *stored_name = symbolTree.addEntry(nta, p_value);
+    symbolNames.push_back(stored_name ? stored_name : nameArena.add(nta));
     return p_value;
 }
 int symbolTable::find_or_add(const char *name) {
@@ -260,4 +341,4 @@ int symbolTable::add_operator(const char *nta, int priority, int vcpucmd) {
     return nss;
 }
 
-symbolTable sym;
+CC_THREAD_LOCAL symbolTable sym;
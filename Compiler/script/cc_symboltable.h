@@ -15,10 +15,11 @@
 #define __CC_SYMBOLTABLE_H
 
 #include <cstdint>
-#include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "script/cs_parser_common.h"   // macro definitions
+#include "script/cc_common.h"          // CC_THREAD_LOCAL
 #include "script/cc_treemap.h"
 #include "script/cc_symboldef.h"
 
@@ -63,13 +64,25 @@ struct symbolTable {
 
 	// properties for symbols, size is numsymbols
 	std::vector<SymbolTableEntry> entries;
+    // symbols which have been made local variables, not sorted;
+    // may also contain symbols which are not local variables anymore
+    std::vector<int> localVars;
 
     symbolTable();
+    // copies the symbols, the names are stored separately in each table
+    symbolTable(const symbolTable &other);
+    symbolTable &operator=(const symbolTable &other);
     void reset();    // clears table
     int  find(const char*);  // returns ID of symbol, or -1
     int  add_ex(const char*,int,char);  // adds new symbol of type and size
     int  add(const char*);   // adds new symbol, returns -1 if already exists
     int  find_or_add(const char*);
+    // finds the "struct::member" symbol, returns -1 if there's none
+    int  find_member(int structSym, int memberSym);
+    // finds or adds the "struct::member" symbol
+    int  find_or_add_member(int structSym, int memberSym);
+    // makes the symbol a local variable, and records it in localVars
+    void set_local_var(int idx);
 
     // TODO: why is there "friendly name" and "name", and what's the difference?
     std::string get_friendly_name(int idx);  // inclue ptr
@@ -80,16 +93,22 @@ struct symbolTable {
 
 private:
 
-    std::map<int, char *> nameGenCache;
+    // symbol names, by symbol index
+    std::vector<const char *> symbolNames;
+    // names of the symbols with type flags, by full index
+    std::unordered_map<int, const char *> nameGenCache;
+    // "struct::member" symbols, by struct and member symbols
+    std::unordered_map<uint64_t, int> memberSymCache;
+    ccStringArena nameArena;
 
     ccTreeMap symbolTree;
-    std::vector<char *> symbolTreeNames;
 
     int  add_operator(const char*, int priority, int vcpucmd); // adds new operator
     std::string get_name_string(int idx);
+    std::string get_member_name(int structSym, int memberSym);
 };
 
 
-extern symbolTable sym;
+extern CC_THREAD_LOCAL symbolTable sym;
 
 #endif //__CC_SYMBOLTABLE_H
@@ -14,24 +14,99 @@
 #include <cstring>
 #include "cc_treemap.h"
 
-int ccTreeMap::findValue(const char *key) {
-	if (!key || strlen(key) <= 0) { return -1; }
-    std::string cppkey(key);
-    if (this->storage.count(cppkey) <= 0) { return -1; }
-    return this->storage[cppkey];
+const char *ccStringArena::add(const char *str, size_t len) {
+    const size_t need = len + 1;
+    if (blockCapacity - blockUsed < need) {
+        // strings longer than the block get a block of their own
+        const size_t new_size = need > BlockSize ? need : BlockSize;
+        blocks.emplace_back(new char[new_size]);
+        blockUsed = 0u;
+        blockCapacity = new_size;
+    }
+    char *dst = blocks.back().get() + blockUsed;
+    memcpy(dst, str, len);
+    dst[len] = 0;
+    blockUsed += need;
+    return dst;
 }
 
-void ccTreeMap::addEntry(const char* ntx, int p_value) {
-    // don't add if it's an empty string or if it's already here
-    if (!ntx || strlen(ntx) <= 0) { return; }
+const char *ccStringArena::add(const char *str) {
+    return add(str, strlen(str));
+}
+
+void ccStringArena::clear() {
+    blocks.clear();
+    blockUsed = 0u;
+    blockCapacity = 0u;
+}
+
+uint32_t ccTreeMap::hashKey(const char *key, size_t len) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= static_cast<uint8_t>(key[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+size_t ccTreeMap::findSlot(const char *key, size_t len, uint32_t hash) const {
+    const size_t mask = slots.size() - 1;
+    for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+        const Slot &slot = slots[i];
+        if (!slot.key ||
+            ((slot.hash == hash) && (strncmp(slot.key, key, len) == 0) && (slot.key[len] == 0)))
+            return i;
+    }
+}
 
-    this->storage[std::string(ntx)] = p_value;
+void ccTreeMap::grow() {
+    std::vector<Slot> old_slots;
+    old_slots.swap(slots);
+    slots.resize(old_slots.empty() ? 256 : old_slots.size() * 2);
+    const size_t mask = slots.size() - 1;
+    for (const auto &slot : old_slots) {
+        if (!slot.key)
+            continue;
+        size_t i = slot.hash & mask;
+        while (slots[i].key)
+            i = (i + 1) & mask;
+        slots[i] = slot;
+    }
+}
+
+int ccTreeMap::findValue(const char *key) const {
+    if (!key || !key[0] || slots.empty()) { return -1; }
+    const size_t len = strlen(key);
+    const Slot &slot = slots[findSlot(key, len, hashKey(key, len))];
+    return slot.key ? slot.value : -1;
+}
+
+const char *ccTreeMap::addEntry(const char* ntx, int p_value) {
+    // don't add if it's an empty string
+    if (!ntx || !ntx[0]) { return nullptr; }
+
+    // keep the load factor under 3/4
+    if ((count + 1) * 4 > slots.size() * 3)
+        grow();
+    const size_t len = strlen(ntx);
+    const uint32_t hash = hashKey(ntx, len);
+    Slot &slot = slots[findSlot(ntx, len, hash)];
+    if (!slot.key) {
+        slot.key = keys.add(ntx, len);
+        slot.hash = hash;
+        count++;
+    }
+    slot.value = p_value;
+    return slot.key;
 }
 
 void ccTreeMap::clear() {
-    this->storage.clear();
+    slots.clear();
+    count = 0u;
+    keys.clear();
 }
 
 ccTreeMap::~ccTreeMap() {
-    this->storage.clear();
-}
\ No newline at end of file
+    clear();
+}
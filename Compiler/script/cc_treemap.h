@@ -18,18 +18,52 @@
 #ifndef __CC_TREEMAP_H
 #define __CC_TREEMAP_H
 
-#include <map>
-#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
 
-// Mimics original interface but uses a std::map for storage
+// Stores null-terminated strings in large blocks; the blocks are never
+// moved, so the stored strings remain valid until the arena is cleared.
+struct ccStringArena {
+    // Copies the string into the arena, returns the stored copy
+    const char *add(const char *str, size_t len);
+    const char *add(const char *str);
+    void clear();
+
+private:
+    static const size_t BlockSize = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    size_t blockUsed = 0u;
+    size_t blockCapacity = 0u;
+};
+
+// Mimics original interface but uses a hash table for storage,
+// with the keys stored in the string arena
 struct ccTreeMap {
-    int findValue(const char *key);
-    void addEntry(const char *ntx, int p_value);
+    int findValue(const char *key) const;
+    // Adds or replaces the entry; returns the stored copy of the key,
+    // or null if the key was not accepted
+    const char *addEntry(const char *ntx, int p_value);
     void clear();
     ~ccTreeMap();
 
 private:
-    std::map<std::string, int> storage;
+    struct Slot {
+        const char *key = nullptr; // null for the unused slot
+        uint32_t hash = 0u;
+        int value = -1;
+    };
+
+    static uint32_t hashKey(const char *key, size_t len);
+    // Finds the slot which has the given key, or the free slot for it
+    size_t findSlot(const char *key, size_t len, uint32_t hash) const;
+    void grow();
+
+    std::vector<Slot> slots; // open addressing, size is a power of 2
+    size_t count = 0u;
+    ccStringArena keys;
 };
 
-#endif // __CC_TREEMAP_H
\ No newline at end of file
+#endif // __CC_TREEMAP_H
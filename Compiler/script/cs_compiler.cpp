@@ -50,16 +50,13 @@ void ccSetSoftwareVersion(const char *versionNumber) {
     ccSoftwareVersion = versionNumber;
 }
 
-ccScript* ccCompileText(const char *texo, const char *scriptName) {
-    ccCompiledScript *cctemp = new ccCompiledScript();
-
-    sym.reset();
-
-    if (scriptName == NULL)
-        scriptName = "Main script";
-
-    cc_clear_error();
+struct ccCompiledHeaders {
+    ccCompiledScript script;
+    symbolTable symbols;
+};
 
+// Compiles the default headers into the given script, using the current symbol table
+static void compile_default_headers(ccCompiledScript *cctemp) {
     for (size_t t=0;t<defaultheaders.size();t++) {
         if (defaultHeaderNames[t])
             ccCurScriptName = defaultHeaderNames[t];
@@ -70,6 +67,13 @@ ccScript* ccCompileText(const char *texo, const char *scriptName) {
         cc_compile(defaultheaders[t],cctemp);
         if (cc_has_error()) break;
     }
+}
+
+// Compiles the main script after the headers, and finalizes the compiled script;
+// deletes the script and returns NULL on failure
+static ccScript *compile_main_script(ccCompiledScript *cctemp, const char *texo, const char *scriptName) {
+    if (scriptName == NULL)
+        scriptName = "Main script";
 
     if (!cc_has_error()) {
         ccCurScriptName = scriptName;
@@ -126,3 +130,32 @@ ccScript* ccCompileText(const char *texo, const char *scriptName) {
     cctemp->free_extra();
     return cctemp;
 }
+
+ccScript* ccCompileText(const char *texo, const char *scriptName) {
+    ccCompiledScript *cctemp = new ccCompiledScript();
+
+    sym.reset();
+    cc_clear_error();
+    compile_default_headers(cctemp);
+    return compile_main_script(cctemp, texo, scriptName);
+}
+
+std::shared_ptr<ccCompiledHeaders> ccCompileDefaultHeaders() {
+    std::shared_ptr<ccCompiledHeaders> headers(new ccCompiledHeaders());
+
+    sym.reset();
+    cc_clear_error();
+    compile_default_headers(&headers->script);
+    if (cc_has_error())
+        return nullptr;
+    headers->symbols = sym;
+    return headers;
+}
+
+ccScript *ccCompileText(const ccCompiledHeaders &headers, const char *texo, const char *scriptName) {
+    ccCompiledScript *cctemp = new ccCompiledScript(headers.script);
+
+    sym = headers.symbols;
+    cc_clear_error();
+    return compile_main_script(cctemp, texo, scriptName);
+}
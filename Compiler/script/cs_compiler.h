@@ -18,6 +18,7 @@
 #ifndef __CS_COMPILER_H
 #define __CS_COMPILER_H
 
+#include <memory>
 #include "script/cc_script.h"  // ccScript
 
 // ********* SCRIPT COMPILATION FUNCTIONS **************
@@ -42,6 +43,16 @@ extern void ccSetSoftwareVersion(const char *version);
 // compile the script supplied, returns NULL on failure
 extern ccScript *ccCompileText(const char *script, const char *scriptName);
 
+// the default headers compiled once, to be reused for compiling many scripts
+struct ccCompiledHeaders;
+// compile the default headers, returns NULL on failure
+extern std::shared_ptr<ccCompiledHeaders> ccCompileDefaultHeaders();
+// compile the script supplied, using the previously compiled headers
+// instead of the default ones; returns NULL on failure.
+// This may be called on several threads at once, if the compiler is built
+// with AGS_CC_THREADLOCAL_STATE, but the options must not be changed meanwhile.
+extern ccScript *ccCompileText(const ccCompiledHeaders &headers, const char *script, const char *scriptName);
+
 extern const char *ccSoftwareVersion;
 
 #endif // __CS_COMPILER_H
\ No newline at end of file
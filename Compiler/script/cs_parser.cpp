@@ -11,6 +11,7 @@
 // https://opensource.org/license/artistic-2-0/
 //
 //=============================================================================
+#include <algorithm>
 #include <cerrno>
 #include <cstdio>
 #include <cstdlib>
@@ -28,8 +29,6 @@
 #include "util/string_utils.h"
 #include "util/utf8.h"
 
-extern int currentline;
-
 char ccCopyright[]="ScriptCompiler32 v" SCOM_VERSIONSTR " (c) 2000-2007 Chris Jones and 2011-2025 others";
 
 int  evaluate_expression(ccInternalList*,ccCompiledScript*,int,bool insideBracketedDeclaration);
@@ -79,8 +78,8 @@ void clear_chunk_list(std::vector<ccChunk> *list) {
 
 static int is_part_of_symbol(char thischar, char startchar) {
     // workaround for strings
-    static int sayno_next_char = 0;
-    static int next_is_escaped = 0;
+    static CC_THREAD_LOCAL int sayno_next_char = 0;
+    static CC_THREAD_LOCAL int next_is_escaped = 0;
     if (sayno_next_char) {
         sayno_next_char = 0;
         return 0;
@@ -144,32 +143,8 @@ static int is_part_of_symbol(char thischar, char startchar) {
 
 // NOTE: global buffers meant to store parsed lines and symbols;
 // most of these were local char arrays of fixed size, refactored into global std::string for convenience
-std::string constructedMemberName;
-std::string thissymbol;
-std::string thissymbol_mangled;
-std::string constructedFunctionName;
-
-const char *get_member_full_name(int structSym, int memberSym) {
-
-    const char* memberName = sym.get_name(memberSym);
-
-    // de-mangle name, if appropriate
-    if (memberName[0] == '.')
-        memberName = &memberName[1];
-
-    const char *struct_name = sym.get_name(structSym);
-    size_t len = static_cast<size_t>(snprintf(nullptr, 0, "%s::%s", struct_name, memberName));
-    constructedMemberName.resize(len + 1);
-    snprintf(&constructedMemberName.front(), len + 1, "%s::%s", struct_name, memberName);
-    return constructedMemberName.c_str();
-}
-
-const char *get_mangled_name(const char *sname) {
-    size_t len = snprintf(nullptr, 0, ".%s", sname);
-    thissymbol_mangled.resize(len + 1);
-    snprintf(&thissymbol_mangled.front(), len + 1, ".%s", sname);
-    return thissymbol_mangled.c_str();
-}
+CC_THREAD_LOCAL std::string thissymbol;
+CC_THREAD_LOCAL std::string constructedFunctionName;
 
 const char *get_member_func_name(int structSym, int funcSym) {
     const char *struct_name = sym.get_name(structSym);
@@ -245,7 +220,7 @@ int cc_tokenize(const char*inpl, ccInternalList*targ, ccCompiledScript*scrip) {
         if (sym.entries[last_time].stype == SYM_DOT) {
             // mangle member variable accesses so that you can have a
             // struct called Room but also a member property called Room
-            thissymbol = get_mangled_name(thissymbol.c_str());
+            thissymbol.insert(0, 1, '.');
         }
 
         int towrite = sym_find_or_add(sym, thissymbol.c_str());
@@ -311,8 +286,7 @@ int cc_tokenize(const char*inpl, ccInternalList*targ, ccCompiledScript*scrip) {
                     (sym.entries[last_time].stype != SYM_OPENBRACE) &&
                     (sym.entries[last_time].stype != SYM_OPENBRACKET) &&
                     (towrite != in_struct_declr)) {
-                        const char *new_name = get_member_full_name(in_struct_declr, towrite);
-                        towrite = sym_find_or_add(sym, new_name);
+                        towrite = sym.find_or_add_member(in_struct_declr, towrite);
                         if (towrite < 0) {
                             cc_error("symbol table error - could not ensure new struct symbol.");
                             return -1;
@@ -409,41 +383,56 @@ int remove_locals(int from_level, int just_count, ccCompiledScript *scrip) {
     if (from_level == 0)
         zeroPtrCmd = SCMD_MEMZEROPTRND;
 
-    for (cc=0; (size_t)cc<sym.entries.size();cc++) {
-        if ((sym.entries[cc].sscope > from_level) && (sym.entries[cc].stype == SYM_LOCALVAR)) {
-            // caller will sort out stack, so ignore parameters
-            if ((sym.entries[cc].flags & SFLG_PARAMETER)==0) {
-                if (sym.entries[cc].flags & SFLG_DYNAMICARRAY)
-                    totalsub += 4;
-                else
-                {
-                    totalsub += sym.entries[cc].ssize;
-                    // remove all elements if array
-                    if (sym.entries[cc].flags & SFLG_ARRAY)
-                        totalsub += (sym.entries[cc].arrsize - 1) * sym.entries[cc].ssize;
-                }
-                if (sym.entries[cc].flags & SFLG_STRBUFFER)
-                    totalsub += STRING_LENGTH;
-            }
-            // release the pointer reference if applicable
-            if (sym.entries[cc].flags & SFLG_THISPTR) { }
-            else if (((sym.entries[cc].flags & SFLG_POINTER) != 0) ||
-                ((sym.entries[cc].flags & SFLG_DYNAMICARRAY) != 0))
+    // only check the symbols which were made local variables,
+    // but do this in the order of their index, as if checking all symbols
+    std::vector<int> &locals = sym.localVars;
+    std::sort(locals.begin(), locals.end());
+    locals.erase(std::unique(locals.begin(), locals.end()), locals.end());
+    size_t keep = 0;
+    for (size_t i = 0; i < locals.size(); i++) {
+        cc = locals[i];
+        if (sym.entries[cc].stype != SYM_LOCALVAR)
+            continue; // not a local variable anymore, forget it
+        if (sym.entries[cc].sscope <= from_level) {
+            locals[keep++] = cc;
+            continue;
+        }
+        // caller will sort out stack, so ignore parameters
+        if ((sym.entries[cc].flags & SFLG_PARAMETER)==0) {
+            if (sym.entries[cc].flags & SFLG_DYNAMICARRAY)
+                totalsub += 4;
+            else
             {
-                free_pointer(scrip->cur_sp - sym.entries[cc].soffs, zeroPtrCmd, cc, scrip);
-            }
-            else if (sym.entries[sym.entries[cc].vartype].flags & SFLG_STRUCTTYPE) {
-                // a struct -- free any pointers it contains
-                free_pointers_from_struct(cc, scrip);
+                totalsub += sym.entries[cc].ssize;
+                // remove all elements if array
+                if (sym.entries[cc].flags & SFLG_ARRAY)
+                    totalsub += (sym.entries[cc].arrsize - 1) * sym.entries[cc].ssize;
             }
+            if (sym.entries[cc].flags & SFLG_STRBUFFER)
+                totalsub += STRING_LENGTH;
+        }
+        // release the pointer reference if applicable
+        if (sym.entries[cc].flags & SFLG_THISPTR) { }
+        else if (((sym.entries[cc].flags & SFLG_POINTER) != 0) ||
+            ((sym.entries[cc].flags & SFLG_DYNAMICARRAY) != 0))
+        {
+            free_pointer(scrip->cur_sp - sym.entries[cc].soffs, zeroPtrCmd, cc, scrip);
+        }
+        else if (sym.entries[sym.entries[cc].vartype].flags & SFLG_STRUCTTYPE) {
+            // a struct -- free any pointers it contains
+            free_pointers_from_struct(cc, scrip);
+        }
 
-            if (just_count == 0) {
-                sym.entries[cc].stype = 0;
-                sym.entries[cc].sscope = 0;
-                sym.entries[cc].flags = 0;
-            }
+        if (just_count == 0) {
+            sym.entries[cc].stype = 0;
+            sym.entries[cc].sscope = 0;
+            sym.entries[cc].flags = 0;
+        }
+        else {
+            locals[keep++] = cc;
         }
     }
+    locals.resize(keep);
     return totalsub;
 }
 
@@ -566,10 +555,7 @@ int deal_with_end_of_switch (int32_t *nested_assign_addr, int32_t *nested_start,
 }
 
 int find_member_sym(int structSym, int32_t *memSym, int allowProtected) {
-    int oriname = *memSym;
-    const char *possname = get_member_full_name(structSym, oriname);
-
-    oriname = sym.find(possname);
+    int oriname = sym.find_member(structSym, *memSym);
     if (oriname < 0) {
         if (sym.entries[structSym].extends > 0) {
             // walk the inheritance tree to find the member
@@ -1008,7 +994,7 @@ int process_function_declaration(ccInternalList &targ, ccCompiledScript*scrip,
           return -1;
         }
         cursym = targ.getnext();
-        sym.entries[cursym].stype = SYM_LOCALVAR;
+        sym.set_local_var(cursym);
         sym.entries[cursym].extends = 0;
         sym.entries[cursym].arrsize = 1;
         sym.entries[cursym].vartype = vartypesym;
@@ -1692,7 +1678,7 @@ int extractPathIntoParts(VariableSymlist *variablePath, int slilen, int32_t *sym
   return variablePathSize;
 }
 
-int readcmd_lastcalledwith=0;
+CC_THREAD_LOCAL int readcmd_lastcalledwith=0;
 int get_readcmd_for_size(int sizz, int writeinstead) {
   int readcmd = SCMD_MEMREAD;
   if (writeinstead) {
@@ -2081,7 +2067,7 @@ int do_variable_memory_access(ccCompiledScript *scrip, int variableSym,
 
 // If the variable being read is actually a property, not a
 // member variable, then read_variable_into_ax sets this
-int readonly_cannot_cause_error = 0;
+CC_THREAD_LOCAL int readonly_cannot_cause_error = 0;
 
 int do_variable_ax(int slilen, int32_t *syml, ccCompiledScript*scrip, int writing, int mustBeWritable, bool negateLiteral = false) {
   // read the various types of values into AX
@@ -3151,7 +3137,10 @@ int parse_variable_declaration(int32_t cursym,int *next_type,int isglobal,
   }
 
   sym.entries[cursym].extends = 0;
-  sym.entries[cursym].stype = (isglobal != 0) ? SYM_GLOBALVAR : SYM_LOCALVAR;
+  if (isglobal != 0)
+    sym.entries[cursym].stype = SYM_GLOBALVAR;
+  else
+    sym.set_local_var(cursym);
   if (isPointer) {
     varsize = 4;
   }
@@ -3493,7 +3482,7 @@ int __cc_compile_file(const char*inpl,ccCompiledScript*scrip) {
                     if (thisSym > 0) {
                         int varsize = 4;
                         // declare "this" inside member functions
-                        sym.entries[thisSym].stype = SYM_LOCALVAR;
+                        sym.set_local_var(thisSym);
                         sym.entries[thisSym].vartype = isMemberFunction;
                         sym.entries[thisSym].ssize = varsize; // pointer to struct
                         sym.entries[thisSym].sscope = nested_level;
@@ -3793,8 +3782,7 @@ int __cc_compile_file(const char*inpl,ccCompiledScript*scrip) {
                     const char *memberExt = sym.get_name(vname);
                     memberExt = strstr(memberExt, "::");
                     if (!isFunction && sym.get_type(vname) == SYM_VARTYPE && vname > sym.normalFloatSym && memberExt == NULL) {
-                        const char *new_name = get_member_full_name(stname, vname);
-                        vname = sym_find_or_add(sym, new_name);
+                        vname = sym.find_or_add_member(stname, vname);
                     }
                     if (sym.get_type(vname) != 0 && (sym.get_type(vname) != SYM_VARTYPE || vname <= sym.normalFloatSym)) {
                         cc_error("'%s' is already defined",sym.get_friendly_name(vname).c_str());
@@ -4292,8 +4280,7 @@ startvarbit:
                 int whichmember = targ.getnext();
                 structSym = cursym;
                 // change cursym to be the full function name
-                const char *mfullname = get_member_full_name(cursym, whichmember);
-                cursym = sym.find(mfullname);
+                cursym = sym.find_member(cursym, whichmember);
                 if (cursym < 0) {
                     cc_error("'%s' does not contain a function '%s'", sym.get_friendly_name(structSym).c_str(), sym.get_friendly_name(whichmember).c_str());
                     return -1;
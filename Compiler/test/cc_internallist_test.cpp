@@ -13,9 +13,7 @@
 //=============================================================================
 #include "gtest/gtest.h"
 #include "script/cc_internallist.h"
-
-// defined in script_common, modified by getnext
-extern int currentline; 
+#include "script/cc_common.h" // currentline, modified by getnext
 
 
 TEST(InternalList, Constructor) {
@@ -227,3 +227,26 @@ TEST(SymbolTable, OperatorToVCPUCmd) {
 	testSym.entries[sym_01].vartype = 100;
 	ASSERT_TRUE(testSym.entries[sym_01].operatorToVCPUCmd() == 100);
 }
+
+TEST(SymbolTable, Copy) {
+	symbolTable testSym;
+	testSym.reset();
+	int sym_01 = testSym.add("grassgreen");
+	testSym.entries[sym_01].vartype = 10;
+
+	symbolTable copySym(testSym);
+	ASSERT_TRUE(copySym.entries.size() == testSym.entries.size());
+	ASSERT_TRUE(copySym.find("grassgreen") == sym_01);
+	ASSERT_TRUE(copySym.find("int") == testSym.normalIntSym);
+	ASSERT_TRUE(copySym.normalIntSym == testSym.normalIntSym);
+	ASSERT_TRUE(copySym.entries[sym_01].vartype == 10);
+	ASSERT_STREQ("grassgreen", copySym.get_name(sym_01));
+	ASSERT_TRUE(copySym.get_name(sym_01) != testSym.get_name(sym_01));
+
+	// the tables are independent
+	int sym_02 = copySym.add("bluesky");
+	ASSERT_TRUE(testSym.find("bluesky") == -1);
+	testSym = copySym;
+	ASSERT_TRUE(testSym.find("bluesky") == sym_02);
+	ASSERT_STREQ("bluesky", testSym.get_name(sym_02));
+}
@@ -11,6 +11,7 @@
 // https://opensource.org/license/artistic-2-0/
 //
 //=============================================================================
+#include <stdio.h>
 #include "gtest/gtest.h"
 #include "script/cc_treemap.h"
 
@@ -68,3 +69,19 @@ TEST(TreeMap, Clear) {
 	symbolTree.clear();
 	ASSERT_TRUE (symbolTree.findValue("a") == -1);
 }
+
+TEST(TreeMap, ManyEntries) {
+	ccTreeMap symbolTree;
+	char name[32];
+	for (int i = 0; i < 5000; ++i) {
+		snprintf(name, sizeof(name), "sym%d", i);
+		const char *stored = symbolTree.addEntry(name, i);
+		ASSERT_STREQ (stored, name);
+		ASSERT_TRUE (stored != name);
+	}
+	for (int i = 0; i < 5000; ++i) {
+		snprintf(name, sizeof(name), "sym%d", i);
+		ASSERT_TRUE (symbolTree.findValue(name) == i);
+	}
+	ASSERT_TRUE (symbolTree.findValue("sym5000") == -1);
+}
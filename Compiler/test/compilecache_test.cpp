@@ -0,0 +1,195 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+#include "gtest/gtest.h"
+#include "compilecache.h"
+#include "compiler.h"
+#include "util/directory.h"
+#include "util/file.h"
+#include "util/path.h"
+#include "util/stream.h"
+
+using namespace AGS::Common;
+
+static const char *CacheTestDir = "compilecache_test.tmp";
+
+static CompileCacheKey MakeFullKey(const CompilerOptions &comp_opts, const char *script)
+{
+    CompileCacheKey key;
+    key.AddOptions(comp_opts);
+    key.Add(script);
+    return key;
+}
+
+static CompileCacheKey MakeFullKey(const char *script)
+{
+    return MakeFullKey(CompilerOptions(), script);
+}
+
+static uint64_t MakeKey(const CompilerOptions &comp_opts, const char *script)
+{
+    return MakeFullKey(comp_opts, script).Get();
+}
+
+static std::unique_ptr<ccScript> MakeScript()
+{
+    std::unique_ptr<ccScript> script(new ccScript("test.asc"));
+    script->globaldata = { 1, 2, 3, 4 };
+    script->code = { 29, 3, 0, 5, 1, 2, 6 };
+    const char strings[] = "hello";
+    script->strings.assign(strings, strings + sizeof(strings));
+    script->fixuptypes = { 3 };
+    script->fixups = { 2 };
+    script->imports = { "Display" };
+    script->exports = { "game_start$0" };
+    script->export_addr = { 0x01000000 };
+    script->sectionNames = { "test.asc" };
+    script->sectionOffsets = { 0 };
+    return script;
+}
+
+TEST(CompileCache, Key) {
+    CompilerOptions comp_opts;
+    const uint64_t key = MakeKey(comp_opts, "int a;");
+    ASSERT_EQ(MakeKey(comp_opts, "int a;"), key);
+    ASSERT_NE(MakeKey(comp_opts, "int b;"), key);
+
+    // Options which affect the compilation change the key
+    CompilerOptions debug_opts;
+    debug_opts.DebugMode = true;
+    ASSERT_NE(MakeKey(debug_opts, "int a;"), key);
+    CompilerOptions flag_opts;
+    flag_opts.Flags.LineNumbers = false;
+    ASSERT_NE(MakeKey(flag_opts, "int a;"), key);
+    CompilerOptions version_opts;
+    version_opts.Version = "3.6.0.0";
+    ASSERT_NE(MakeKey(version_opts, "int a;"), key);
+    CompilerOptions macro_opts;
+    macro_opts.Macros.push_back({ "DEBUG", "1" });
+    ASSERT_NE(MakeKey(macro_opts, "int a;"), key);
+    // ...but the options which do not, keep it the same
+    CompilerOptions other_opts;
+    other_opts.Jobs = 4;
+    other_opts.OutputObjFile = "other.o";
+    ASSERT_EQ(MakeKey(other_opts, "int a;"), key);
+
+    // Strings are separated, so moving text between fields changes the key
+    CompileCacheKey key1, key2;
+    key1.Add("ab");
+    key1.Add("c");
+    key2.Add("a");
+    key2.Add("bc");
+    ASSERT_NE(key1.Get(), key2.Get());
+}
+
+static void WriteTestFile(const char *name)
+{
+    std::unique_ptr<Stream> out(File::CreateFile(Path::ConcatPaths(CacheTestDir, name)));
+    ASSERT_NE(out, nullptr);
+    out->WriteInt32(0);
+}
+
+TEST(CompileCache, StoreLoad) {
+    CompileCache cache(CacheTestDir);
+    ASSERT_TRUE(cache.Init());
+    cache.Clean();
+    const CompileCacheKey key1 = MakeFullKey("int a;");
+    const CompileCacheKey key2 = MakeFullKey("int b;");
+    ASSERT_EQ(cache.Load(key1), nullptr);
+
+    std::unique_ptr<ccScript> script = MakeScript();
+    ASSERT_TRUE(cache.Store(key1, script.get()));
+    std::unique_ptr<ccScript> loaded = cache.Load(key1);
+    ASSERT_NE(loaded, nullptr);
+    ASSERT_EQ(loaded->globaldata, script->globaldata);
+    ASSERT_EQ(loaded->code, script->code);
+    ASSERT_EQ(loaded->strings, script->strings);
+    ASSERT_EQ(loaded->fixuptypes, script->fixuptypes);
+    ASSERT_EQ(loaded->fixups, script->fixups);
+    ASSERT_EQ(loaded->imports, script->imports);
+    ASSERT_EQ(loaded->exports, script->exports);
+    ASSERT_EQ(loaded->export_addr, script->export_addr);
+    ASSERT_EQ(loaded->sectionNames, script->sectionNames);
+    ASSERT_EQ(loaded->sectionOffsets, script->sectionOffsets);
+    // Other keys are not affected
+    ASSERT_EQ(cache.Load(key2), nullptr);
+
+    // Storing again replaces the entry
+    script->code.push_back(7);
+    ASSERT_TRUE(cache.Store(key1, script.get()));
+    loaded = cache.Load(key1);
+    ASSERT_NE(loaded, nullptr);
+    ASSERT_EQ(loaded->code, script->code);
+    cache.Clean();
+}
+
+TEST(CompileCache, KeyCollision) {
+    CompileCache cache(CacheTestDir);
+    ASSERT_TRUE(cache.Init());
+    cache.Clean();
+    std::unique_ptr<ccScript> script = MakeScript();
+    const CompileCacheKey key = MakeFullKey("int a;");
+    ASSERT_TRUE(cache.Store(key, script.get()));
+
+    // An entry stored for another key with the same hash is not used:
+    // simulate this by putting the entry under the other key's name
+    CompilerOptions debug_opts;
+    debug_opts.DebugMode = true;
+    const CompileCacheKey other_key = MakeFullKey(debug_opts, "int a;");
+    ASSERT_NE(other_key.GetOptions(), key.GetOptions());
+    char name[64], other_name[64];
+    snprintf(name, sizeof(name), "%016" PRIx64 ".agscache", key.Get());
+    snprintf(other_name, sizeof(other_name), "%016" PRIx64 ".agscache", other_key.Get());
+    ASSERT_TRUE(File::RenameFile(Path::ConcatPaths(CacheTestDir, name), Path::ConcatPaths(CacheTestDir, other_name)));
+    ASSERT_EQ(cache.Load(other_key), nullptr);
+    ASSERT_EQ(cache.Load(key), nullptr);
+    cache.Clean();
+}
+
+TEST(CompileCache, Clean) {
+    CompileCache cache(CacheTestDir);
+    ASSERT_TRUE(cache.Init());
+    cache.Clean();
+
+    std::unique_ptr<ccScript> script = MakeScript();
+    const CompileCacheKey key1 = MakeFullKey("int a;");
+    const CompileCacheKey key2 = MakeFullKey("int b;");
+    ASSERT_TRUE(cache.Store(key1, script.get()));
+    ASSERT_TRUE(cache.Store(key2, script.get()));
+    cache.AddStats(1u, 2u);
+    // a leftover temporary file, e.g. from an interrupted compilation
+    WriteTestFile("0000000000000003.agscache.1.2.tmp");
+    // files which do not belong to the cache
+    WriteTestFile("room1.o");
+    WriteTestFile("script.tmp");
+    WriteTestFile("notakey.agscache");
+    WriteTestFile("0000000000000004.agscache.txt");
+
+    ASSERT_EQ(cache.Clean(), 2u);
+    ASSERT_EQ(cache.Load(key1), nullptr);
+    ASSERT_EQ(cache.Load(key2), nullptr);
+    ASSERT_FALSE(File::IsFile(Path::ConcatPaths(CacheTestDir, "0000000000000003.agscache.1.2.tmp")));
+    ASSERT_EQ(cache.Clean(), 0u);
+    // Other files are left untouched
+    const char *other_files[] = { "room1.o", "script.tmp", "notakey.agscache", "0000000000000004.agscache.txt" };
+    for (const char *file : other_files)
+    {
+        const String path = Path::ConcatPaths(CacheTestDir, file);
+        ASSERT_TRUE(File::IsFile(path));
+        File::DeleteFile(path);
+    }
+    ASSERT_FALSE(Directory::HasAnyFiles(CacheTestDir));
+}
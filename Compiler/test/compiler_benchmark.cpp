@@ -0,0 +1,163 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// Script compiler benchmark.
+//
+// Generates a synthetic script corpus of a number of modules, each declaring
+// a struct with members and a few functions using them, and measures
+// tokenizing and compiling it. Reports tokens and symbols per second.
+//
+// Usage: compiler_benchmark [module count] [repeat count]
+//
+//=============================================================================
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "script/cc_common.h"
+#include "script/cc_compiledscript.h"
+#include "script/cc_internallist.h"
+#include "script/cc_symboltable.h"
+#include "script/cs_compiler.h"
+
+extern int cc_tokenize(const char*inpl, ccInternalList*targ, ccCompiledScript*scrip);
+
+typedef std::chrono::steady_clock Clock;
+
+static std::string MakeModule(int index)
+{
+    // $N is replaced by the module index
+    const char *module_text =
+        "struct Actor$N\n"
+        "{\n"
+        "  int x;\n"
+        "  int y;\n"
+        "  int frame;\n"
+        "  float speed;\n"
+        "  int path[8];\n"
+        "  import int Distance(int tx, int ty);\n"
+        "  import void Move(int dx, int dy);\n"
+        "  import void Animate();\n"
+        "};\n"
+        "Actor$N gActor$N;\n"
+        "int Actor$N::Distance(int tx, int ty)\n"
+        "{\n"
+        "  int dx = tx - this.x;\n"
+        "  int dy = ty - this.y;\n"
+        "  if (dx < 0) dx = -dx;\n"
+        "  if (dy < 0) dy = -dy;\n"
+        "  return dx + dy;\n"
+        "}\n"
+        "void Actor$N::Move(int dx, int dy)\n"
+        "{\n"
+        "  this.x += dx;\n"
+        "  this.y += dy;\n"
+        "  this.path[this.frame] = this.x * 1000 + this.y;\n"
+        "}\n"
+        "void Actor$N::Animate()\n"
+        "{\n"
+        "  this.frame++;\n"
+        "  if (this.frame >= 8)\n"
+        "    this.frame = 0;\n"
+        "  this.speed = this.speed * 0.5 + 1.0;\n"
+        "}\n"
+        "int update_actor$N(int steps)\n"
+        "{\n"
+        "  int total = 0;\n"
+        "  for (int i = 0; i < steps; i++)\n"
+        "  {\n"
+        "    gActor$N.Move(i % 3 - 1, i % 5 - 2);\n"
+        "    gActor$N.Animate();\n"
+        "    total += gActor$N.Distance(100, 200);\n"
+        "    if (total > 10000)\n"
+        "      total -= 10000;\n"
+        "  }\n"
+        "  return total;\n"
+        "}\n";
+    const std::string num = std::to_string(index);
+    std::string text = module_text;
+    for (size_t pos = text.find("$N"); pos != std::string::npos; pos = text.find("$N", pos))
+        text.replace(pos, 2, num);
+    return text;
+}
+
+// Counts actual tokens in the list, skipping the meta entries
+static size_t CountTokens(const ccInternalList &list)
+{
+    size_t count = 0;
+    for (int i = 0; i < list.length; ++i)
+    {
+        if (list.script[i] == SCODE_META)
+            i += 2;
+        else
+            count++;
+    }
+    return count;
+}
+
+int main(int argc, char *argv[])
+{
+    const int modules = argc > 1 ? atoi(argv[1]) : 200;
+    const int repeats = argc > 2 ? atoi(argv[2]) : 5;
+    if (modules <= 0 || repeats <= 0)
+    {
+        printf("Usage: compiler_benchmark [module count] [repeat count]\n");
+        return -1;
+    }
+
+    std::string corpus;
+    for (int i = 0; i < modules; ++i)
+        corpus += MakeModule(i);
+
+    // Tokenizing only
+    size_t tokens = 0;
+    size_t symbols = 0;
+    auto start = Clock::now();
+    for (int r = 0; r < repeats; ++r)
+    {
+        ccCompiledScript scrip;
+        ccInternalList list;
+        sym.reset();
+        if (cc_tokenize(corpus.c_str(), &list, &scrip) != 0)
+        {
+            printf("Error tokenizing the corpus: %s\n", cc_get_error().ErrorString.GetCStr());
+            return -1;
+        }
+        tokens = CountTokens(list);
+        symbols = sym.entries.size();
+    }
+    const double tokenize_sec = std::chrono::duration<double>(Clock::now() - start).count() / repeats;
+
+    // Full compilation
+    start = Clock::now();
+    for (int r = 0; r < repeats; ++r)
+    {
+        ccScript *script = ccCompileText(corpus.c_str(), "Benchmark");
+        if (!script)
+        {
+            printf("Error compiling the corpus: %s\n", cc_get_error().ErrorString.GetCStr());
+            return -1;
+        }
+        delete script;
+    }
+    const double compile_sec = std::chrono::duration<double>(Clock::now() - start).count() / repeats;
+
+    printf("Corpus: %d modules, %zu bytes, %zu tokens, %zu symbols\n",
+        modules, corpus.size(), tokens, symbols);
+    printf("Tokenize: %.3f ms, %.0f tokens/sec, %.0f symbols/sec\n",
+        tokenize_sec * 1000.0, tokens / tokenize_sec, symbols / tokenize_sec);
+    printf("Compile:  %.3f ms, %.0f tokens/sec, %.0f symbols/sec\n",
+        compile_sec * 1000.0, tokens / compile_sec, symbols / compile_sec);
+    return 0;
+}
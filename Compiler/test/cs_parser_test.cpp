@@ -15,6 +15,7 @@
 #include <util/string_compat.h>
 #include "gtest/gtest.h"
 #include "test/cc_test_helper.h"
+#include "script/cs_compiler.h"
 #include "script/cs_parser.h"
 #include "script/cc_symboltable.h"
 #include "script/cc_internallist.h"
@@ -650,3 +651,42 @@ TEST(Compile, AccessNonStaticMemberOfAStaticMember) {
     //printf("Error: %s\n", last_seen_cc_error());
     ASSERT_EQ(0, compileResult);
 }
+
+TEST(Compile, CompiledHeadersSameAsDefault) {
+    const char *header = ""
+        "struct Point {"
+        "    int x, y;"
+        "    import int Sum();"
+        "};"
+        "import int GetValue();";
+    const char *inpl = ""
+        "int Point::Sum() {"
+        "    return this.x + this.y + GetValue();"
+        "}"
+        "int Func() {"
+        "    Point p;"
+        "    p.x = 1;"
+        "    return p.Sum();"
+        "}";
+
+    ccRemoveDefaultHeaders();
+    ccAddDefaultHeader(header, "Header");
+    std::unique_ptr<ccScript> script(ccCompileText(inpl, "Script"));
+    ASSERT_TRUE(script != nullptr);
+    std::shared_ptr<ccCompiledHeaders> headers = ccCompileDefaultHeaders();
+    ASSERT_TRUE(headers != nullptr);
+    ccRemoveDefaultHeaders();
+
+    // compile twice, to check that the compiled headers are not changed
+    for (int i = 0; i < 2; ++i) {
+        std::unique_ptr<ccScript> script2(ccCompileText(*headers, inpl, "Script"));
+        ASSERT_TRUE(script2 != nullptr);
+        EXPECT_EQ(script->code, script2->code);
+        EXPECT_EQ(script->globaldata, script2->globaldata);
+        EXPECT_EQ(script->fixups, script2->fixups);
+        EXPECT_EQ(script->imports, script2->imports);
+        EXPECT_EQ(script->exports, script2->exports);
+        EXPECT_EQ(script->sectionNames, script2->sectionNames);
+        EXPECT_EQ(script->sectionOffsets, script2->sectionOffsets);
+    }
+}
@@ -3213,6 +3213,10 @@ builtin struct Game {
   /// Gets whether the game is currently in a blocking state, that is during a blocking action or a Wait() call.
   import static readonly attribute bool InBlockingWait;
 #endif // SCRIPT_API_v362
+#ifdef SCRIPT_API_v363
+  /// Gets whether a game save is being written in background.
+  import static readonly attribute bool SaveInProgress;
+#endif // SCRIPT_API_v363
 };
 
 #ifdef SCRIPT_API_v363
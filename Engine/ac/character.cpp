@@ -15,7 +15,9 @@
 // AGS Character functions
 //
 //=============================================================================
+#include <algorithm>
 #include <cstdio>
+#include <unordered_map>
 #include "ac/character.h"
 #include "ac/common.h"
 #include "ac/gamesetupstruct.h"
@@ -104,6 +106,17 @@ const char *text_lips_text = nullptr;
 std::vector<SpeechLipSyncLine> splipsync;
 int numLipLines = 0, curLipLine = -1, curLipLinePhoneme = 0;
 
+// Character IDs per room, sorted in ascending order; note that negative
+// room numbers are valid here, they are used by the delayed followers
+static std::unordered_map<int, std::vector<int>> room_chars;
+// Tells that the characters' rooms may have been changed directly,
+// and the lists must be rebuilt before use
+static bool room_chars_dirty = false;
+// Tells that the characters are exposed to plugins, which may change their
+// rooms at any time; the lists are then rebuilt at least once per frame
+static bool room_chars_exposed = false;
+static uint32_t room_chars_frame = 0u;
+
 // **** CHARACTER: FUNCTIONS ****
 
 bool is_valid_character(int char_id)
@@ -281,7 +294,7 @@ void Character_ChangeRoomSetLoop(CharacterInfo *chaa, int room, int x, int y, in
 			if (direction != SCR_NO_VALUE && direction>=0) chaa->loop = direction;
         }
         chaa->prevroom = chaa->room;
-        chaa->room = room;
+        set_character_room(chaa, room);
 
 		debug_script_log("%s moved to room %d, location %d,%d, loop %d",
 			chaa->scrname, room, chaa->x, chaa->y, chaa->loop);
@@ -817,7 +830,7 @@ void Character_SetAsPlayer(CharacterInfo *chaa) {
     // the current room for 2.x. Following script calls to NewRoom() will
     // make sure this still works as intended.
     if ((loaded_game_file_version <= kGameVersion_272) && (playerchar->room < 0))
-        playerchar->room = displayed_room;
+        set_character_room(playerchar, displayed_room);
 
     if (displayed_room != playerchar->room)
         NewRoom(playerchar->room);
@@ -1851,8 +1864,10 @@ void move_character_impl(CharacterInfo *chin, const std::vector<Point> *path, in
     else
     {
         MaskRouteFinder *pathfind = get_room_pathfinder();
-        pathfind->SetWalkableArea(prepare_walkable_areas(chac), thisroom.MaskResolution);
-        path_result = Pathfinding::FindRoute(mls[mslot], pathfind, src_x, src_y, dst_x, dst_y, move_speed_x, move_speed_y, false, ignwal);
+        uint64_t mask_key;
+        pathfind->SetWalkableArea(prepare_walkable_areas(chac, &mask_key), thisroom.MaskResolution);
+        path_result = Pathfinding::FindRoute(mls[mslot], pathfind, get_room_route_cache(), mask_key,
+            src_x, src_y, dst_x, dst_y, move_speed_x, move_speed_y, false, ignwal);
     }
 
     // If successful, then start moving
@@ -2012,9 +2027,8 @@ int has_hit_another_character(int sourceChar) {
     if (game.chars[sourceChar].flags & CHF_NOBLOCKING)
         return -1;
 
-    for (int ww = 0; ww < game.numcharacters; ww++) {
+    for (int ww : get_room_characters(displayed_room)) {
         if (game.chars[ww].on != 1) continue;
-        if (game.chars[ww].room != displayed_room) continue;
         if (ww == sourceChar) continue;
         if (game.chars[ww].flags & CHF_NOBLOCKING) continue;
 
@@ -2390,9 +2404,8 @@ void update_character_scale(int charid)
 }
 
 int is_pos_on_character(int xx,int yy) {
-    int cc,sppic,lowestyp=0,lowestwas=-1;
-    for (cc=0;cc<game.numcharacters;cc++) {
-        if (game.chars[cc].room!=displayed_room) continue;
+    int sppic,lowestyp=0,lowestwas=-1;
+    for (int cc : get_room_characters(displayed_room)) {
         if (game.chars[cc].on==0) continue;
         if (game.chars[cc].flags & CHF_NOINTERACT) continue;
         if (game.chars[cc].view < 0) continue;
@@ -2414,6 +2427,14 @@ int is_pos_on_character(int xx,int yy) {
         int yyy = charextra[cc].GetEffectiveY(chin) - game_to_data_coord(usehit);
         int mirrored = views[chin->view].loops[chin->loop].frames[chin->frame].flags & VFLG_FLIPSPRITE;
 
+        // do the cheap tests first, and only get the image for the pixel test
+        // if this character may actually be the one on top
+        int use_base = chin->get_baseline();
+        if (use_base < lowestyp) continue;
+        if (!is_pos_in_sprite_box(xx, yy, xxx, yyy,
+            game_to_data_coord(usewid), game_to_data_coord(usehit)))
+            continue;
+
         bool is_original;
         Bitmap *theImage = GetCharacterImage(cc, &is_original);
         if (!is_original)
@@ -2424,8 +2445,6 @@ int is_pos_on_character(int xx,int yy) {
             game_to_data_coord(usehit), mirrored, is_original) == FALSE)
             continue;
 
-        int use_base = chin->get_baseline();
-        if (use_base < lowestyp) continue;
         lowestyp=use_base;
         lowestwas=cc;
     }
@@ -3110,6 +3129,52 @@ void restore_characters()
         charextra[i].zoom_offs = (game.options[OPT_SCALECHAROFFSETS] != 0) ?
             charextra[i].zoom : 100;
     }
+    reset_room_characters();
+}
+
+void reset_room_characters()
+{
+    // keep the allocated lists, as characters usually return to the same rooms
+    for (auto &list : room_chars)
+        list.second.clear();
+    for (int i = 0; i < game.numcharacters; ++i)
+        room_chars[game.chars[i].room].push_back(i);
+    room_chars_dirty = false;
+    room_chars_frame = get_loop_counter();
+}
+
+void invalidate_room_characters()
+{
+    room_chars_dirty = true;
+}
+
+void expose_room_characters()
+{
+    room_chars_exposed = true;
+    room_chars_dirty = true;
+}
+
+void set_character_room(CharacterInfo *chi, int room)
+{
+    if (chi->room == room)
+        return;
+
+    auto &old_list = room_chars[chi->room];
+    auto it = std::lower_bound(old_list.begin(), old_list.end(), chi->index_id);
+    if ((it != old_list.end()) && (*it == chi->index_id))
+        old_list.erase(it);
+    auto &new_list = room_chars[room];
+    it = std::lower_bound(new_list.begin(), new_list.end(), chi->index_id);
+    if ((it == new_list.end()) || (*it != chi->index_id))
+        new_list.insert(it, chi->index_id);
+    chi->room = room;
+}
+
+const std::vector<int> &get_room_characters(int room)
+{
+    if (room_chars_dirty || (room_chars_exposed && (room_chars_frame != get_loop_counter())))
+        reset_room_characters();
+    return room_chars[room];
 }
 
 Rect GetCharacterRoomBBox(int charid, bool use_frame_0)
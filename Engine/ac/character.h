@@ -222,6 +222,25 @@ int update_lip_sync(int talkview, int talkloop, int *talkframeptr);
 // Recalculate dynamic character properties, e.g. after restoring a game save
 void restore_characters();
 
+// Per-room character lists, which let iterate only over the characters
+// in a particular room, instead of testing every character in game.
+// NOTE: engine code must change character's room using set_character_room,
+// or else call reset_room_characters or invalidate_room_characters after the change.
+//
+// Rebuilds room lists from the characters' current rooms
+void reset_room_characters();
+// Tells that the characters' rooms may have been changed directly,
+// the lists will be rebuilt on the next request
+void invalidate_room_characters();
+// Tells that the characters' data is given to the external code (plugins),
+// which may change their rooms directly at any time; after this the lists
+// are rebuilt on the first request in each game frame
+void expose_room_characters();
+// Assigns character a new room, and updates room lists
+void set_character_room(CharacterInfo *chi, int room);
+// Returns IDs of the characters which are in the given room, in ascending order
+const std::vector<int> &get_room_characters(int room);
+
 // Calculates character's bounding box in room coordinates (takes only in-room transform into account)
 // use_frame_0 optionally tells to use frame 0 of current loop instead of current frame.
 Rect GetCharacterRoomBBox(int charid, bool use_frame_0 = false);
@@ -56,7 +56,7 @@ void CharacterExtras::SetFollowing(CharacterInfo *chi, int follow_who, int dista
 
 void CharacterExtras::ReadFromSavegame(Stream *in, CharacterSvgVersion save_ver)
 {
-    in->ReadArrayOfInt16(invorder, MAX_INVORDER);
+    in->ReadArrayOfInt16(invorder.data(), MAX_INVORDER);
     invorder_count = in->ReadInt16();
     width = in->ReadInt16();
     height = in->ReadInt16();
@@ -88,7 +88,7 @@ void CharacterExtras::ReadFromSavegame(Stream *in, CharacterSvgVersion save_ver)
 
 void CharacterExtras::WriteToSavegame(Stream *out) const
 {
-    out->WriteArrayOfInt16(invorder, MAX_INVORDER);
+    out->WriteArrayOfInt16(invorder.data(), MAX_INVORDER);
     out->WriteInt16(invorder_count);
     out->WriteInt16(width);
     out->WriteInt16(height);
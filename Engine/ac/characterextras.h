@@ -26,6 +26,7 @@
 #ifndef __AGS_EE_AC__CHARACTEREXTRAS_H
 #define __AGS_EE_AC__CHARACTEREXTRAS_H
 
+#include <vector>
 #include "ac/characterinfo.h"
 #include "ac/runtime_defines.h"
 
@@ -37,7 +38,10 @@ using namespace AGS; // FIXME later
 // and plugin API, therefore new stuff has to go here
 struct CharacterExtras
 {
-    short invorder[MAX_INVORDER]{};
+    // The inventory order is kept out of the struct, because it's
+    // rarely used but large, while the rest of the data is accessed
+    // by the per-frame character updates for all characters.
+    std::vector<short> invorder = std::vector<short>(MAX_INVORDER);
     short invorder_count = 0;
     // TODO: implement full AABB and keep updated, so that engine could rely on these cached values all time;
     // TODO: consider having both fixed AABB and volatile one that changes with animation frame (unless you change how anims work)
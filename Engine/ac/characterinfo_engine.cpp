@@ -128,7 +128,7 @@ void UpdateFollowingExactlyCharacter(CharacterInfo *chi)
     chi->x = following.x;
     chi->y = following.y;
     chi->z = following.z;
-    chi->room = following.room;
+    set_character_room(chi, following.room);
     chi->prevroom = following.prevroom;
 
     const int usebase = following.get_baseline();
@@ -388,10 +388,10 @@ void UpdateCharacterFollower(CharacterInfo *chi, std::vector<int> &followingAsSh
       // no character in this room
       if ((game.chars[following].on == 0) || (chi->on == 0)) ;
       else if (chi->room < 0) {
-        chi->room ++; // CHECKME: what the heck is this for ???
+        set_character_room(chi, chi->room + 1); // CHECKME: what the heck is this for ???
         if (chi->room == 0) {
           // appear in the new room
-          chi->room = game.chars[following].room;
+          set_character_room(chi, game.chars[following].room);
           chi->x = play.entered_at_x;
           chi->y = play.entered_at_y;
         }
@@ -404,7 +404,7 @@ void UpdateCharacterFollower(CharacterInfo *chi, std::vector<int> &followingAsSh
         ;  // do nothing if the player isn't visible
       else if (chi->room != game.chars[following].room) {
         chi->prevroom = chi->room;
-        chi->room = game.chars[following].room;
+        set_character_room(chi, game.chars[following].room);
 
         if (chi->room == displayed_room) {
           // only move to the room-entered position if coming into
@@ -428,7 +428,7 @@ void UpdateCharacterFollower(CharacterInfo *chi, std::vector<int> &followingAsSh
           else {
             // not at one of the edges
             // delay for a few seconds to let the player move
-            chi->room = -play.follow_change_room_timer;
+            set_character_room(chi, -play.follow_change_room_timer);
           }
           if (chi->room >= 0) {
             walk_character(chi, play.entered_at_x, play.entered_at_y, true /* ignwal */);
@@ -19,6 +19,7 @@
 #include "ac/common.h"
 #include "util/compress.h"
 #include "ac/view.h"
+#include "ac/character.h"
 #include "ac/characterextras.h"
 #include "ac/characterinfo.h"
 #include "ac/display.h"
@@ -47,6 +48,7 @@
 #include "ac/walkablearea.h"
 #include "ac/walkbehind.h"
 #include "ac/dynobj/scriptsystem.h"
+#include "debug/benchmark.h"
 #include "debug/debugger.h"
 #include "debug/debug_log.h"
 #include "font/fonts.h"
@@ -58,6 +60,7 @@
 #include "gfx/gfx_util.h"
 #include "gfx/graphicsdriver.h"
 #include "gfx/ali3dexception.h"
+#include "gfx/blend_kernels.h"
 #include "gfx/blender.h"
 #include "main/game_run.h"
 #include "media/audio/audio_system.h"
@@ -1284,8 +1287,11 @@ void draw_sprite_support_alpha(Bitmap *ds, bool ds_has_alpha, int xpos, int ypos
     // Backwards-compatible drawing
     else if (src_has_alpha && alpha == 0xFF)
     {
-        set_alpha_blender();
-        ds->TransBlendBlt(image, xpos, ypos);
+        if (!BlendKernels::DrawTransSprite(ds, image, xpos, ypos, BlendKernels::kBlendKernel_Alpha32))
+        {
+            set_alpha_blender();
+            ds->TransBlendBlt(image, xpos, ypos);
+        }
     }
     else
     {
@@ -1485,11 +1491,15 @@ void draw_gui_sprite(Bitmap *ds, bool use_alpha, int x, int y, Bitmap *sprite, b
     // Backwards-compatible drawing
     else if (use_alpha && ds_has_alpha && (game.options[OPT_NEWGUIALPHA] == kGuiAlphaRender_AdditiveAlpha) && (alpha == 0xFF))
     {
-        if (src_has_alpha)
-            set_additive_alpha_blender();
-        else
-            set_opaque_alpha_blender();
-        ds->TransBlendBlt(sprite, x, y);
+        if (!BlendKernels::DrawTransSprite(ds, sprite, x, y, src_has_alpha ?
+                BlendKernels::kBlendKernel_Additive : BlendKernels::kBlendKernel_OpaqueAlpha))
+        {
+            if (src_has_alpha)
+                set_additive_alpha_blender();
+            else
+                set_opaque_alpha_blender();
+            ds->TransBlendBlt(sprite, x, y);
+        }
     }
     else
     {
@@ -1660,6 +1670,7 @@ static void apply_tint_or_light(ObjTexture &actsp, int light_level,
          // to LitBlendBlt defines how much it will be darkened/lightened by.
          
          int lit_amnt;
+         int lit_col = 0;
          active_spr->FillTransparent();
          // It's a light level, not a tint
          if (game.color_depth == 1) {
@@ -1668,14 +1679,15 @@ static void apply_tint_or_light(ObjTexture &actsp, int light_level,
          }
          else {
              // hi-color
-             if (light_level < 0)
-                 set_my_trans_blender(8,8,8,0);
-             else
-                 set_my_trans_blender(248,248,248,0);
+             lit_col = (light_level < 0) ? 8 : 248;
+             set_my_trans_blender(lit_col, lit_col, lit_col, 0);
              lit_amnt = abs(light_level) * 2;
          }
 
-         active_spr->LitBlendBlt(oldwas.get(), 0, 0, lit_amnt);
+         if ((game.color_depth == 1) ||
+             !BlendKernels::DrawLitSprite(active_spr, oldwas.get(), 0, 0, BlendKernels::kBlendKernel_TransKeepAlpha,
+                lit_amnt, makecol32(lit_col, lit_col, lit_col)))
+             active_spr->LitBlendBlt(oldwas.get(), 0, 0, lit_amnt);
      }
 
      if (oldwas.get() == blitFrom)
@@ -2091,8 +2103,11 @@ void tint_image (Bitmap *ds, Bitmap *srcimg, int red, int grn, int blu, int ligh
         finaltarget->LitBlendBlt(srcimg, 0, 0, luminance);
 
         // customized trans blender to preserve alpha channel
-        set_my_trans_blender (0, 0, 0, light_level);
-        ds->TransBlendBlt (finaltarget, 0, 0);
+        if (!BlendKernels::DrawTransSprite(ds, finaltarget, 0, 0, BlendKernels::kBlendKernel_TransKeepAlpha, light_level))
+        {
+            set_my_trans_blender (0, 0, 0, light_level);
+            ds->TransBlendBlt (finaltarget, 0, 0);
+        }
         delete finaltarget;
     }
 }
@@ -2130,13 +2145,11 @@ void prepare_characters_for_drawing()
     const bool hw_accel = !drawstate.SoftwareRender;
 
     // draw characters
-    for (int charid = 0; charid < game.numcharacters; ++charid)
+    for (int charid : get_room_characters(displayed_room))
     {
         const CharacterInfo &chin = game.chars[charid];
         if (chin.on == 0)
             continue; // disabled
-        if (chin.room != displayed_room)
-            continue; // in another room
 
         eip_guinum = charid;
         const CharacterExtras &chex = charextra[charid];
@@ -2994,6 +3007,7 @@ void render_graphics(IDriverDependantBitmap *extraBitmap, int extraX, int extraY
         gfxDriver->EndSpriteBatch();
     }
     construct_game_screen_overlay(!in_room_transition);
+    benchmark_phase(kBenchPhase_Render);
     render_to_screen();
 
     if (!play.screen_is_faded_out) {
@@ -68,6 +68,12 @@ public:
     void WriteInt16(void *address, intptr_t offset, int16_t val) override;
     void WriteInt32(void *address, intptr_t offset, int32_t val) override;
     void WriteFloat(void *address, intptr_t offset, float val) override;
+
+    //
+    // Managed handle storage: not supported by default
+    //
+    bool SetHandle(void* /*address*/, int32_t /*handle*/) override { return false; }
+    int32_t GetHandle(const void* /*address*/) override { return 0; }
 };
 
 
@@ -14,6 +14,7 @@
 #include "cc_dynamicarray.h"
 #include <string.h>
 #include "ac/dynobj/dynobj_manager.h"
+#include "ac/dynobj/managedobjectheap.h"
 #include "ac/dynobj/scriptstring.h"
 
 using namespace AGS::Common;
@@ -48,10 +49,21 @@ int CCDynamicArray::Dispose(void *address, bool force)
         }
     }
 
-    delete[] (static_cast<uint8_t*>(address) - MemHeaderSz);
+    objheap.Free(static_cast<uint8_t*>(address) - MemHeaderSz);
     return 1;
 }
 
+bool CCDynamicArray::SetHandle(void *address, int32_t handle)
+{
+    ManagedObjectHeap::SetHandle(static_cast<uint8_t*>(address) - MemHeaderSz, handle);
+    return true;
+}
+
+int32_t CCDynamicArray::GetHandle(const void *address)
+{
+    return ManagedObjectHeap::GetHandle(static_cast<const uint8_t*>(address) - MemHeaderSz);
+}
+
 size_t CCDynamicArray::CalcSerializeSize(const void *address)
 {
     const Header &hdr = GetHeader(address);
@@ -68,7 +80,7 @@ void CCDynamicArray::Serialize(const void *address, Stream *out)
 
 void CCDynamicArray::Unserialize(int index, Stream *in, size_t data_sz)
 {
-    uint8_t *new_arr = new uint8_t[(data_sz - FileHeaderSz) + MemHeaderSz];
+    uint8_t *new_arr = static_cast<uint8_t*>(objheap.Allocate((data_sz - FileHeaderSz) + MemHeaderSz));
     Header &hdr = reinterpret_cast<Header&>(*new_arr);
     hdr.ElemCount = in->ReadInt32();
     hdr.TotalSize = in->ReadInt32();
@@ -83,7 +95,7 @@ void CCDynamicArray::Unserialize(int index, Stream *in, size_t data_sz)
     if (elem_count > INT32_MAX || (is_managed && elem_size != sizeof(int32_t)))
         return {};
 
-    uint8_t *new_arr = new uint8_t[elem_count * elem_size + MemHeaderSz];
+    uint8_t *new_arr = static_cast<uint8_t*>(objheap.Allocate(elem_count * elem_size + MemHeaderSz));
     memset(new_arr, 0, elem_count * elem_size + MemHeaderSz);
     Header &hdr = reinterpret_cast<Header&>(*new_arr);
     hdr.ElemCount = elem_count | (ARRAY_MANAGED_TYPE_FLAG * is_managed);
@@ -92,7 +104,7 @@ void CCDynamicArray::Unserialize(int index, Stream *in, size_t data_sz)
     int32_t handle = ccRegisterManagedObject(obj_ptr, &globalDynamicArray);
     if (handle == 0)
     {
-        delete[] new_arr;
+        objheap.Free(new_arr);
         return {};
     }
     return DynObjectRef(handle, obj_ptr, &globalDynamicArray);
@@ -53,6 +53,8 @@ public:
     const char *GetType() override;
     int Dispose(void *address, bool force) override;
     void Unserialize(int index, AGS::Common::Stream *in, size_t data_sz) override;
+    bool SetHandle(void *address, int32_t handle) override;
+    int32_t GetHandle(const void *address) override;
 
 private:
     // The size of the array's header in memory, prepended to the element data
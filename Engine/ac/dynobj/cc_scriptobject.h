@@ -94,6 +94,14 @@ struct IScriptObject
     virtual void    WriteInt32(void *address, intptr_t offset, int32_t val)   = 0;
     virtual void    WriteFloat(void *address, intptr_t offset, float val)     = 0;
 
+    // Stores the object's managed handle along with the object's data;
+    // returns false if this object type does not support that, in which
+    // case the handle has to be found by the object's address.
+    virtual bool    SetHandle(void *address, int32_t handle)                  = 0;
+    // Returns the managed handle stored along with the object's data,
+    // or 0 if there's none.
+    virtual int32_t GetHandle(const void *address)                            = 0;
+
 protected:
     IScriptObject() = default;
     ~IScriptObject() = default;
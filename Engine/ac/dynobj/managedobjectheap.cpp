@@ -0,0 +1,119 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "ac/dynobj/managedobjectheap.h"
+#include <algorithm>
+#include <assert.h>
+
+const size_t ManagedObjectHeap::ClassSizes[ManagedObjectHeap::NumSizeClasses] =
+    { 16, 32, 48, 64, 80, 96, 128, 160, 192, 256, 320, 384, 512, 640, 768, MaxSmallSize };
+
+ManagedObjectHeap objheap;
+
+uint32_t ManagedObjectHeap::GetSizeClass(size_t full_size)
+{
+    const size_t *it = std::lower_bound(ClassSizes, ClassSizes + NumSizeClasses, full_size);
+    return it == ClassSizes + NumSizeClasses ? LargeBlockClass : static_cast<uint32_t>(it - ClassSizes);
+}
+
+void *ManagedObjectHeap::Allocate(size_t size)
+{
+    const size_t full_size = size + BlockHeaderSz;
+    const uint32_t size_class = GetSizeClass(full_size);
+    uint8_t *block;
+    if (size_class == LargeBlockClass)
+    {
+        block = new uint8_t[full_size];
+        _regions[block] = Region{ block + full_size, LargeBlockClass };
+        _stats.LargeBlocks++;
+    }
+    else
+    {
+        ClassPool &cpool = _classes[size_class];
+        const size_t block_size = ClassSizes[size_class];
+        if (cpool.FreeList)
+        {
+            block = reinterpret_cast<uint8_t*>(cpool.FreeList);
+            cpool.FreeList = cpool.FreeList->Next;
+        }
+        else
+        {
+            if (static_cast<size_t>(cpool.SlabEnd - cpool.SlabPos) < block_size)
+            {
+                // NOTE: the remainder of the previous slab (if any) is smaller
+                // than a block of this class, so it's just abandoned
+                // the slab is zeroed, so that the blocks not allocated yet
+                // have no handle in their headers
+                _slabs.emplace_back(new uint8_t[SlabSize]());
+                cpool.SlabPos = _slabs.back().get();
+                cpool.SlabEnd = cpool.SlabPos + SlabSize;
+                _regions[cpool.SlabPos] = Region{ cpool.SlabEnd, size_class };
+                _stats.SlabCount++;
+            }
+            block = cpool.SlabPos;
+            cpool.SlabPos += block_size;
+        }
+        _stats.SmallBlocks++;
+    }
+
+    BlockHeader *hdr = reinterpret_cast<BlockHeader*>(block);
+    hdr->SizeClass = size_class;
+    hdr->Handle = 0;
+    return block + BlockHeaderSz;
+}
+
+void ManagedObjectHeap::Free(void *ptr)
+{
+    if (!ptr)
+        return;
+
+    uint8_t *block = static_cast<uint8_t*>(ptr) - BlockHeaderSz;
+    const uint32_t size_class = reinterpret_cast<const BlockHeader*>(block)->SizeClass;
+    if (size_class == LargeBlockClass)
+    {
+        _regions.erase(block);
+        delete[] block;
+        _stats.LargeBlocks--;
+        return;
+    }
+
+    assert(size_class < NumSizeClasses);
+    ClassPool &cpool = _classes[size_class];
+    FreeBlock *fb = reinterpret_cast<FreeBlock*>(block);
+    fb->Header.Handle = 0;
+    fb->Next = cpool.FreeList;
+    cpool.FreeList = fb;
+    _stats.SmallBlocks--;
+}
+
+int32_t ManagedObjectHeap::FindHandle(const void *addr) const
+{
+    const uint8_t *ptr = static_cast<const uint8_t*>(addr);
+    auto it = _regions.upper_bound(ptr);
+    if (it == _regions.begin())
+        return 0;
+    --it;
+    const Region &region = it->second;
+    if (ptr >= region.End)
+        return 0;
+    const uint8_t *block = it->first;
+    if (region.SizeClass != LargeBlockClass)
+    {
+        const size_t block_size = ClassSizes[region.SizeClass];
+        block += ((ptr - block) / block_size) * block_size;
+    }
+    // an address inside the block header does not belong to the object
+    if (ptr < block + BlockHeaderSz)
+        return 0;
+    return reinterpret_cast<const BlockHeader*>(block)->Handle;
+}
@@ -0,0 +1,136 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// ManagedObjectHeap: a size-classed slab allocator for the data of
+// the dynamic script objects (strings, arrays and user structs).
+//
+// Scripts create and release many short-lived objects, typically strings,
+// and allocating each of them separately with the general purpose allocator
+// is relatively slow. The heap instead takes memory from large slabs,
+// divided into blocks of several fixed size classes, and keeps freed blocks
+// in a per-class free list for reuse. Large blocks are allocated separately.
+//
+// Each block is prepended by a small header, which tells its size class,
+// and also lets keep the managed handle of the object stored in this block;
+// this lets find the object's handle without a lookup by its address.
+// The heap also keeps the address ranges of its slabs and large blocks,
+// so that the handle may be found from any address inside a used block.
+//
+// The slabs are not released until the heap is destroyed, and are reused
+// for the new objects.
+//
+// NOTE: the heap is not thread-safe; it is meant to be used only on the
+// game thread, same as the managed object pool.
+//
+//=============================================================================
+#ifndef __CC_MANAGEDOBJECTHEAP_H
+#define __CC_MANAGEDOBJECTHEAP_H
+
+#include <map>
+#include <memory>
+#include <vector>
+#include "core/types.h"
+
+class ManagedObjectHeap final
+{
+public:
+    // Heap statistics, for diagnostics
+    struct Stats
+    {
+        size_t SlabCount = 0u;    // number of allocated slabs
+        size_t SmallBlocks = 0u;  // number of the used slab blocks
+        size_t LargeBlocks = 0u;  // number of the used separately allocated blocks
+    };
+
+    // Size of a single slab, in bytes
+    static const size_t SlabSize = 64 * 1024;
+    // Max size of a block allocated from slabs, including its header;
+    // larger blocks are allocated separately
+    static const size_t MaxSmallSize = 1024;
+
+    ManagedObjectHeap() = default;
+
+    // Allocates a block of at least the given size; the block's contents
+    // are not initialized
+    void *Allocate(size_t size);
+    // Frees the block previously allocated by this heap
+    void Free(void *ptr);
+    // Gets heap statistics
+    const Stats &GetStats() const { return _stats; }
+
+    // Gets the managed handle stored in the block's header, 0 if none was set
+    inline static int32_t GetHandle(const void *ptr)
+    {
+        return reinterpret_cast<const BlockHeader*>(static_cast<const uint8_t*>(ptr) - BlockHeaderSz)->Handle;
+    }
+    // Stores the managed handle in the block's header
+    inline static void SetHandle(void *ptr, int32_t handle)
+    {
+        reinterpret_cast<BlockHeader*>(static_cast<uint8_t*>(ptr) - BlockHeaderSz)->Handle = handle;
+    }
+    // Finds a block which contains the given address, and returns the
+    // managed handle stored in its header; returns 0 if the address does not
+    // belong to this heap, or the block is free or has no handle set
+    int32_t FindHandle(const void *addr) const;
+
+private:
+    struct BlockHeader
+    {
+        uint32_t SizeClass; // index of the size class, or LargeBlockClass
+        int32_t  Handle;    // managed handle of the object using this block
+    };
+
+    // A freed block, linked into the free list; the link is stored
+    // after the block header, which is kept with no handle
+    struct FreeBlock
+    {
+        BlockHeader Header;
+        FreeBlock *Next;
+    };
+
+    // A range of memory owned by the heap: either a slab, or a large block
+    struct Region
+    {
+        const uint8_t *End;
+        uint32_t SizeClass; // size class of the slab's blocks, or LargeBlockClass
+    };
+
+    struct ClassPool
+    {
+        FreeBlock *FreeList = nullptr;
+        // Unused remainder of the last slab assigned to this class
+        uint8_t *SlabPos = nullptr;
+        uint8_t *SlabEnd = nullptr;
+    };
+
+    static const size_t BlockHeaderSz = sizeof(BlockHeader);
+    static const uint32_t LargeBlockClass = UINT32_MAX;
+    // Size classes, these include the block header
+    static const size_t NumSizeClasses = 16;
+    static const size_t ClassSizes[NumSizeClasses];
+    static_assert(sizeof(FreeBlock) <= 16, "free block link must fit into the smallest size class");
+
+    // Finds the smallest size class which fits a block of the given full size
+    static uint32_t GetSizeClass(size_t full_size);
+
+    ClassPool _classes[NumSizeClasses];
+    std::vector<std::unique_ptr<uint8_t[]>> _slabs;
+    // Slabs and large blocks, by their start address
+    std::map<const uint8_t*, Region> _regions;
+    Stats _stats;
+};
+
+extern ManagedObjectHeap objheap;
+
+#endif // __CC_MANAGEDOBJECTHEAP_H
@@ -11,19 +11,25 @@
 // https://opensource.org/license/artistic-2-0/
 //
 //=============================================================================
+#include <algorithm>
 #include <vector>
 #include <string.h>
 #include "ac/dynobj/managedobjectpool.h"
+#include "ac/dynobj/managedobjectheap.h"
 #include "debug/out.h"
 #include "util/string_utils.h"               // fputstring, etc
 #include "script/cc_common.h"
 #include "util/stream.h"
+#include "util/time_util.h"
 
 using namespace AGS::Common;
+using namespace AGS::Engine;
 
 const auto OBJECT_CACHE_MAGIC_NUMBER = 0xa30b;
 const auto SERIALIZE_BUFFER_SIZE = 10240;
 const auto GARBAGE_COLLECTION_INTERVAL = 1024;
+// How many handles to check between testing the time budget
+const auto GARBAGE_COLLECTION_TIME_CHECK = 256;
 const auto RESERVED_SIZE = 2048;
 
 int ManagedObjectPool::Remove(ManagedObject &o, bool force) {
@@ -31,8 +37,9 @@ int ManagedObjectPool::Remove(ManagedObject &o, bool force) {
     if (!(can_remove || force))
         return 0;
 
-    available_ids.push(o.handle);
-    handleByAddress.erase(o.addr);
+    available_ids.push_back(o.handle);
+    if (o.addrIndexed)
+        handleByAddress.erase(o.addr);
     ManagedObjectLog("Line %d Disposed managed object handle=%d", currentline, o.handle);
     o = ManagedObject();
     return 1;
@@ -74,8 +81,30 @@ int32_t ManagedObjectPool::SubRef(int32_t handle) {
     return newRefCount;
 }
 
-int32_t ManagedObjectPool::AddressToHandle(void *addr) {
+int32_t ManagedObjectPool::SubRefNoDispose(int32_t handle) {
+    if (handle < 1 || (size_t)handle >= objects.size()) { return 0; }
+    auto & o = objects[handle];
+    if (!o.isUsed()) { return 0; }
+
+    o.refCount--;
+    ManagedObjectLog("Line %d SubRefNoDispose: handle=%d new refcount=%d", currentline, handle, o.refCount);
+    return o.refCount;
+}
+
+int32_t ManagedObjectPool::AddressToHandle(void *addr, IScriptObject *mgr) {
     if (addr == nullptr) { return 0; }
+    if (mgr) {
+        const int32_t handle = mgr->GetHandle(addr);
+        if ((handle > 0) && ((size_t)handle < objects.size()) && (objects[handle].addr == addr)) {
+            return handle;
+        }
+    }
+    // Objects which keep their handle are allocated from the objects heap;
+    // others are registered in the lookup by address
+    const int32_t handle = objheap.FindHandle(addr);
+    if ((handle > 0) && ((size_t)handle < objects.size()) && (objects[handle].addr == addr)) {
+        return handle;
+    }
     auto it = handleByAddress.find(addr);
     if (it == handleByAddress.end()) { return 0; }
     return it->second;
@@ -104,31 +133,76 @@ ScriptValueType ManagedObjectPool::HandleToAddressAndManager(int32_t handle, voi
 }
 
 int ManagedObjectPool::RemoveObject(void *address) {
-    if (address == nullptr) { return 0; }
-    auto it = handleByAddress.find(address);
-    if (it == handleByAddress.end()) { return 0; }
+    const int32_t handle = AddressToHandle(address);
+    if (handle == 0) { return 0; }
 
-    auto & o = objects[it->second];
+    auto & o = objects[handle];
     return Remove(o, true);
 }
 
-void ManagedObjectPool::RunGarbageCollectionIfAppropriate()
+void ManagedObjectPool::RunGarbageCollectionIfAppropriate(std::chrono::microseconds budget)
 {
-    if (objectCreationCounter <= GARBAGE_COLLECTION_INTERVAL) { return; }
-    RunGarbageCollection();
-    objectCreationCounter = 0;
+    if (gcNextHandle == 0)
+    {
+        if (objectCreationCounter <= GARBAGE_COLLECTION_INTERVAL) { return; }
+        objectCreationCounter = 0;
+        gcNextHandle = 1;
+    }
+    RunGarbageCollectionStep(budget);
 }
 
-void ManagedObjectPool::RunGarbageCollection()
+bool ManagedObjectPool::RunGarbageCollectionStep(std::chrono::microseconds budget)
 {
-    for (int i = 1; i < nextHandle; i++) {
-        auto & o = objects[i];
-        if (!o.isUsed()) { continue; }
-        if (o.refCount < 1) {
-            Remove(o);
+    if (gcNextHandle == 0) { return true; }
+
+    // Sweep the handles in portions, testing the time after each one;
+    // objects added behind the sweep position are left for the next cycle
+    const auto deadline = Clock::now() + budget;
+    while (gcNextHandle < nextHandle) {
+        const int32_t portion_end = std::min(nextHandle, gcNextHandle + GARBAGE_COLLECTION_TIME_CHECK);
+        for (; gcNextHandle < portion_end; gcNextHandle++) {
+            CollectGarbage(objects[gcNextHandle]);
         }
+        if ((gcNextHandle < nextHandle) && (Clock::now() >= deadline)) {
+            return false;
+        }
+    }
+    EndGarbageCollection();
+    return true;
+}
+
+void ManagedObjectPool::RunGarbageCollection()
+{
+    if (gcNextHandle == 0) {
+        gcNextHandle = 1;
+    }
+    for (; gcNextHandle < nextHandle; gcNextHandle++) {
+        CollectGarbage(objects[gcNextHandle]);
     }
-    ManagedObjectLog("Ran garbage collection");
+    EndGarbageCollection();
+}
+
+void ManagedObjectPool::CollectGarbage(ManagedObject &o)
+{
+    if (!o.isUsed()) { return; }
+    if ((o.refCount < 1) && Remove(o)) {
+        gcCollected++;
+    } else {
+        gcRetained++;
+    }
+}
+
+void ManagedObjectPool::EndGarbageCollection()
+{
+    gcStats.Cycles++;
+    gcStats.TotalCollected += gcCollected;
+    gcStats.LastCollected = gcCollected;
+    gcStats.LastRetained = gcRetained;
+    Debug::Printf(kDbgGroup_ManObj, kDbgMsg_Debug, "Garbage collection: disposed %u, retained %u objects",
+        gcCollected, gcRetained);
+    gcNextHandle = 0;
+    gcCollected = 0u;
+    gcRetained = 0u;
 }
 
 int ManagedObjectPool::Add(int handle, void *address, IScriptObject *callback, ScriptValueType obj_type)
@@ -137,8 +211,10 @@ int ManagedObjectPool::Add(int handle, void *address, IScriptObject *callback, S
     assert(!o.isUsed());
 
     o = ManagedObject(obj_type, handle, address, callback);
-
-    handleByAddress.insert({address, handle});
+    if (!callback->SetHandle(address, handle)) {
+        handleByAddress.insert({address, handle});
+        o.addrIndexed = true;
+    }
     ManagedObjectLog("Allocated managed object type=%s, handle=%d, addr=%08X", callback->GetType(), handle, address);
     return handle;
 }
@@ -148,8 +224,8 @@ int ManagedObjectPool::AddObject(void *address, IScriptObject *callback, ScriptV
     int32_t handle;
 
     if (!available_ids.empty()) {
-        handle = available_ids.front();
-        available_ids.pop();
+        handle = available_ids.back();
+        available_ids.pop_back();
     } else {
         handle = nextHandle++;
         if ((size_t)handle >= objects.size()) {
@@ -277,21 +353,29 @@ int ManagedObjectPool::ReadFromDisk(Stream *in, ICCObjectCollectionReader *reade
     }
 
     // re-adjust next handles. (in case saved in random order)
-    available_ids = std::queue<int32_t>();
     nextHandle = 1;
+    gcNextHandle = 0;
+    gcCollected = gcRetained = 0u;
+    resetCount++;
 
     for (const auto &o : objects) {
         if (o.isUsed()) { 
             nextHandle = o.handle + 1;
         }
     }
-    for (int i = 1; i < nextHandle; i++) {
+    ResetAvailableIds();
+
+    return 0;
+}
+
+void ManagedObjectPool::ResetAvailableIds() {
+    available_ids.clear();
+    // push in reverse, so that the lower handles are reused first
+    for (int i = nextHandle - 1; i >= 1; i--) {
         if (!objects[i].isUsed()) {
-            available_ids.push(i);
+            available_ids.push_back(i);
         }
     }
-
-    return 0;
 }
 
 // de-allocate all objects
@@ -301,8 +385,11 @@ void ManagedObjectPool::reset() {
         if (!o.isUsed()) { continue; }
         Remove(o, true);
     }
-    available_ids = std::queue<int32_t>();
+    available_ids.clear();
     nextHandle = 1;
+    gcNextHandle = 0;
+    gcCollected = gcRetained = 0u;
+    resetCount++;
 }
 
 void ManagedObjectPool::TraverseManagedObjects(const String &type, PfnProcessObject proc)
@@ -317,6 +404,7 @@ void ManagedObjectPool::TraverseManagedObjects(const String &type, PfnProcessObj
 }
 
 ManagedObjectPool::ManagedObjectPool() : objectCreationCounter(0), nextHandle(1), available_ids(), objects(RESERVED_SIZE, ManagedObject()), handleByAddress() {
+    available_ids.reserve(RESERVED_SIZE);
     handleByAddress.reserve(RESERVED_SIZE);
 }
 
@@ -15,8 +15,8 @@
 #ifndef __CC_MANAGEDOBJECTPOOL_H
 #define __CC_MANAGEDOBJECTPOOL_H
 
+#include <chrono>
 #include <vector>
-#include <queue>
 #include <unordered_map>
 
 #include "ac/dynobj/cc_scriptobject.h"   // IScriptObject
@@ -28,6 +28,16 @@ namespace AGS { namespace Common { class Stream; }}
 using namespace AGS; // FIXME later
 
 struct ManagedObjectPool final {
+public:
+    // Garbage collection statistics, for diagnostics
+    struct GCStats
+    {
+        uint32_t Cycles = 0u;        // number of completed collection cycles
+        uint64_t TotalCollected = 0u; // objects disposed by all the cycles
+        uint32_t LastCollected = 0u; // objects disposed by the last cycle
+        uint32_t LastRetained = 0u;  // objects kept alive after the last cycle
+    };
+
 private:
     // TODO: find out if we can make handle size_t
     struct ManagedObject {
@@ -36,36 +46,73 @@ private:
         void *addr;
         IScriptObject *callback;
         int refCount;
+        // Whether the object is registered in the lookup by address
+        bool addrIndexed;
 
         bool isUsed() const { return obj_type != kScValUndefined; }
 
         ManagedObject() 
-            : obj_type(kScValUndefined), handle(0), addr(nullptr), callback(nullptr), refCount(0) {}
+            : obj_type(kScValUndefined), handle(0), addr(nullptr), callback(nullptr), refCount(0), addrIndexed(false) {}
         ManagedObject(ScriptValueType obj_type, int32_t handle, void *addr, IScriptObject * callback) 
-            : obj_type(obj_type), handle(handle), addr(addr), callback(callback), refCount(0) {}
+            : obj_type(obj_type), handle(handle), addr(addr), callback(callback), refCount(0), addrIndexed(false) {}
     };
 
     int objectCreationCounter;  // used to do garbage collection every so often
+    // Incremental garbage collection: the next handle to check,
+    // or 0 if no collection cycle is in progress
+    int32_t gcNextHandle {};
+    uint32_t gcCollected {}; // counts of the current cycle
+    uint32_t gcRetained {};
+    GCStats gcStats;
+    // Counts resets of the pool, which invalidate all the handles
+    uint32_t resetCount {};
 
     int32_t nextHandle {}; // TODO: manage nextHandle's going over INT32_MAX !
-    std::queue<int32_t> available_ids;
+    // Free handles, the next one to reuse is at the back
+    std::vector<int32_t> available_ids;
     std::vector<ManagedObject> objects;
+    // Lookup by address, for when the object's manager is not known;
+    // only has objects which cannot keep their own handle (see IScriptObject::SetHandle),
+    // the rest are found through the objects heap
     std::unordered_map<void*, int32_t> handleByAddress;
 
     int  Add(int handle, void *address, IScriptObject *callback, ScriptValueType obj_type);
     int  Remove(ManagedObject &o, bool force = false);
+    // Fills the list of free handles below nextHandle
+    void ResetAvailableIds();
+    // Runs full garbage collection, finishing any cycle in progress
     void RunGarbageCollection();
+    // Checks the handle for the garbage collection, disposing the unreferenced object
+    void CollectGarbage(ManagedObject &o);
+    // Ends the current garbage collection cycle and updates stats
+    void EndGarbageCollection();
 
 public:
 
     int32_t AddRef(int32_t handle);
     int CheckDispose(int32_t handle);
     int32_t SubRef(int32_t handle);
-    int32_t AddressToHandle(void *addr);
+    // Decrements the reference count, but leaves an unreferenced object
+    // for the garbage collection, instead of disposing it right away
+    int32_t SubRefNoDispose(int32_t handle);
+    // Finds the object's handle by its address; if the object's manager is known,
+    // then the handle may be retrieved from the object itself, which is faster
+    int32_t AddressToHandle(void *addr, IScriptObject *mgr = nullptr);
     void* HandleToAddress(int32_t handle);
     ScriptValueType HandleToAddressAndManager(int32_t handle, void *&object, IScriptObject *&manager);
     int RemoveObject(void *address);
-    void RunGarbageCollectionIfAppropriate();
+    // Starts a new garbage collection cycle if enough objects were created
+    // since the last one, and continues the current cycle for the given
+    // time budget; the cycle may span several calls
+    void RunGarbageCollectionIfAppropriate(std::chrono::microseconds budget = std::chrono::microseconds(500));
+    // Continues the current garbage collection cycle, if there's one,
+    // for the given time budget; returns true if the cycle is complete
+    bool RunGarbageCollectionStep(std::chrono::microseconds budget);
+    // Gets garbage collection statistics
+    const GCStats &GetGCStats() const { return gcStats; }
+    // Gets the number of times the pool was reset or restored from a save;
+    // any handles remembered before that are no longer valid
+    uint32_t GetResetCount() const { return resetCount; }
     int AddObject(void *address, IScriptObject *callback, ScriptValueType obj_type);
     int AddUnserializedObject(void *address, IScriptObject *callback, ScriptValueType obj_type, int handle);
     void WriteToDisk(Common::Stream *out);
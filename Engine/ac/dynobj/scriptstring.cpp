@@ -14,15 +14,38 @@
 #include "ac/dynobj/scriptstring.h"
 #include <stdlib.h>
 #include <string.h>
+#include <unordered_map>
 #include <allegro.h>
 #include "ac/string.h"
 #include "ac/dynobj/dynobj_manager.h"
+#include "ac/dynobj/managedobjectheap.h"
+#include "ac/dynobj/managedobjectpool.h"
 #include "util/stream.h"
 
 using namespace AGS::Common;
 
 ScriptString myScriptStringImpl;
 
+namespace
+{
+
+struct InternedString
+{
+    int32_t Handle;
+    const char *Text;
+};
+
+// Interned strings, found by the pointer to the source text
+std::unordered_map<const char*, InternedString> InternedStrings;
+// Pool's reset count at the time the interned strings were registered
+uint32_t InternedPoolResetCount = 0u;
+// Max number of interned strings; the source texts may come and go (for
+// instance, when the room scripts are reloaded), so the interned strings
+// are released altogether when there's too many of them
+const size_t MaxInternedStrings = 1024;
+
+} // namespace
+
 const char *ScriptString::GetType()
 {
     return "String";
@@ -30,10 +53,21 @@ const char *ScriptString::GetType()
 
 int ScriptString::Dispose(void *address, bool /*force*/)
 {
-    delete[] (static_cast<uint8_t*>(address) - MemHeaderSz);
+    objheap.Free(static_cast<uint8_t*>(address) - MemHeaderSz);
     return 1;
 }
 
+bool ScriptString::SetHandle(void *address, int32_t handle)
+{
+    ManagedObjectHeap::SetHandle(static_cast<uint8_t*>(address) - MemHeaderSz, handle);
+    return true;
+}
+
+int32_t ScriptString::GetHandle(const void *address)
+{
+    return ManagedObjectHeap::GetHandle(static_cast<const uint8_t*>(address) - MemHeaderSz);
+}
+
 size_t ScriptString::CalcSerializeSize(const void *address)
 {
     const Header &hdr = GetHeader(address);
@@ -50,7 +84,7 @@ void ScriptString::Serialize(const void* address, Stream *out)
 void ScriptString::Unserialize(int index, Stream *in, size_t /*data_sz*/)
 {
     size_t len = in->ReadInt32();
-    uint8_t *buf = new uint8_t[len + 1 + MemHeaderSz];
+    uint8_t *buf = static_cast<uint8_t*>(objheap.Allocate(len + 1 + MemHeaderSz));
     char *text_ptr = reinterpret_cast<char*>(buf + MemHeaderSz);
     in->Read(text_ptr, len + 1); // it was writing trailing 0 for some reason
     text_ptr[len] = 0; // for safety
@@ -68,22 +102,42 @@ DynObjectRef ScriptString::CreateObject(uint8_t *buf)
     int32_t handle = ccRegisterManagedObject(text_ptr, &myScriptStringImpl);
     if (handle == 0)
     {
-        delete[] buf;
+        objheap.Free(buf);
         return DynObjectRef();
     }
     return DynObjectRef(handle, text_ptr, &myScriptStringImpl);
 }
 
+ScriptString::Buffer::~Buffer()
+{
+    objheap.Free(_buf);
+}
+
+ScriptString::Buffer::Buffer(Buffer &&buf)
+    : _buf(buf._buf), _sz(buf._sz)
+{
+    buf._buf = nullptr;
+    buf._sz = 0u;
+}
+
+uint8_t *ScriptString::Buffer::Release()
+{
+    uint8_t *buf = _buf;
+    _buf = nullptr;
+    _sz = 0u;
+    return buf;
+}
+
 ScriptString::Buffer ScriptString::CreateBuffer(size_t len, size_t ulen)
 {
     assert(ulen <= len);
-    std::unique_ptr<uint8_t[]> buf(new uint8_t[len + 1 + MemHeaderSz]);
-    auto *header = reinterpret_cast<Header*>(buf.get());
+    uint8_t *buf = static_cast<uint8_t*>(objheap.Allocate(len + 1 + MemHeaderSz));
+    auto *header = reinterpret_cast<Header*>(buf);
     header->Length = len;
     header->ULength = ulen;
     header->LastCharIdx = 0;
     header->LastCharOff = 0;
-    return Buffer(std::move(buf), len + 1 + MemHeaderSz);
+    return Buffer(buf, len + 1 + MemHeaderSz);
 }
 
 DynObjectRef ScriptString::Create(const char *text)
@@ -95,12 +149,58 @@ DynObjectRef ScriptString::Create(const char *text)
     ustrlen2(text, &len, &ulen);
     auto buf = CreateBuffer(len, ulen);
     memcpy(buf.Get(), text, len + 1);
-    return CreateObject(buf._buf.release());
+    return CreateObject(buf.Release());
+}
+
+DynObjectRef ScriptString::CreateInterned(const char *text)
+{
+    if (!text)
+        return DynObjectRef();
+
+    if (pool.GetResetCount() != InternedPoolResetCount)
+    {
+        // All the managed objects were disposed, drop the invalid handles
+        InternedStrings.clear();
+        InternedPoolResetCount = pool.GetResetCount();
+    }
+
+    auto it = InternedStrings.find(text);
+    if (it != InternedStrings.end())
+    {
+        if (strcmp(it->second.Text, text) == 0)
+            return DynObjectRef(it->second.Handle, const_cast<char*>(it->second.Text), &myScriptStringImpl);
+        // The source text has changed, replace the interned string;
+        // the old one may still be used by a running script, so leave it
+        // for the garbage collector, in case this was the last reference
+        pool.SubRefNoDispose(it->second.Handle);
+        InternedStrings.erase(it);
+    }
+    else if (InternedStrings.size() >= MaxInternedStrings)
+    {
+        ReleaseInterned();
+    }
+
+    DynObjectRef ref = Create(text);
+    if (!ref)
+        return ref;
+    ccAddObjectReference(ref.Handle);
+    InternedStrings.insert(std::make_pair(text, InternedString{ ref.Handle, static_cast<const char*>(ref.Obj) }));
+    return ref;
+}
+
+void ScriptString::ReleaseInterned()
+{
+    if (pool.GetResetCount() == InternedPoolResetCount)
+    {
+        for (const auto &interned : InternedStrings)
+            pool.SubRefNoDispose(interned.second.Handle);
+    }
+    InternedStrings.clear();
 }
 
 DynObjectRef ScriptString::Create(Buffer &&strbuf)
 {
-    uint8_t *buf = strbuf._buf.release();
+    uint8_t *buf = strbuf.Release();
     auto *header = reinterpret_cast<Header*>(buf);
     char *text_ptr = reinterpret_cast<char*>(buf + MemHeaderSz);
     text_ptr[header->Length] = 0; // fixup in case buffer did not have one added
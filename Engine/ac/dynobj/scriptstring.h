@@ -37,19 +37,21 @@ public:
         friend ScriptString;
     public:
         Buffer() = default;
-        ~Buffer() = default;
-        Buffer(Buffer &&buf) = default;
+        ~Buffer();
+        Buffer(Buffer &&buf);
         // Returns a pointer to the beginning of a text buffer
-        char *Get() { return reinterpret_cast<char*>(_buf.get() + MemHeaderSz); }
+        char *Get() { return reinterpret_cast<char*>(_buf + MemHeaderSz); }
         // Returns size allocated for a text content (includes null pointer)
         size_t GetSize() const { return _sz - MemHeaderSz; }
 
     private:
-        Buffer(std::unique_ptr<uint8_t[]> &&buf, size_t buf_sz)
-            : _buf(std::move(buf)), _sz(buf_sz) {}
+        Buffer(uint8_t *buf, size_t buf_sz)
+            : _buf(buf), _sz(buf_sz) {}
+        // Releases the ownership over the allocated memory
+        uint8_t *Release();
 
-        std::unique_ptr<uint8_t[]> _buf;
-        size_t _sz;
+        uint8_t *_buf = nullptr; // allocated from the managed object heap
+        size_t _sz = 0u;
     };
 
 
@@ -76,10 +78,23 @@ public:
     // Create a new script string by taking ownership over the given buffer;
     // passed buffer variable becomes invalid after this call.
     static DynObjectRef Create(Buffer &&strbuf);
+    // Returns an interned script string with the copy of the given text:
+    // if a string was already created from the same text pointer, and the
+    // contents are still equal, then returns that string instead of a new one.
+    // Meant for the text which is converted to script strings repeatedly,
+    // such as script literals and translations. Interned strings are kept
+    // alive by an internal reference, until the interned strings are released.
+    static DynObjectRef CreateInterned(const char *text);
+    // Releases the internal references to the interned strings, and forgets them;
+    // the strings which are no longer referenced are left for the garbage
+    // collection. Must be called before the managed pool is saved
+    static void ReleaseInterned();
 
     const char *GetType() override;
     int Dispose(void *address, bool force) override;
     void Unserialize(int index, AGS::Common::Stream *in, size_t data_sz) override;
+    bool SetHandle(void *address, int32_t handle) override;
+    int32_t GetHandle(const void *address) override;
 
 private:
     friend ScriptString::Buffer;
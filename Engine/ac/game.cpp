@@ -926,6 +926,11 @@ int Game_InBlockingWait()
     return IsInWaitMode();
 }
 
+bool Game_GetSaveInProgress()
+{
+    return is_saving_game();
+}
+
 void Game_PrecacheSprite(int sprnum)
 {
     const auto tp_start = FastClock::now();
@@ -982,7 +987,7 @@ void Game_ScanSaveSlots(void *dest_arr, int min_slot, int max_slot, int save_sor
     can_run_delayed_command();
     if (inside_script)
     {
-        int handle = ccGetObjectHandleFromAddress(dest_arr);
+        int handle = ccGetObjectHandleFromAddress(dest_arr, &globalDynamicArray);
         ccAddObjectReference(handle); // add internal handle to prevent disposal
         curscript->QueueAction(PostScriptAction(ePSAScanSaves, handle, min_slot, max_slot, save_sort, sort_dir, user_param, "ScanSaveSlots"));
         return;
@@ -1023,17 +1028,12 @@ static std::unique_ptr<Common::Bitmap> create_savegame_screenshot()
     return create_game_screenshot(play.screenshot_width, play.screenshot_height, game.options[OPT_SAVESCREENSHOTLAYER]);
 }
 
-void save_game(int slotn, const String &descript, std::unique_ptr<Bitmap> &&image)
-{
-    pl_run_plugin_hooks(kPluginEvt_PreSaveGame, 0);
+// Slot of the save which is being written in background, -1 if none
+static int async_save_slot = -1;
 
-    String nametouse = get_save_game_path(slotn);
-    if (!image && (game.options[OPT_SAVESCREENSHOT] != 0))
-        image = create_savegame_screenshot();
-
-    HSaveError err = SaveGame(nametouse, descript, image.get(),
-             (SaveCmpSelection)(kSaveCmp_All & ~(game.options[OPT_SAVECOMPONENTSIGNORE] & kSaveCmp_ScriptIgnoreMask)),
-             usetup.CompressSaves);
+// Reports the save's result, and runs "after save" callbacks
+static void on_game_saved(int slotn, HSaveError err)
+{
     if (!err)
     {
         // FIXME: left this original Display call for the time being,
@@ -1041,13 +1041,67 @@ void save_game(int slotn, const String &descript, std::unique_ptr<Bitmap> &&imag
         // either pass error code to kScriptEvent_GameSaved, or have a separate event for errors
         Display("ERROR: Unable to open savegame file for writing!");
         Debug::Printf(kDbgMsg_Error, "Save game failed: %s", err->FullMessage().GetCStr());
+        pl_run_plugin_hooks(kPluginEvt_PostSaveGame, -1);
         return;
     }
 
+    pl_run_plugin_hooks(kPluginEvt_PostSaveGame, slotn);
     // call "After Save" event callback
     run_on_event(kScriptEvent_GameSaved, slotn);
 }
 
+void save_game(int slotn, const String &descript, std::unique_ptr<Bitmap> &&image)
+{
+    // Finish the previous background save first, so that events come in order
+    complete_async_save();
+
+    pl_run_plugin_hooks(kPluginEvt_PreSaveGame, 0);
+
+    String nametouse = get_save_game_path(slotn);
+    if (!image && (game.options[OPT_SAVESCREENSHOT] != 0))
+        image = create_savegame_screenshot();
+
+    const SaveCmpSelection select_cmp =
+        (SaveCmpSelection)(kSaveCmp_All & ~(game.options[OPT_SAVECOMPONENTSIGNORE] & kSaveCmp_ScriptIgnoreMask));
+    if (usetup.AsyncSaves)
+    {
+        HSaveError err = SaveGameAsync(nametouse, descript, std::move(image), select_cmp,
+            usetup.CompressSaves, usetup.IncrementalSaves);
+        if (err)
+            async_save_slot = slotn; // the rest is done in update_async_save
+        else
+            on_game_saved(slotn, err);
+        return;
+    }
+
+    HSaveError err = SaveGame(nametouse, descript, image.get(), select_cmp,
+             usetup.CompressSaves, usetup.IncrementalSaves);
+    on_game_saved(slotn, err);
+}
+
+void update_async_save()
+{
+    HSaveError err;
+    if ((async_save_slot < 0) || !GetAsyncSaveResult(err))
+        return;
+    const int slotn = async_save_slot;
+    async_save_slot = -1;
+    on_game_saved(slotn, err);
+}
+
+void complete_async_save()
+{
+    if (async_save_slot < 0)
+        return;
+    WaitForAsyncSave();
+    update_async_save();
+}
+
+bool is_saving_game()
+{
+    return async_save_slot >= 0;
+}
+
 int gameHasBeenRestored = 0;
 int oldeip;
 
@@ -1189,6 +1243,8 @@ bool try_restore_save(int slot, bool startup)
 
 bool try_restore_save(const Common::String &path, int slot, bool startup)
 {
+    complete_async_save();
+
     bool data_overwritten;
     Debug::Printf(kDbgMsg_Info, "Restoring saved game '%s'", path.GetCStr());
     HSaveError err = load_game(path, slot, startup, data_overwritten);
@@ -2082,6 +2138,11 @@ RuntimeScriptValue Sc_Game_InBlockingWait(const RuntimeScriptValue *params, int3
     API_SCALL_BOOL(Game_InBlockingWait);
 }
 
+RuntimeScriptValue Sc_Game_GetSaveInProgress(const RuntimeScriptValue *params, int32_t param_count)
+{
+    API_SCALL_BOOL(Game_GetSaveInProgress);
+}
+
 RuntimeScriptValue Sc_Game_PrecacheSprite(const RuntimeScriptValue *params, int32_t param_count)
 {
     API_SCALL_VOID_PINT(Game_PrecacheSprite);
@@ -2185,6 +2246,7 @@ void RegisterGameAPI()
         { "Game::get_IgnoreUserInputAfterTextTimeoutMs",  API_FN_PAIR(Game_GetIgnoreUserInputAfterTextTimeoutMs) },
         { "Game::set_IgnoreUserInputAfterTextTimeoutMs",  API_FN_PAIR(Game_SetIgnoreUserInputAfterTextTimeoutMs) },
         { "Game::get_InBlockingWait",                     API_FN_PAIR(Game_InBlockingWait) },
+        { "Game::get_SaveInProgress",                     API_FN_PAIR(Game_GetSaveInProgress) },
         { "Game::get_InSkippableCutscene",                API_FN_PAIR(Game_GetInSkippableCutscene) },
         { "Game::get_InventoryItemCount",                 API_FN_PAIR(Game_GetInventoryItemCount) },
         { "Game::get_MinimumTextDisplayTimeMs",           API_FN_PAIR(Game_GetMinimumTextDisplayTimeMs) },
@@ -175,6 +175,12 @@ void shutdown_game_state();
 // Free all the memory associated with the game
 void unload_game();
 void save_game(int slotn, const Common::String &descript, std::unique_ptr<Common::Bitmap> &&image = nullptr);
+// Checks if the background save has completed, and runs "after save" callbacks
+void update_async_save();
+// Waits for the background save to complete, and runs "after save" callbacks
+void complete_async_save();
+// Tells if the game is being saved in background
+bool is_saving_game();
 std::unique_ptr<Common::Bitmap> create_game_screenshot(int width, int height, int layers);
 bool read_savedgame_description(const Common::String &savedgame, Common::String &description);
 std::unique_ptr<Common::Bitmap> read_savedgame_screenshot(const Common::String &savedgame);
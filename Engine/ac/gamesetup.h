@@ -90,6 +90,7 @@ struct GameConfig
     // Display configuration
     DisplayModeSetup Display;
     String  SoftwareRenderDriver;      // Driver for the final output when using Software renderer
+    int     SoftwareRenderThreads = 1; // Number of threads for drawing sprites with Software renderer, 0 = auto
 
     // Graphic options (additional)
     bool    RenderAtScreenRes    = false; // render sprites at screen resolution, as opposed to native one
@@ -102,6 +103,8 @@ struct GameConfig
     bool    AudioEnabled         = false;
     String  AudioDriverID;
     bool    UseVoicePack         = false;
+    int     AudioDecoderThreads  = 1; // number of threads decoding sounds ahead, 0 = decode on the audio thread
+    int     AudioDecodeAhead     = 4; // max number of sound chunks decoded ahead, per sound
 
     // Control options
     bool    MouseAutoLock        = false;
@@ -128,7 +131,10 @@ struct GameConfig
     // Misc engine options
     bool    LoadLatestSave       = false; // load latest saved game on launch
     bool    CompressSaves        = false;
+    bool    IncrementalSaves     = false; // keep compressed save components in memory, reuse unchanged ones
+    bool    AsyncSaves           = false; // write saves on a background thread
     bool    ClearCacheOnRoomChange = false; // for low-end devices: clear resource caches on room change
+    bool    MemoryMapAssets      = true; // map game data files into memory, where supported
     bool    RunInBackground      = false; // whether run on background, when game is switched out
     bool    ShowFps              = false;
 
@@ -148,6 +154,11 @@ struct GameSetup : public GameConfig
     // Disables handling exceptions and displaying exception message on exit
     bool   DisableExceptionHandling = false;
 
+    // Benchmark run: number of frames to run, 0 disables benchmark
+    uint32_t BenchmarkFrames = 0u;
+    String  BenchmarkOutput; // file to write per-frame timings to
+    String  BenchmarkInput;  // file with the input to replay
+
     // Game data paths, some are calculated from enviroment,
     // other may be use-defined or passed from IDE when doing a test run.
     String  StartupDir; // directory where the default game config is located (usually same as MainDataDir)
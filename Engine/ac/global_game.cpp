@@ -47,6 +47,7 @@
 #include "debug/debugger.h"
 #include "debug/debug_log.h"
 #include "font/fonts.h"
+#include "game/savegame.h"
 #include "gui/guidialog.h"
 #include "main/engine.h"
 #include "main/game_start.h"
@@ -116,6 +117,8 @@ void CopySaveSlot(int old_save, int new_save)
     if (old_save == new_save)
         return; // cannot copy into itself
 
+    // Either slot may be still written by the background save
+    WaitForAsyncSave();
     String old_filename = get_save_game_path(old_save);
     String new_filename = get_save_game_path(new_save);
     File::CopyFile(old_filename, new_filename, true);
@@ -126,6 +129,8 @@ void MoveSaveSlot(int old_save, int new_save)
     if (old_save == new_save)
         return; // cannot move into itself
 
+    // Either slot may be still written by the background save
+    WaitForAsyncSave();
     String old_filename = get_save_game_path(old_save);
     String new_filename = get_save_game_path(new_save);
     File::RenameFile(old_filename, new_filename);
@@ -179,6 +184,8 @@ void SaveGameSlot2(int slnum, const char *descript)
 
 void DeleteSaveSlot(int slnum)
 {
+    // The slot may be still written by the background save
+    WaitForAsyncSave();
     String save_filename = get_save_game_path(slnum);
     File::DeleteFile(save_filename);
 
@@ -84,6 +84,13 @@ int GetObjectIDAtRoom(int roomx, int roomy)
         if (objs[aa].view != RoomObject::NoView)
             isflipped = views[objs[aa].view].loops[objs[aa].loop].frames[objs[aa].frame].flags & VFLG_FLIPSPRITE;
 
+        // do the cheap tests first, and only get the image for the pixel test
+        // if this object may actually be the one on top
+        int usebasel = objs[aa].get_baseline();   
+        if (usebasel < bestshotyp) continue;
+        if (!is_pos_in_sprite_box(roomx, roomy, xxx, yyy - spHeight, spWidth, spHeight))
+            continue;
+
         bool is_original;
         Bitmap *theImage = GetObjectImage(aa, &is_original);
         if (!is_original)
@@ -93,9 +100,6 @@ int GetObjectIDAtRoom(int roomx, int roomy)
             spWidth, spHeight, isflipped, is_original) == FALSE)
             continue;
 
-        int usebasel = objs[aa].get_baseline();   
-        if (usebasel < bestshotyp) continue;
-
         bestshotwas = aa;
         bestshotyp = usebasel;
     }
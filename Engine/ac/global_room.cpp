@@ -74,7 +74,7 @@ void NewRoom(int nrnum) {
 
     if (displayed_room < 0) {
         // called from game_start; change the room where the game will start
-        playerchar->room = nrnum;
+        set_character_room(playerchar, nrnum);
         return;
     }
 
@@ -287,7 +287,7 @@ const char* Object_GetName_New(ScriptObject *objj) {
     if (!is_valid_object(objj->id))
         quit("!Object.Name: invalid object number");
 
-    return CreateNewScriptString(get_translation(croom->obj[objj->id].name.GetCStr()));
+    return CreateInternedScriptString(get_translation(croom->obj[objj->id].name.GetCStr()));
 }
 
 void Object_SetName(ScriptObject *objj, const char *newName) {
@@ -471,9 +471,10 @@ void move_object(int objj, int tox, int toy, int speed, int ignwal) {
 
     const int mslot = objj + 1;
     MaskRouteFinder *pathfind = get_room_pathfinder();
-    pathfind->SetWalkableArea(prepare_walkable_areas(-1), thisroom.MaskResolution);
-    if (Pathfinding::FindRoute(mls[mslot], pathfind, src_x, src_y, dst_x, dst_y,
-        speed, speed, false, ignwal != 0))
+    uint64_t mask_key;
+    pathfind->SetWalkableArea(prepare_walkable_areas(-1, &mask_key), thisroom.MaskResolution);
+    if (Pathfinding::FindRoute(mls[mslot], pathfind, get_room_route_cache(), mask_key,
+        src_x, src_y, dst_x, dst_y, speed, speed, false, ignwal != 0))
     {
         objs[objj].moving = mslot;
         convert_move_path_to_data_resolution(mls[mslot]);
@@ -603,6 +604,13 @@ int isposinbox(int mmx,int mmy,int lf,int tp,int rt,int bt) {
     else return FALSE;
 }
 
+bool is_pos_in_sprite_box(int xx, int yy, int arx, int ary, int spww, int sphh) {
+    // is_pos_in_sprite uses the image's own size in this case
+    if ((spww == 0) || (sphh == 0))
+        return true;
+    return isposinbox(xx,yy,arx,ary,arx+spww,ary+sphh) != FALSE;
+}
+
 // xx,yy is the position in room co-ordinates that we are checking
 // arx,ary,spww,sphh are the sprite's bounding box
 // bitmap_original tells whether bitmap is an original sprite, or transformed version
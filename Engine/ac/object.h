@@ -90,6 +90,10 @@ void    update_object_scale(int &res_zoom, int &res_width, int &res_height,
 void    move_object(int objj,int tox,int toy,int spee,int ignwal);
 void    get_object_blocking_rect(int objid, int *x1, int *y1, int *width, int *y2);
 int     isposinbox(int mmx,int mmy,int lf,int tp,int rt,int bt);
+// Tests if the position may be inside the sprite, checking only its bounding box;
+// zero spww or sphh means that the size is not known yet, and the test passes.
+// This lets skip getting the sprite image for the drawables that are not hit.
+bool    is_pos_in_sprite_box(int xx, int yy, int arx, int ary, int spww, int sphh);
 // xx,yy is the position in room co-ordinates that we are checking
 // arx,ary,spww,sphh are the sprite's bounding box (including sprite scaling);
 // bitmap_original tells whether bitmap is an original sprite, or transformed version
@@ -43,6 +43,7 @@
 #include "ac/screen.h"
 #include "ac/string.h"
 #include "ac/system.h"
+#include "ac/view.h"
 #include "ac/walkablearea.h"
 #include "ac/walkbehind.h"
 #include "ac/dynobj/scriptobject.h"
@@ -88,6 +89,7 @@ extern EnterNewRoomState in_new_room, new_room_was;
 extern ScriptHotspot scrHotspot[MAX_ROOM_HOTSPOTS];
 extern int in_leaves_screen;
 extern CharacterInfo*playerchar;
+extern std::vector<ViewStruct> views;
 extern std::vector<CharacterExtras> charextra;
 extern int starting_room;
 extern IDriverDependantBitmap* roomBackgroundBmp;
@@ -98,6 +100,8 @@ extern CCHotspot ccDynamicHotspot;
 extern CCObject ccDynamicObject;
 
 std::unique_ptr<MaskRouteFinder> room_pathfinder;
+// Found paths, reused by the characters and objects moving in the same room
+std::unique_ptr<RouteCache> room_route_cache;
 RGB_MAP rgb_table;  // for 256-col antialiasing
 int new_room_flags=0;
 int gs_to_newroom=-1;
@@ -483,6 +487,51 @@ HError LoadRoomScript(RoomStruct *room, int newnum)
     return HError::None();
 }
 
+// Adds sprites of all the view's frames to the list
+static void add_view_sprites(int view, std::vector<sprkey_t> &sprites)
+{
+    if (view < 0 || view >= game.numviews)
+        return;
+    for (const auto &loop : views[view].loops)
+    {
+        for (int f = 0; f < loop.numFrames; ++f)
+            sprites.push_back(loop.frames[f].pic);
+    }
+}
+
+// Queues sprites used by the room objects and characters in this room
+// for loading in background, so that they are likely ready by the time
+// they are first drawn. Currently displayed sprites go first, as the queue
+// may be cut short if the sprite cache does not have enough free space.
+static void prefetch_room_sprites()
+{
+    std::vector<sprkey_t> sprites;
+    for (uint32_t i = 0; i < croom->numobj; ++i)
+    {
+        if (objs[i].on)
+            sprites.push_back(objs[i].num);
+    }
+    for (int i : get_room_characters(displayed_room))
+    {
+        const CharacterInfo &chi = game.chars[i];
+        if ((chi.view < 0) || (chi.view >= game.numviews))
+            continue;
+        const ViewStruct &view = views[chi.view];
+        if ((chi.loop < view.numLoops) && (chi.frame < view.loops[chi.loop].numFrames))
+            sprites.push_back(view.loops[chi.loop].frames[chi.frame].pic);
+    }
+    for (uint32_t i = 0; i < croom->numobj; ++i)
+    {
+        if (objs[i].view != RoomObject::NoView)
+            add_view_sprites(objs[i].view, sprites);
+    }
+    for (int i : get_room_characters(displayed_room))
+    {
+        add_view_sprites(game.chars[i].view, sprites);
+    }
+    spriteset.PrefetchSprites(sprites);
+}
+
 static void reset_temp_room()
 {
     troom = RoomStatus();
@@ -760,18 +809,20 @@ void load_new_room(int newnum, CharacterInfo*forchar) {
                     (forchar->prevroom == newnum))
                     // the player went back to the previous room, so make sure
                     // the following character is still there
-                    game.chars[ff].room = newnum;
+                    set_character_room(&game.chars[ff], newnum);
                 else
-                    game.chars[ff].room = game.chars[charextra[ff].following].room;
+                    set_character_room(&game.chars[ff], game.chars[charextra[ff].following].room);
             }
         }
 
         forchar->prevroom=forchar->room;
-        forchar->room=newnum;
+        set_character_room(forchar, newnum);
         // only stop moving if it's a new room, not a restore game
         for (int cc=0;cc<game.numcharacters;cc++)
             StopMoving(cc);
     }
+    // resync room lists, in case the rooms were changed bypassing them
+    reset_room_characters();
 
     roominst=nullptr;
     if (debug_flags & DBG_NOSCRIPT) ;
@@ -921,6 +972,7 @@ void load_new_room(int newnum, CharacterInfo*forchar) {
         forchar->frame=0;   // make him standing
     }
     color_map = nullptr;
+    prefetch_room_sprites();
 
     set_our_eip(209);
     generate_light_table();
@@ -1116,11 +1168,20 @@ void init_room_pathfinder()
 {
     if (!room_pathfinder)
         room_pathfinder = Pathfinding::CreateDefaultMaskPathfinder(loaded_game_file_version);
+    // Legacy pathfinder keeps some state in between searches, which may
+    // affect results, so we only cache paths found by the modern one
+    if (loaded_game_file_version >= kGameVersion_350)
+    {
+        if (!room_route_cache)
+            room_route_cache.reset(new RouteCache());
+        room_route_cache->Clear();
+    }
 }
 
 void dispose_room_pathfinder()
 {
     room_pathfinder.reset();
+    room_route_cache.reset();
 }
 
 MaskRouteFinder *get_room_pathfinder()
@@ -1128,6 +1189,11 @@ MaskRouteFinder *get_room_pathfinder()
     return room_pathfinder.get();
 }
 
+RouteCache *get_room_route_cache()
+{
+    return room_route_cache.get();
+}
+
 // coordinate conversion (data) ---> game ---> (room mask)
 int room_to_mask_coord(int coord)
 {
@@ -60,6 +60,9 @@ void  init_room_pathfinder();
 void  dispose_room_pathfinder();
 // Gets current room's pathfinder object
 AGS::Engine::MaskRouteFinder *get_room_pathfinder();
+// Gets current room's cache of found paths; returns null if the
+// current pathfinder does not support caching
+AGS::Engine::RouteCache *get_room_route_cache();
 
 // Following functions convert coordinates between room resolution and region mask.
 // Region masks can be 1:N of the room size: 1:1, 1:2 etc.
@@ -115,6 +115,32 @@ bool FindRoute(MoveList &mls, IRouteFinder *finder, int srcx, int srcy, int dstx
     return CalculateMoveList(mls, path, move_speed_x, move_speed_y, ignore_walls ? kMoveStage_Direct : 0);
 }
 
+bool FindRoute(MoveList &mls, MaskRouteFinder *finder, RouteCache *cache, uint64_t mask_key,
+    int srcx, int srcy, int dstx, int dsty,
+    int move_speed_x, int move_speed_y, bool exact_dest, bool ignore_walls)
+{
+    // Straight line paths are trivial, no reason to cache them
+    if (!cache || ignore_walls)
+        return FindRoute(mls, finder, srcx, srcy, dstx, dsty, move_speed_x, move_speed_y, exact_dest, ignore_walls);
+
+    // MaskRouteFinder works in mask cells, so any positions within the same
+    // cells give identical resulting path
+    const int scale = finder->GetCoordScale();
+    const RouteKey key(mask_key, Point(srcx / scale, srcy / scale), Point(dstx / scale, dsty / scale),
+        exact_dest, ignore_walls);
+    auto route = cache->Find(key);
+    if (!route)
+    {
+        route = std::make_shared<RoutePath>();
+        route->Found = finder->FindRoute(route->Path, srcx, srcy, dstx, dsty, exact_dest, ignore_walls);
+        cache->Put(key, route);
+    }
+
+    if (!route->Found)
+        return false;
+    return CalculateMoveList(mls, route->Path, move_speed_x, move_speed_y, 0);
+}
+
 // Converts input moving speed to a fixed-point representation.
 // Negative move speeds become fractional, e.g. -2 = 1/2 speed.
 inline fixed InputSpeedToFixed(int speed_val)
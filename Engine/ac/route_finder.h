@@ -18,6 +18,7 @@
 #include <vector>
 #include "ac/game_version.h"
 #include "util/geometry.h"
+#include "util/resourcecache.h"
 
 class MoveList;
 
@@ -68,6 +69,8 @@ public:
     // Tells whether the current position is walkable
     bool IsWalkableAt(int x, int y) override;
 
+    // Gets the coordinate scale factor, which input coordinates are divided by
+    int  GetCoordScale() const { return _coordScale; }
     // Assign a walkable mask, and an optional coordinate scale factor which will be used
     // to convert (divide) input coordinates, and resulting path back (multiply).
     // Note that this may make routefinder to generate additional data, taking more time.
@@ -86,6 +89,88 @@ protected:
     int _coordScale = 1;
 };
 
+// RouteKey: identifies a navigation path stored in the RouteCache.
+struct RouteKey
+{
+    // A value identifying the walkable mask contents, that must change
+    // whenever any part of the mask changes (e.g. mask version + blocking rects hash)
+    uint64_t MaskKey = 0u;
+    // Source and destination cells on the mask
+    Point Src;
+    Point Dst;
+    // Pathfinding flags
+    bool ExactDest = false;
+    bool IgnoreWalls = false;
+
+    RouteKey() = default;
+    RouteKey(uint64_t mask_key, const Point &src, const Point &dst, bool exact_dest, bool ignore_walls)
+        : MaskKey(mask_key), Src(src), Dst(dst), ExactDest(exact_dest), IgnoreWalls(ignore_walls) {}
+
+    bool operator ==(const RouteKey &other) const
+    {
+        return MaskKey == other.MaskKey && Src == other.Src && Dst == other.Dst &&
+            ExactDest == other.ExactDest && IgnoreWalls == other.IgnoreWalls;
+    }
+};
+
+struct RouteKeyHash
+{
+    size_t operator()(const RouteKey &key) const
+    {
+        uint64_t hash = key.MaskKey;
+        hash = hash * 31 + static_cast<uint32_t>(key.Src.X);
+        hash = hash * 31 + static_cast<uint32_t>(key.Src.Y);
+        hash = hash * 31 + static_cast<uint32_t>(key.Dst.X);
+        hash = hash * 31 + static_cast<uint32_t>(key.Dst.Y);
+        hash = hash * 4 + (key.ExactDest ? 2 : 0) + (key.IgnoreWalls ? 1 : 0);
+        return static_cast<size_t>(hash ^ (hash >> 32));
+    }
+};
+
+// RoutePath: a cached pathfinding result; failed searches are stored too
+struct RoutePath
+{
+    bool Found = false;
+    std::vector<Point> Path;
+};
+
+// RouteCache: stores recently found navigation paths, tracks use history
+// with MRU list. Lets multiple agents moving in the same area, such as
+// a group of followers, reuse the same route instead of searching again.
+class RouteCache final :
+    public Common::ResourceCache<RouteKey, std::shared_ptr<RoutePath>, size_t, RouteKeyHash>
+{
+public:
+    // Default limit is in bytes, roughly a few hundred of average paths
+    RouteCache(size_t max_size = 64 * 1024) : ResourceCache(max_size) {}
+
+    // Gets hits and misses counts, for diagnostics
+    uint32_t GetHits() const { return _hits; }
+    uint32_t GetMisses() const { return _misses; }
+    void ResetStats() { _hits = 0u; _misses = 0u; }
+
+    // Looks up the path in cache, counts hit or miss
+    std::shared_ptr<RoutePath> Find(const RouteKey &key)
+    {
+        auto path = Get(key);
+        if (path)
+            _hits++;
+        else
+            _misses++;
+        return path;
+    }
+
+private:
+    size_t CalcSize(const std::shared_ptr<RoutePath> &item) override
+    {
+        assert(item);
+        return item ? sizeof(RoutePath) + item->Path.size() * sizeof(Point) : 0u;
+    }
+
+    uint32_t _hits = 0u;
+    uint32_t _misses = 0u;
+};
+
 //
 // Various additional pathfinding functions and helpers.
 // Manages converting navigation paths into MoveLists.
@@ -97,6 +182,13 @@ namespace Pathfinding
     // Find route using a provided IRouteFinder, and calculate the MoveList using move speeds
     bool FindRoute(MoveList &mls, IRouteFinder *finder, int srcx, int srcy, int dstx, int dsty,
         int move_speed_x, int move_speed_y, bool exact_dest, bool ignore_walls);
+    // Find route using a provided MaskRouteFinder, first looking it up in the RouteCache,
+    // then calculate the MoveList using move speeds. If cache is null, then always searches anew.
+    // mask_key must identify the contents of the finder's current walkable mask.
+    // NOTE: cache may only be used with pathfinders that give same result for same input.
+    bool FindRoute(MoveList &mls, MaskRouteFinder *finder, RouteCache *cache, uint64_t mask_key,
+        int srcx, int srcy, int dstx, int dsty,
+        int move_speed_x, int move_speed_y, bool exact_dest, bool ignore_walls);
     // Calculate the MoveList from the given navigation path and move speeds.
     bool CalculateMoveList(MoveList &mls, const std::vector<Point> path, int move_speed_x, int move_speed_y, uint8_t stage_flag);
     // Append a waypoint to the move list, skip pathfinding
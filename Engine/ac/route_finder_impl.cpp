@@ -45,15 +45,30 @@ void JPSRouteFinder::Configure(GameDataVersion /*game_ver*/)
 
 void JPSRouteFinder::OnSetWalkableArea()
 {
+    SyncNavWalkablearea();
 }
 
 void JPSRouteFinder::SyncNavWalkablearea()
 {
-    // FIXME: this is dumb, but...
-    nav.Resize(_walkablearea->GetWidth(), _walkablearea->GetHeight());
-
-    for (int y = 0; y < _walkablearea->GetHeight(); y++)
+    if (!_walkablearea)
+        return;
+
+    const uint8_t *mask_data = _walkablearea->GetData();
+    const int width = _walkablearea->GetWidth();
+    const int height = _walkablearea->GetHeight();
+    const int pitch = _walkablearea->GetLineLength();
+    if ((mask_data == _navMaskData) && (width == _navMaskWidth) &&
+        (height == _navMaskHeight) && (pitch == _navMaskPitch))
+        return; // same rows, nothing to update
+
+    nav.Resize(width, height);
+    for (int y = 0; y < height; y++)
         nav.SetMapRow(y, _walkablearea->GetScanLine(y));
+
+    _navMaskData = mask_data;
+    _navMaskWidth = width;
+    _navMaskHeight = height;
+    _navMaskPitch = pitch;
 }
 
 bool JPSRouteFinder::CanSeeFromImpl(int srcx, int srcy, int dstx, int dsty, int *lastcx, int *lastcy)
@@ -62,7 +77,6 @@ bool JPSRouteFinder::CanSeeFromImpl(int srcx, int srcy, int dstx, int dsty, int
     int last_valid_x = srcx, last_valid_y = srcy;
     if ((srcx != dstx) || (srcy != dsty))
     {
-        SyncNavWalkablearea();
         result = !nav.TraceLine(srcx, srcy, dstx, dsty, last_valid_x, last_valid_y);
     }
     if (lastcx)
@@ -77,8 +91,6 @@ bool JPSRouteFinder::FindRouteJPS(std::vector<Point> &nav_path, int fromx, int f
     if (!_walkablearea)
         return false;
 
-    SyncNavWalkablearea();
-
     path.clear();
     cpath.clear();
 
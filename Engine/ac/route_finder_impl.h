@@ -43,11 +43,21 @@ private:
     bool FindRouteImpl(std::vector<Point> &path, int srcx, int srcy, int dstx, int dsty,
         bool exact_dest, bool ignore_walls)  override;
 
+    // Updates navigation map to reference the current walkable mask;
+    // does nothing if the mask's memory layout did not change since the last sync
     void SyncNavWalkablearea();
     bool FindRouteJPS(std::vector<Point> &nav_path, int fromx, int fromy, int destx, int desty);
 
     Navigation &nav; // declare as reference, because we must hide real Navigation decl here
     std::vector<int> path, cpath;
+    // Mask layout that the navigation map was last synced with;
+    // Navigation references mask rows directly, so any changes to the mask
+    // pixels are seen immediately, and we only have to resync when the
+    // mask gets reallocated or resized.
+    const uint8_t *_navMaskData = nullptr;
+    int _navMaskWidth = 0;
+    int _navMaskHeight = 0;
+    int _navMaskPitch = 0;
 };
 
 } // namespace Engine
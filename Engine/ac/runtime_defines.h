@@ -226,6 +226,7 @@ enum PluginEventID
     kPluginEvt_PreSaveGame      = 0x00020000,
     kPluginEvt_PostRestoreGame  = 0x00040000,
     kPluginEvt_PostRoomDraw     = 0x00080000,
+    kPluginEvt_PostSaveGame     = 0x00100000,
 };
 
 #endif // __AC_RUNTIMEDEFINES_H
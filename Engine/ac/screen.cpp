@@ -28,6 +28,7 @@
 #include "platform/base/agsplatformdriver.h"
 #include "plugin/plugin_engine.h"
 #include "gfx/bitmap.h"
+#include "gfx/blend_kernels.h"
 #include "gfx/graphicsdriver.h"
 
 using namespace AGS::Common;
@@ -281,8 +282,13 @@ public:
         if (game.color_depth > 1)
         {
             _bmpBuff->Fill(_clearCol);
-            set_trans_blender(0, 0, 0, _fadein ? _alpha : 255 - _alpha);
-            _bmpBuff->TransBlendBlt(_bmpFrame.get(), _view.Left, _view.Top);
+            const int alpha = _fadein ? _alpha : 255 - _alpha;
+            if (!BlendKernels::DrawTransSprite(_bmpBuff, _bmpFrame.get(), _view.Left, _view.Top,
+                    BlendKernels::kBlendKernel_Trans24, alpha))
+            {
+                set_trans_blender(0, 0, 0, alpha);
+                _bmpBuff->TransBlendBlt(_bmpFrame.get(), _view.Left, _view.Top);
+            }
             render_to_screen();
         }
         else
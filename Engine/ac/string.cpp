@@ -237,7 +237,30 @@ int String_GetChars(const char *thisString, int index) {
     {
         off = uoffset(thisString + header.LastCharOff, index - header.LastCharIdx) + header.LastCharOff;
     }
-    // TODO: support faster reverse iteration too? that would require reverse-dir uoffset
+    else if (header.LastCharIdx - index < index)
+    {
+        // Closer to the last requested char than to the beginning, so step back.
+        // Any byte other than the UTF-8 continuation byte always starts a char,
+        // so step back to such byte, and count chars from it with the same
+        // decoder as uoffset uses; this gives same results on malformed text.
+        int back = header.LastCharIdx - index;
+        off = header.LastCharOff;
+        while (back > 0)
+        {
+            int start = off;
+            do { --start; } while ((start > 0) && ((thisString[start] & 0xC0) == 0x80));
+            int count = 0;
+            for (const char *ptr = thisString + start; ptr < thisString + off; ++count)
+                ugetxc(&ptr);
+            if (count > back)
+            {
+                off = uoffset(thisString + start, count - back) + start;
+                break;
+            }
+            back -= count;
+            off = start;
+        }
+    }
     else
     {
         off = uoffset(thisString, index);
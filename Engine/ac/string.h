@@ -38,6 +38,10 @@ inline const char *CreateNewScriptString(const AGS::Common::String &text)
     { return CreateNewScriptString(text.GetCStr()); }
 inline const char *CreateNewScriptString(ScriptString::Buffer &&buf)
     { return static_cast<const char*>(ScriptString::Create(std::move(buf)).Obj); }
+// Returns an interned script string for the text from a persistent source,
+// such as game data or translation; see ScriptString::CreateInterned
+inline const char *CreateInternedScriptString(const char *text)
+    { return static_cast<const char*>(ScriptString::CreateInterned(text).Obj); }
 
 int String_IsNullOrEmpty(const char *thisString);
 const char* String_Copy(const char *srcString);
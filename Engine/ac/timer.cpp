@@ -35,6 +35,7 @@ const auto MAXIMUM_FALL_BEHIND = 3; // number of full frames
 auto tick_duration = std::chrono::microseconds(1000000LL/40);
 auto framerate = 0;
 auto framerate_maxed = false;
+auto fixed_step = false;
 
 auto last_tick_time = Clock::now();
 auto next_frame_timestamp = Clock::now();
@@ -68,6 +69,11 @@ bool isTimerFpsMaxed()
     return framerate_maxed;
 }
 
+void setTimerFixedStep(bool on)
+{
+    fixed_step = on;
+}
+
 void WaitForNextFrame()
 {
     // Do the last polls on this frame, if necessary
@@ -79,7 +85,7 @@ void WaitForNextFrame()
     const auto frameDuration = GetFrameDuration();
 
     // early exit if we're trying to maximise framerate
-    if (frameDuration <= std::chrono::milliseconds::zero()) {
+    if (fixed_step || (frameDuration <= std::chrono::milliseconds::zero())) {
         last_tick_time = next_frame_timestamp;
         next_frame_timestamp = now;
 
@@ -27,6 +27,10 @@ extern void WaitForNextFrame();
 extern int setTimerFps(int new_fps);
 // Tells whether maxed FPS mode is currently set
 extern bool isTimerFpsMaxed();
+// Sets the fixed step mode: frames run one after another without waiting, but
+// unlike the maxed FPS mode the game keeps its nominal FPS, so that the game
+// timing does not depend on the real time
+extern void setTimerFixedStep(bool on);
 // If more than N frames, just skip all, start a fresh.
 extern void skipMissedTicks();
 
@@ -12,6 +12,7 @@
 //
 //=============================================================================
 
+#include <vector>
 #include "ac/common.h"
 #include "ac/object.h"
 #include "ac/character.h"
@@ -35,8 +36,47 @@ extern RoomObject*objs;
 
 Bitmap *walkareabackup=nullptr, *walkable_areas_temp = nullptr;
 
+// Walkable mask version, incremented each time the mask is modified
+static uint32_t walkable_areas_version = 0u;
+// Tells that the walkable mask was given to a plugin, which may draw on it
+// at any time, without notifying the engine
+static bool walkable_areas_exposed = false;
+
+// Blocking rectangle, cut out from the walkable mask by prepare_walkable_areas;
+// these are in room coordinates, same as passed into remove_walkable_areas_from_temp.
+struct WalkBlockRect
+{
+    int FromX, Width, StartY, EndY;
+
+    bool operator ==(const WalkBlockRect &other) const
+    {
+        return FromX == other.FromX && Width == other.Width &&
+            StartY == other.StartY && EndY == other.EndY;
+    }
+};
+
+// Layout of the last generated walkable_areas_temp: which mask version it was
+// made from, and which rects were cut out of it; lets to skip regenerating
+// the temp mask when neither have changed.
+static uint32_t walkable_temp_version = UINT32_MAX;
+static std::vector<WalkBlockRect> walkable_temp_blocks;
+static uint64_t walkable_temp_key = 0u;
+
+void walkable_areas_modified()
+{
+    walkable_areas_version++;
+    walkable_temp_version = UINT32_MAX;
+}
+
+void expose_walkable_areas()
+{
+    walkable_areas_exposed = true;
+    walkable_areas_modified();
+}
+
 void redo_walkable_areas()
 {
+    walkable_areas_modified();
     thisroom.WalkAreaMask->Blit(walkareabackup, 0, 0);
     for (int h = 0; h < walkareabackup->GetHeight(); ++h)
     {
@@ -132,57 +172,97 @@ int is_point_in_rect(int x, int y, int left, int top, int right, int bottom) {
     return 0;
 }
 
-Bitmap *prepare_walkable_areas (int sourceChar) {
-    // copy the walkable areas to the temp bitmap
-    walkable_areas_temp->Blit(thisroom.WalkAreaMask.get(), 0,0,0,0,thisroom.WalkAreaMask->GetWidth(),thisroom.WalkAreaMask->GetHeight());
+// Computes a FNV-1a hash of the walkable mask layout
+static uint64_t hash_walkable_layout(uint32_t version, const std::vector<WalkBlockRect> &blocks)
+{
+    const uint64_t fnv_prime = 0x100000001B3ULL;
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    auto hash_int = [&hash, fnv_prime](uint32_t val)
+    {
+        for (int i = 0; i < 4; ++i, val >>= 8)
+        {
+            hash ^= (val & 0xFF);
+            hash *= fnv_prime;
+        }
+    };
+    hash_int(version);
+    for (const auto &b : blocks)
+    {
+        hash_int(b.FromX); hash_int(b.Width); hash_int(b.StartY); hash_int(b.EndY);
+    }
+    return hash;
+}
+
+Bitmap *prepare_walkable_areas (int sourceChar, uint64_t *layout_key) {
+    // If a plugin has the mask, then it might have changed since the last call
+    if (walkable_areas_exposed)
+        walkable_areas_modified();
+
+    // Gather the list of rects blocked by characters and objects first;
+    // if it's identical to the last time, then we may skip regenerating the mask.
+    static std::vector<WalkBlockRect> blocks;
+    blocks.clear();
+
     // if the character who's moving doesn't block, don't bother checking
-    if (sourceChar < 0) ;
-    else if (game.chars[sourceChar].flags & CHF_NOBLOCKING)
-        return walkable_areas_temp;
-
-    // for each character in the current room, make the area under them unwalkable
-    for (int ww = 0; ww < game.numcharacters; ww++) {
-        if (game.chars[ww].on != 1) continue;
-        if (game.chars[ww].room != displayed_room) continue;
-        if (ww == sourceChar) continue;
-        if (game.chars[ww].flags & CHF_NOBLOCKING) continue;
-        if (room_to_mask_coord(game.chars[ww].y) >= walkable_areas_temp->GetHeight()) continue;
-        if (room_to_mask_coord(game.chars[ww].x) >= walkable_areas_temp->GetWidth()) continue;
-        if ((game.chars[ww].y < 0) || (game.chars[ww].x < 0)) continue;
-
-        CharacterInfo *char1 = &game.chars[ww];
-        int cwidth, fromx;
-
-        // If walking character is already inside that other character's blocking rect,
-        // then ignore that blocking rect (otherwise character may get stuck forever)
-        if (is_char_in_blocking_rect(sourceChar, ww, &fromx, &cwidth))
-            continue;
-
-        remove_walkable_areas_from_temp(fromx, cwidth, char1->get_blocking_top(), char1->get_blocking_bottom());
+    if ((sourceChar < 0) || (game.chars[sourceChar].flags & CHF_NOBLOCKING) == 0)
+    {
+        // for each character in the current room, make the area under them unwalkable
+        for (int ww : get_room_characters(displayed_room)) {
+            if (game.chars[ww].on != 1) continue;
+            if (ww == sourceChar) continue;
+            if (game.chars[ww].flags & CHF_NOBLOCKING) continue;
+            if (room_to_mask_coord(game.chars[ww].y) >= walkable_areas_temp->GetHeight()) continue;
+            if (room_to_mask_coord(game.chars[ww].x) >= walkable_areas_temp->GetWidth()) continue;
+            if ((game.chars[ww].y < 0) || (game.chars[ww].x < 0)) continue;
+
+            CharacterInfo *char1 = &game.chars[ww];
+            int cwidth, fromx;
+
+            // If walking character is already inside that other character's blocking rect,
+            // then ignore that blocking rect (otherwise character may get stuck forever)
+            if (is_char_in_blocking_rect(sourceChar, ww, &fromx, &cwidth))
+                continue;
+
+            blocks.push_back({ fromx, cwidth, char1->get_blocking_top(), char1->get_blocking_bottom() });
+        }
+
+        // check for any blocking objects in the room, and deal with them as well
+        for (uint32_t ww = 0; ww < croom->numobj; ww++) {
+            if (objs[ww].on != 1) continue;
+            if ((objs[ww].flags & OBJF_SOLID) == 0)
+                continue;
+            if (room_to_mask_coord(objs[ww].y) >= walkable_areas_temp->GetHeight()) continue;
+            if (room_to_mask_coord(objs[ww].x) >= walkable_areas_temp->GetWidth()) continue;
+            if ((objs[ww].y < 0) || (objs[ww].x < 0)) continue;
+
+            int x1, y1, width, y2;
+            get_object_blocking_rect(ww, &x1, &y1, &width, &y2);
+
+            // if the character is currently standing on the object, ignore
+            // it so as to allow him to escape
+            if ((sourceChar >= 0) &&
+                (is_point_in_rect(game.chars[sourceChar].x, game.chars[sourceChar].y, 
+                x1, y1, x1 + width, y2)))
+                continue;
+
+            blocks.push_back({ x1, width, y1, y2 });
+        }
     }
 
-    // check for any blocking objects in the room, and deal with them as well
-    for (uint32_t ww = 0; ww < croom->numobj; ww++) {
-        if (objs[ww].on != 1) continue;
-        if ((objs[ww].flags & OBJF_SOLID) == 0)
-            continue;
-        if (room_to_mask_coord(objs[ww].y) >= walkable_areas_temp->GetHeight()) continue;
-        if (room_to_mask_coord(objs[ww].x) >= walkable_areas_temp->GetWidth()) continue;
-        if ((objs[ww].y < 0) || (objs[ww].x < 0)) continue;
-
-        int x1, y1, width, y2;
-        get_object_blocking_rect(ww, &x1, &y1, &width, &y2);
-
-        // if the character is currently standing on the object, ignore
-        // it so as to allow him to escape
-        if ((sourceChar >= 0) &&
-            (is_point_in_rect(game.chars[sourceChar].x, game.chars[sourceChar].y, 
-            x1, y1, x1 + width, y2)))
-            continue;
-
-        remove_walkable_areas_from_temp(x1, width, y1, y2);
+    if ((walkable_temp_version != walkable_areas_version) || (blocks != walkable_temp_blocks))
+    {
+        // copy the walkable areas to the temp bitmap, and cut out blocked areas
+        walkable_areas_temp->Blit(thisroom.WalkAreaMask.get(), 0,0,0,0,thisroom.WalkAreaMask->GetWidth(),thisroom.WalkAreaMask->GetHeight());
+        for (const auto &b : blocks)
+            remove_walkable_areas_from_temp(b.FromX, b.Width, b.StartY, b.EndY);
+
+        walkable_temp_version = walkable_areas_version;
+        walkable_temp_blocks = blocks;
+        walkable_temp_key = hash_walkable_layout(walkable_areas_version, blocks);
     }
 
+    if (layout_key)
+        *layout_key = walkable_temp_key;
     return walkable_areas_temp;
 }
 
@@ -18,14 +18,26 @@
 #ifndef __AGS_EE_AC__WALKABLEAREA_H
 #define __AGS_EE_AC__WALKABLEAREA_H
 
+#include <stdint.h>
+
 void  redo_walkable_areas();
+// Notifies that the room's walkable mask has been modified;
+// invalidates any data that was generated from it
+void  walkable_areas_modified();
+// Notifies that the room's walkable mask is given to the external code (plugin),
+// which may modify it at any time; after this the data generated from the mask
+// is not reused, but regenerated each time
+void  expose_walkable_areas();
 int   get_walkable_area_pixel(int x, int y);
 int   get_area_scaling (int onarea, int xx, int yy);
 void  scale_sprite_size(int sppic, int zoom_level, int *newwidth, int *newheight);
 void  remove_walkable_areas_from_temp(int fromx, int cwidth, int starty, int endy);
 int   is_point_in_rect(int x, int y, int left, int top, int right, int bottom);
+// Generates a walkable mask for the pathfinder, where areas blocked by characters
+// and objects are removed. Optionally returns a "layout key": a hash value which
+// identifies the generated mask contents, and may be used for caching.
 // IMPORTANT: this function returns *global pointer*, do not delete the returned bitmap! -- subject to future refactor
-Common::Bitmap *prepare_walkable_areas (int sourceChar);
+Common::Bitmap *prepare_walkable_areas (int sourceChar, uint64_t *layout_key = nullptr);
 int   get_walkable_area_at_location(int xx, int yy);
 int   get_walkable_area_at_character (int charnum);
 
@@ -13,6 +13,7 @@
 //=============================================================================
 #include "ac/walkbehind.h"
 #include <algorithm>
+#include <cstring>
 #include "ac/draw.h"
 #include "ac/gamestate.h"
 #include "ac/roomstatus.h"
@@ -27,161 +28,168 @@ extern RoomStruct thisroom;
 extern IGraphicsDriver *gfxDriver;
 extern RoomStatus *croom;
 
-// An info on vertical column of walk-behind mask, which may contain WB area
-struct WalkBehindColumn
-{
-    bool Exists = false; // whether any WB area is in this column
-    int Y1 = 0, Y2 = 0; // WB top and bottom Y coords
-};
-
-std::vector<WalkBehindColumn> walkBehindCols; // precalculated WB positions
-Rect walkBehindAABB[MAX_WALK_BEHINDS]; // WB bounding box
+WalkBehindSpans walkBehindSpans; // precalculated WB spans
 int walkBehindsCachedForBgNum = -1; // WB textures are for this background
 bool noWalkBehindsAtAll = false; // quick report that no WBs in this room
 bool walk_behind_baselines_changed = false;
 
 
-// Generates walk-behinds as separate sprites
-void walkbehinds_generate_sprites()
+void WalkBehindSpans::Build(const Bitmap *mask)
 {
-    const Bitmap *mask = thisroom.WalkBehindMask.get();
-    const Bitmap *bg = thisroom.BgFrames[play.bg_frame].Graphic.get();
-    
-    const int coldepth = bg->GetColorDepth();
-    Bitmap wbbmp; // temp buffer
-    // Iterate through walk-behinds and generate a texture for each of them
-    for (int wb = 1 /* 0 is "no area" */; wb < MAX_WALK_BEHINDS; ++wb)
+    Clear();
+    // note that mask is always 8-bit
+    const int width = mask->GetWidth();
+    _height = mask->GetHeight();
+    _rows.resize(_height + 1);
+    for (int y = 0; y < _height; ++y)
     {
-        const Rect pos = walkBehindAABB[wb];
-        if (pos.Right > 0)
+        _rows[y] = _spans.size();
+        const uint8_t *line = mask->GetScanLine(y);
+        for (int x = 0; x < width;)
         {
-            wbbmp.CreateTransparent(pos.GetWidth(), pos.GetHeight(), coldepth);
-            // Copy over all solid pixels belonging to this WB area
-            const int sx = pos.Left, ex = pos.Right, sy = pos.Top, ey = pos.Bottom;
-            for (int y = sy; y <= ey; ++y)
+            const int wb = line[x];
+            int x2 = x + 1;
+            for (; (x2 < width) && (line[x2] == wb); ++x2);
+            // Valid areas start with index 1, 0 = no area
+            if ((wb >= 1) && (wb < MAX_WALK_BEHINDS))
             {
-                const uint8_t *check_line = mask->GetScanLine(y);
-                const uint8_t *src_line = bg->GetScanLine(y);
-                uint8_t *dst_line = wbbmp.GetScanLineForWriting(y - sy);
-                for (int x = sx; x <= ex; ++x)
-                {
-                    if (check_line[x] != wb) continue;
-                    switch (coldepth)
-                    {
-                    case 8:
-                        dst_line[(x - sx)] = src_line[x];
-                        break;
-                    case 16:
-                        reinterpret_cast<uint16_t*>(dst_line)[(x - sx)] =
-                            reinterpret_cast<const uint16_t*>(src_line)[x];
-                        break;
-                    case 32:
-                        reinterpret_cast<uint32_t*>(dst_line)[(x - sx)] =
-                            reinterpret_cast<const uint32_t*>(src_line)[x];
-                        break;
-                    default: assert(0); break;
-                    }
-                }
+                Span span;
+                span.X1 = x;
+                span.X2 = x2;
+                span.Area = wb;
+                _spans.push_back(span);
+                // resize the bounding rect
+                Rect &bounds = _bounds[wb];
+                bounds.Left = std::min(x, bounds.Left);
+                bounds.Top = std::min(y, bounds.Top);
+                bounds.Right = std::max(x2 - 1, bounds.Right);
+                bounds.Bottom = std::max(y, bounds.Bottom);
             }
-            // Add to walk-behinds image list
-            add_walkbehind_image(wb, &wbbmp, pos.Left, pos.Top);
+            x = x2;
         }
     }
+    _rows[_height] = _spans.size();
+}
 
-    walkBehindsCachedForBgNum = play.bg_frame;
+void WalkBehindSpans::Clear()
+{
+    _height = 0;
+    _spans.clear();
+    _rows.clear();
+    _bounds.assign(MAX_WALK_BEHINDS, Rect(INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN));
 }
 
-// Edits the given game object's sprite, cutting out pixels covered by walk-behinds;
-// returns whether any pixels were updated;
-bool walkbehinds_cropout(Bitmap *sprit, int sprx, int spry, int basel)
+Rect WalkBehindSpans::GetAreaBounds(int area) const
 {
-    if (noWalkBehindsAtAll)
-        return false;
+    if ((area < 0) || (static_cast<size_t>(area) >= _bounds.size()))
+        return Rect(INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN);
+    return _bounds[area];
+}
 
+template <typename T>
+static void fill_row(uint8_t *line, int x1, int x2, int color)
+{
+    std::fill(reinterpret_cast<T*>(line) + x1, reinterpret_cast<T*>(line) + x2, static_cast<T>(color));
+}
+
+bool WalkBehindSpans::Cropout(Bitmap *sprit, int sprx, int spry, int basel,
+    const short *area_baselines) const
+{
     const int maskcol = sprit->GetMaskColor();
     const int spcoldep = sprit->GetColorDepth();
+    // sprite's horizontal range in mask coordinates
+    const int left = sprx, right = sprx + sprit->GetWidth();
 
     bool pixels_changed = false;
-    // pass along the sprite's pixels, but skip those that lie outside the mask
-    for (int x = std::max(0, 0 - sprx);
-        (x < sprit->GetWidth()) && (x + sprx < thisroom.WalkBehindMask->GetWidth()); ++x)
+    // pass along the sprite's rows, but skip those that lie outside the mask
+    const int y1 = std::max(0, 0 - spry);
+    const int y2 = std::min(sprit->GetHeight(), _height - spry);
+    for (int y = y1; y < y2; ++y)
     {
-        // select the WB column at this x
-        const auto &wbcol = walkBehindCols[x + sprx];
-        // skip if no area, or sprite lies outside of all areas in this column
-        if ((!wbcol.Exists) ||
-            (wbcol.Y2 <= spry) ||
-            (wbcol.Y1 > spry + sprit->GetHeight()))
-            continue;
-
-        // ensure we only check within the valid areas (between Y1 and Y2)
-        // we assume that Y1 and Y2 are always within the mask
-        for (int y = std::max(0, wbcol.Y1 - spry);
-            (y < sprit->GetHeight()) && (y + spry < wbcol.Y2); ++y)
+        const size_t span_end = _rows[y + spry + 1];
+        uint8_t *dst_line = nullptr;
+        for (size_t i = _rows[y + spry]; i < span_end; ++i)
         {
-            const int wb = thisroom.WalkBehindMask->GetScanLine(y + spry)[x + sprx];
-            if (wb < 1) continue; // "no area"
-            if (croom->walkbehind_base[wb] <= basel) continue;
+            const Span &span = _spans[i];
+            if (span.X2 <= left) continue;
+            if (span.X1 >= right) break; // spans are ordered by X
+            if (area_baselines[span.Area] <= basel) continue;
 
             pixels_changed = true;
-            uint8_t *dst_line = sprit->GetScanLineForWriting(y);
+            if (!dst_line)
+                dst_line = sprit->GetScanLineForWriting(y);
+            const int x1 = std::max(span.X1, left) - sprx;
+            const int x2 = std::min(span.X2, right) - sprx;
             switch (spcoldep)
             {
-            case 8:
-                dst_line[x] = maskcol;
-                break;
-            case 16:
-                reinterpret_cast<uint16_t*>(dst_line)[x] = maskcol;
-                break;
-            case 32:
-                reinterpret_cast<uint32_t*>(dst_line)[x] = maskcol;
-                break;
-            default:
-                assert(0);
-                break;
+            case 8: fill_row<uint8_t>(dst_line, x1, x2, maskcol); break;
+            case 16: fill_row<uint16_t>(dst_line, x1, x2, maskcol); break;
+            case 32: fill_row<uint32_t>(dst_line, x1, x2, maskcol); break;
+            default: assert(0); break;
             }
         }
     }
     return pixels_changed;
 }
 
-void walkbehinds_recalc()
+void WalkBehindSpans::CopyArea(int area, const Bitmap *src, Bitmap *dst) const
 {
-    // Reset all data
-    walkBehindCols.clear();
-    for (int wb = 0; wb < MAX_WALK_BEHINDS; ++wb)
+    const Rect pos = GetAreaBounds(area);
+    const int bpp = src->GetBPP();
+    for (int y = pos.Top; y <= pos.Bottom; ++y)
     {
-        walkBehindAABB[wb] = Rect(INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN);
+        const uint8_t *src_line = src->GetScanLine(y);
+        uint8_t *dst_line = dst->GetScanLineForWriting(y - pos.Top);
+        const size_t span_end = _rows[y + 1];
+        for (size_t i = _rows[y]; i < span_end; ++i)
+        {
+            const Span &span = _spans[i];
+            if (span.Area != area) continue;
+            memcpy(dst_line + (span.X1 - pos.Left) * bpp, src_line + span.X1 * bpp,
+                (span.X2 - span.X1) * bpp);
+        }
     }
-    noWalkBehindsAtAll = true;
+}
 
-    // Recalculate everything; note that mask is always 8-bit
-    const Bitmap *mask = thisroom.WalkBehindMask.get();
-    walkBehindCols.resize(mask->GetWidth());
-    for (int col = 0; col < mask->GetWidth(); ++col)
+
+// Generates walk-behinds as separate sprites
+void walkbehinds_generate_sprites()
+{
+    const Bitmap *bg = thisroom.BgFrames[play.bg_frame].Graphic.get();
+    
+    const int coldepth = bg->GetColorDepth();
+    Bitmap wbbmp; // temp buffer
+    // Iterate through walk-behinds and generate a texture for each of them
+    for (int wb = 1 /* 0 is "no area" */; wb < MAX_WALK_BEHINDS; ++wb)
     {
-        auto &wbcol = walkBehindCols[col];
-        for (int y = 0; y < mask->GetHeight(); ++y)
+        const Rect pos = walkBehindSpans.GetAreaBounds(wb);
+        if (pos.Right > 0)
         {
-            int wb = mask->GetScanLine(y)[col];
-            // Valid areas start with index 1, 0 = no area
-            if ((wb >= 1) && (wb < MAX_WALK_BEHINDS))
-            {
-                if (!wbcol.Exists)
-                {
-                    wbcol.Y1 = y;
-                    wbcol.Exists = true;
-                    noWalkBehindsAtAll = false;
-                }
-                wbcol.Y2 = y + 1; // +1 to allow bottom line of screen to work (CHECKME??)
-                // resize the bounding rect
-                walkBehindAABB[wb].Left = std::min(col, walkBehindAABB[wb].Left);
-                walkBehindAABB[wb].Top = std::min(y, walkBehindAABB[wb].Top);
-                walkBehindAABB[wb].Right = std::max(col, walkBehindAABB[wb].Right);
-                walkBehindAABB[wb].Bottom = std::max(y, walkBehindAABB[wb].Bottom);
-            }
+            wbbmp.CreateTransparent(pos.GetWidth(), pos.GetHeight(), coldepth);
+            // Copy over all solid pixels belonging to this WB area
+            walkBehindSpans.CopyArea(wb, bg, &wbbmp);
+            // Add to walk-behinds image list
+            add_walkbehind_image(wb, &wbbmp, pos.Left, pos.Top);
         }
     }
 
+    walkBehindsCachedForBgNum = play.bg_frame;
+}
+
+// Edits the given game object's sprite, cutting out pixels covered by walk-behinds;
+// returns whether any pixels were updated;
+bool walkbehinds_cropout(Bitmap *sprit, int sprx, int spry, int basel)
+{
+    if (noWalkBehindsAtAll)
+        return false;
+
+    return walkBehindSpans.Cropout(sprit, sprx, spry, basel, croom->walkbehind_base);
+}
+
+void walkbehinds_recalc()
+{
+    // Recalculate everything
+    walkBehindSpans.Build(thisroom.WalkBehindMask.get());
+    noWalkBehindsAtAll = walkBehindSpans.IsEmpty();
     walkBehindsCachedForBgNum = -1;
 }
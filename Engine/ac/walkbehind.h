@@ -18,6 +18,7 @@
 #ifndef __AGS_EE_AC__WALKBEHIND_H
 #define __AGS_EE_AC__WALKBEHIND_H
 
+#include <vector>
 #include "util/geometry.h"
 
 // A method of rendering walkbehinds on screen:
@@ -36,6 +37,43 @@ enum WalkBehindMethodEnum
 namespace AGS { namespace Common { class Bitmap; } }
 using namespace AGS; // FIXME later
 
+// WalkBehindSpans is a run-length representation of the walk-behind mask:
+// each mask row is stored as a list of horizontal spans of the same area.
+// This lets process walk-behinds row by row, touching only covered pixels,
+// instead of looking up the full-size mask bitmap pixel by pixel.
+class WalkBehindSpans
+{
+public:
+    // A horizontal run of the mask pixels which belong to the same area
+    struct Span
+    {
+        int X1 = 0, X2 = 0; // first and past-the-last X coords
+        int Area = 0;
+    };
+
+    // Builds spans from the 8-bit walk-behind mask
+    void Build(const Common::Bitmap *mask);
+    void Clear();
+    // Tells if there are any walk-behind areas in the mask
+    bool IsEmpty() const { return _spans.empty(); }
+    // Returns the bounding box of the given area; if the area is not present
+    // in the mask, then its Right and Bottom are negative
+    Rect GetAreaBounds(int area) const;
+    // Cuts out sprite pixels covered by the areas, which baseline is above
+    // the given one; returns whether any pixels were updated
+    bool Cropout(Common::Bitmap *sprit, int sprx, int spry, int basel,
+        const short *area_baselines) const;
+    // Copies pixels of the given area from the room-sized source bitmap
+    // to the destination, which is positioned at the area's bounding box
+    void CopyArea(int area, const Common::Bitmap *src, Common::Bitmap *dst) const;
+
+private:
+    int _height = 0;
+    std::vector<Span> _spans; // spans of all rows, ordered by row and by X
+    std::vector<size_t> _rows; // first span of each row, plus the end one
+    std::vector<Rect> _bounds; // bounding box of each area
+};
+
 // Recalculates walk-behind positions
 void walkbehinds_recalc();
 // Generates walk-behinds as separate sprites
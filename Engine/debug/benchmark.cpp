@@ -0,0 +1,294 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "debug/benchmark.h"
+#include <algorithm>
+#include <stdio.h>
+#include <vector>
+#include "ac/gamesetupstruct.h"
+#include "ac/mouse.h"
+#include "ac/sys_events.h"
+#include "ac/timer.h"
+#include "debug/out.h"
+#include "util/file.h"
+#include "util/string_compat.h"
+#include "util/textstreamreader.h"
+#include "util/textstreamwriter.h"
+#include "util/time_util.h"
+
+using namespace AGS::Common;
+using namespace AGS::Engine;
+
+extern GameSetupStruct game;
+extern volatile bool want_exit;
+
+namespace
+{
+
+enum ReplayCommand
+{
+    kReplay_Mouse,
+    kReplay_Click,
+    kReplay_Key
+};
+
+struct ReplayEvent
+{
+    uint32_t Frame = 0u;
+    ReplayCommand Cmd = kReplay_Mouse;
+    int Arg1 = 0;
+    int Arg2 = 0;
+};
+
+struct FrameTimes
+{
+    Clock::duration Phases[kNumBenchPhases]{};
+    bool Done = false;
+};
+
+// An open frame, and the phase to return to when it ends
+struct OpenFrame
+{
+    size_t Index;
+    BenchmarkPhase OuterPhase;
+};
+
+const char *PhaseNames[kNumBenchPhases] = { "script", "update", "draw", "render" };
+
+struct BenchmarkState
+{
+    bool Running = false;
+    uint32_t FrameCount = 0u;
+    uint32_t FramesDone = 0u;
+    String OutputFile;
+    // Input to replay, sorted by frame index
+    std::vector<ReplayEvent> Input;
+    size_t NextInput = 0u;
+    // Timings of all the begun frames, in the order of their beginning
+    std::vector<FrameTimes> Frames;
+    // Stack of the currently open (nested) frames
+    std::vector<OpenFrame> OpenFrames;
+    BenchmarkPhase Phase = kBenchPhase_Update;
+    Clock::time_point LastMark;
+} bench;
+
+bool read_replay_input(const String &filename, std::vector<ReplayEvent> &events)
+{
+    auto in = File::OpenFileRead(filename);
+    if (!in)
+    {
+        Debug::Printf(kDbgMsg_Error, "Benchmark: failed to open input file: %s", filename.GetCStr());
+        return false;
+    }
+
+    TextStreamReader reader(std::move(in));
+    for (int line_num = 1; !reader.EOS(); ++line_num)
+    {
+        String line = reader.ReadLine();
+        line.Trim();
+        if (line.IsEmpty() || line[0u] == '#')
+            continue;
+
+        ReplayEvent evt;
+        char cmd[16]{};
+        int args = sscanf(line.GetCStr(), "%u %15s %d %d", &evt.Frame, cmd, &evt.Arg1, &evt.Arg2);
+        bool valid = true;
+        if (args >= 3 && ags_stricmp(cmd, "click") == 0)
+            evt.Cmd = kReplay_Click;
+        else if (args >= 3 && ags_stricmp(cmd, "key") == 0)
+            evt.Cmd = kReplay_Key;
+        else if (args >= 4 && ags_stricmp(cmd, "mouse") == 0)
+            evt.Cmd = kReplay_Mouse;
+        else
+            valid = false;
+
+        if (valid)
+            events.push_back(evt);
+        else
+            Debug::Printf(kDbgMsg_Warn, "Benchmark: invalid input at line %d: %s", line_num, line.GetCStr());
+    }
+
+    std::stable_sort(events.begin(), events.end(),
+        [](const ReplayEvent &a, const ReplayEvent &b) { return a.Frame < b.Frame; });
+    return true;
+}
+
+void replay_input(uint32_t frame)
+{
+    for (; (bench.NextInput < bench.Input.size()) && (bench.Input[bench.NextInput].Frame <= frame); ++bench.NextInput)
+    {
+        const ReplayEvent &evt = bench.Input[bench.NextInput];
+        switch (evt.Cmd)
+        {
+        case kReplay_Mouse:
+            SetMousePosition(evt.Arg1, evt.Arg2);
+            break;
+        case kReplay_Click:
+            ags_simulate_mouseclick(static_cast<eAGSMouseButton>(evt.Arg1));
+            break;
+        case kReplay_Key:
+            ags_simulate_keypress(static_cast<eAGSKeyCode>(evt.Arg1), (game.options[OPT_KEYHANDLEAPI] == 0));
+            break;
+        }
+    }
+}
+
+// Accounts the time passed since the last mark to the current phase of the top frame
+void mark_time()
+{
+    const auto now = Clock::now();
+    if (!bench.OpenFrames.empty())
+        bench.Frames[bench.OpenFrames.back().Index].Phases[bench.Phase] += now - bench.LastMark;
+    bench.LastMark = now;
+}
+
+inline int64_t to_us(Clock::duration dur)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(dur).count();
+}
+
+void write_results()
+{
+    if (bench.OutputFile.IsEmpty())
+        return;
+    auto out = File::CreateFile(bench.OutputFile);
+    if (!out)
+    {
+        Debug::Printf(kDbgMsg_Error, "Benchmark: failed to open output file: %s", bench.OutputFile.GetCStr());
+        return;
+    }
+
+    TextStreamWriter writer(std::move(out));
+    const bool json = bench.OutputFile.CompareRightNoCase(".json") == 0;
+    if (json)
+        writer.WriteLine("[");
+    else
+        writer.WriteFormat("frame,%s_us,%s_us,%s_us,%s_us,total_us\n",
+            PhaseNames[0], PhaseNames[1], PhaseNames[2], PhaseNames[3]);
+
+    bool first = true;
+    for (size_t i = 0; i < bench.Frames.size(); ++i)
+    {
+        const FrameTimes &ft = bench.Frames[i];
+        if (!ft.Done)
+            continue;
+        Clock::duration total{};
+        for (const auto &dur : ft.Phases)
+            total += dur;
+        if (json)
+        {
+            writer.WriteFormat("%s  {\"frame\": %zu", first ? "" : ",\n", i);
+            for (int p = 0; p < kNumBenchPhases; ++p)
+                writer.WriteFormat(", \"%s_us\": %lld", PhaseNames[p], static_cast<long long>(to_us(ft.Phases[p])));
+            writer.WriteFormat(", \"total_us\": %lld}", static_cast<long long>(to_us(total)));
+        }
+        else
+        {
+            writer.WriteFormat("%zu", i);
+            for (int p = 0; p < kNumBenchPhases; ++p)
+                writer.WriteFormat(",%lld", static_cast<long long>(to_us(ft.Phases[p])));
+            writer.WriteFormat(",%lld\n", static_cast<long long>(to_us(total)));
+        }
+        first = false;
+    }
+    if (json)
+        writer.WriteLine("\n]");
+}
+
+void print_summary()
+{
+    Clock::duration sums[kNumBenchPhases]{};
+    size_t count = 0u;
+    for (const auto &ft : bench.Frames)
+    {
+        if (!ft.Done)
+            continue;
+        for (int p = 0; p < kNumBenchPhases; ++p)
+            sums[p] += ft.Phases[p];
+        count++;
+    }
+    if (count == 0u)
+        return;
+    Debug::Printf(kDbgMsg_Info, "Benchmark: %zu frames, average ms per frame: script %.3f, update %.3f, draw %.3f, render %.3f",
+        count, ToMillisecondsF(sums[0]) / count, ToMillisecondsF(sums[1]) / count,
+        ToMillisecondsF(sums[2]) / count, ToMillisecondsF(sums[3]) / count);
+}
+
+} // namespace
+
+bool benchmark_start(uint32_t frame_count, const String &output_file, const String &input_file)
+{
+    bench = BenchmarkState();
+    if (!input_file.IsEmpty() && !read_replay_input(input_file, bench.Input))
+        return false;
+    bench.Running = true;
+    bench.FrameCount = frame_count;
+    bench.OutputFile = output_file;
+    bench.Frames.reserve(std::min<uint32_t>(frame_count, 0x10000));
+    bench.LastMark = Clock::now();
+    setTimerFixedStep(true);
+    Debug::Printf(kDbgMsg_Info, "Benchmark: running %u frames, %zu input events",
+        frame_count, bench.Input.size());
+    return true;
+}
+
+bool benchmark_is_running()
+{
+    return bench.Running;
+}
+
+void benchmark_frame_begin()
+{
+    if (!bench.Running)
+        return;
+    mark_time();
+    const uint32_t frame = static_cast<uint32_t>(bench.Frames.size());
+    bench.Frames.emplace_back();
+    bench.OpenFrames.push_back({ frame, bench.Phase });
+    bench.Phase = kBenchPhase_Update;
+    replay_input(frame);
+}
+
+void benchmark_frame_end()
+{
+    if (!bench.Running || bench.OpenFrames.empty())
+        return;
+    mark_time();
+    bench.Frames[bench.OpenFrames.back().Index].Done = true;
+    bench.Phase = bench.OpenFrames.back().OuterPhase;
+    bench.OpenFrames.pop_back();
+    if (++bench.FramesDone >= bench.FrameCount)
+    {
+        benchmark_shutdown();
+        want_exit = true;
+    }
+}
+
+void benchmark_phase(BenchmarkPhase phase)
+{
+    if (!bench.Running)
+        return;
+    mark_time();
+    bench.Phase = phase;
+}
+
+void benchmark_shutdown()
+{
+    if (!bench.Running)
+        return;
+    bench.Running = false;
+    setTimerFixedStep(false);
+    print_summary();
+    write_results();
+    bench = BenchmarkState();
+}
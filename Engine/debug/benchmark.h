@@ -0,0 +1,66 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// Benchmark run mode.
+//
+// In this mode the game runs a fixed number of frames as fast as possible,
+// with the game timer in the fixed step mode, optionally replaying the input
+// from a file; then the engine quits. Time spent in each game update is
+// measured and divided into phases (script, update, draw, render), and
+// the per-frame timings are written to the output file.
+//
+// The input file is a text file, where each line has a frame index followed
+// by a command. Frames are counted from the benchmark's start. Commands are:
+//   <frame> mouse <x> <y>   - moves the mouse cursor, in script coordinates;
+//   <frame> click <button>  - clicks a mouse button (1 - left, 2 - right, 3 - middle);
+//   <frame> key <keycode>   - presses a key, using the script keycode;
+// Empty lines and lines beginning with '#' are skipped.
+//
+// The output is written in JSON format if the file has ".json" extension,
+// and in CSV format otherwise.
+//
+//=============================================================================
+#ifndef __AGS_EE_DEBUG__BENCHMARK_H
+#define __AGS_EE_DEBUG__BENCHMARK_H
+
+#include "util/string.h"
+
+enum BenchmarkPhase
+{
+    kBenchPhase_Script,
+    kBenchPhase_Update,
+    kBenchPhase_Draw,
+    kBenchPhase_Render,
+    kNumBenchPhases
+};
+
+// Starts the benchmark, which will run for the given number of frames;
+// returns false if failed to read the input file
+bool benchmark_start(uint32_t frame_count, const AGS::Common::String &output_file,
+    const AGS::Common::String &input_file);
+// Tells if the benchmark is running
+bool benchmark_is_running();
+// Begins measuring a new game frame, and replays the input scheduled for it;
+// frames may be nested, if the game update is run from the blocking script
+void benchmark_frame_begin();
+// Ends measuring the last begun frame, and returns to the outer one, if any
+void benchmark_frame_end();
+// Switches current frame to the given phase; the time passed since
+// the previous switch is accounted to the previous phase
+void benchmark_phase(BenchmarkPhase phase);
+// Stops the benchmark, writes the timings of the completed frames, if that
+// was not done yet
+void benchmark_shutdown();
+
+#endif // __AGS_EE_DEBUG__BENCHMARK_H
@@ -164,6 +164,7 @@ void InitAndRegisterCharacters(GameSetupStruct &game)
         // export the character's script object
         ccAddExternalScriptObject(game.chars2[i].scrname_new, &game.chars[i], &ccDynamicCharacter);
     }
+    reset_room_characters();
 }
 
 // Initializes dialog and registers them in the script system
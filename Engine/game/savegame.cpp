@@ -11,6 +11,10 @@
 // https://opensource.org/license/artistic-2-0/
 //
 //=============================================================================
+#include <atomic>
+#if !defined(AGS_DISABLE_THREADS)
+#include <thread>
+#endif
 #include "ac/button.h"
 #include "ac/character.h"
 #include "ac/common.h"
@@ -170,6 +174,8 @@ String GetSavegameErrorText(SavegameErrorType err)
         return "Game object initialization failed after save restoration.";
     case kSvgErr_ComponentUncompressedSizeMismatch:
         return "Uncompressed component data size mismatch.";
+    case kSvgErr_ComponentChecksumMismatch:
+        return "Component data checksum mismatch, file is corrupted.";
     default:
         return "Unknown error.";
     }
@@ -391,6 +397,9 @@ SavegameVersion CheckSaveSignature(Stream *in)
 
 HSaveError OpenSavegameBase(const String &filename, SavegameSource *src, SavegameDescription *desc, SavegameDescElem elems)
 {
+    // The file may still be written by the background save
+    WaitForAsyncSave();
+
     UStream in(File::OpenFileRead(filename));
     if (!in.get())
         return new SavegameError(kSvgErr_FileOpenFailed, String::FromFormat("Requested filename: %s.", filename.GetCStr()));
@@ -1035,7 +1044,8 @@ void WriteFileFormat(Stream *out, const SavegameFileFormat &format)
     out->WriteInt32(format.GameDataOffset);
 }
 
-void WriteDescription(Stream *out, const String &user_text, const Bitmap *user_image, SavegameFileFormat &format)
+// Writes savegame description, except the user image
+static void WriteDescriptionBase(Stream *out, const String &user_text, SavegameFileFormat &format)
 {
     // Data format version
     out->WriteInt32(kSvgVersion_Current);
@@ -1061,7 +1071,6 @@ void WriteDescription(Stream *out, const String &user_text, const Bitmap *user_i
     // User description
     soff_t user_desc_pos = out->GetPosition();
     StrUtil::WriteString(user_text, out);
-    WriteUserImage(out, user_image, true /* always compress screenshots */);
 
     // Fill few known fields for SavegameFileFormat
     format.FileFormatOffset = fileformat_pos;
@@ -1070,8 +1079,15 @@ void WriteDescription(Stream *out, const String &user_text, const Bitmap *user_i
     format.UserDescOffset = user_desc_pos;
 }
 
-std::unique_ptr<Stream> StartSavegame(const String &filename, const String &user_text, const Bitmap *user_image,
-                                      SavegameFileFormat &format)
+void WriteDescription(Stream *out, const String &user_text, const Bitmap *user_image, SavegameFileFormat &format)
+{
+    WriteDescriptionBase(out, user_text, format);
+    WriteUserImage(out, user_image, true /* always compress screenshots */);
+}
+
+// Opens savegame for writing and puts in savegame description, except the user image
+static std::unique_ptr<Stream> StartSavegameBase(const String &filename, const String &user_text,
+                                                 SavegameFileFormat &format)
 {
     auto out = File::CreateFile(filename);
     if (!out)
@@ -1080,7 +1096,17 @@ std::unique_ptr<Stream> StartSavegame(const String &filename, const String &user
     // Savegame signature
     out->Write(SavegameSource::Signature.GetCStr(), SavegameSource::Signature.GetLength());
     // Write description block
-    WriteDescription(out.get(), user_text, user_image, format);
+    WriteDescriptionBase(out.get(), user_text, format);
+    return out;
+}
+
+std::unique_ptr<Stream> StartSavegame(const String &filename, const String &user_text, const Bitmap *user_image,
+                                      SavegameFileFormat &format)
+{
+    auto out = StartSavegameBase(filename, user_text, format);
+    if (!out)
+        return nullptr;
+    WriteUserImage(out.get(), user_image, true /* always compress screenshots */);
     return out;
 }
 
@@ -1104,12 +1130,12 @@ void DoBeforeSave()
     }
 }
 
-void SaveGameState(Stream *out, SaveCmpSelection select_cmp, bool compress)
+void SaveGameState(Stream *out, SaveCmpSelection select_cmp, bool compress, bool incremental)
 {
     select_cmp = FixupCmpSelection(select_cmp);
 
     DoBeforeSave();
-    SavegameComponents::WriteAllCommon(out, select_cmp, compress);
+    SavegameComponents::WriteAllCommon(out, select_cmp, compress, incremental);
 }
 
 void ReadPluginSaveData(Stream *in, PluginSvgVersion svg_ver, soff_t max_size)
@@ -1191,8 +1217,11 @@ void WritePluginSaveData(Stream *out)
 }
 
 HSaveError SaveGame(const String &filename, const String &user_text, const Bitmap *user_image,
-                    SaveCmpSelection select_cmp, bool compress_data)
+                    SaveCmpSelection select_cmp, bool compress_data, bool incremental)
 {
+    // The component caches may be used by the background save
+    WaitForAsyncSave();
+
     SavegameFileFormat format;
     format.Flags = kSvgFmt_DeflateComponents * compress_data;
     std::unique_ptr<Stream> out(StartSavegame(filename, user_text, user_image, format));
@@ -1200,13 +1229,110 @@ HSaveError SaveGame(const String &filename, const String &user_text, const Bitma
         return new SavegameError(kSvgErr_FileOpenFailed, String::FromFormat("Requested filename: %s.", filename.GetCStr()));
 
     format.GameDataOffset = out->GetPosition();
-    SaveGameState(out.get(), select_cmp, compress_data);
+    SaveGameState(out.get(), select_cmp, compress_data, incremental);
 
     // Finalize the save file, write composed file format
     WriteFileFormat(out.get(), format);
     return HSaveError::None();
 }
 
+//=============================================================================
+//
+// Background save
+//
+//=============================================================================
+
+// AsyncSaveJob contains the game data snapshot, and the state of writing it
+struct AsyncSaveJob
+{
+    std::unique_ptr<Stream> Out;
+    std::unique_ptr<Bitmap> UserImage;
+    SavegameFileFormat Format;
+    std::vector<SavegameComponents::ComponentSnapshot> Snapshots;
+    bool Compress = false;
+    bool Incremental = false;
+    HSaveError Result;
+    std::atomic<bool> Done{false};
+#if !defined(AGS_DISABLE_THREADS)
+    std::thread Thread;
+#endif
+};
+
+static std::unique_ptr<AsyncSaveJob> AsyncSave;
+
+// Writes the rest of the save file from the job's data;
+// must not access any of the game state
+static void WriteAsyncSave(AsyncSaveJob *job)
+{
+    WriteUserImage(job->Out.get(), job->UserImage.get(), true /* always compress screenshots */);
+    job->Format.GameDataOffset = job->Out->GetPosition();
+    job->Result = SavegameComponents::WriteAllSnapshots(job->Out.get(), job->Snapshots,
+        job->Compress, job->Incremental);
+    WriteFileFormat(job->Out.get(), job->Format);
+    job->Out.reset(); // close the file
+    job->Snapshots.clear();
+    job->Done = true;
+}
+
+HSaveError SaveGameAsync(const String &filename, const String &user_text, std::unique_ptr<Bitmap> &&user_image,
+                         SaveCmpSelection select_cmp, bool compress_data, bool incremental)
+{
+    // Only one save may be written at a time
+    WaitForAsyncSave();
+    if (AsyncSave)
+    {
+        Debug::Printf(kDbgMsg_Warn, "WARNING: previous background save's result was not retrieved");
+        AsyncSave.reset();
+    }
+
+    std::unique_ptr<AsyncSaveJob> job(new AsyncSaveJob());
+    job->Format.Flags = kSvgFmt_DeflateComponents * compress_data;
+    job->Out = StartSavegameBase(filename, user_text, job->Format);
+    if (!job->Out)
+        return new SavegameError(kSvgErr_FileOpenFailed, String::FromFormat("Requested filename: %s.", filename.GetCStr()));
+
+    DoBeforeSave();
+    HSaveError err = SavegameComponents::SnapshotAllCommon(FixupCmpSelection(select_cmp), job->Snapshots);
+    if (!err)
+        return err;
+
+    job->UserImage = std::move(user_image);
+    job->Compress = compress_data;
+    job->Incremental = incremental;
+    AsyncSave = std::move(job);
+#if !defined(AGS_DISABLE_THREADS)
+    AsyncSave->Thread = std::thread(WriteAsyncSave, AsyncSave.get());
+#else
+    WriteAsyncSave(AsyncSave.get());
+#endif
+    return HSaveError::None();
+}
+
+bool IsAsyncSaveRunning()
+{
+    return AsyncSave && !AsyncSave->Done;
+}
+
+void WaitForAsyncSave()
+{
+    if (!AsyncSave)
+        return;
+#if !defined(AGS_DISABLE_THREADS)
+    if (AsyncSave->Thread.joinable())
+        AsyncSave->Thread.join();
+#endif
+}
+
+bool GetAsyncSaveResult(HSaveError &result)
+{
+    if (!AsyncSave || !AsyncSave->Done)
+        return false;
+    WaitForAsyncSave(); // join the finished thread
+    result = std::move(AsyncSave->Result);
+    AsyncSave.reset();
+    return true;
+}
+
 //=============================================================================
 //
 // RestoredSaveInfo API
@@ -89,6 +89,7 @@ enum SavegameErrorType
     kSvgErr_DifferentColorDepth,
     kSvgErr_GameObjectInitFailed,
     kSvgErr_ComponentUncompressedSizeMismatch,
+    kSvgErr_ComponentChecksumMismatch,
     kNumSavegameError
 };
 
@@ -271,8 +272,9 @@ HSaveError     PrescanSaveState(Stream *in, SavegameVersion save_ver, const Save
 // Opens savegame for writing and puts in savegame description
 std::unique_ptr<Stream> StartSavegame(const String &filename, const String &user_text, const Bitmap *user_image,
                                 SavegameFileFormat &file_format);
-// Prepares game for saving state and writes game data into the save stream
-void           SaveGameState(Stream *out, SaveCmpSelection select_cmp);
+// Prepares game for saving state and writes game data into the save stream;
+// see SavegameComponents::WriteAllCommon for the incremental mode
+void           SaveGameState(Stream *out, SaveCmpSelection select_cmp, bool compress = false, bool incremental = false);
 
 // Reads savegame's description out of the given file
 HSaveError     ReadSaveDescription(const String &filename, SavegameDescription &desc, SavegameDescElem elems = kSvgDesc_All);
@@ -282,7 +284,21 @@ HSaveError     RestoreSavegame(const String &filename, const RestoreGameStateOpt
 
 // Write a save file, using user description, and optionally restricting game data to selected components
 HSaveError     SaveGame(const String &filename, const String &user_text, const Bitmap *user_image,
-                        SaveCmpSelection select_cmp, bool compress_data = false);
+                        SaveCmpSelection select_cmp, bool compress_data = false, bool incremental = false);
+// Starts writing a save file in background: opens the file and serializes
+// the game state into memory, then leaves compressing and writing the data
+// to a worker thread. Only one save may be written at a time; the previous
+// save's result must be retrieved using GetAsyncSaveResult before starting
+// a new one.
+HSaveError     SaveGameAsync(const String &filename, const String &user_text, std::unique_ptr<Bitmap> &&user_image,
+                             SaveCmpSelection select_cmp, bool compress_data = false, bool incremental = false);
+// Tells if the background save is still being written
+bool           IsAsyncSaveRunning();
+// Waits until the background save is written, if there's one
+void           WaitForAsyncSave();
+// Retrieves the result of the finished background save, and releases it;
+// returns false if there's no save, or if it has not finished yet
+bool           GetAsyncSaveResult(HSaveError &result);
 
 } // namespace Engine
 } // namespace AGS
@@ -11,6 +11,7 @@
 // https://opensource.org/license/artistic-2-0/
 //
 //=============================================================================
+#include <algorithm>
 #include <map>
 #include "game/savegame_components.h"
 #include "ac/audiocliptype.h"
@@ -34,6 +35,7 @@
 #include "ac/system.h"
 #include "ac/dynobj/cc_serializer.h"
 #include "ac/dynobj/dynobj_manager.h"
+#include "ac/dynobj/scriptstring.h"
 #include "debug/out.h"
 #include "game/savegame_internal.h"
 #include "gfx/bitmap.h"
@@ -50,9 +52,12 @@
 #include "plugin/plugin_engine.h"
 #include "script/cc_common.h"
 #include "script/script.h"
+#include "util/compress.h"
 #include "util/deflatestream.h"
 #include "util/memory_compat.h"
+#include "util/memorystream.h"
 #include "util/string_utils.h"
+#include "util/thread_pool.h"
 
 using namespace Common;
 
@@ -1654,6 +1659,8 @@ HSaveError PrescanMoveLists(Stream *in, int32_t /*cmp_ver*/, soff_t /*cmp_size*/
 
 HSaveError WriteManagedPool(Stream *out)
 {
+    // Interned strings must not be saved with the engine's own references
+    ScriptString::ReleaseInterned();
     ccSerializeAllObjects(out);
     return HSaveError::None();
 }
@@ -1898,9 +1905,13 @@ struct SvgCmpReadHelper
 
 enum ComponentFlags
 {
-    kSvgCmp_Deflate = 0x0001 // compress using Deflate algorithm
+    kSvgCmp_Deflate  = 0x0001, // compress using Deflate algorithm
+    kSvgCmp_Checksum = 0x0002  // header contains a checksum of the uncompressed data
 };
 
+// Size of the component header, following the opening tag (since kSvgVersion_363)
+const uint32_t ComponentHeaderSize = 6 * sizeof(int32_t);
+
 // The basic information about deserialized component, used for debugging purposes
 struct ComponentInfo
 {
@@ -1912,15 +1923,27 @@ struct ComponentInfo
     uint32_t    DataOffset = 0; // offset at which component data begins [not serialized]
     uint32_t    DataSize = 0u;  // expected size of component data
     uint32_t    UncompressedDataSize = 0u; // uncompressed data size
-    uint32_t    Checksum = 0u;  // checksum of the uncompressed data (only if compressed)
+    uint32_t    Checksum = 0u;  // checksum of the uncompressed data (only if kSvgCmp_Checksum is set)
 
     ComponentInfo() = default;
 };
 
-HSaveError ReadComponent(Stream *in, SvgCmpReadHelper &hlp, ComponentInfo &info)
+// A component read from the save, and prepared for unserialization
+struct LoadedComponent
+{
+    ComponentInfo           Info;
+    // Handler to read this component with, null if the component is skipped
+    const ComponentHandler *Handler = nullptr;
+    // Component data, as stored in the save, and uncompressed after decoding
+    std::vector<uint8_t>    Data;
+    HSaveError              DecodeError;
+};
+
+// Reads component's header and data, and finds its handler
+HSaveError ReadComponent(Stream *in, SvgCmpReadHelper &hlp, LoadedComponent &cmp)
 {
     // Read component info
-    info = ComponentInfo();
+    ComponentInfo &info = cmp.Info;
     info.TagOffset = in->GetPosition();
     if (!ReadFormatTag(in, info.Name, true))
         return new SavegameError(kSvgErr_ComponentOpeningTagFormat);
@@ -1964,44 +1987,26 @@ HSaveError ReadComponent(Stream *in, SvgCmpReadHelper &hlp, ComponentInfo &info)
     }
 
     const bool prescan = (hlp.RData.Result.RestoreFlags & kSaveRestore_Prescan) != 0;
-    auto pfn_read = prescan ? handler->Prescan : handler->Unserialize;
+    auto pfn_read = handler ? (prescan ? handler->Prescan : handler->Unserialize) : nullptr;
 
-    // If a handler is chosen, and has Unserialize method, then try reading the data
+    // If a handler is chosen, and has Unserialize method, then read the data
     if (handler && pfn_read)
     {
         if (info.Version > handler->Version || info.Version < handler->LowestVersion)
             return new SavegameError(kSvgErr_UnsupportedComponentVersion, String::FromFormat("Saved version: %d, supported: %d - %d", info.Version, handler->LowestVersion, handler->Version));
 
-        if ((info.Flags & kSvgCmp_Deflate) != 0)
-        {
-            auto deflate_s = std::make_unique<DeflateStream>(in->ReleaseStreamBase(), info.DataOffset, info.DataOffset + info.DataSize);
-            auto deflate_in = std::make_unique<Stream>(std::move(deflate_s));
-
-            HSaveError err = pfn_read(deflate_in.get(), info.Version, info.UncompressedDataSize, hlp.PP, hlp.RData);
-            if (!err)
-                return err;
-
-            if (prescan)
-                deflate_in->Seek(info.UncompressedDataSize, kSeekBegin);
-
-            // FIXME: this is very ugly, maybe may be fixed by changing stream base storage to shared ptr?
-            deflate_s.reset(dynamic_cast<DeflateStream*>(deflate_in->ReleaseStreamBase().release()));
-            uint32_t uncomp_data_sz = deflate_s->GetProcessedInput();
-            if (uncomp_data_sz != info.UncompressedDataSize)
-                return new SavegameError(kSvgErr_ComponentUncompressedSizeMismatch, String::FromFormat("Expected: %zu, actual: %zu", info.UncompressedDataSize, uncomp_data_sz));
-            // TODO: test checksum too?
-
-            in->AttachStreamBase(deflate_s->ReleaseStreamBase());
-        }
-        else
-        {
-            HSaveError err = pfn_read(in, info.Version, info.DataSize, hlp.PP, hlp.RData);
-            if (!err)
-                return err;
+        // Test the size before allocating, in case the header is corrupt
+        const soff_t data_left = in->GetLength() - in->GetPosition();
+        if ((data_left >= 0) && (static_cast<soff_t>(info.DataSize) > data_left))
+            return new SavegameError(kSvgErr_ComponentSizeMismatch, String::FromFormat("Expected: %u, left in stream: %jd",
+                info.DataSize, static_cast<intmax_t>(data_left)));
 
-            if (prescan)
-                in->Seek(info.DataOffset + info.DataSize, kSeekBegin);
-        }
+        cmp.Handler = handler;
+        cmp.Data.resize(info.DataSize);
+        const size_t read_sz = in->Read(cmp.Data.data(), info.DataSize);
+        if (read_sz != info.DataSize)
+            return new SavegameError(kSvgErr_ComponentSizeMismatch, String::FromFormat("Expected: %u, actual: %zu",
+                info.DataSize, read_sz));
     }
     // Else, skip the data
     else
@@ -2009,23 +2014,89 @@ HSaveError ReadComponent(Stream *in, SvgCmpReadHelper &hlp, ComponentInfo &info)
         in->Seek(info.DataSize);
     }
 
-    // Test that we have reached an expected position in stream
-    if (in->GetPosition() - info.DataOffset != info.DataSize)
-        return new SavegameError(kSvgErr_ComponentSizeMismatch, String::FromFormat("Expected: %jd, actual: %jd",
-            static_cast<intmax_t>(info.DataSize), static_cast<intmax_t>(in->GetPosition() - info.DataOffset)));
     if (!AssertFormatTag(in, info.Name, false))
         return new SavegameError(kSvgErr_ComponentClosingTagFormat);
     return HSaveError::None();
 }
 
-HSaveError ReadAllImpl(Stream *in, SavegameVersion svg_version, SaveCmpSelection select_cmp,
-    const PreservedParams &pp, RestoredData &r_data)
+// Uncompresses component data if necessary, and tests its checksum;
+// does not access any shared state, so may be run in parallel for
+// different components.
+HSaveError DecodeComponent(LoadedComponent &cmp)
 {
-    // Prepare a helper struct we will be passing to the block reading proc
-    SvgCmpReadHelper hlp(svg_version, select_cmp, pp, r_data);
-    GenerateHandlersMap(hlp.Handlers);
+    const ComponentInfo &info = cmp.Info;
+    if ((info.Flags & kSvgCmp_Deflate) != 0)
+    {
+        // The uncompressed size is not verified by anything yet, so don't
+        // allocate all of it at once, but grow the buffer while inflating
+        const size_t chunk_sz = 64 * 1024;
+        // read one byte more than expected, to make sure that there's no more data
+        const size_t read_limit = static_cast<size_t>(info.UncompressedDataSize) + 1u;
+        std::vector<uint8_t> data;
+        size_t uncomp_data_sz = 0u;
+        {
+            DeflateStream deflate_s(std::make_unique<VectorStream>(cmp.Data), 0, cmp.Data.size());
+            while (uncomp_data_sz < read_limit)
+            {
+                data.resize(std::min(read_limit, uncomp_data_sz + chunk_sz));
+                uncomp_data_sz += deflate_s.Read(data.data() + uncomp_data_sz, data.size() - uncomp_data_sz);
+                if (uncomp_data_sz < data.size())
+                    break; // end of data
+            }
+        }
+        if (uncomp_data_sz != info.UncompressedDataSize)
+            return new SavegameError(kSvgErr_ComponentUncompressedSizeMismatch, String::FromFormat("Expected: %u, actual: %zu",
+                info.UncompressedDataSize, uncomp_data_sz));
+        data.resize(uncomp_data_sz);
+        cmp.Data = std::move(data);
+    }
+
+    if ((info.Flags & kSvgCmp_Checksum) != 0)
+    {
+        const uint32_t checksum = crc32_checksum(cmp.Data.data(), cmp.Data.size());
+        if (checksum != info.Checksum)
+            return new SavegameError(kSvgErr_ComponentChecksumMismatch, String::FromFormat("Expected: %08X, actual: %08X",
+                info.Checksum, checksum));
+    }
+    return HSaveError::None();
+}
+
+// Unserializes the decoded component data
+HSaveError UnserializeComponent(LoadedComponent &cmp, SvgCmpReadHelper &hlp)
+{
+    const ComponentInfo &info = cmp.Info;
+    const bool prescan = (hlp.RData.Result.RestoreFlags & kSaveRestore_Prescan) != 0;
+    auto pfn_read = prescan ? cmp.Handler->Prescan : cmp.Handler->Unserialize;
+
+    const soff_t data_sz = cmp.Data.size();
+    Stream mem_in(std::make_unique<VectorStream>(cmp.Data));
+    HSaveError err = pfn_read(&mem_in, info.Version, data_sz, hlp.PP, hlp.RData);
+    if (!err)
+        return err;
+
+    // Test that we have reached an expected position in stream
+    // (prescan is allowed to read only a part of data)
+    if (!prescan && (mem_in.GetPosition() != data_sz))
+    {
+        return new SavegameError(((info.Flags & kSvgCmp_Deflate) != 0) ?
+                kSvgErr_ComponentUncompressedSizeMismatch : kSvgErr_ComponentSizeMismatch,
+            String::FromFormat("Expected: %jd, actual: %jd",
+                static_cast<intmax_t>(data_sz), static_cast<intmax_t>(mem_in.GetPosition())));
+    }
+    return HSaveError::None();
+}
 
-    size_t idx = 0;
+static HSaveError MakeComponentReadError(size_t idx, const ComponentInfo &info, const HSaveError &err)
+{
+    return new SavegameError(kSvgErr_ComponentUnserialization,
+        String::FromFormat("(#%zu) %s, version %i, at offset %u.",
+        idx, info.Name.IsEmpty() ? "unknown" : info.Name.GetCStr(), info.Version, info.TagOffset),
+        err);
+}
+
+// Reads the list of components, along with their data
+HSaveError ReadComponentList(Stream *in, SvgCmpReadHelper &hlp, std::vector<LoadedComponent> &components)
+{
     if (!AssertFormatTag(in, ComponentListTag, true))
         return new SavegameError(kSvgErr_ComponentListOpeningTagFormat);
     do
@@ -2038,21 +2109,59 @@ HSaveError ReadAllImpl(Stream *in, SavegameVersion svg_version, SaveCmpSelection
         // If the list's end was not detected, then seek back and continue reading
         in->Seek(off, kSeekBegin);
 
-        ComponentInfo info;
-        HSaveError err = ReadComponent(in, hlp, info);
+        components.emplace_back();
+        HSaveError err = ReadComponent(in, hlp, components.back());
         if (!err)
-        {
-            return new SavegameError(kSvgErr_ComponentUnserialization,
-                String::FromFormat("(#%d) %s, version %i, at offset %u.",
-                idx, info.Name.IsEmpty() ? "unknown" : info.Name.GetCStr(), info.Version, info.TagOffset),
-                err);
-        }
-        idx++;
+            return MakeComponentReadError(components.size() - 1, components.back().Info, err);
     }
     while (!in->EOS());
     return new SavegameError(kSvgErr_ComponentListClosingTagMissing);
 }
 
+HSaveError ReadAllImpl(Stream *in, SavegameVersion svg_version, SaveCmpSelection select_cmp,
+    const PreservedParams &pp, RestoredData &r_data)
+{
+    // Prepare a helper struct we will be passing to the block reading proc
+    SvgCmpReadHelper hlp(svg_version, select_cmp, pp, r_data);
+    GenerateHandlersMap(hlp.Handlers);
+
+    // Read all the components first, decode them in parallel,
+    // and only then unserialize them in their order
+    std::vector<LoadedComponent> components;
+    HSaveError err = ReadComponentList(in, hlp, components);
+    if (!err)
+        return err;
+
+    // Prescanning is done for every save when listing them, where starting
+    // and joining the threads for each file would cost more than it saves;
+    // a pool of 1 thread runs all the jobs on this thread
+    const bool prescan = (r_data.Result.RestoreFlags & kSaveRestore_Prescan) != 0;
+    ThreadPool pool(prescan ? 1u : std::min(ThreadPool::GetDefaultThreadCount(), components.size()));
+    pool.Run(components.size(), [&components](size_t i)
+        {
+            if (components[i].Handler)
+                components[i].DecodeError = DecodeComponent(components[i]);
+        });
+    // Fail before any of the game data is touched
+    for (size_t i = 0; i < components.size(); ++i)
+    {
+        if (!components[i].DecodeError)
+            return MakeComponentReadError(i, components[i].Info, components[i].DecodeError);
+    }
+
+    for (size_t i = 0; i < components.size(); ++i)
+    {
+        LoadedComponent &cmp = components[i];
+        if (!cmp.Handler)
+            continue;
+        err = UnserializeComponent(cmp, hlp);
+        if (!err)
+            return MakeComponentReadError(i, cmp.Info, err);
+        cmp.Data = std::vector<uint8_t>(); // free the memory early
+    }
+    return HSaveError::None();
+}
+
 HSaveError ReadAll(Stream *in, SavegameVersion svg_version, SaveCmpSelection select_cmp,
     const PreservedParams &pp, RestoredData &r_data)
 {
@@ -2067,74 +2176,147 @@ HSaveError PrescanAll(Stream *in, SavegameVersion svg_version, SaveCmpSelection
     return ReadAllImpl(in, svg_version, select_cmp, pp, r_data);
 }
 
-HSaveError WriteComponent(Stream *out, ComponentHandler &hdlr, bool compress)
+// Prepared data of a component, ready to be written into the save;
+// also used as a cache by the incremental saving: if the component's data
+// did not change since the previous save, then its previously compressed
+// data is written again, instead of compressing the same data anew.
+struct ComponentCache
 {
-    uint32_t flags = kSvgCmp_Deflate * compress;
-
-    WriteFormatTag(out, hdlr.Name, true);
-    soff_t header_pos = out->GetPosition();
-    out->WriteInt32(0); // header size placeholder
-    out->WriteInt32(flags); // flags
-    out->WriteInt32(hdlr.Version);
-    soff_t data_sz_pos = out->GetPosition();
-    out->WriteInt32(0); // component size placeholder
-    out->WriteInt32(0); // uncompressed size
-    out->WriteInt32(0); // checksum
+    int32_t              Version = -1;   // component version
+    std::vector<uint8_t> Data;           // uncompressed component data
+    std::vector<uint8_t> CompressedData; // compressed component data
+    uint32_t             Checksum = 0u;  // checksum of the uncompressed data
+};
 
-    soff_t data_begin_pos = out->GetPosition();
+// Caches of the written components, one per component handler
+std::vector<ComponentCache> ComponentCaches;
 
-    uint32_t uncomp_data_sz = 0u;
-    if (compress)
+// Prepares the caches for writing a new save
+static void ResetComponentCaches(bool use_cache)
+{
+    if (use_cache)
     {
-        auto deflate_s = std::make_unique<DeflateStream>(out->ReleaseStreamBase(), kStream_Write);
-        auto deflate_out = std::make_unique<Stream>(std::move(deflate_s));
-        HSaveError err = hdlr.Serialize(deflate_out.get());
-        if (!err)
-            return err;
-
-        // FIXME: this is very ugly, maybe may be fixed by changing stream base storage to shared ptr?
-        deflate_s.reset(dynamic_cast<DeflateStream *>(deflate_out->ReleaseStreamBase().release()));
-        deflate_s->Finalize();
-        uncomp_data_sz = deflate_s->GetProcessedInput();
-        out->AttachStreamBase(deflate_s->ReleaseStreamBase());
+        size_t handler_count = 0;
+        for (; !ComponentHandlers[handler_count].Name.IsEmpty(); ++handler_count);
+        ComponentCaches.resize(handler_count);
     }
     else
     {
-        HSaveError err = hdlr.Serialize(out);
-        if (!err)
-            return err;
+        ComponentCaches.clear();
+        ComponentCaches.shrink_to_fit();
     }
+}
 
-    soff_t data_end_pos = out->GetPosition();
+// Serializes the component in memory
+static HSaveError SerializeToMemory(ComponentHandler &hdlr, std::vector<uint8_t> &data)
+{
+    Stream mem_out(std::make_unique<VectorStream>(data, kStream_Write));
+    return hdlr.Serialize(&mem_out);
+}
 
-    out->Seek(header_pos, kSeekBegin);
-    out->WriteInt32(data_begin_pos - header_pos);
-    out->Seek(data_sz_pos, kSeekBegin);
-    out->WriteInt32(data_end_pos - data_begin_pos); // size of serialized component data
-    out->WriteInt32(compress ? uncomp_data_sz : (data_end_pos - data_begin_pos)); // uncompressed size
-    out->WriteInt32(0); // checksum (?)
-    out->Seek(data_end_pos, kSeekBegin);
-    WriteFormatTag(out, hdlr.Name, false);
-    return HSaveError::None();
+// Calculates the checksum and compresses the serialized component data,
+// unless the same data is already present in the cache; returns whether
+// the cached data was reused. Does not access any shared state, so may be
+// run in parallel for different components.
+static bool PrepareComponent(ComponentSnapshot &snap, bool compress, ComponentCache &cache)
+{
+    if (compress && (cache.Version == snap.Version) && (cache.Data == snap.Data))
+        return true;
+
+    cache.Version = snap.Version;
+    cache.Data = std::move(snap.Data);
+    cache.Checksum = crc32_checksum(cache.Data.data(), cache.Data.size());
+    cache.CompressedData.clear();
+    if (compress)
+    {
+        auto deflate_s = std::make_unique<DeflateStream>(
+            std::make_unique<VectorStream>(cache.CompressedData, kStream_Write), kStream_Write);
+        deflate_s->Write(cache.Data.data(), cache.Data.size());
+        deflate_s->Finalize();
+    }
+    return false;
 }
 
-HSaveError WriteAllCommon(Stream *out, SaveCmpSelection select_cmp, bool compress)
+// Writes prepared component along with its header
+static void WritePreparedComponent(Stream *out, const String &name, bool compress, const ComponentCache &prep)
 {
-    WriteFormatTag(out, ComponentListTag, true);
+    const std::vector<uint8_t> &data = compress ? prep.CompressedData : prep.Data;
+    const uint32_t flags = (kSvgCmp_Deflate * compress) | kSvgCmp_Checksum;
+
+    WriteFormatTag(out, name, true);
+    out->WriteInt32(ComponentHeaderSize);
+    out->WriteInt32(flags);
+    out->WriteInt32(prep.Version);
+    out->WriteInt32(data.size()); // size of serialized component data
+    out->WriteInt32(prep.Data.size()); // uncompressed size
+    out->WriteInt32(prep.Checksum);
+    out->Write(data.data(), data.size());
+    WriteFormatTag(out, name, false);
+}
+
+HSaveError WriteAllCommon(Stream *out, SaveCmpSelection select_cmp, bool compress, bool incremental)
+{
+    std::vector<ComponentSnapshot> snapshots;
+    HSaveError err = SnapshotAllCommon(select_cmp, snapshots);
+    if (!err)
+        return err;
+    return WriteAllSnapshots(out, snapshots, compress, incremental);
+}
+
+HSaveError SnapshotAllCommon(SaveCmpSelection select_cmp, std::vector<ComponentSnapshot> &snapshots)
+{
+    snapshots.clear();
     for (int type = 0; !ComponentHandlers[type].Name.IsEmpty(); ++type)
     {
         if ((ComponentHandlers[type].Selection & select_cmp) == 0)
             continue; // skip this component
 
-        HSaveError err = WriteComponent(out, ComponentHandlers[type], compress);
+        ComponentSnapshot snap;
+        snap.Type = type;
+        // NOTE: make a separate copy of the name's buffer, because
+        // snapshots may be passed to another thread
+        snap.Name = String(ComponentHandlers[type].Name.GetCStr());
+        snap.Version = ComponentHandlers[type].Version;
+        HSaveError err = SerializeToMemory(ComponentHandlers[type], snap.Data);
         if (!err)
         {
             return new SavegameError(kSvgErr_ComponentSerialization,
                 String::FromFormat("Component: (#%d) %s", type, ComponentHandlers[type].Name.GetCStr()),
                 err);
         }
+        snapshots.push_back(std::move(snap));
+    }
+    return HSaveError::None();
+}
+
+HSaveError WriteAllSnapshots(Stream *out, std::vector<ComponentSnapshot> &snapshots,
+    bool compress, bool incremental)
+{
+    // Caches are only useful when compressing, as that is the slowest part
+    const bool use_cache = compress && incremental;
+    ResetComponentCaches(use_cache);
+
+    // Compress components in parallel, and then write them in order
+    std::vector<ComponentCache> prepared(use_cache ? 0 : snapshots.size());
+    std::vector<uint8_t> unchanged(snapshots.size());
+    auto get_prepared = [&](size_t i) -> ComponentCache&
+        { return use_cache ? ComponentCaches[snapshots[i].Type] : prepared[i]; };
+    ThreadPool pool(std::min(ThreadPool::GetDefaultThreadCount(), snapshots.size()));
+    pool.Run(snapshots.size(), [&](size_t i)
+        { unchanged[i] = PrepareComponent(snapshots[i], compress, get_prepared(i)); });
+
+    WriteFormatTag(out, ComponentListTag, true);
+    for (size_t i = 0; i < snapshots.size(); ++i)
+    {
+        WritePreparedComponent(out, snapshots[i].Name, compress, get_prepared(i));
+        if (!use_cache)
+            prepared[i] = ComponentCache(); // free the memory early
     }
     WriteFormatTag(out, ComponentListTag, false);
+
+    if (use_cache)
+        Debug::Printf("Incremental save: %d of %d components unchanged",
+            static_cast<int>(std::count(unchanged.begin(), unchanged.end(), 1)), static_cast<int>(snapshots.size()));
     return HSaveError::None();
 }
 
@@ -14,6 +14,7 @@
 #ifndef __AGS_EE_GAME__SAVEGAMECOMPONENTS_H
 #define __AGS_EE_GAME__SAVEGAMECOMPONENTS_H
 
+#include <vector>
 #include "game/savegame.h"
 #include "util/stream.h"
 
@@ -40,8 +41,27 @@ namespace SavegameComponents
     // does *not* keep any actual game data
     HSaveError    PrescanAll(Stream *in, SavegameVersion svg_version, SaveCmpSelection select_cmp,
         const PreservedParams &pp, RestoredData &r_data);
-    // Writes a full list of common components to the stream
-    HSaveError    WriteAllCommon(Stream *out, SaveCmpSelection select_cmp, bool compress);
+    // Writes a full list of common components to the stream;
+    // in the incremental mode the compressed data of each component is kept
+    // in memory, and reused by the next save if the component did not change
+    HSaveError    WriteAllCommon(Stream *out, SaveCmpSelection select_cmp, bool compress, bool incremental = false);
+
+    // Serialized data of a single component, prepared for writing into the save
+    struct ComponentSnapshot
+    {
+        int                  Type = -1; // index of the component handler
+        Common::String       Name;
+        int32_t              Version = 0;
+        std::vector<uint8_t> Data;
+    };
+
+    // Serializes selected common components into memory
+    HSaveError    SnapshotAllCommon(SaveCmpSelection select_cmp, std::vector<ComponentSnapshot> &snapshots);
+    // Writes a list of the previously serialized components to the stream;
+    // this does not access the game state, and may be run on another thread,
+    // but there may be only one such write at a time.
+    HSaveError    WriteAllSnapshots(Stream *out, std::vector<ComponentSnapshot> &snapshots,
+        bool compress, bool incremental = false);
 
     // Utility functions for reading and writing legacy interactions,
     // or their "times run" counters separately.
@@ -241,6 +241,7 @@ public:
     bool DoesSupportVsyncToggle() override { return _capsVsync; }
     void RenderSpritesAtScreenResolution(bool enabled) override;
     void UseSmoothScaling(bool enabled) override { _smoothScaling = enabled; }
+    void SetRenderThreads(int /*thread_count*/) override { }
     bool SupportsGammaControl() override;
     void SetGamma(int newGamma) override;
 
@@ -16,7 +16,10 @@
 #include <array>
 #include <stack>
 #include "ac/sys_events.h"
+#include "debug/out.h"
 #include "gfx/ali3dexception.h"
+#include "gfx/blend_kernels.h"
+#include "gfx/blender.h"
 #include "gfx/gfxfilter_sdl_renderer.h"
 #include "gfx/gfx_util.h"
 #include "platform/base/agsplatformdriver.h"
@@ -33,8 +36,6 @@ namespace ALSW
 
 using namespace Common;
 
-static uint32_t _trans_alpha_blender32(uint32_t x, uint32_t y, uint32_t n);
-
 
 // ----------------------------------------------------------------------------
 // SDLRendererGraphicsDriver
@@ -52,7 +53,8 @@ static auto fix_alpha_blender = SDL_ComposeCustomBlendMode(
 );
 #endif // SDL_VERSION_ATLEAST(2, 0, 5)
 
-SDLRendererGraphicsDriver::SDLRendererGraphicsDriver()
+SDLRendererGraphicsDriver::SDLRendererGraphicsDriver(bool headless)
+  : _headless(headless)
 {
   _tint_red = 0;
   _tint_green = 0;
@@ -124,6 +126,15 @@ bool SDLRendererGraphicsDriver::SetDisplayMode(const DisplayMode &mode)
 
   _capsVsync = true; // reset vsync flag, allow to try setting again
 
+  if (_headless)
+  {
+    // No window and no presentation, the game is only drawn on the virtual screen
+    _capsVsync = false;
+    OnInit();
+    OnModeSet(mode);
+    return true;
+  }
+
   SDL_Window *window = sys_get_window();
   if (!window)
   {
@@ -221,7 +232,8 @@ void SDLRendererGraphicsDriver::CreateVirtualScreen()
   virtualScreen = _origVirtualScreen.get();
   _stageVirtualScreen = virtualScreen;
 
-  _screenTex = SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, vscreen_w, vscreen_h);
+  if (_renderer)
+    _screenTex = SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, vscreen_w, vscreen_h);
 
   // Fake bitmap that will wrap over texture pixels for simplier conversion
   _fakeTexBitmap = create_bitmap_placeholder(32, vscreen_w, vscreen_h, nullptr);
@@ -315,6 +327,15 @@ void SDLRendererGraphicsDriver::SetGamma(int newGamma)
   SDL_SetWindowGammaRamp(sys_get_window(), gamma_red, gamma_green, gamma_blue);
 }
 
+void SDLRendererGraphicsDriver::SetRenderThreads(int thread_count)
+{
+  const size_t use_threads = thread_count > 0 ? thread_count : ThreadPool::GetDefaultThreadCount();
+  if (use_threads == _renderThreads.GetThreadCount())
+    return;
+  _renderThreads.Start(use_threads);
+  Debug::Printf("Software renderer: using %zu thread(s) for drawing sprites", _renderThreads.GetThreadCount());
+}
+
 int SDLRendererGraphicsDriver::GetCompatibleBitmapFormat(int color_depth)
 {
   return color_depth;
@@ -577,8 +598,14 @@ void SDLRendererGraphicsDriver::RenderToBackBuffer()
     ClearDrawLists();
 }
 
+// Minimal height of a surface band, which is worth a separate thread
+static const int MinRenderBandHeight = 32;
+
 size_t SDLRendererGraphicsDriver::RenderSpriteBatch(const ALSpriteBatch &batch, size_t from, Bitmap *surface, int surf_offx, int surf_offy)
 {
+  if ((_renderThreads.GetThreadCount() > 1) && (surface->GetHeight() >= MinRenderBandHeight * 2))
+    return RenderSpriteBatchBanded(batch, from, surface, surf_offx, surf_offy);
+
   for (; (from < _spriteList.size()) && (_spriteList[from].node == batch.ID); ++from)
   {
     const auto &sprite = _spriteList[from];
@@ -595,8 +622,12 @@ size_t SDLRendererGraphicsDriver::RenderSpriteBatch(const ALSpriteBatch &batch,
     else if (sprite.ddb == reinterpret_cast<ALSoftwareBitmap*>(DRAWENTRY_TINT))
     {
       // draw screen tint fx
-      set_trans_blender(_tint_red, _tint_green, _tint_blue, 0);
-      surface->LitBlendBlt(surface, 0, 0, 128);
+      if (!BlendKernels::DrawLitSprite(surface, surface, 0, 0, BlendKernels::kBlendKernel_Trans24,
+            128, makecol32(_tint_red, _tint_green, _tint_blue)))
+      {
+        set_trans_blender(_tint_red, _tint_green, _tint_blue, 0);
+        surface->LitBlendBlt(surface, 0, 0, 128);
+      }
       continue;
     }
 
@@ -620,9 +651,17 @@ size_t SDLRendererGraphicsDriver::RenderSpriteBatch(const ALSpriteBatch &batch,
     else if (has_alpha)
     {
       if (alpha == 255) // no global transparency, simple alpha blend
+      {
+        if (BlendKernels::DrawTransSprite(surface, native_bmp, drawAtX, drawAtY, BlendKernels::kBlendKernel_Alpha32))
+          continue;
         set_alpha_blender();
+      }
       else
+      {
+        if (BlendKernels::DrawTransSprite(surface, native_bmp, drawAtX, drawAtY, BlendKernels::kBlendKernel_TransAlpha32, alpha))
+          continue;
         set_blender_mode(nullptr, nullptr, _trans_alpha_blender32, 0, 0, 0, alpha);
+      }
 
       surface->TransBlendBlt(native_bmp, drawAtX, drawAtY);
     }
@@ -636,6 +675,227 @@ size_t SDLRendererGraphicsDriver::RenderSpriteBatch(const ALSpriteBatch &batch,
   return from;
 }
 
+// Tries to draw the operation using the blend kernels;
+// returns false if it has to be drawn using the Allegro blenders instead
+static bool DrawBandOpWithKernels(Bitmap *band, int y, const ALSpriteDrawOp &op, const ALBlender &blender)
+{
+    using namespace BlendKernels;
+    switch (op.Type)
+    {
+    case ALSpriteDrawOp::kMaskedBlit:
+        return DrawTransSprite(band, op.Bmp, op.X, y, kBlendKernel_Copy);
+    case ALSpriteDrawOp::kTransBlend:
+        switch (blender.Type)
+        {
+        case ALBlender::kAlpha:
+            return DrawTransSprite(band, op.Bmp, op.X, y, kBlendKernel_Alpha32);
+        case ALBlender::kTransAlpha:
+            return DrawTransSprite(band, op.Bmp, op.X, y, kBlendKernel_TransAlpha32, blender.Alpha);
+        case ALBlender::kTrans:
+            return DrawTransSprite(band, op.Bmp, op.X, y, kBlendKernel_Trans24, blender.Alpha);
+        default:
+            return false;
+        }
+    case ALSpriteDrawOp::kTint:
+        return DrawLitSprite(band, band, 0, 0, kBlendKernel_Trans24, 128,
+            makecol32(blender.R, blender.G, blender.B));
+    default:
+        return false;
+    }
+}
+
+// Draws the operation on a surface band, which begins at the given y offset;
+// blender is the one which is currently set for this operation
+static void DrawBandOp(Bitmap *band, int band_y, const ALSpriteDrawOp &op, const ALBlender &blender)
+{
+    const int y = (op.Type == ALSpriteDrawOp::kTint) ? 0 : op.Y - band_y;
+    if ((op.Type != ALSpriteDrawOp::kTint) &&
+        ((y >= band->GetHeight()) || (y + op.Bmp->GetHeight() <= 0)))
+        return; // not on this band
+    if (DrawBandOpWithKernels(band, y, op, blender))
+        return;
+
+    switch (op.Type)
+    {
+    case ALSpriteDrawOp::kBlit:
+        band->Blit(op.Bmp, 0, 0, op.X, y, op.Bmp->GetWidth(), op.Bmp->GetHeight());
+        break;
+    case ALSpriteDrawOp::kMaskedBlit:
+        band->Blit(op.Bmp, op.X, y, kBitmap_Transparency);
+        break;
+    case ALSpriteDrawOp::kTransBlend:
+        band->TransBlendBlt(op.Bmp, op.X, y);
+        break;
+    case ALSpriteDrawOp::kTint:
+        band->LitBlendBlt(band, 0, 0, 128);
+        break;
+    default:
+        break;
+    }
+}
+
+static void SetBlender(const ALBlender &blender)
+{
+    switch (blender.Type)
+    {
+    case ALBlender::kAlpha:
+        set_alpha_blender();
+        break;
+    case ALBlender::kTransAlpha:
+        set_blender_mode(nullptr, nullptr, _trans_alpha_blender32, 0, 0, 0, blender.Alpha);
+        break;
+    case ALBlender::kTrans:
+        set_trans_blender(blender.R, blender.G, blender.B, blender.Alpha);
+        break;
+    default:
+        break;
+    }
+}
+
+// NOTE: the banded rendering must give exactly same result as the regular one.
+// Each band is drawn by only one thread, and all the sprites are drawn
+// on it in the list order, so every pixel undergoes the same sequence of
+// operations. Allegro's blenders are global, therefore the operations are
+// queued for as long as they can use the same blender, and the queue
+// is flushed (drawn on all bands in parallel) when a different blender
+// is required. Anything which cannot be split into bands is drawn on
+// the calling thread, after flushing the queue.
+size_t SDLRendererGraphicsDriver::RenderSpriteBatchBanded(const ALSpriteBatch &batch, size_t from, Bitmap *surface, int surf_offx, int surf_offy)
+{
+  PrepareRenderBands(surface);
+  ALBlender blender; // a blender used by the pending operations
+  for (; (from < _spriteList.size()) && (_spriteList[from].node == batch.ID); ++from)
+  {
+    const auto &sprite = _spriteList[from];
+    if (sprite.ddb == nullptr)
+    {
+      // Plugin may draw on the stage surface, so have everything drawn before
+      FlushBandOps(blender);
+      if (_spriteEvtCallback)
+        _spriteEvtCallback(sprite.x, sprite.y);
+      else
+        throw Ali3DException("Unhandled attempt to draw null sprite");
+      // Stage surface could have been replaced by plugin
+      surface = _stageVirtualScreen;
+      PrepareRenderBands(surface);
+      continue;
+    }
+
+    ALSpriteDrawOp op;
+    ALBlender op_blender;
+    if (sprite.ddb == reinterpret_cast<ALSoftwareBitmap*>(DRAWENTRY_TINT))
+    {
+      // draw screen tint fx
+      op = ALSpriteDrawOp(ALSpriteDrawOp::kTint, nullptr, 0, 0);
+      op_blender = ALBlender(ALBlender::kTrans, _tint_red, _tint_green, _tint_blue, 0);
+    }
+    else
+    {
+      ALSoftwareBitmap* bitmap = sprite.ddb;
+      const int drawAtX = sprite.x + surf_offx;
+      const int drawAtY = sprite.y + surf_offy;
+      const int alpha = bitmap->GetAlpha();
+      const bool has_alpha = bitmap->HasAlpha();
+      const bool is_opaque = bitmap->IsOpaque();
+      const Bitmap *native_bmp = bitmap->GetBitmap();
+
+      if (alpha <= 0)
+        continue; // fully transparent, do nothing
+      else if (is_opaque && (native_bmp == surface) && (alpha == 255))
+        continue;
+      else if (is_opaque)
+      {
+        op = ALSpriteDrawOp(ALSpriteDrawOp::kBlit, native_bmp, drawAtX, drawAtY);
+      }
+      else if (has_alpha)
+      {
+        op = ALSpriteDrawOp(ALSpriteDrawOp::kTransBlend, native_bmp, drawAtX, drawAtY);
+        op_blender = (alpha == 255) ? ALBlender(ALBlender::kAlpha, 0, 0, 0, 0) :
+            ALBlender(ALBlender::kTransAlpha, 0, 0, 0, alpha);
+      }
+      else
+      {
+        // Same as GfxUtil::DrawSpriteWithTransparency
+        const int surface_depth = surface->GetColorDepth();
+        const int sprite_depth = native_bmp->GetColorDepth();
+        if ((surface_depth != sprite_depth) && (sprite_depth > 8))
+        {
+          // requires a converted sprite, do this on the calling thread
+          FlushBandOps(blender);
+          GfxUtil::DrawSpriteWithTransparency(surface, native_bmp, drawAtX, drawAtY, alpha);
+          continue;
+        }
+        else if ((alpha < 0xFF) && (surface_depth > 8) && (sprite_depth > 8))
+        {
+          op = ALSpriteDrawOp(ALSpriteDrawOp::kTransBlend, native_bmp, drawAtX, drawAtY);
+          op_blender = ALBlender(ALBlender::kTrans, 0, 0, 0, alpha);
+        }
+        else
+        {
+          op = ALSpriteDrawOp(ALSpriteDrawOp::kMaskedBlit, native_bmp, drawAtX, drawAtY);
+        }
+      }
+    }
+
+    if (op.Bmp == surface)
+    {
+      // drawing surface over itself, cannot split this into bands
+      FlushBandOps(blender);
+      SetBlender(op_blender);
+      DrawBandOp(surface, 0, op, op_blender);
+      continue;
+    }
+    if ((op_blender.Type != ALBlender::kNone) && (op_blender != blender))
+    {
+      FlushBandOps(blender);
+      blender = op_blender;
+    }
+    _bandOps.push_back(op);
+  }
+  FlushBandOps(blender);
+  _bandSurfaces.clear();
+  _bandOffsets.clear();
+  return from;
+}
+
+void SDLRendererGraphicsDriver::PrepareRenderBands(Bitmap *surface)
+{
+  _bandSurfaces.clear();
+  _bandOffsets.clear();
+  const int surf_w = surface->GetWidth();
+  const int surf_h = surface->GetHeight();
+  const int band_count = std::max(1, std::min(static_cast<int>(_renderThreads.GetThreadCount()),
+      surf_h / MinRenderBandHeight));
+  const int band_h = (surf_h + band_count - 1) / band_count;
+  const Rect clip = surface->GetClip();
+  for (int y = 0; y < surf_h; y += band_h)
+  {
+    const Rect band_rc(0, y, surf_w - 1, std::min(y + band_h, surf_h) - 1);
+    const Rect band_clip = IntersectRects(clip, band_rc);
+    if (band_clip.IsEmpty())
+      continue; // nothing may be drawn here
+    std::unique_ptr<Bitmap> band(BitmapHelper::CreateSubBitmap(surface, band_rc));
+    band->SetClip(Rect::MoveBy(band_clip, 0, -y));
+    _bandSurfaces.push_back(std::move(band));
+    _bandOffsets.push_back(y);
+  }
+}
+
+void SDLRendererGraphicsDriver::FlushBandOps(const ALBlender &blender)
+{
+  if (_bandOps.empty())
+    return;
+  SetBlender(blender);
+  _renderThreads.Run(_bandSurfaces.size(), [this, &blender](size_t band)
+  {
+    Bitmap *band_surf = _bandSurfaces[band].get();
+    const int band_y = _bandOffsets[band];
+    for (const auto &op : _bandOps)
+      DrawBandOp(band_surf, band_y, op, blender);
+  });
+  _bandOps.clear();
+}
+
 void SDLRendererGraphicsDriver::BlitToTexture()
 {
     void *pixels = nullptr;
@@ -787,28 +1047,6 @@ bool SDLRendererGraphicsDriver::GetCopyOfScreenIntoBitmap(Bitmap *destination, c
   return true;
 }
 
-// add the alpha values together, used for compositing alpha images
-// TODO: why is this here, move to gfx/blender? check if there's already similar function there
-static uint32_t _trans_alpha_blender32(uint32_t x, uint32_t y, uint32_t n)
-{
-   uint32_t res, g;
-
-   n = (n * geta32(x)) / 256;
-
-   if (n)
-      n++;
-
-   res = ((x & 0xFF00FF) - (y & 0xFF00FF)) * n / 256 + y;
-   y &= 0xFF00;
-   x &= 0xFF00;
-   g = (x - y) * n / 256 + y;
-
-   res &= 0xFF00FF;
-   g &= 0xFF00;
-
-   return res | g;
-}
-
 bool SDLRendererGraphicsDriver::SetVsyncImpl(bool enabled, bool &vsync_res)
 {
 #if SDL_VERSION_ATLEAST(2, 0, 18)
@@ -827,10 +1065,14 @@ bool SDLRendererGraphicsDriver::SetVsyncImpl(bool enabled, bool &vsync_res)
 }
 
 SDLRendererGraphicsFactory *SDLRendererGraphicsFactory::_factory = nullptr;
+SDLRendererGraphicsFactory *SDLRendererGraphicsFactory::_nullFactory = nullptr;
 
 SDLRendererGraphicsFactory::~SDLRendererGraphicsFactory()
 {
-    _factory = nullptr;
+    if (_headless)
+        _nullFactory = nullptr;
+    else
+        _factory = nullptr;
 }
 
 size_t SDLRendererGraphicsFactory::GetFilterCount() const
@@ -857,14 +1099,21 @@ String SDLRendererGraphicsFactory::GetDefaultFilterID() const
 /* static */ SDLRendererGraphicsFactory *SDLRendererGraphicsFactory::GetFactory()
 {
     if (!_factory)
-        _factory = new SDLRendererGraphicsFactory();
+        _factory = new SDLRendererGraphicsFactory(false);
     return _factory;
 }
 
+/* static */ SDLRendererGraphicsFactory *SDLRendererGraphicsFactory::GetNullFactory()
+{
+    if (!_nullFactory)
+        _nullFactory = new SDLRendererGraphicsFactory(true);
+    return _nullFactory;
+}
+
 SDLRendererGraphicsDriver *SDLRendererGraphicsFactory::EnsureDriverCreated()
 {
     if (!_driver)
-        _driver = new SDLRendererGraphicsDriver();
+        _driver = new SDLRendererGraphicsDriver(_headless);
     return _driver;
 }
 
@@ -30,6 +30,7 @@
 #include "gfx/ddb.h"
 #include "gfx/gfxdriverfactorybase.h"
 #include "gfx/gfxdriverbase.h"
+#include "util/thread_pool.h"
 
 namespace AGS
 {
@@ -144,20 +145,56 @@ struct ALSpriteBatch
 };
 typedef std::vector<ALSpriteBatch> ALSpriteBatches;
 
+// Allegro's blender setup, which has to be applied before drawing a sprite.
+// Blenders are global in Allegro, so they cannot be changed while there are
+// sprites being drawn on other threads.
+struct ALBlender
+{
+    enum BlenderType { kNone, kAlpha, kTransAlpha, kTrans };
+    BlenderType Type = kNone;
+    int R = 0, G = 0, B = 0, Alpha = 0;
+
+    ALBlender() = default;
+    ALBlender(BlenderType type, int r, int g, int b, int alpha)
+        : Type(type), R(r), G(g), B(b), Alpha(alpha) {}
+
+    bool operator ==(const ALBlender &other) const
+    {
+        return Type == other.Type && R == other.R && G == other.G && B == other.B && Alpha == other.Alpha;
+    }
+    bool operator !=(const ALBlender &other) const { return !(*this == other); }
+};
+
+// A sprite drawing operation, which may be done on a horizontal band
+// of the destination surface, independently from the other bands.
+struct ALSpriteDrawOp
+{
+    enum OpType { kBlit, kMaskedBlit, kTransBlend, kTint };
+    OpType Type = kBlit;
+    const Bitmap *Bmp = nullptr; // not used by kTint, which blends surface with itself
+    int X = 0, Y = 0;
+
+    ALSpriteDrawOp() = default;
+    ALSpriteDrawOp(OpType type, const Bitmap *bmp, int x, int y)
+        : Type(type), Bmp(bmp), X(x), Y(y) {}
+};
+
 
 class SDLRendererGraphicsDriver : public GraphicsDriverBase
 {
 public:
-    SDLRendererGraphicsDriver();
+    // Creates the software renderer; the headless renderer does not create
+    // any window and does not output anything, drawing only to the memory
+    explicit SDLRendererGraphicsDriver(bool headless = false);
     ~SDLRendererGraphicsDriver() override;
 
     ///////////////////////////////////////////////////////
     // Identification
     //
     // Gets graphic driver's identifier
-    const char *GetDriverID() override { return "Software"; }
+    const char *GetDriverID() override { return _headless ? "Null" : "Software"; }
     // Gets graphic driver's "friendly name"
-    const char *GetDriverName() override { return "SDL 2D Software renderer"; }
+    const char *GetDriverName() override { return _headless ? "Null renderer (no display output)" : "SDL 2D Software renderer"; }
 
     ///////////////////////////////////////////////////////
     // Attributes
@@ -207,6 +244,8 @@ public:
     void RenderSpritesAtScreenResolution(bool /*enabled*/) override { }
     // Enables or disables a smooth sprite scaling mode
     void UseSmoothScaling(bool /*enabled*/) override { }
+    // Sets the number of threads used to draw sprites
+    void SetRenderThreads(int thread_count) override;
     // Tells if driver supports gamma control
     bool SupportsGammaControl() override;
     // Sets gamma level
@@ -322,6 +361,13 @@ private:
     //
     // Renders single sprite batch on the precreated surface
     size_t RenderSpriteBatch(const ALSpriteBatch &batch, size_t from, Common::Bitmap *surface, int surf_offx, int surf_offy);
+    // Renders single sprite batch, splitting the surface into horizontal bands,
+    // which are drawn upon by multiple threads
+    size_t RenderSpriteBatchBanded(const ALSpriteBatch &batch, size_t from, Common::Bitmap *surface, int surf_offx, int surf_offy);
+    // Creates subbitmaps for the surface bands, each clipped by the surface's clip rect
+    void PrepareRenderBands(Common::Bitmap *surface);
+    // Draws all the pending operations on all the bands, using the given blender
+    void FlushBandOps(const ALBlender &blender);
     // Copy raw screen bitmap pixels to the SDL texture
     void BlitToTexture();
     // Render SDL texture on screen
@@ -330,6 +376,7 @@ private:
 
     PSDLRenderFilter _filter;
 
+    const bool _headless = false;
     bool _hasGamma = false;
     Uint16 _defaultGammaRed[256]{};
     Uint16 _defaultGammaGreen[256]{};
@@ -361,6 +408,14 @@ private:
     ALSpriteBatches _spriteBatches;
     // List of sprites to render
     std::vector<ALDrawListEntry> _spriteList;
+
+    // Threads used for rendering sprites on surface bands
+    ThreadPool _renderThreads;
+    // Surface bands, subbitmaps of the current stage surface, and their offsets
+    std::vector<std::unique_ptr<Bitmap>> _bandSurfaces;
+    std::vector<int> _bandOffsets;
+    // Pending draw operations, which may be run on all bands at once
+    std::vector<ALSpriteDrawOp> _bandOps;
 };
 
 
@@ -374,12 +429,19 @@ public:
     String               GetDefaultFilterID() const override;
 
     static SDLRendererGraphicsFactory *GetFactory();
+    // Gets the factory of the headless renderers
+    static SDLRendererGraphicsFactory *GetNullFactory();
 
 private:
+    explicit SDLRendererGraphicsFactory(bool headless) : _headless(headless) {}
+
     SDLRendererGraphicsDriver *EnsureDriverCreated() override;
     SDLRendererGfxFilter      *CreateFilter(const String &id) override;
 
+    const bool _headless;
+
     static SDLRendererGraphicsFactory *_factory;
+    static SDLRendererGraphicsFactory *_nullFactory;
 };
 
 } // namespace ALSW
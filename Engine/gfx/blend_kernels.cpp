@@ -0,0 +1,206 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "gfx/blend_kernels.h"
+#include "gfx/blend_kernels_impl.h"
+#include <SDL.h>
+#include "debug/out.h"
+#include "gfx/bitmap.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define AGS_BLEND_KERNELS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace AGS
+{
+namespace Engine
+{
+namespace BlendKernels
+{
+
+using namespace Common;
+
+namespace
+{
+
+const KernelSet ScalarKernels = MakeKernelSet<VecScalar>(kKernelArch_Scalar, "scalar");
+
+#if defined(AGS_BLEND_KERNELS_SSE2)
+
+// SSE2 implementation of the "vector" type, processes 4 pixels at a time
+struct VecSSE2
+{
+    typedef __m128i T;
+    enum { Width = 4 };
+
+    static T Load(const uint32_t *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void Store(uint32_t *p, T v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static T Set1(uint32_t v) { return _mm_set1_epi32(static_cast<int>(v)); }
+    static T Add(T a, T b) { return _mm_add_epi32(a, b); }
+    static T Sub(T a, T b) { return _mm_sub_epi32(a, b); }
+    // SSE2 does not have 32-bit multiplication with 32-bit result,
+    // so multiply even and odd lanes separately and combine low halves
+    static T Mul(T a, T b)
+    {
+        const T even = _mm_mul_epu32(a, b);
+        const T odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+    static T And(T a, T b) { return _mm_and_si128(a, b); }
+    static T AndNot(T a, T b) { return _mm_andnot_si128(a, b); }
+    static T Or(T a, T b) { return _mm_or_si128(a, b); }
+    static T Shr8(T a) { return _mm_srli_epi32(a, 8); }
+    static T Shr24(T a) { return _mm_srli_epi32(a, 24); }
+    static T Shl24(T a) { return _mm_slli_epi32(a, 24); }
+    static T CmpEq(T a, T b) { return _mm_cmpeq_epi32(a, b); }
+    static T CmpGt(T a, T b) { return _mm_cmpgt_epi32(a, b); }
+    static T Select(T mask, T a, T b) { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+    // For d in [1; 256] the float quotient is never rounded up to the next
+    // integer, so truncating it gives exactly the integer division result.
+    static T Recip65536(T d) { return _mm_cvttps_epi32(_mm_div_ps(_mm_set1_ps(65536.f), _mm_cvtepi32_ps(d))); }
+};
+
+const KernelSet SSE2Kernels = MakeKernelSet<VecSSE2>(kKernelArch_SSE2, "SSE2");
+
+#endif // AGS_BLEND_KERNELS_SSE2
+
+const KernelSet *SelectBestKernels()
+{
+    const KernelSet *kernels = nullptr;
+    for (int arch = kNumKernelArchs - 1; arch >= 0 && !kernels; --arch)
+        kernels = GetKernelSet(static_cast<KernelArch>(arch));
+    Debug::Printf(kDbgMsg_Info, "Blend kernels: using %s", kernels->Name);
+    return kernels;
+}
+
+} // namespace
+
+const KernelSet *GetKernelSet(KernelArch arch)
+{
+    switch (arch)
+    {
+    case kKernelArch_Scalar:
+        return &ScalarKernels;
+#if defined(AGS_BLEND_KERNELS_SSE2)
+    case kKernelArch_SSE2:
+        return SDL_HasSSE2() ? &SSE2Kernels : nullptr;
+#endif
+    case kKernelArch_AVX2:
+        return SDL_HasAVX2() ? Detail::GetAVX2Kernels() : nullptr;
+    default:
+        return nullptr;
+    }
+}
+
+const KernelSet &GetKernels()
+{
+    static const KernelSet *kernels = SelectBestKernels();
+    return *kernels;
+}
+
+bool CanDraw(const Bitmap *ds, const Bitmap *sprite)
+{
+    if ((ds->GetColorDepth() != 32) || (sprite->GetColorDepth() != 32))
+        return false;
+    // Drawing a bitmap over itself is only supported without an offset, because
+    // otherwise the result depends on the order in which pixels are processed
+    BITMAP *dst = const_cast<BITMAP*>(ds->GetAllegroBitmap());
+    BITMAP *src = const_cast<BITMAP*>(sprite->GetAllegroBitmap());
+    return !is_same_bitmap(dst, src) || (dst == src);
+}
+
+// Calculates the sprite's drawn area, clipped by the destination's clip rect,
+// the same way as Allegro's sprite drawing functions do.
+// Returns false if there's nothing to draw.
+static bool ClipSprite(const BITMAP *dst, const BITMAP *src, int dx, int dy,
+    int &sxbeg, int &sybeg, int &dxbeg, int &dybeg, int &w, int &h)
+{
+    if (dst->clip)
+    {
+        int tmp = dst->cl - dx;
+        sxbeg = ((tmp < 0) ? 0 : tmp);
+        dxbeg = sxbeg + dx;
+
+        tmp = dst->cr - dx;
+        w = ((tmp > src->w) ? src->w : tmp) - sxbeg;
+        if (w <= 0)
+            return false;
+
+        tmp = dst->ct - dy;
+        sybeg = ((tmp < 0) ? 0 : tmp);
+        dybeg = sybeg + dy;
+
+        tmp = dst->cb - dy;
+        h = ((tmp > src->h) ? src->h : tmp) - sybeg;
+        if (h <= 0)
+            return false;
+    }
+    else
+    {
+        w = src->w;
+        h = src->h;
+        sxbeg = 0;
+        sybeg = 0;
+        dxbeg = dx;
+        dybeg = dy;
+    }
+    return true;
+}
+
+bool DrawTransSprite(Bitmap *ds, const Bitmap *sprite, int x, int y, BlendKernel kernel, uint32_t alpha)
+{
+    if (!CanDraw(ds, sprite))
+        return false;
+    const BITMAP *dst = ds->GetAllegroBitmap();
+    const BITMAP *src = sprite->GetAllegroBitmap();
+    if ((dst == src) && ((x != 0) || (y != 0)))
+        return false;
+
+    int sxbeg, sybeg, dxbeg, dybeg, w, h;
+    if (!ClipSprite(dst, src, x, y, sxbeg, sybeg, dxbeg, dybeg, w, h))
+        return true;
+    const TransRowFn fn = GetKernels().Trans[kernel];
+    for (int row = 0; row < h; ++row)
+    {
+        fn(reinterpret_cast<uint32_t*>(dst->line[dybeg + row]) + dxbeg,
+           reinterpret_cast<const uint32_t*>(src->line[sybeg + row]) + sxbeg, w, alpha);
+    }
+    return true;
+}
+
+bool DrawLitSprite(Bitmap *ds, const Bitmap *sprite, int x, int y, BlendKernel kernel, uint32_t amount, uint32_t color)
+{
+    if (!CanDraw(ds, sprite))
+        return false;
+    const BITMAP *dst = ds->GetAllegroBitmap();
+    const BITMAP *src = sprite->GetAllegroBitmap();
+    if ((dst == src) && ((x != 0) || (y != 0)))
+        return false;
+
+    int sxbeg, sybeg, dxbeg, dybeg, w, h;
+    if (!ClipSprite(dst, src, x, y, sxbeg, sybeg, dxbeg, dybeg, w, h))
+        return true;
+    const LitRowFn fn = GetKernels().Lit[kernel];
+    for (int row = 0; row < h; ++row)
+    {
+        fn(reinterpret_cast<uint32_t*>(dst->line[dybeg + row]) + dxbeg,
+           reinterpret_cast<const uint32_t*>(src->line[sybeg + row]) + sxbeg, w, amount, color);
+    }
+    return true;
+}
+
+} // namespace BlendKernels
+} // namespace Engine
+} // namespace AGS
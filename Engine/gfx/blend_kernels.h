@@ -0,0 +1,104 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// Row kernels for drawing 32-bit sprites over 32-bit bitmaps.
+//
+// Each kernel reproduces one of the blender functions used with Allegro's
+// draw_trans_sprite and draw_lit_sprite, but processes whole pixel rows
+// at once, using SIMD instructions where available. The results are
+// identical to the ones of the corresponding blenders. The best kernel set
+// is chosen at runtime depending on the CPU features.
+//
+//=============================================================================
+#ifndef __AGS_EE_GFX__BLENDKERNELS_H
+#define __AGS_EE_GFX__BLENDKERNELS_H
+
+#include <stddef.h>
+#include "core/types.h"
+
+namespace AGS
+{
+namespace Common { class Bitmap; }
+
+namespace Engine
+{
+namespace BlendKernels
+{
+
+// Blend kernel types, each named after the blender which it replicates
+enum BlendKernel
+{
+    kBlendKernel_Alpha32,       // _blender_alpha32 (set_alpha_blender)
+    kBlendKernel_TransAlpha32,  // _trans_alpha_blender32
+    kBlendKernel_Trans24,       // _blender_trans24 (set_trans_blender)
+    kBlendKernel_TransKeepAlpha,// _myblender_alpha_trans24 (set_my_trans_blender)
+    kBlendKernel_Argb2Argb,     // _argb2argb_blender
+    kBlendKernel_Argb2Rgb,      // _argb2rgb_blender
+    kBlendKernel_Rgb2Argb,      // _rgb2argb_blender
+    kBlendKernel_OpaqueAlpha,   // _opaque_alpha_blender
+    kBlendKernel_Additive,      // _additive_alpha_copysrc_blender
+    kBlendKernel_Copy,          // masked copy (draw_sprite)
+    kNumBlendKernels
+};
+
+// Instruction set used by the kernel set
+enum KernelArch
+{
+    kKernelArch_Scalar,
+    kKernelArch_SSE2,
+    kKernelArch_AVX2,
+    kNumKernelArchs
+};
+
+// Blends a row of src pixels over the dst pixels, skipping the src pixels
+// of MASK_COLOR_32, same as draw_trans_sprite does;
+// alpha is the blender's custom parameter (as passed to set_blender_mode).
+typedef void (*TransRowFn)(uint32_t *dst, const uint32_t *src, size_t count, uint32_t alpha);
+// Blends a color with the row of src pixels, and writes result to dst,
+// skipping the src pixels of MASK_COLOR_32, same as draw_lit_sprite does;
+// amount is the lighting parameter (as passed to draw_lit_sprite).
+typedef void (*LitRowFn)(uint32_t *dst, const uint32_t *src, size_t count, uint32_t amount, uint32_t color);
+
+struct KernelSet
+{
+    KernelArch Arch;
+    const char *Name;
+    TransRowFn Trans[kNumBlendKernels];
+    LitRowFn   Lit[kNumBlendKernels];
+};
+
+// Gets the kernel set for the given instruction set;
+// returns null if it's not built in, or not supported by this CPU
+const KernelSet *GetKernelSet(KernelArch arch);
+// Gets the best kernel set supported by this CPU
+const KernelSet &GetKernels();
+
+// Tells if the kernels may be used for drawing this sprite on this bitmap
+bool CanDraw(const Common::Bitmap *ds, const Common::Bitmap *sprite);
+// Draws the sprite over the destination, same as draw_trans_sprite would
+// with the matching blender set. Returns false if kernels may not be used
+// for these bitmaps, in which case caller should draw the regular way.
+bool DrawTransSprite(Common::Bitmap *ds, const Common::Bitmap *sprite, int x, int y,
+    BlendKernel kernel, uint32_t alpha = 0);
+// Draws the sprite lit with a color, same as draw_lit_sprite would
+// with the matching blender set. Color is an 32-bit RGB value.
+// Returns false if kernels may not be used for these bitmaps.
+bool DrawLitSprite(Common::Bitmap *ds, const Common::Bitmap *sprite, int x, int y,
+    BlendKernel kernel, uint32_t amount, uint32_t color);
+
+} // namespace BlendKernels
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_GFX__BLENDKERNELS_H
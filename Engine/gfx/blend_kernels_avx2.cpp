@@ -0,0 +1,85 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// AVX2 blend kernels. With GCC and Clang this unit has to be compiled with
+// AVX2 enabled (-mavx2), otherwise the kernels are not built in.
+// NOTE: no code from this unit may be run unless CPU supports AVX2, so keep
+// the headers included here limited to the kernel implementation.
+//
+//=============================================================================
+#include "gfx/blend_kernels_impl.h"
+
+#if defined(__AVX2__) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+#define AGS_BLEND_KERNELS_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace AGS
+{
+namespace Engine
+{
+namespace BlendKernels
+{
+
+#if defined(AGS_BLEND_KERNELS_AVX2)
+
+namespace
+{
+
+// AVX2 implementation of the "vector" type, processes 8 pixels at a time
+struct VecAVX2
+{
+    typedef __m256i T;
+    enum { Width = 8 };
+
+    static T Load(const uint32_t *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void Store(uint32_t *p, T v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static T Set1(uint32_t v) { return _mm256_set1_epi32(static_cast<int>(v)); }
+    static T Add(T a, T b) { return _mm256_add_epi32(a, b); }
+    static T Sub(T a, T b) { return _mm256_sub_epi32(a, b); }
+    static T Mul(T a, T b) { return _mm256_mullo_epi32(a, b); }
+    static T And(T a, T b) { return _mm256_and_si256(a, b); }
+    static T AndNot(T a, T b) { return _mm256_andnot_si256(a, b); }
+    static T Or(T a, T b) { return _mm256_or_si256(a, b); }
+    static T Shr8(T a) { return _mm256_srli_epi32(a, 8); }
+    static T Shr24(T a) { return _mm256_srli_epi32(a, 24); }
+    static T Shl24(T a) { return _mm256_slli_epi32(a, 24); }
+    static T CmpEq(T a, T b) { return _mm256_cmpeq_epi32(a, b); }
+    static T CmpGt(T a, T b) { return _mm256_cmpgt_epi32(a, b); }
+    static T Select(T mask, T a, T b) { return _mm256_blendv_epi8(b, a, mask); }
+    // See the note to VecSSE2::Recip65536
+    static T Recip65536(T d) { return _mm256_cvttps_epi32(_mm256_div_ps(_mm256_set1_ps(65536.f), _mm256_cvtepi32_ps(d))); }
+};
+
+const KernelSet AVX2Kernels = MakeKernelSet<VecAVX2>(kKernelArch_AVX2, "AVX2");
+
+} // namespace
+
+const KernelSet *Detail::GetAVX2Kernels()
+{
+    return &AVX2Kernels;
+}
+
+#else // !AGS_BLEND_KERNELS_AVX2
+
+const KernelSet *Detail::GetAVX2Kernels()
+{
+    return nullptr;
+}
+
+#endif // AGS_BLEND_KERNELS_AVX2
+
+} // namespace BlendKernels
+} // namespace Engine
+} // namespace AGS
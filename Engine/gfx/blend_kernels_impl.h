@@ -0,0 +1,340 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// Blend kernels implementation, shared by the units compiled for particular
+// instruction sets.
+//
+// Kernels are written once, in terms of a "vector" type V, which provides
+// a number of operations on 32-bit unsigned lanes. Each blend operation
+// repeats the arithmetic of its original blender function step by step,
+// including unsigned overflows, so results are identical for any V.
+// Adding a new instruction set (e.g. NEON) requires only implementing V.
+//
+// IMPORTANT: everything here is put into an anonymous namespace, so that
+// code compiled with different instruction set options in different units
+// is never merged by the linker. For the same reason do not include any
+// headers with inline functions here.
+//
+//=============================================================================
+#ifndef __AGS_EE_GFX__BLENDKERNELSIMPL_H
+#define __AGS_EE_GFX__BLENDKERNELSIMPL_H
+
+#include "gfx/blend_kernels.h"
+
+namespace AGS
+{
+namespace Engine
+{
+namespace BlendKernels
+{
+
+namespace Detail
+{
+// Gets the AVX2 kernel set, if it was built in; does not test CPU support
+const KernelSet *GetAVX2Kernels();
+}
+
+namespace
+{
+
+// Transparent color for 32-bit bitmaps (same as Allegro's MASK_COLOR_32)
+const uint32_t MaskColor32 = 0xFF00FF;
+
+// Scalar implementation of the "vector" type, processes 1 pixel at a time
+struct VecScalar
+{
+    typedef uint32_t T;
+    enum { Width = 1 };
+
+    static T Load(const uint32_t *p) { return *p; }
+    static void Store(uint32_t *p, T v) { *p = v; }
+    static T Set1(uint32_t v) { return v; }
+    static T Add(T a, T b) { return a + b; }
+    static T Sub(T a, T b) { return a - b; }
+    static T Mul(T a, T b) { return a * b; }
+    static T And(T a, T b) { return a & b; }
+    static T AndNot(T a, T b) { return ~a & b; }
+    static T Or(T a, T b) { return a | b; }
+    static T Shr8(T a) { return a >> 8; }
+    static T Shr24(T a) { return a >> 24; }
+    static T Shl24(T a) { return a << 24; }
+    // Comparisons return all bits set for "true", and zero for "false"
+    static T CmpEq(T a, T b) { return a == b ? 0xFFFFFFFFu : 0u; }
+    static T CmpGt(T a, T b) { return static_cast<int32_t>(a) > static_cast<int32_t>(b) ? 0xFFFFFFFFu : 0u; }
+    // Selects a where mask is set, and b otherwise
+    static T Select(T mask, T a, T b) { return (a & mask) | (b & ~mask); }
+    // Calculates 0x10000 / d, where d is in range [1; 256]
+    static T Recip65536(T d) { return 0x10000u / d; }
+};
+
+//
+// Blend operations, each gets source (x), destination (y) and the custom
+// blender parameter (n); named after the blender function which they repeat.
+//
+
+// Adds 1 to the non-zero values, a common step in Allegro's blenders
+template <class V>
+inline typename V::T IncNonZero(typename V::T n)
+{
+    return V::Add(n, V::AndNot(V::CmpEq(n, V::Set1(0)), V::Set1(1)));
+}
+
+// Calculates (x - y) * n / 256 + y separately for red+blue and green parts
+// of the pixel; returns RGB with zero alpha. Based on _blender_trans24.
+template <class V>
+inline typename V::T LerpRGB(typename V::T x, typename V::T y, typename V::T n)
+{
+    typedef typename V::T T;
+    const T rb_mask = V::Set1(0xFF00FF);
+    const T g_mask = V::Set1(0xFF00);
+    const T res = V::Add(V::Shr8(V::Mul(V::Sub(V::And(x, rb_mask), V::And(y, rb_mask)), n)), y);
+    const T y_g = V::And(y, g_mask);
+    const T g = V::Add(V::Shr8(V::Mul(V::Sub(V::And(x, g_mask), y_g), n)), y_g);
+    return V::Or(V::And(res, rb_mask), V::And(g, g_mask));
+}
+
+// _blender_alpha32
+struct OpAlpha32
+{
+    template <class V>
+    static typename V::T Blend(typename V::T x, typename V::T y, typename V::T /*n*/)
+    {
+        return LerpRGB<V>(x, y, IncNonZero<V>(V::Shr24(x)));
+    }
+};
+
+// _trans_alpha_blender32
+struct OpTransAlpha32
+{
+    template <class V>
+    static typename V::T Blend(typename V::T x, typename V::T y, typename V::T n)
+    {
+        return LerpRGB<V>(x, y, IncNonZero<V>(V::Shr8(V::Mul(n, V::Shr24(x)))));
+    }
+};
+
+// _blender_trans24
+struct OpTrans24
+{
+    template <class V>
+    static typename V::T Blend(typename V::T x, typename V::T y, typename V::T n)
+    {
+        return LerpRGB<V>(x, y, IncNonZero<V>(n));
+    }
+};
+
+// _myblender_alpha_trans24
+struct OpTransKeepAlpha
+{
+    template <class V>
+    static typename V::T Blend(typename V::T x, typename V::T y, typename V::T n)
+    {
+        const typename V::T alpha = V::And(y, V::Set1(0xFF000000));
+        return V::Or(LerpRGB<V>(x, V::And(y, V::Set1(0x00FFFFFF)), IncNonZero<V>(n)), alpha);
+    }
+};
+
+// Source alpha multiplied by the optional custom alpha,
+// used by _argb2argb_blender and _argb2rgb_blender
+template <class V>
+inline typename V::T CombinedSrcAlpha(typename V::T x, typename V::T n)
+{
+    typedef typename V::T T;
+    const T src_alpha = V::Shr24(x);
+    const T mul_alpha = V::Shr8(V::Mul(src_alpha, V::Add(V::And(n, V::Set1(0xFF)), V::Set1(1))));
+    return V::Select(V::CmpEq(n, V::Set1(0)), src_alpha, mul_alpha);
+}
+
+// argb2argb_blend_core
+template <class V>
+inline typename V::T Argb2ArgbCore(typename V::T src_col, typename V::T dst_col, typename V::T src_alpha)
+{
+    typedef typename V::T T;
+    const T rb_mask = V::Set1(0xFF00FF);
+    const T g_mask = V::Set1(0x00FF00);
+    const T v256 = V::Set1(256);
+    src_alpha = V::Add(src_alpha, V::Set1(1));
+    T dst_alpha = IncNonZero<V>(V::Shr24(dst_col));
+
+    T dst_g = V::Shr8(V::Mul(V::And(dst_col, g_mask), dst_alpha));
+    T dst_rb = V::Shr8(V::Mul(V::And(dst_col, rb_mask), dst_alpha));
+    dst_g = V::And(V::Add(V::Shr8(V::Mul(V::Sub(V::And(src_col, g_mask), V::And(dst_g, g_mask)), src_alpha)), dst_g), g_mask);
+    dst_rb = V::And(V::Add(V::Shr8(V::Mul(V::Sub(V::And(src_col, rb_mask), V::And(dst_rb, rb_mask)), src_alpha)), dst_rb), rb_mask);
+
+    dst_alpha = V::Sub(v256, V::Shr8(V::Mul(V::Sub(v256, src_alpha), V::Sub(v256, dst_alpha))));
+    const T alpha_factor = V::Recip65536(dst_alpha);
+    dst_g = V::And(V::Shr8(V::Mul(dst_g, alpha_factor)), g_mask);
+    dst_rb = V::And(V::Shr8(V::Mul(dst_rb, alpha_factor)), rb_mask);
+    return V::Or(V::Or(dst_rb, dst_g), V::Shl24(V::Sub(dst_alpha, V::Set1(1))));
+}
+
+// _argb2argb_blender
+struct OpArgb2Argb
+{
+    template <class V>
+    static typename V::T Blend(typename V::T x, typename V::T y, typename V::T n)
+    {
+        const typename V::T src_alpha = CombinedSrcAlpha<V>(x, n);
+        return V::Select(V::CmpEq(src_alpha, V::Set1(0)), y, Argb2ArgbCore<V>(x, y, src_alpha));
+    }
+};
+
+// _argb2rgb_blender
+struct OpArgb2Rgb
+{
+    template <class V>
+    static typename V::T Blend(typename V::T x, typename V::T y, typename V::T n)
+    {
+        return LerpRGB<V>(x, y, IncNonZero<V>(CombinedSrcAlpha<V>(x, n)));
+    }
+};
+
+// _rgb2argb_blender
+struct OpRgb2Argb
+{
+    template <class V>
+    static typename V::T Blend(typename V::T x, typename V::T y, typename V::T n)
+    {
+        typedef typename V::T T;
+        const T opaque_x = V::Or(x, V::Set1(0xFF000000));
+        const T no_blend = V::Or(V::CmpEq(n, V::Set1(0)), V::CmpEq(n, V::Set1(0xFF)));
+        return V::Select(no_blend, opaque_x, Argb2ArgbCore<V>(opaque_x, y, n));
+    }
+};
+
+// _opaque_alpha_blender
+struct OpOpaqueAlpha
+{
+    template <class V>
+    static typename V::T Blend(typename V::T x, typename V::T /*y*/, typename V::T /*n*/)
+    {
+        return V::Or(x, V::Set1(0xFF000000));
+    }
+};
+
+// _additive_alpha_copysrc_blender
+struct OpAdditive
+{
+    template <class V>
+    static typename V::T Blend(typename V::T x, typename V::T y, typename V::T /*n*/)
+    {
+        typedef typename V::T T;
+        const T max_alpha = V::Set1(0xFF);
+        T alpha = V::Add(V::Shr24(x), V::Shr24(y));
+        alpha = V::Select(V::CmpGt(alpha, max_alpha), max_alpha, alpha);
+        return V::Or(V::Shl24(alpha), V::And(x, V::Set1(0x00FFFFFF)));
+    }
+};
+
+// Plain copy, used for the masked blit
+struct OpCopy
+{
+    template <class V>
+    static typename V::T Blend(typename V::T x, typename V::T /*y*/, typename V::T /*n*/)
+    {
+        return x;
+    }
+};
+
+//
+// Row functions
+//
+
+// Blends src over dst, skipping transparent src pixels (see draw_trans_sprite)
+template <class V, class Op>
+void TransRow(uint32_t *dst, const uint32_t *src, size_t count, uint32_t alpha)
+{
+    typedef typename V::T T;
+    const T n = V::Set1(alpha);
+    const T mask = V::Set1(MaskColor32);
+    size_t i = 0;
+    for (; i + V::Width <= count; i += V::Width)
+    {
+        const T x = V::Load(src + i);
+        const T y = V::Load(dst + i);
+        V::Store(dst + i, V::Select(V::CmpEq(x, mask), y, Op::template Blend<V>(x, y, n)));
+    }
+    for (; i < count; ++i)
+    {
+        const uint32_t x = src[i];
+        if (x != MaskColor32)
+            dst[i] = Op::template Blend<VecScalar>(x, dst[i], alpha);
+    }
+}
+
+// Blends color with src and writes to dst, skipping transparent src pixels
+// (see draw_lit_sprite)
+template <class V, class Op>
+void LitRow(uint32_t *dst, const uint32_t *src, size_t count, uint32_t amount, uint32_t color)
+{
+    typedef typename V::T T;
+    const T n = V::Set1(amount);
+    const T x = V::Set1(color);
+    const T mask = V::Set1(MaskColor32);
+    size_t i = 0;
+    for (; i + V::Width <= count; i += V::Width)
+    {
+        const T y = V::Load(src + i);
+        const T r = Op::template Blend<V>(x, y, n);
+        V::Store(dst + i, V::Select(V::CmpEq(y, mask), V::Load(dst + i), r));
+    }
+    for (; i < count; ++i)
+    {
+        const uint32_t y = src[i];
+        if (y != MaskColor32)
+            dst[i] = Op::template Blend<VecScalar>(color, y, amount);
+    }
+}
+
+// Makes a full kernel set for the given vector type;
+// NOTE: must stay a constant expression, so that no code compiled for
+// a particular instruction set is run before it's known to be supported.
+template <class V>
+constexpr KernelSet MakeKernelSet(KernelArch arch, const char *name)
+{
+    return KernelSet{ arch, name,
+        {
+            &TransRow<V, OpAlpha32>,
+            &TransRow<V, OpTransAlpha32>,
+            &TransRow<V, OpTrans24>,
+            &TransRow<V, OpTransKeepAlpha>,
+            &TransRow<V, OpArgb2Argb>,
+            &TransRow<V, OpArgb2Rgb>,
+            &TransRow<V, OpRgb2Argb>,
+            &TransRow<V, OpOpaqueAlpha>,
+            &TransRow<V, OpAdditive>,
+            &TransRow<V, OpCopy>
+        },
+        {
+            &LitRow<V, OpAlpha32>,
+            &LitRow<V, OpTransAlpha32>,
+            &LitRow<V, OpTrans24>,
+            &LitRow<V, OpTransKeepAlpha>,
+            &LitRow<V, OpArgb2Argb>,
+            &LitRow<V, OpArgb2Rgb>,
+            &LitRow<V, OpRgb2Argb>,
+            &LitRow<V, OpOpaqueAlpha>,
+            &LitRow<V, OpAdditive>,
+            &LitRow<V, OpCopy>
+        }
+    };
+}
+
+} // namespace
+
+} // namespace BlendKernels
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_GFX__BLENDKERNELSIMPL_H
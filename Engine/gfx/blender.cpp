@@ -248,6 +248,27 @@ uint32_t _argb2rgb_blender(uint32_t src_col, uint32_t dst_col, uint32_t src_alph
    return res | g;
 }
 
+// add the alpha values together, used for compositing alpha images
+uint32_t _trans_alpha_blender32(uint32_t x, uint32_t y, uint32_t n)
+{
+   uint32_t res, g;
+
+   n = (n * geta32(x)) / 256;
+
+   if (n)
+      n++;
+
+   res = ((x & 0xFF00FF) - (y & 0xFF00FF)) * n / 256 + y;
+   y &= 0xFF00;
+   x &= 0xFF00;
+   g = (x - y) * n / 256 + y;
+
+   res &= 0xFF00FF;
+   g &= 0xFF00;
+
+   return res | g;
+}
+
 // Based on _blender_alpha16, but keep source pixel if dest is transparent
 uint32_t skiptranspixels_blender_alpha16(uint32_t x, uint32_t y, uint32_t n)
 {
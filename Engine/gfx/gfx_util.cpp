@@ -14,6 +14,7 @@
 
 #include "core/platform.h"
 #include "gfx/gfx_util.h"
+#include "gfx/blend_kernels.h"
 #include "gfx/blender.h"
 
 namespace AGS
@@ -64,18 +65,37 @@ static const BlendModeSetter BlendModeSets[kNumBlendModes] =
     // NOTE: add new modes here
 };
 
-bool SetBlender(BlendMode blend_mode, bool dst_has_alpha, bool src_has_alpha, int blend_alpha)
+static PfnBlenderCb GetBlender(BlendMode blend_mode, bool dst_has_alpha, bool src_has_alpha, int blend_alpha)
 {
     if (blend_mode < 0 || blend_mode >= kNumBlendModes)
-        return false;
+        return nullptr;
     const BlendModeSetter &set = BlendModeSets[blend_mode];
-    PfnBlenderCb blender;
     if (dst_has_alpha)
-        blender = src_has_alpha ? set.AllAlpha :
+        return src_has_alpha ? set.AllAlpha :
             (blend_alpha == 0xFF ? set.OpaqueToAlphaNoTrans : set.OpaqueToAlpha);
     else
-        blender = src_has_alpha ? set.AlphaToOpaque : set.AllOpaque;
+        return src_has_alpha ? set.AlphaToOpaque : set.AllOpaque;
+}
 
+// Finds a blend kernel which replicates the given blender
+static bool GetBlendKernel(PfnBlenderCb blender, BlendKernels::BlendKernel &kernel)
+{
+    if (blender == _argb2argb_blender)
+        kernel = BlendKernels::kBlendKernel_Argb2Argb;
+    else if (blender == _argb2rgb_blender)
+        kernel = BlendKernels::kBlendKernel_Argb2Rgb;
+    else if (blender == _rgb2argb_blender)
+        kernel = BlendKernels::kBlendKernel_Rgb2Argb;
+    else if (blender == _opaque_alpha_blender)
+        kernel = BlendKernels::kBlendKernel_OpaqueAlpha;
+    else
+        return false;
+    return true;
+}
+
+bool SetBlender(BlendMode blend_mode, bool dst_has_alpha, bool src_has_alpha, int blend_alpha)
+{
+    PfnBlenderCb blender = GetBlender(blend_mode, dst_has_alpha, src_has_alpha, blend_alpha);
     if (blender)
     {
         set_blender_mode(nullptr, nullptr, blender, 0, 0, 0, blend_alpha);
@@ -90,11 +110,18 @@ void DrawSpriteBlend(Bitmap *ds, const Point &ds_at, const Bitmap *sprite,
     if (blend_alpha <= 0)
         return; // do not draw 100% transparent image
 
-    if (// support only 32-bit blending at the moment
-        ds->GetColorDepth() == 32 && sprite->GetColorDepth() == 32 &&
-        // set blenders if applicable and tell if succeeded
-        SetBlender(blend_mode, dst_has_alpha, src_has_alpha, blend_alpha))
+    // support only 32-bit blending at the moment
+    PfnBlenderCb blender = (ds->GetColorDepth() == 32 && sprite->GetColorDepth() == 32) ?
+        GetBlender(blend_mode, dst_has_alpha, src_has_alpha, blend_alpha) : nullptr;
+    BlendKernels::BlendKernel kernel;
+    if (blender && GetBlendKernel(blender, kernel) &&
+        BlendKernels::DrawTransSprite(ds, sprite, ds_at.X, ds_at.Y, kernel, blend_alpha))
     {
+        // drawn using the blend kernels
+    }
+    else if (blender)
+    {
+        set_blender_mode(nullptr, nullptr, blender, 0, 0, 0, blend_alpha);
         ds->TransBlendBlt(sprite, ds_at.X, ds_at.Y);
     }
     else
@@ -126,12 +153,16 @@ void DrawSpriteWithTransparency(Bitmap *ds, const Bitmap *sprite, int x, int y,
 
     if ((alpha < 0xFF) && (surface_depth > 8) && (sprite_depth > 8))
     {
-        set_trans_blender(0, 0, 0, alpha);
-        ds->TransBlendBlt(sprite, x, y);
+        if (!BlendKernels::DrawTransSprite(ds, sprite, x, y, BlendKernels::kBlendKernel_Trans24, alpha))
+        {
+            set_trans_blender(0, 0, 0, alpha);
+            ds->TransBlendBlt(sprite, x, y);
+        }
     }
     else
     {
-        ds->Blit(sprite, x, y, kBitmap_Transparency);
+        if (!BlendKernels::DrawTransSprite(ds, sprite, x, y, BlendKernels::kBlendKernel_Copy))
+            ds->Blit(sprite, x, y, kBitmap_Transparency);
     }
 }
 
@@ -57,6 +57,10 @@ IGfxDriverFactory *GetGfxDriverFactory(const String id)
 #endif
     if (id.CompareNoCase("Software") == 0)
         return ALSW::SDLRendererGraphicsFactory::GetFactory();
+    // NOTE: Null driver is not listed among the regular ones,
+    // and may be only requested explicitly
+    if (id.CompareNoCase("Null") == 0)
+        return ALSW::SDLRendererGraphicsFactory::GetNullFactory();
     SDL_SetError("No graphics factory with such id: %s", id.GetCStr());
     return nullptr;
 }
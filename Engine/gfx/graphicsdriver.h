@@ -165,6 +165,10 @@ public:
     virtual void RenderSpritesAtScreenResolution(bool enabled) = 0;
     // Enables or disables a smooth sprite scaling mode
     virtual void UseSmoothScaling(bool enabled) = 0;
+    // Sets the number of threads which the renderer may use to draw sprites
+    // on CPU; 1 means drawing on the calling thread only, and 0 tells to use
+    // as many threads as there are CPU cores. Ignored by GPU renderers.
+    virtual void SetRenderThreads(int thread_count) = 0;
     // Tells if driver supports gamma control
     virtual bool SupportsGammaControl() = 0;
     // Sets gamma level
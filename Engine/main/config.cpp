@@ -383,6 +383,7 @@ void load_common_config(const ConfigTree &cfg, GameConfig &setup)
     setup.RenderAtScreenRes = CfgReadBoolInt(cfg, "graphics", "render_at_screenres");
     setup.AntialiasSprites = CfgReadBoolInt(cfg, "graphics", "antialias", setup.AntialiasSprites);
     setup.SoftwareRenderDriver = CfgReadString(cfg, "graphics", "software_driver");
+    setup.SoftwareRenderThreads = std::max(0, CfgReadInt(cfg, "graphics", "software_threads", setup.SoftwareRenderThreads));
 
     String rotation_str = CfgReadString(cfg, "graphics", "rotation", "unlocked");
     setup.Rotation = StrUtil::ParseEnum<ScreenRotation>(
@@ -393,6 +394,8 @@ void load_common_config(const ConfigTree &cfg, GameConfig &setup)
     setup.AudioEnabled = CfgReadBoolInt(cfg, "sound", "enabled", setup.AudioEnabled);
     setup.AudioDriverID = CfgReadString(cfg, "sound", "driver");
     setup.UseVoicePack = CfgReadBoolInt(cfg, "sound", "usespeech", true);
+    setup.AudioDecoderThreads = std::max(0, CfgReadInt(cfg, "sound", "decoder_threads", setup.AudioDecoderThreads));
+    setup.AudioDecodeAhead = std::max(1, CfgReadInt(cfg, "sound", "decode_ahead", setup.AudioDecodeAhead));
 
     // Mouse options
     setup.MouseAutoLock = CfgReadBoolInt(cfg, "mouse", "auto_lock");
@@ -431,9 +434,12 @@ void load_common_config(const ConfigTree &cfg, GameConfig &setup)
     // Various system options
     setup.LoadLatestSave = CfgReadBoolInt(cfg, "misc", "load_latest_save", setup.LoadLatestSave);
     setup.CompressSaves = CfgReadBoolInt(cfg, "misc", "compress_saves", setup.CompressSaves);
+    setup.IncrementalSaves = CfgReadBoolInt(cfg, "misc", "incremental_saves", setup.IncrementalSaves);
+    setup.AsyncSaves = CfgReadBoolInt(cfg, "misc", "async_saves", setup.AsyncSaves);
     setup.RunInBackground = CfgReadInt(cfg, "misc", "background", 0) != 0;
     setup.ShowFps = CfgReadBoolInt(cfg, "misc", "show_fps");
     setup.ClearCacheOnRoomChange = CfgReadBoolInt(cfg, "misc", "clear_cache_on_room_change", setup.ClearCacheOnRoomChange);
+    setup.MemoryMapAssets = CfgReadBoolInt(cfg, "misc", "memory_map_assets", setup.MemoryMapAssets);
 
     // Accessibility settings
     setup.Access.SpeechSkipStyle = parse_speechskip_style(CfgReadString(cfg, "access", "speechskip"));
@@ -494,6 +500,8 @@ void save_common_config(const GameConfig &setup, ConfigTree &cfg)
     CfgWriteString(cfg, "misc", "user_data_dir", setup.UserSaveDir);
     CfgWriteString(cfg, "misc", "shared_data_dir", setup.AppDataDir);
     CfgWriteBoolInt(cfg, "misc", "compress_saves", setup.CompressSaves);
+    CfgWriteBoolInt(cfg, "misc", "incremental_saves", setup.IncrementalSaves);
+    CfgWriteBoolInt(cfg, "misc", "async_saves", setup.AsyncSaves);
 
     CfgWriteString(cfg, "graphics", "driver", setup.Display.DriverID);
     CfgWriteInt(cfg, "graphics", "display", (setup.Display.UseDefaultDisplay) ?
@@ -102,13 +102,13 @@ ResourcePaths ResPaths;
 
 t_engine_pre_init_callback engine_pre_init_callback = nullptr;
 
-bool engine_init_backend()
+bool engine_init_backend(bool headless)
 {
     set_our_eip(-199);
     platform->PreBackendInit();
     // Initialize SDL
     Debug::Printf(kDbgMsg_Info, "Initializing backend libs");
-    if (sys_main_init())
+    if (sys_main_init(headless))
     {
         const char *err = SDL_GetError();
         const char *user_hint = platform->GetBackendFailUserHint();
@@ -342,6 +342,7 @@ void engine_locate_audio_pak()
 // Assign asset locations to the AssetManager
 void engine_assign_assetpaths()
 {
+    AssetMgr->SetMemoryMapping(usetup.MemoryMapAssets);
     AssetMgr->AddLibrary(ResPaths.GamePak.Path, ",audio"); // main pack may have audio bundled too
     // The asset filters are currently a workaround for limiting search to certain locations;
     // this is both an optimization and to prevent unexpected behavior.
@@ -369,6 +370,8 @@ void engine_assign_assetpaths()
         const auto lib = AssetMgr->GetLibraryEntry(i);
         Debug::Printf(String::FromFormat("- %s:\t%s", lib.IsDirectory ? "DIR" : "LIB", lib.Path.GetCStr()));
         Debug::Printf("\tFilters: %s", lib.Filters.GetCStr());
+        if (lib.IsMemoryMapped)
+            Debug::Printf("\tMapped into memory");
         if (lib.LibFiles.size() > 1)
         {
             Debug::Printf("\tSub-files:");
@@ -392,7 +395,7 @@ void engine_init_audio()
         if (res)
         {
             try {
-                audio_core_init(); // audio core system
+                audio_core_init(usetup.AudioDecoderThreads, usetup.AudioDecodeAhead); // audio core system
             }
             catch (std::runtime_error& ex) {
                 Debug::Printf(kDbgMsg_Error, "Failed to initialize audio system: %s", ex.what());
@@ -1186,8 +1189,9 @@ int initialize_engine(const ConfigTree &startup_opts)
     }
 
     //-----------------------------------------------------
-    // Install backend
-    if (!engine_init_backend())
+    // Install backend; the headless mode may be only requested in the startup options,
+    // because the full config is not read yet at this point
+    if (!engine_init_backend(CfgReadString(startup_opts, "graphics", "driver").CompareNoCase("Null") == 0))
         return EXIT_ERROR;
 
     //-----------------------------------------------------
@@ -63,6 +63,7 @@ void engine_adjust_for_rotation_settings()
 void engine_post_gfxmode_driver_setup()
 {
     gfxDriver->SetCallbackOnSpriteEvt(GfxDriverSpriteEvtCallback);
+    gfxDriver->SetRenderThreads(usetup.SoftwareRenderThreads);
 }
 
 // Reset gfx driver callbacks
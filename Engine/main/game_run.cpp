@@ -49,6 +49,7 @@
 #include "ac/viewframe.h"
 #include "ac/walkablearea.h"
 #include "ac/walkbehind.h"
+#include "debug/benchmark.h"
 #include "debug/debugger.h"
 #include "debug/debug_log.h"
 #include "device/mousew32.h"
@@ -545,8 +546,9 @@ bool run_service_key_controls(KeyInput &out_key)
         DisplayMB(buffer.GetCStr());
         int chd = game.playercharacter;
         buffer = "CHARACTERS IN THIS ROOM:[";
-        for (int ff = 0; ff < game.numcharacters; ff++) {
-            if (game.chars[ff].room != displayed_room) continue;
+        // copy the list, as displaying messages runs game updates
+        const std::vector<int> room_chars = get_room_characters(displayed_room);
+        for (int ff : room_chars) {
             if (buffer.GetLength() > 430) { // FIXME: why 430? measure graphical size instead?
                 buffer.Append("and more...");
                 DisplayMB(buffer.GetCStr());
@@ -810,7 +812,7 @@ static void update_objects_scale()
         update_object_scale(objid);
     }
 
-    for (int charid = 0; charid < game.numcharacters; ++charid)
+    for (int charid : get_room_characters(displayed_room))
     {
         update_character_scale(charid);
     }
@@ -910,6 +912,7 @@ static void update_cursor_over_location(int mwasatx, int mwasaty)
 
 static void game_loop_update_events()
 {
+    update_async_save();
     new_room_was = in_new_room;
     if (in_new_room != kEnterRoom_None)
         setevent({ kAGSEvent_FadeIn });
@@ -1000,7 +1003,16 @@ uint32_t get_loop_counter() {
     return loopcounter;
 }
 
+// Measures a single game update in the benchmark mode
+struct BenchmarkFrameScope
+{
+    BenchmarkFrameScope() { benchmark_frame_begin(); }
+    ~BenchmarkFrameScope() { benchmark_frame_end(); }
+};
+
 void UpdateGameOnce(bool checkControls, IDriverDependantBitmap *extraBitmap, int extraX, int extraY) {
+    BenchmarkFrameScope bench_frame;
+
     sys_evt_process_pending();
 
     numEventsAtStartOfFunction = events.size();
@@ -1024,6 +1036,7 @@ void UpdateGameOnce(bool checkControls, IDriverDependantBitmap *extraBitmap, int
 
     set_our_eip(1004);
 
+    benchmark_phase(kBenchPhase_Script);
     game_loop_do_early_script_update();
     // run this immediately to make sure it gets done before fade-in
     // (player enters screen)
@@ -1034,6 +1047,7 @@ void UpdateGameOnce(bool checkControls, IDriverDependantBitmap *extraBitmap, int
     if (!game_loop_check_ground_level_interactions())
         return; // update interrupted
 
+    benchmark_phase(kBenchPhase_Update);
     mouse_on_iface=-1;
 
     check_debug_keys();
@@ -1057,7 +1071,9 @@ void UpdateGameOnce(bool checkControls, IDriverDependantBitmap *extraBitmap, int
 
     game_loop_update_animated_buttons();
 
+    benchmark_phase(kBenchPhase_Script);
     game_loop_do_late_script_update();
+    benchmark_phase(kBenchPhase_Update);
 
     // historically room object and character scaling was updated
     // right before the drawing
@@ -1067,13 +1083,21 @@ void UpdateGameOnce(bool checkControls, IDriverDependantBitmap *extraBitmap, int
 
     update_audio_system_on_game_loop();
 
+    // install sprites that were loaded in background since the last update
+    spriteset.ProcessPrefetched();
+
     // Only render if we are not skipping a cutscene
     if (!play.fast_forward)
+    {
+        benchmark_phase(kBenchPhase_Draw);
         render_graphics(extraBitmap, extraX, extraY);
+    }
 
     set_our_eip(6);
 
+    benchmark_phase(kBenchPhase_Script);
     game_loop_update_events();
+    benchmark_phase(kBenchPhase_Update);
 
     set_our_eip(7);
 
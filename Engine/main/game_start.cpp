@@ -18,6 +18,7 @@
 
 #include <stdio.h>
 #include "ac/common.h"
+#include "ac/character.h"
 #include "ac/characterinfo.h"
 #include "ac/game.h"
 #include "ac/gamesetup.h"
@@ -28,6 +29,7 @@
 #include "ac/room.h"
 #include "ac/screen.h"
 #include "ac/timer.h"
+#include "debug/benchmark.h"
 #include "debug/debug_log.h"
 #include "debug/debugger.h"
 #include "debug/out.h"
@@ -93,11 +95,17 @@ void initialize_start_and_play_game(int override_start_room, const String &load_
         set_cursor_mode (MODE_WALK);
 
         if (override_start_room)
-            playerchar->room = override_start_room;
+            set_character_room(playerchar, override_start_room);
 
         Debug::Printf(kDbgMsg_Info, "Engine initialization complete");
         Debug::Printf(kDbgMsg_Info, "Starting game");
 
+        if ((usetup.BenchmarkFrames > 0) &&
+            !benchmark_start(usetup.BenchmarkFrames, usetup.BenchmarkOutput, usetup.BenchmarkInput))
+        {
+            quit("Failed to start the benchmark, see the log for details");
+        }
+
         start_game_load_savegame_on_startup(load_save);
 
         // only start if not restored a save
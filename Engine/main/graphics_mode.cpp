@@ -464,16 +464,24 @@ bool graphics_mode_init_any(const GraphicResolution &game_res, const DisplayMode
     // Prepare the list of available gfx factories, having the one requested by user at first place
     // TODO: make factory & driver IDs case-insensitive!
     StringV ids;
-    GetGfxDriverFactoryNames(ids);
-    StringV::iterator it = ids.begin();
-    for (; it != ids.end(); ++it)
+    if (setup.DriverID.CompareNoCase("Null") == 0)
     {
-        if (it->CompareNoCase(setup.DriverID) == 0) break;
+        // Headless renderer is only used when requested, and has no fallbacks
+        ids.push_back(setup.DriverID);
     }
-    if (it != ids.end())
-        std::rotate(ids.begin(), it, ids.end());
     else
-        Debug::Printf(kDbgMsg_Error, "Requested graphics driver '%s' not found, will try existing drivers instead", setup.DriverID.GetCStr());
+    {
+        GetGfxDriverFactoryNames(ids);
+        StringV::iterator it = ids.begin();
+        for (; it != ids.end(); ++it)
+        {
+            if (it->CompareNoCase(setup.DriverID) == 0) break;
+        }
+        if (it != ids.end())
+            std::rotate(ids.begin(), it, ids.end());
+        else
+            Debug::Printf(kDbgMsg_Error, "Requested graphics driver '%s' not found, will try existing drivers instead", setup.DriverID.GetCStr());
+    }
 
     // Fixup display setup if necessary
     DisplayModeSetup use_setup = setup;
@@ -110,6 +110,11 @@ void main_print_help() {
            "Options:\n"
            "  --background                 Keeps game running in background\n"
            "                               (this does not work in exclusive fullscreen)\n"
+           "  --benchmark <frames>         Run given number of frames as fast as possible\n"
+           "                               with fixed game timing, then quit\n"
+           "  --benchmark-input FILEPATH   Replay input from the file in benchmark mode\n"
+           "  --benchmark-out FILEPATH     Write per-frame timings to the file in benchmark\n"
+           "                               mode (JSON if has .json extension, otherwise CSV)\n"
            "  --clear-cache-on-room-change Clears sprite cache on every room change\n"
            "  --conf FILEPATH              Specify explicit config file to read on startup\n"
 #if AGS_PLATFORM_OS_WINDOWS
@@ -120,9 +125,9 @@ void main_print_help() {
            "  --fullscreen                 Force display mode to fullscreen\n"
            "  --gfxdriver <id>             Request graphics driver. Available options:\n"
 #if AGS_PLATFORM_OS_WINDOWS
-           "                                 d3d9, ogl, software\n"
+           "                                 d3d9, ogl, software, null\n"
 #else
-           "                                 ogl, software\n"
+           "                                 ogl, software, null\n"
 #endif
           //--------------------------------------------------------------------------------|
            "  --gfxfilter FILTER [SCALING]\n"
@@ -231,6 +236,19 @@ static int main_process_cmdline(ConfigTree &cfg, int argc, char *argv[])
         {
             usetup.DisableExceptionHandling = true;
         }
+        else if ((ags_stricmp(arg, "--benchmark") == 0) && (argc > ee + 1))
+        {
+            const int frames = atoi(argv[++ee]);
+            usetup.BenchmarkFrames = frames > 0 ? frames : 0;
+        }
+        else if ((ags_stricmp(arg, "--benchmark-out") == 0) && (argc > ee + 1))
+        {
+            usetup.BenchmarkOutput = argv[++ee];
+        }
+        else if ((ags_stricmp(arg, "--benchmark-input") == 0) && (argc > ee + 1))
+        {
+            usetup.BenchmarkInput = argv[++ee];
+        }
         else if (ags_stricmp(arg, "--setup") == 0)
         {
             justRunSetup = true;
@@ -29,10 +29,12 @@
 #include "ac/translation.h"
 #include "ac/dynobj/dynobj_manager.h"
 #include "debug/agseditordebugger.h"
+#include "debug/benchmark.h"
 #include "debug/debug_log.h"
 #include "debug/debugger.h"
 #include "debug/out.h"
 #include "font/fonts.h"
+#include "game/savegame.h"
 #include "main/config.h"
 #include "main/engine.h"
 #include "main/main.h"
@@ -181,6 +183,9 @@ void quit(const char *quitmsg)
 {
     Debug::Printf(kDbgMsg_Info, "Quitting the game...");
 
+    // Write the timings of the frames run so far, if quitting in the midst of benchmark
+    benchmark_shutdown();
+
     // NOTE: we must not use the quitmsg pointer past this step,
     // as it may be from a plugin and we're about to free plugins
     String errmsg, fullmsg;
@@ -197,6 +202,9 @@ void quit(const char *quitmsg)
 
     set_our_eip(9900);
 
+    // Let the background save finish writing the file
+    WaitForAsyncSave();
+
     quit_stop_cd();
     if (use_cdplayer)
         platform->ShutdownCDPlayer();
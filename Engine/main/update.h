@@ -20,6 +20,8 @@
 #ifndef __AGS_EE_MAIN__UPDATE_H
 #define __AGS_EE_MAIN__UPDATE_H
 
+#include <vector>
+
 // Update MoveList of certain index, save current position;
 // *resets* mslot to zero if path is complete.
 // returns "need_to_fix_sprite" value, which may be 0,1,2;
@@ -30,6 +32,9 @@ int do_movelist_move(short &mslot, int &pos_x, int &pos_y);
 void restore_movelists();
 // Update various things on the game frame (historical code mess...)
 void update_stuff();
+// Updates moving and animating of all the enabled characters; fills the list
+// of characters which follow others exactly, for the further update
+void update_character_move_and_anim(std::vector<int> &followingAsSheep);
 
 // Tells if a voice lipsyncing is currently active (enabled and speech playing)
 bool has_voice_lipsync();
@@ -13,6 +13,9 @@
 //=============================================================================
 #include "media/audio/audio_core.h"
 #include <math.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <stdexcept>
@@ -20,13 +23,60 @@
 #include <unordered_map>
 #include "debug/out.h"
 #include "media/audio/audioplayer.h"
+#include "media/audio/decoderpool.h"
 #include "media/audio/sdldecoder.h"
 #include "media/audio/openalsource.h"
 #include "util/memory_compat.h"
+#include "util/spsc_queue.h"
 
 using namespace AGS::Common;
 using namespace AGS::Engine;
 
+// Slot's playback state, published by the audio thread for the game thread
+struct AudioSlotShared
+{
+    const float DurationMs;
+    const int Frequency;
+    std::atomic<PlaybackState> PlayState;
+    std::atomic<float> PositionMs{0.f};
+    // Number of processed state commands (play, pause, seek);
+    // is updated after the state above is published
+    std::atomic<uint32_t> CommandsDone{0u};
+
+    AudioSlotShared(float duration_ms, int freq, PlaybackState play_state)
+        : DurationMs(duration_ms), Frequency(freq), PlayState(play_state) {}
+};
+
+enum AudioCommandType
+{
+    kAudioCmd_None,
+    kAudioCmd_Init,
+    kAudioCmd_Release,
+    kAudioCmd_Play,
+    kAudioCmd_Pause,
+    kAudioCmd_Seek,
+    kAudioCmd_SetVolume,
+    kAudioCmd_SetPanning,
+    kAudioCmd_SetSpeed
+};
+
+// Command sent from the game thread to the audio thread
+struct AudioCommand
+{
+    AudioCommandType Type = kAudioCmd_None;
+    int SlotHandle = -1;
+    float Value = 0.f;
+    // New slot's player and state, for kAudioCmd_Init
+    std::unique_ptr<AudioPlayer> Player;
+    std::shared_ptr<AudioSlotShared> Shared;
+};
+
+// Max number of commands not yet received by the audio thread
+static const size_t AudioCommandQueueSize = 256;
+// Min and max delay between polling the players, in ms
+static const float MinPollDelayMs = 1.f;
+static const float MaxPollDelayMs = 50.f;
+
 // Global audio core state and resources
 static struct 
 {
@@ -37,17 +87,38 @@ static struct
 
     // Audio thread: polls sound decoders, feeds OpenAL sources
     std::thread audio_core_thread;
-    bool audio_core_thread_running = false;
-
+    std::atomic<bool> audio_core_thread_running{false};
+    // Decoder workers: decode sounds ahead of time
+    DecoderPool decoder_pool;
+    size_t decode_ahead = 1u; // number of chunks to decode ahead
+    uint32_t total_underruns = 0u; // total underruns of the released slots
+
+    // Game thread's side: slots' published states, and the number
+    // of the state commands sent to each slot
+    struct GameSlot
+    {
+        std::shared_ptr<AudioSlotShared> Shared;
+        uint32_t CommandsSent = 0u;
+    };
+    std::unordered_map<int, GameSlot> game_slots;
     // Sound slot id counter
     int nextId = 0;
 
-    // One mutex to lock them all... any operation on individual decoders
-    // is done under this only mutex, which means that they are currently
-    // polled one by one, any action like pause/resume is also synced.
-    std::mutex mixer_mutex_m;
-    std::condition_variable mixer_cv;
-    std::unordered_map<int, std::unique_ptr<AudioPlayer>> slots_;
+    // Commands from the game thread to the audio thread
+    SpscQueue<AudioCommand, AudioCommandQueueSize> commands;
+    // Wakes the audio thread when there are new commands;
+    // the mutex is never held while processing audio
+    std::mutex wake_mutex;
+    std::condition_variable wake_cv;
+    bool wake_pending = false;
+
+    // Audio thread's side: the players; only accessed by the audio thread
+    struct AudioSlot
+    {
+        std::unique_ptr<AudioPlayer> Player;
+        std::shared_ptr<AudioSlotShared> Shared;
+    };
+    std::unordered_map<int, AudioSlot> slots_;
 } g_acore;
 
 // Prints any OpenAL errors to the log
@@ -65,7 +136,7 @@ void dump_al_errors()
 
 static void audio_core_entry();
 
-void audio_core_init() 
+void audio_core_init(size_t decoder_threads, size_t decode_ahead)
 {
     /* InitAL opens a device and sets up a context using default attributes, making
      * the program ready to call OpenAL functions. */
@@ -97,6 +168,12 @@ void audio_core_init()
         Debug::Printf(kDbgMsg_Info, " - %s : %s", (*dec)->description, buf.GetCStr());
     }
 
+    g_acore.decode_ahead = std::max<size_t>(1u, decode_ahead);
+    g_acore.decoder_pool.Start(decoder_threads);
+    if (g_acore.decoder_pool.GetThreadCount() > 0)
+        Debug::Printf(kDbgMsg_Info, "AudioCore: decoding on %zu thread(s), up to %zu chunk(s) ahead",
+            g_acore.decoder_pool.GetThreadCount(), g_acore.decode_ahead);
+
     g_acore.audio_core_thread_running = true;
 #if !defined(AGS_DISABLE_THREADS)
     g_acore.audio_core_thread = std::thread(audio_core_entry);
@@ -108,11 +185,27 @@ void audio_core_shutdown()
     g_acore.audio_core_thread_running = false;
 #if !defined(AGS_DISABLE_THREADS)
     if (g_acore.audio_core_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lk(g_acore.wake_mutex);
+            g_acore.wake_pending = true;
+        }
+        g_acore.wake_cv.notify_one();
         g_acore.audio_core_thread.join();
+    }
 #endif
 
-    // dispose all the active slots
+    g_acore.decoder_pool.Stop();
+
+    // dispose all the active slots, and any players still in the queue
+    AudioCommand cmd;
+    while (g_acore.commands.Pop(cmd)) {}
+    for (const auto &slot : g_acore.slots_)
+        g_acore.total_underruns += slot.second.Player->GetUnderruns();
     g_acore.slots_.clear();
+    g_acore.game_slots.clear();
+    if (g_acore.total_underruns > 0)
+        Debug::Printf(kDbgMsg_Warn, "AudioCore: total decoding underruns: %u", g_acore.total_underruns);
 
     // SDL_Sound
     Sound_Quit();
@@ -147,17 +240,73 @@ void audio_core_set_master_volume(float newvol)
 // SLOTS
 // -------------------------------------------------------------------------------------------------
 
+static void audio_core_process_commands();
+
 static int avail_slot_id()
 {
     return g_acore.nextId++;
 }
 
+// Passes the command to the audio thread, and wakes it up
+static void audio_core_send(AudioCommand &&cmd)
+{
+    while (!g_acore.commands.Push(std::move(cmd)))
+    {
+        // The queue is full: this is not expected to happen normally,
+        // as the audio thread is woken up after each command.
+#if defined(AGS_DISABLE_THREADS)
+        audio_core_process_commands();
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+#if !defined(AGS_DISABLE_THREADS)
+    {
+        std::lock_guard<std::mutex> lk(g_acore.wake_mutex);
+        g_acore.wake_pending = true;
+    }
+    g_acore.wake_cv.notify_one();
+#endif
+}
+
+static void audio_core_send(int slot_handle, AudioCommandType type, float value = 0.f)
+{
+    auto it = g_acore.game_slots.find(slot_handle);
+    if (it == g_acore.game_slots.end())
+        return;
+    switch (type)
+    {
+    case kAudioCmd_Play:
+    case kAudioCmd_Pause:
+    case kAudioCmd_Seek:
+        it->second.CommandsSent++;
+        break;
+    default:
+        break;
+    }
+    AudioCommand cmd;
+    cmd.Type = type;
+    cmd.SlotHandle = slot_handle;
+    cmd.Value = value;
+    audio_core_send(std::move(cmd));
+}
+
 static int audio_core_slot_init(std::unique_ptr<SDLDecoder> decoder)
 {
     auto handle = avail_slot_id();
-    std::lock_guard<std::mutex> lk(g_acore.mixer_mutex_m);
-    g_acore.slots_[handle] = std::make_unique<AudioPlayer>(handle, std::move(decoder));
-    g_acore.mixer_cv.notify_all();
+    auto player = std::make_unique<AudioPlayer>(handle, std::move(decoder),
+        g_acore.decode_ahead, &g_acore.decoder_pool);
+    auto shared = std::make_shared<AudioSlotShared>(player->GetDurationMs(),
+        static_cast<int>(player->GetFrequency()), player->GetPlayStateNormal());
+    g_acore.game_slots[handle].Shared = shared;
+
+    AudioCommand cmd;
+    cmd.Type = kAudioCmd_Init;
+    cmd.SlotHandle = handle;
+    cmd.Player = std::move(player);
+    cmd.Shared = std::move(shared);
+    audio_core_send(std::move(cmd));
     return handle;
 }
 
@@ -177,56 +326,167 @@ int audio_core_slot_init(std::unique_ptr<Stream> in, const String &extension_hin
     return audio_core_slot_init(std::move(decoder));
 }
 
-AudioPlayerLock audio_core_get_player(int slot_handle)
+bool audio_core_get_slot_state(int slot_handle, AudioSlotState &state)
 {
-    std::unique_lock<std::mutex> ulk(g_acore.mixer_mutex_m);
-    auto it = g_acore.slots_.find(slot_handle);
-    if (it == g_acore.slots_.end())
-        return AudioPlayerLock(nullptr, std::move(ulk), &g_acore.mixer_cv);
-    return AudioPlayerLock(it->second.get(), std::move(ulk), &g_acore.mixer_cv);
+    auto it = g_acore.game_slots.find(slot_handle);
+    if (it == g_acore.game_slots.end())
+        return false;
+    const auto &shared = *it->second.Shared;
+    // NOTE: read the processed commands counter first, which guarantees
+    // that the state values are at least as recent
+    state.Synced = shared.CommandsDone.load(std::memory_order_acquire) == it->second.CommandsSent;
+    state.PlayState = shared.PlayState.load(std::memory_order_relaxed);
+    state.PositionMs = shared.PositionMs.load(std::memory_order_relaxed);
+    state.DurationMs = shared.DurationMs;
+    state.Frequency = shared.Frequency;
+    return true;
+}
+
+void audio_core_slot_play(int slot_handle)
+{
+    audio_core_send(slot_handle, kAudioCmd_Play);
+}
+
+void audio_core_slot_pause(int slot_handle)
+{
+    audio_core_send(slot_handle, kAudioCmd_Pause);
+}
+
+void audio_core_slot_seek(int slot_handle, float pos_ms)
+{
+    audio_core_send(slot_handle, kAudioCmd_Seek, pos_ms);
+}
+
+void audio_core_slot_set_volume(int slot_handle, float volume)
+{
+    audio_core_send(slot_handle, kAudioCmd_SetVolume, volume);
+}
+
+void audio_core_slot_set_panning(int slot_handle, float panning)
+{
+    audio_core_send(slot_handle, kAudioCmd_SetPanning, panning);
+}
+
+void audio_core_slot_set_speed(int slot_handle, float speed)
+{
+    audio_core_send(slot_handle, kAudioCmd_SetSpeed, speed);
 }
 
 void audio_core_slot_stop(int slot_handle)
 {
-    std::lock_guard<std::mutex> lk(g_acore.mixer_mutex_m);
-    auto it = g_acore.slots_.find(slot_handle);
-    if (it == g_acore.slots_.end())
+    if (g_acore.game_slots.erase(slot_handle) == 0)
         return;
-    it->second->Stop();
-    g_acore.slots_.erase(slot_handle);
-    g_acore.mixer_cv.notify_all();
+    AudioCommand cmd;
+    cmd.Type = kAudioCmd_Release;
+    cmd.SlotHandle = slot_handle;
+    audio_core_send(std::move(cmd));
 }
 
 // -------------------------------------------------------------------------------------------------
 // AUDIO PROCESSING
 // -------------------------------------------------------------------------------------------------
 
-void audio_core_entry_poll()
+// Publishes the player's current state for the game thread
+static void audio_core_publish_state(const AudioPlayer &player, AudioSlotShared &shared)
+{
+    shared.PlayState.store(player.GetPlayStateNormal(), std::memory_order_relaxed);
+    shared.PositionMs.store(player.GetPositionMs(), std::memory_order_relaxed);
+}
+
+static void audio_core_apply_command(AudioCommand &cmd)
+{
+    if (cmd.Type == kAudioCmd_Init)
+    {
+        g_acore.slots_[cmd.SlotHandle] = { std::move(cmd.Player), std::move(cmd.Shared) };
+        return;
+    }
+
+    auto it = g_acore.slots_.find(cmd.SlotHandle);
+    if (it == g_acore.slots_.end())
+        return;
+    auto &player = *it->second.Player;
+    switch (cmd.Type)
+    {
+    case kAudioCmd_Release:
+        player.Stop();
+        if (player.GetUnderruns() > 0)
+        {
+            Debug::Printf(kDbgMsg_Warn, "AudioCore: slot %d had %u decoding underrun(s)",
+                cmd.SlotHandle, player.GetUnderruns());
+            g_acore.total_underruns += player.GetUnderruns();
+        }
+        g_acore.slots_.erase(it);
+        return;
+    case kAudioCmd_Play: player.Play(); break;
+    case kAudioCmd_Pause: player.Pause(); break;
+    case kAudioCmd_Seek: player.Seek(cmd.Value); break;
+    case kAudioCmd_SetVolume: player.SetVolume(cmd.Value); return;
+    case kAudioCmd_SetPanning: player.SetPanning(cmd.Value); return;
+    case kAudioCmd_SetSpeed: player.SetSpeed(cmd.Value); return;
+    default: return;
+    }
+    // State command: publish the new state, and then mark the command done
+    auto &shared = *it->second.Shared;
+    audio_core_publish_state(player, shared);
+    shared.CommandsDone.fetch_add(1u, std::memory_order_release);
+}
+
+static void audio_core_process_commands()
+{
+    AudioCommand cmd;
+    while (g_acore.commands.Pop(cmd))
+    {
+        try {
+            audio_core_apply_command(cmd);
+        } catch (const std::exception& e) {
+            Debug::Printf(kDbgMsg_Error, "AudioCore command exception: %s", e.what());
+        }
+        cmd = AudioCommand();
+    }
+}
+
+// Processes pending commands and polls all the players;
+// returns the suggested delay before the next poll, in ms
+static float audio_core_poll()
 {
     // burn off any errors for new loop
     dump_al_errors();
 
+    audio_core_process_commands();
+
+    float poll_delay = MaxPollDelayMs;
     for (auto &entry : g_acore.slots_) {
         auto &slot = entry.second;
 
         try {
-            slot->Poll();
+            slot.Player->Poll();
+            audio_core_publish_state(*slot.Player, *slot.Shared);
+            poll_delay = std::min(poll_delay, slot.Player->GetPollDelayMs());
         } catch (const std::exception& e) {
             Debug::Printf(kDbgMsg_Error, "AudioCore poll exception: %s", e.what());
         }
     }
+    return poll_delay;
+}
+
+void audio_core_entry_poll()
+{
+    audio_core_poll();
 }
 
 #if !defined(AGS_DISABLE_THREADS)
 static void audio_core_entry()
 {
-    std::unique_lock<std::mutex> lk(g_acore.mixer_mutex_m);
-
     while (g_acore.audio_core_thread_running) {
 
-        audio_core_entry_poll();
+        const float poll_delay = std::max(MinPollDelayMs, audio_core_poll());
 
-        g_acore.mixer_cv.wait_for(lk, std::chrono::milliseconds(50));
+        // Sleep until the players need more data, or new commands arrive
+        std::unique_lock<std::mutex> lk(g_acore.wake_mutex);
+        g_acore.wake_cv.wait_for(lk,
+            std::chrono::microseconds(static_cast<int64_t>(poll_delay * 1000.f)),
+            []() { return g_acore.wake_pending; });
+        g_acore.wake_pending = false;
     }
 }
 #endif
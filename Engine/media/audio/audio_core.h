@@ -17,61 +17,31 @@
 //=============================================================================
 #ifndef __AGS_EE_MEDIA__AUDIOCORE_H
 #define __AGS_EE_MEDIA__AUDIOCORE_H
-#include <condition_variable>
 #include <memory>
-#include <mutex>
 #include <vector>
 #include "media/audio/audiodefines.h"
-#include "media/audio/audioplayer.h"
+#include "util/stream.h"
 #include "util/string.h"
 
-
-namespace AGS
-{
-namespace Engine
+// AudioSlotState is the playback state of the audio slot, as last
+// published by the audio thread.
+struct AudioSlotState
 {
-
-// AudioPlayerLock wraps a AudioPlayer pointer guarded by a mutex lock.
-// Unlocks the mutex on destruction (e.g. when going out of scope).
-class AudioPlayerLock
-{
-public:
-    AudioPlayerLock(AudioPlayer *player, std::unique_lock<std::mutex> &&ulk, std::condition_variable *cv)
-        : _player(player)
-        , _ulock(std::move(ulk))
-        , _cv(cv)
-    {
-    }
-
-    AudioPlayerLock(AudioPlayerLock &&lock)
-        : _player(lock._player)
-        , _ulock(std::move(lock._ulock))
-        , _cv(lock._cv)
-    {
-        lock._cv = nullptr;
-    }
-
-    ~AudioPlayerLock()
-    {
-        if (_cv)
-            _cv->notify_all();
-    }
-
-    const AudioPlayer *operator ->() const { return _player; }
-    AudioPlayer *operator ->() { return _player; }
-
-private:
-    AudioPlayer *_player = nullptr;
-    std::unique_lock<std::mutex> _ulock;
-    std::condition_variable *_cv = nullptr;
+    // Playback state, *excluding* temporary states such as Initial
+    PlaybackState PlayState = PlayStateInvalid;
+    float PositionMs = 0.f;
+    float DurationMs = 0.f;
+    int   Frequency = 0;
+    // Tells if all the play, pause and seek commands sent to this slot were
+    // already processed; otherwise the state does not reflect them yet
+    bool  Synced = false;
 };
 
-} // namespace Engine
-} // namespace AGS
-
 // Initializes audio core system;
-// starts polling on a background thread.
-void audio_core_init(/*config, soundlib*/);
+// starts polling on a background thread, and decoder_threads workers for
+// decoding up to decode_ahead chunks of each sound in advance
+// (0 decoder threads makes the sounds decoded on the polling thread).
+void audio_core_init(size_t decoder_threads, size_t decode_ahead);
 // Shut downs audio core system;
 // stops any associated threads.
 void audio_core_shutdown();
@@ -81,14 +51,29 @@ void audio_core_shutdown();
 void audio_core_set_master_volume(float newvol);
 
 // Audio slot controls: slots are abstract holders for a playback.
+// The slot commands are passed to the audio thread through a lock-free queue
+// and are applied asynchronously, so the caller never waits for the audio
+// processing. All the slot functions must be called from the same thread.
 //
 // Initializes playback on a free playback slot (reuses spare one or allocates new if there's none).
 // Data array must contain full wave data to play.
 int audio_core_slot_init(std::shared_ptr<std::vector<uint8_t>> &data, const AGS::Common::String &extension_hint, bool repeat);
 // Initializes playback streaming
 int audio_core_slot_init(std::unique_ptr<AGS::Common::Stream> in, const AGS::Common::String &extension_hint, bool repeat);
-// Returns a AudioPlayer from the given slot, wrapped in a auto-locking struct.
-AGS::Engine::AudioPlayerLock audio_core_get_player(int slot_handle);
+// Gets the last published state of the given slot; returns false if there's no such slot
+bool audio_core_get_slot_state(int slot_handle, AudioSlotState &state);
+// Begin or resume the playback
+void audio_core_slot_play(int slot_handle);
+// Pause the playback
+void audio_core_slot_pause(int slot_handle);
+// Seek to the given time position
+void audio_core_slot_seek(int slot_handle, float pos_ms);
+// Sets the playback volume (gain)
+void audio_core_slot_set_volume(int slot_handle, float volume);
+// Sets the sound panning (-1.0f to 1.0)
+void audio_core_slot_set_panning(int slot_handle, float panning);
+// Sets the playback speed (fraction of normal)
+void audio_core_slot_set_speed(int slot_handle, float speed);
 // Stop and release the audio player at the given slot
 void audio_core_slot_stop(int slot_handle);
 
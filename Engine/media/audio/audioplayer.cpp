@@ -12,6 +12,7 @@
 //
 //=============================================================================
 #include "media/audio/audioplayer.h"
+#include <limits>
 #include "util/memory_compat.h"
 
 namespace AGS
@@ -19,8 +20,10 @@ namespace AGS
 namespace Engine
 {
 
-AudioPlayer::AudioPlayer(int handle, std::unique_ptr<SDLDecoder> decoder)
-    : handle_(handle), _decoder(std::move(decoder))
+AudioPlayer::AudioPlayer(int handle, std::unique_ptr<SDLDecoder> decoder,
+        size_t decode_ahead, DecoderPool *pool)
+    : handle_(handle)
+    , _decoder(std::make_shared<DecodeAheadQueue>(std::move(decoder), decode_ahead, pool))
 {
     _source = std::make_unique<OpenAlSource>(
         _decoder->GetFormat(), _decoder->GetChannels(), _decoder->GetFreq());
@@ -37,6 +40,8 @@ void AudioPlayer::Init()
     _playState = success ? _onLoadPlayState : PlayStateError;
     if (_playState == PlayStatePlaying)
         _source->Play();
+    if (success)
+        _decoder->DecodeAhead();
 }
 
 void AudioPlayer::Poll()
@@ -47,17 +52,22 @@ void AudioPlayer::Poll()
         return;
 
     // Read data from Decoder and pass into the Al Source
-    if (!_bufferPending.Data() && !_decoder->EOS())
+    if (!_bufferPending && !_decoder->EOS())
     { // if no buffer saved, and still something to decode, then read a buffer
-        _bufferPending = _decoder->GetData();
-        assert(_bufferPending.Data() || (_bufferPending.Size() == 0));
+        _decoder->GetData(_bufferPending);
     }
-    if (_bufferPending.Data() && (_bufferPending.Size() > 0))
+    if (_bufferPending)
     { // if having a buffer already, then try to put into source
         if (_source->PutData(_bufferPending) > 0)
-            _bufferPending = SoundBufferPtr(); // clear buffer on success
+            _bufferPending = SoundBuffer(); // clear buffer on success
     }
     _source->Poll();
+    // If the source ran out of data while the decoder has more,
+    // then the decoding is not keeping up with the playback
+    const bool source_empty = _source->IsEmpty();
+    if (source_empty && _sourceFed && !_decoder->EOS())
+        _underruns++;
+    _sourceFed = !source_empty;
     // If both finished decoding and playing, we done here.
     if (_decoder->EOS() && _source->IsEmpty())
     {
@@ -65,6 +75,17 @@ void AudioPlayer::Poll()
     }
 }
 
+float AudioPlayer::GetPollDelayMs() const
+{
+    if (_playState == PlayStateInitial)
+        return 0.f; // have to initialize
+    if (_playState != PlayStatePlaying)
+        return std::numeric_limits<float>::max(); // nothing to do until commanded
+    if (!_source->IsFull() && !_decoder->EOS())
+        return 0.f; // can accept more data right away
+    return _source->GetBufferTimeLeftMs();
+}
+
 void AudioPlayer::Play()
 {
     switch (_playState)
@@ -74,6 +95,7 @@ void AudioPlayer::Play()
         break;
     case PlayStateStopped:
         _decoder->Seek(0.0f);
+        _decoder->DecodeAhead();
         /* fall-through */
     case PlayStatePaused:
         _playState = PlayStatePlaying;
@@ -111,7 +133,8 @@ void AudioPlayer::Stop()
     case PlayStatePaused:
         _playState = PlayStateStopped;
         _source->Stop();
-        _bufferPending = SoundBufferPtr(); // clear
+        _bufferPending = SoundBuffer(); // clear
+        _sourceFed = false;
         break;
     default:
         break;
@@ -131,9 +154,11 @@ void AudioPlayer::Seek(float pos_ms)
     case PlayStateStopped:
         {
             _source->Stop();
-            _bufferPending = SoundBufferPtr(); // clear
+            _bufferPending = SoundBuffer(); // clear
+            _sourceFed = false;
             float new_pos = _decoder->Seek(pos_ms);
             _source->SetPlaybackPosMs(new_pos);
+            _decoder->DecodeAhead();
         }
         break;
     default:
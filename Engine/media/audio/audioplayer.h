@@ -25,6 +25,7 @@
 #define __AGS_EE_MEDIA__AUDIOPLAYER_H
 #include <memory>
 #include "media/audio/audiodefines.h" // PlaybackState etc
+#include "media/audio/decoderpool.h"
 #include "media/audio/sdldecoder.h"
 #include "media/audio/openalsource.h"
 
@@ -36,7 +37,10 @@ namespace Engine
 class AudioPlayer
 {
 public:
-    AudioPlayer(int handle, std::unique_ptr<SDLDecoder> decoder);
+    // Creates a player over the opened decoder; decode_ahead tells how many
+    // chunks of sound may be decoded in advance on the decoder pool's threads
+    AudioPlayer(int handle, std::unique_ptr<SDLDecoder> decoder,
+        size_t decode_ahead = 1u, DecoderPool *pool = nullptr);
 
     // Gets current playback state
     PlaybackState GetPlayState() const { return _playState; }
@@ -49,6 +53,8 @@ public:
     float GetDurationMs() const { return _decoder->GetDurationMs(); }
     // Gets playback position, in ms
     float GetPositionMs() const { return _source->GetPositionMs(); }
+    // Gets the number of times the playback ran out of the decoded data
+    uint32_t GetUnderruns() const { return _underruns; }
 
     // Sets the sound panning (-1.0f to 1.0)
     void SetPanning(float panning) { _source->SetPanning(panning); }
@@ -60,6 +66,9 @@ public:
 
     // Update state, transfer data from decoder to player if possible
     void Poll();
+    // Gets the suggested delay before the next Poll, in ms;
+    // this is how soon the player will be able to accept more data
+    float GetPollDelayMs() const;
     // Begin playback
     void Play();
     // Pause playback
@@ -74,12 +83,14 @@ private:
     void Init();
 
     const int handle_ = -1; // for diagnostic purposes only
-    std::unique_ptr<SDLDecoder> _decoder;
+    std::shared_ptr<DecodeAheadQueue> _decoder;
     std::unique_ptr<OpenAlSource> _source;
     PlaybackState _playState = PlayStateInitial;
     PlaybackState _onLoadPlayState = PlayStatePaused;
     float _onLoadPositionMs = 0.0f;
-    SoundBufferPtr _bufferPending{};
+    SoundBuffer _bufferPending{};
+    uint32_t _underruns = 0u;
+    bool _sourceFed = false; // whether source had data on the last poll
 };
 
 } // namespace Engine
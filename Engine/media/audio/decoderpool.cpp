@@ -0,0 +1,276 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "media/audio/decoderpool.h"
+#include <algorithm>
+#include <stdexcept>
+#include "debug/out.h"
+
+using namespace AGS::Common;
+
+namespace AGS
+{
+namespace Engine
+{
+
+//-----------------------------------------------------------------------------
+// DecodeAheadQueue
+//-----------------------------------------------------------------------------
+
+DecodeAheadQueue::DecodeAheadQueue(std::unique_ptr<SDLDecoder> decoder, size_t max_chunks, DecoderPool *pool)
+    : _maxChunks(std::max<size_t>(1u, max_chunks))
+    , _pool((pool && pool->GetThreadCount() > 0) ? pool : nullptr)
+    , _decoder(std::move(decoder))
+{
+    _decoderEOS = _decoder->EOS();
+    _decoderPosMs = _decoder->GetPositionMs();
+}
+
+bool DecodeAheadQueue::IsValid()
+{
+    std::lock_guard<std::mutex> dlk(_decoderMutex);
+    return _decoder->IsValid();
+}
+
+bool DecodeAheadQueue::Open(float pos_ms)
+{
+    std::lock_guard<std::mutex> dlk(_decoderMutex);
+    const bool result = _decoder->Open(pos_ms);
+    std::lock_guard<std::mutex> qlk(_queueMutex);
+    _chunks.clear();
+    _decoderEOS = _decoder->EOS();
+    _decoderPosMs = _decoder->GetPositionMs();
+    return result;
+}
+
+float DecodeAheadQueue::Seek(float pos_ms)
+{
+    // NOTE: this waits for a worker to finish decoding the current chunk
+    std::lock_guard<std::mutex> dlk(_decoderMutex);
+    const float new_pos = _decoder->Seek(pos_ms);
+    std::lock_guard<std::mutex> qlk(_queueMutex);
+    _chunks.clear();
+    _decoderEOS = _decoder->EOS();
+    _decoderPosMs = _decoder->GetPositionMs();
+    return new_pos;
+}
+
+float DecodeAheadQueue::GetPositionMs()
+{
+    std::lock_guard<std::mutex> qlk(_queueMutex);
+    return _chunks.empty() ? _decoderPosMs : _chunks.front().Timestamp();
+}
+
+bool DecodeAheadQueue::EOS()
+{
+    std::lock_guard<std::mutex> qlk(_queueMutex);
+    return _decoderEOS && _chunks.empty();
+}
+
+bool DecodeAheadQueue::GetData(SoundBuffer &buf)
+{
+    if (!_pool)
+    {
+        // No workers, decode right away
+        std::lock_guard<std::mutex> dlk(_decoderMutex);
+        {
+            std::lock_guard<std::mutex> qlk(_queueMutex);
+            if (_chunks.empty() && !_decoderEOS)
+                DecodeChunk();
+        }
+    }
+
+    bool result = false;
+    {
+        std::lock_guard<std::mutex> qlk(_queueMutex);
+        if (!_chunks.empty())
+        {
+            buf = std::move(_chunks.front());
+            _chunks.pop_front();
+            result = true;
+        }
+    }
+    DecodeAhead();
+    return result;
+}
+
+void DecodeAheadQueue::DecodeAhead()
+{
+    if (!_pool)
+        return;
+    {
+        std::lock_guard<std::mutex> qlk(_queueMutex);
+        if (!CanDecodeMore())
+            return;
+    }
+    if (!_scheduled.exchange(true))
+        _pool->Schedule(shared_from_this());
+}
+
+bool DecodeAheadQueue::CanDecodeMore() const
+{
+    return !_decoderEOS && (_chunks.size() < _maxChunks);
+}
+
+bool DecodeAheadQueue::DecodeChunk()
+{
+    SoundBufferPtr data = _decoder->GetData();
+    _decoderEOS = _decoder->EOS();
+    _decoderPosMs = _decoder->GetPositionMs();
+    if (!data)
+    {
+        OnDecodeFailed();
+        return false;
+    }
+    _chunks.emplace_back(data.Data(), data.Size(), data.Timestamp(), data.DurationMs());
+    return true;
+}
+
+void DecodeAheadQueue::OnDecodeFailed()
+{
+    if (_decoderEOS)
+        return;
+    // The decoder could not give any data, but did not reach the end either;
+    // treat this as the end of stream, or else the queue would keep trying
+    // to decode more, rescheduling itself on a broken stream forever.
+    // Seeking or reopening resets this state.
+    Debug::Printf(kDbgMsg_Error, "DecoderPool: decoder failed before the end of stream, stopping");
+    _decoderEOS = true;
+}
+
+void DecodeAheadQueue::Fill()
+{
+    for (;;)
+    {
+        // NOTE: holding the decoder lock prevents seeks while decoding
+        std::lock_guard<std::mutex> dlk(_decoderMutex);
+        {
+            std::lock_guard<std::mutex> qlk(_queueMutex);
+            if (!CanDecodeMore())
+                break;
+        }
+        // Decode outside of the queue lock, so that the audio thread
+        // may take already decoded chunks meanwhile
+        SoundBufferPtr data;
+        try {
+            data = _decoder->GetData();
+        } catch (const std::exception &e) {
+            Debug::Printf(kDbgMsg_Error, "DecoderPool: decoding exception: %s", e.what());
+        }
+        std::lock_guard<std::mutex> qlk(_queueMutex);
+        _decoderEOS = _decoder->EOS();
+        _decoderPosMs = _decoder->GetPositionMs();
+        if (!data)
+        {
+            OnDecodeFailed();
+            break;
+        }
+        _chunks.emplace_back(data.Data(), data.Size(), data.Timestamp(), data.DurationMs());
+    }
+
+    _scheduled = false;
+    // The chunks might have been taken after we have checked the queue
+    // last time, but before we cleared the flag; then reschedule
+    DecodeAhead();
+}
+
+
+//-----------------------------------------------------------------------------
+// DecoderPool
+//-----------------------------------------------------------------------------
+
+DecoderPool::~DecoderPool()
+{
+    Stop();
+}
+
+#if !defined(AGS_DISABLE_THREADS)
+
+size_t DecoderPool::GetThreadCount() const
+{
+    return _threads.size();
+}
+
+void DecoderPool::Start(size_t thread_count)
+{
+    Stop();
+    _exit = false;
+    for (size_t i = 0; i < thread_count; ++i)
+        _threads.emplace_back(&DecoderPool::WorkerProc, this);
+}
+
+void DecoderPool::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        _exit = true;
+        _jobs.clear();
+    }
+    _workCv.notify_all();
+    for (auto &t : _threads)
+        t.join();
+    _threads.clear();
+}
+
+void DecoderPool::Schedule(std::shared_ptr<DecodeAheadQueue> queue)
+{
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        if (_exit)
+            return;
+        _jobs.push_back(std::move(queue));
+    }
+    _workCv.notify_one();
+}
+
+void DecoderPool::WorkerProc()
+{
+    for (;;)
+    {
+        std::shared_ptr<DecodeAheadQueue> queue;
+        {
+            std::unique_lock<std::mutex> lk(_mutex);
+            _workCv.wait(lk, [this]() { return _exit || !_jobs.empty(); });
+            if (_exit)
+                return;
+            queue = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+        queue->Fill();
+    }
+}
+
+#else // AGS_DISABLE_THREADS
+
+size_t DecoderPool::GetThreadCount() const
+{
+    return 0u;
+}
+
+void DecoderPool::Start(size_t /*thread_count*/)
+{
+}
+
+void DecoderPool::Stop()
+{
+}
+
+void DecoderPool::Schedule(std::shared_ptr<DecodeAheadQueue> queue)
+{
+    queue->Fill();
+}
+
+#endif // AGS_DISABLE_THREADS
+
+} // namespace Engine
+} // namespace AGS
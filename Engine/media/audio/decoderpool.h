@@ -0,0 +1,141 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// Decoding sounds ahead of time on the worker threads.
+//
+// DecodeAheadQueue wraps a sound decoder and keeps a limited queue of the
+// chunks decoded in advance. The chunks are decoded by the DecoderPool's
+// workers, while the audio thread only takes the ready ones; this lets
+// many sounds decode in parallel, and the slow decoding does not delay
+// feeding the other sounds to the audio output.
+//
+// If the queue has no pool assigned, then it decodes the chunks right when
+// they are requested.
+//
+//=============================================================================
+#ifndef __AGS_EE_MEDIA__DECODERPOOL_H
+#define __AGS_EE_MEDIA__DECODERPOOL_H
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#if !defined(AGS_DISABLE_THREADS)
+#include <condition_variable>
+#include <thread>
+#endif
+#include "media/audio/sdldecoder.h"
+
+namespace AGS
+{
+namespace Engine
+{
+
+class DecoderPool;
+
+class DecodeAheadQueue : public std::enable_shared_from_this<DecodeAheadQueue>
+{
+public:
+    // Creates a queue over the opened decoder; max_chunks tells how many
+    // decoded chunks may be kept in advance
+    DecodeAheadQueue(std::unique_ptr<SDLDecoder> decoder, size_t max_chunks, DecoderPool *pool);
+
+    // Gets the audio format
+    SDL_AudioFormat GetFormat() const { return _decoder->GetFormat(); }
+    // Gets the number of channels
+    int GetChannels() const { return _decoder->GetChannels(); }
+    // Gets the audio rate (frequency)
+    int GetFreq() const { return _decoder->GetFreq(); }
+    // Gets total duration, in ms
+    float GetDurationMs() const { return _decoder->GetDurationMs(); }
+
+    // Tells if the decoder is in a valid state, ready to work
+    bool IsValid();
+    // Try initializing the sound sample, returns the result
+    bool Open(float pos_ms = 0.f);
+    // Seeks to the given read position, discarding any decoded chunks;
+    // returns the new position
+    float Seek(float pos_ms);
+    // Gets current reading position, in ms; this is the position
+    // of the next chunk which will be returned by GetData
+    float GetPositionMs();
+    // Tells if there's no more data: the decoder reached EOS,
+    // and all the decoded chunks were taken
+    bool EOS();
+    // Takes the next decoded chunk; returns false if there's none ready
+    bool GetData(SoundBuffer &buf);
+    // Requests to decode more chunks ahead, if there's a room for them
+    void DecodeAhead();
+
+private:
+    friend class DecoderPool;
+
+    // Tells if more chunks may be decoded; must be called under the queue lock
+    bool CanDecodeMore() const;
+    // Decodes a single chunk and puts it to the queue;
+    // must be called under both decoder and queue locks
+    bool DecodeChunk();
+    // Handles decoder returning no data; must be called under the queue lock
+    void OnDecodeFailed();
+    // Decodes chunks until the queue is full or the decoder reached EOS;
+    // called by the pool's workers
+    void Fill();
+
+    const size_t _maxChunks;
+    DecoderPool *_pool = nullptr;
+    // Locked while using the decoder; workers keep it only
+    // for the duration of decoding a single chunk
+    std::mutex _decoderMutex;
+    std::unique_ptr<SDLDecoder> _decoder;
+    // Locked while accessing the queue of the decoded chunks
+    std::mutex _queueMutex;
+    std::deque<SoundBuffer> _chunks;
+    bool _decoderEOS = false; // mirrors decoder's state, or tells that it failed
+    float _decoderPosMs = 0.f; // mirrors decoder's position
+    // Whether this queue is scheduled for decoding on the pool
+    std::atomic<bool> _scheduled{false};
+};
+
+
+class DecoderPool final
+{
+public:
+    DecoderPool() = default;
+    ~DecoderPool();
+
+    // Gets the number of the worker threads
+    size_t GetThreadCount() const;
+    // Starts the given number of worker threads; 0 disables the pool
+    void Start(size_t thread_count);
+    // Stops and joins all worker threads; any scheduled work is discarded
+    void Stop();
+    // Schedules the queue for decoding ahead on one of the workers
+    void Schedule(std::shared_ptr<DecodeAheadQueue> queue);
+
+private:
+#if !defined(AGS_DISABLE_THREADS)
+    void WorkerProc();
+
+    std::vector<std::thread> _threads;
+    std::mutex _mutex;
+    std::condition_variable _workCv;
+    std::deque<std::shared_ptr<DecodeAheadQueue>> _jobs;
+    bool _exit = false;
+#endif
+};
+
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_MEDIA__DECODERPOOL_H
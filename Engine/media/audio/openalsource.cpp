@@ -152,6 +152,18 @@ float OpenAlSource::GetPositionMs() const
     return _predictTs;
 }
 
+float OpenAlSource::GetBufferTimeLeftMs() const
+{
+    if (_bufferRecords.size() == 0)
+        return 0.f;
+
+    float al_offset = 0.f;
+    alGetSourcef(_source, AL_SEC_OFFSET, &al_offset);
+    dump_al_errors();
+    const auto &r = _bufferRecords.front();
+    return std::max(0.f, r.Duration / r.Speed - al_offset * 1000.f);
+}
+
 size_t OpenAlSource::PutData(const SoundBufferPtr &data)
 {
     Unqueue();
@@ -48,8 +48,12 @@ public:
     PlaybackState GetPlayState() const { return _playState; }
     // Tells if the data queue is empty
     bool IsEmpty() const { return _queued == 0; }
+    // Tells if the data queue is full, and cannot accept more data
+    bool IsFull() const { return _queued >= MaxQueue; }
     // Gets current playback position, in ms
     float GetPositionMs() const;
+    // Gets the time left until the currently playing buffer is processed, in ms
+    float GetBufferTimeLeftMs() const;
 
     // Try putting data into the queue; returns amount of data copied,
     // or 0 if data cannot be accepted at the moment.
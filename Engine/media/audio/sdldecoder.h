@@ -124,6 +124,16 @@ struct SoundBuffer final : SoundBufferPtr
         return *this;
     }
 
+    SoundBuffer &operator=(SoundBuffer &&buf) noexcept
+    {
+        _buf = std::move(buf._buf);
+        _data = _buf.data();
+        _rec = buf._rec;
+        buf._data = nullptr;
+        buf._rec = AudioFrameRecord();
+        return *this;
+    }
+
     void AssignData(const void *data, size_t sz, float ts = -1.f, float dur_ms = 0.f)
     {
         if (_buf.size() != sz)
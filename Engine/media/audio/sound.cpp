@@ -19,13 +19,13 @@
 #include "debug/out.h"
 #include "media/audio/audio_core.h"
 #include "media/audio/audiodefines.h"
+#include "util/mappedstream.h"
 #include "util/path.h"
 #include "util/resourcecache.h"
 #include "util/stream.h"
 #include "util/string_types.h"
 
 using namespace AGS::Common;
-using namespace AGS::Engine;
 
 static int GuessSoundTypeFromExt(const String &extension)
 {
@@ -107,6 +107,8 @@ void soundcache_precache(const AssetPath &apath)
     auto s_in = AssetMgr->OpenAsset(apath);
     if (!s_in)
         return; // failed to open asset
+    if (MappedStream::FromStream(s_in.get()))
+        return; // mapped into memory already, no need to cache
     size_t asset_size = static_cast<size_t>(s_in->GetLength());
     if (asset_size > MaxLoadAtOnce)
         return; // too big for the cache
@@ -137,9 +139,15 @@ std::unique_ptr<SoundClip> load_sound_clip(const AssetPath &apath, const char *e
     const auto ext_hint = asset_ext.IsEmpty() ? String(extension_hint) : asset_ext;
 
     int slot{};
+    // If the asset is mapped into memory, then decode it right from there,
+    // without making a copy in the cache
+    if (!sounddata && MappedStream::FromStream(s_in.get()))
+    {
+        slot = audio_core_slot_init(std::move(s_in), ext_hint, loop);
+    }
     // If sound data was cached, or asset's size is small enough to load at once,
     // then load/use it and update the cache if necessary
-    if (sounddata || asset_size <= MaxLoadAtOnce)
+    else if (sounddata || asset_size <= MaxLoadAtOnce)
     {
         if (!sounddata)
         {
@@ -11,6 +11,7 @@
 // https://opensource.org/license/artistic-2-0/
 //
 //=============================================================================
+#include <algorithm>
 #include <cmath>
 #include "media/audio/soundclip.h"
 #include "media/audio/audio_core.h"
@@ -38,9 +39,10 @@ SoundClip::SoundClip(int slot, int snd_type, bool loop)
     pos = posMs = -1;
     paramsChanged = true;
 
-    const auto player = audio_core_get_player(slot);
-    lengthMs = (int)std::round(player->GetDurationMs());
-    freq = static_cast<int>(player->GetFrequency());
+    AudioSlotState slot_state;
+    audio_core_get_slot_state(slot, slot_state);
+    lengthMs = (int)std::round(slot_state.DurationMs);
+    freq = slot_state.Frequency;
 }
 
 SoundClip::~SoundClip()
@@ -67,9 +69,8 @@ void SoundClip::pause()
 {
     if (!is_ready())
         return;
-    auto player = audio_core_get_player(slot_);
-    player->Pause();
-    state = player->GetPlayStateNormal();
+    audio_core_slot_pause(slot_);
+    state = PlaybackState::PlayStatePaused;
 }
 
 void SoundClip::resume()
@@ -116,14 +117,14 @@ void SoundClip::seek(int pos_)
 void SoundClip::seek_ms(int pos_ms)
 {
     if (slot_ < 0) { return; }
-    auto player = audio_core_get_player(slot_);
-    player->Pause();
+    audio_core_slot_pause(slot_);
     // TODO: for backward compatibility and MOD/XM music support
     // need to reimplement seeking to a position which units
     // are defined according to the sound type
-    player->Seek((float)pos_ms);
-    float posms_f = player->GetPositionMs();
-    posMs = static_cast<int>(posms_f);
+    audio_core_slot_seek(slot_, (float)pos_ms);
+    // the seek is applied asynchronously, so assume the requested position
+    // until the next update
+    posMs = std::max(0, (lengthMs > 0) ? std::min(pos_ms, lengthMs) : pos_ms);
     pos = posms_to_pos(posMs);
 }
 
@@ -131,7 +132,6 @@ bool SoundClip::update()
 {
     if (!is_ready()) return false;
 
-    auto player = audio_core_get_player(slot_);
     if (paramsChanged)
     {
         auto vol_f = static_cast<float>(get_final_volume()) / 255.0f;
@@ -146,15 +146,20 @@ bool SoundClip::update()
         if (panning_f < -1.0f) { panning_f = -1.0f; }
         if (panning_f > 1.0f) { panning_f = 1.0f; }
 
-        player->SetVolume(vol_f);
-        player->SetSpeed(speed_f);
-        player->SetPanning(panning_f);
+        audio_core_slot_set_volume(slot_, vol_f);
+        audio_core_slot_set_speed(slot_, speed_f);
+        audio_core_slot_set_panning(slot_, panning_f);
         paramsChanged = false;
     }
 
-    PlaybackState core_state = player->GetPlayStateNormal();
-    float posms_f = player->GetPositionMs();
-    posMs = static_cast<int>(posms_f);
+    // If the audio core did not yet process our last commands,
+    // then keep the current state until it does
+    AudioSlotState slot_state;
+    if (!audio_core_get_slot_state(slot_, slot_state) || !slot_state.Synced)
+        return is_ready();
+
+    PlaybackState core_state = slot_state.PlayState;
+    posMs = static_cast<int>(slot_state.PositionMs);
     pos = posms_to_pos(posMs);
     if (state == core_state || IsPlaybackDone(core_state))
     {
@@ -165,8 +170,7 @@ bool SoundClip::update()
     switch (state)
     {
     case PlaybackState::PlayStatePlaying:
-        player->Play();
-        state = player->GetPlayStateNormal();
+        audio_core_slot_play(slot_);
         break;
     default: /* do nothing */
         break;
@@ -16,7 +16,9 @@
 #ifndef AGS_NO_VIDEO_PLAYER
 
 #include <inttypes.h>
+#include <algorithm>
 #include "debug/out.h"
+#include "media/video/yuv_convert.h"
 
 namespace AGS
 {
@@ -25,6 +27,9 @@ namespace Engine
 
 using namespace Common;
 
+// Max number of threads used for converting video frames
+static const size_t MaxConvThreads = 4;
+
 TheoraPlayer::~TheoraPlayer()
 {
     CloseImpl();
@@ -86,8 +91,13 @@ HError TheoraPlayer::OpenAPEGStream(Stream *data_stream, const Common::String &n
     // playing if the file is large because it seeks through the whole thing
     apeg_disable_length_detection(TRUE);
     apeg_ignore_audio((flags & kVideo_EnableAudio) == 0);
+    // For 32-bit frames convert YUV images ourselves, which lets write them
+    // straight into the target bitmap, scaling at the same time
+    _directFrames = (target_depth == 32);
+    SetDisplayCallbacks(_directFrames);
 
     APEG_STREAM* apeg_stream = apeg_open_stream_ex(data_stream);
+    SetDisplayCallbacks(false);
     if (!apeg_stream)
     {
         return new Error(String::FromFormat("Failed to open theora video '%s'; could be an invalid or unsupported format", name.GetCStr()));
@@ -108,12 +118,21 @@ HError TheoraPlayer::OpenAPEGStream(Stream *data_stream, const Common::String &n
     _frameTime = 1000.f / _apegStream->frame_rate;
     _frameCount = static_cast<uint32_t>(_apegStream->length / _frameTime);
     _durationMs = _apegStream->length;
+    // APEG does not create its own bitmap if we convert frames ourselves;
+    // otherwise it has fallen back to its own conversion
+    _directFrames = _directFrames && !_apegStream->bitmap;
+    if (_directFrames)
+    {
+        _theoraFullFrame.reset();
+        _theoraSrcFrame.reset();
+        _convThreads.Start(std::min(ThreadPool::GetDefaultThreadCount(), MaxConvThreads));
+    }
     // According to the documentation:
     // encoded theora frames must be a multiple of 16 in width and height.
     // Which means that the original content may end up positioned on a larger frame.
     // In such case we store this surface in a separate wrapper for the reference,
     // while the actual video frame is assigned a sub-bitmap (a portion of the full frame).
-    if (((flags & kVideo_LegacyFrameSize) == 0) &&
+    else if (((flags & kVideo_LegacyFrameSize) == 0) &&
         Size(_apegStream->bitmap->w, _apegStream->bitmap->h) != _frameSize)
     {
         _theoraFullFrame.reset(BitmapHelper::CreateRawBitmapWrapper(_apegStream->bitmap));
@@ -134,12 +153,15 @@ HError TheoraPlayer::OpenAPEGStream(Stream *data_stream, const Common::String &n
 
     const char *pixelfmt_str[] = { "APEG_420", "APEG_422", "APEG_444" };
     Debug::Printf("TheoraPlayer: opened video \"%s\": %dx%d fmt: %s, fps: %.4f"
-                  "\n\taudio: %d Hz, chans: %d",
+                  "\n\taudio: %d Hz, chans: %d"
+                  "\n\tconversion: %s, threads: %u",
                   name.GetCStr(),
                   apeg_stream->w, apeg_stream->h,
                   (apeg_stream->pixel_format >= APEG_STREAM::APEG_420 && apeg_stream->pixel_format <= APEG_STREAM::APEG_444) ? pixelfmt_str[apeg_stream->pixel_format] : "unknown",
                   static_cast<float>(apeg_stream->frame_rate),
-                  _audioFreq, _audioChannels);
+                  _audioFreq, _audioChannels,
+                  _directFrames ? "direct" : "APEG",
+                  static_cast<uint32_t>(_directFrames ? _convThreads.GetThreadCount() : 1u));
 
     return HError::None();
 }
@@ -153,11 +175,15 @@ void TheoraPlayer::CloseImpl()
         Debug::Printf("TheoraPlayer: closed, total video frames decoded: %" PRIu64 "", _videoFramesDecodedTotal);
         _videoFramesDecodedTotal = 0u;
     }
+    _convThreads.Stop();
 }
 
 bool TheoraPlayer::RewindImpl()
 {
-    if (apeg_reset_stream(_apegStream) != APEG_OK)
+    SetDisplayCallbacks(_directFrames);
+    const int reset_ret = apeg_reset_stream(_apegStream);
+    SetDisplayCallbacks(false);
+    if (reset_ret != APEG_OK)
     {
         OpenAPEGStream(_dataStream.get(), GetName(), _usedFlags, _usedDepth);
     }
@@ -181,22 +207,82 @@ bool TheoraPlayer::NextVideoFrame(Bitmap *dst, float &ts)
     if (ret == APEG_ERROR)
         return false;
 
-    // Update the display frame (decode to RGB)
+    // Update the display frame (decode to RGB);
+    // in direct mode this converts the frame right into dst
+    _convTarget = dst;
     ret = apeg_display_video_frame(_apegStream);
+    _convTarget = nullptr;
     if (ret == APEG_ERROR || ret == APEG_EOF)
         return false; // NOTE: apeg_display_video_frame returns EOF when picture is NULL
 
     _videoFramesDecoded++;
     _videoFramesDecodedTotal++;
-    // TODO: investigate if it's possible to optimize this by providing our own src bitmap directly;
-    // but in theory the frame image may be composed of multiple frames which contain partial image,
-    // in which case we probably cannot do this...
-    dst->Blit(_theoraSrcFrame.get());
+    // NOTE: APEG keeps the full decoded YUV image between frames,
+    // so any frame may be converted separately into a recycled bitmap
+    if (!_directFrames)
+        dst->Blit(_theoraSrcFrame.get());
     ts = _nextFrameTs;
     _nextFrameTs = _apegStream->pos * 1000.f; // to milliseconds (FIXME: should we keep ours in seconds?)
     return true;
 }
 
+void TheoraPlayer::SetDisplayCallbacks(bool enable)
+{
+    // NOTE: APEG stores these globally, but they are only used when
+    // a stream is opened or reset, and saved in the stream object
+    if (enable)
+        apeg_set_display_callbacks(InitDisplayCallback, DisplayFrameCallback, this);
+    else
+        apeg_set_display_callbacks(nullptr, nullptr, nullptr);
+}
+
+int TheoraPlayer::InitDisplayCallback(APEG_STREAM *stream, int coded_w, int /*coded_h*/, void *arg)
+{
+    // Only 4:2:0 images are expected from theora decoder;
+    // for anything else return positive value to let APEG do the conversion
+    if (stream->pixel_format != APEG_STREAM::APEG_420)
+        return 1;
+    static_cast<TheoraPlayer*>(arg)->_codedWidth = coded_w;
+    return 0;
+}
+
+void TheoraPlayer::DisplayFrameCallback(APEG_STREAM *stream, unsigned char **src, void *arg)
+{
+    static_cast<TheoraPlayer*>(arg)->ConvertFrame(stream, src);
+}
+
+void TheoraPlayer::ConvertFrame(APEG_STREAM *stream, unsigned char **src)
+{
+    Bitmap *dst = _convTarget;
+    if (!dst)
+        return;
+    assert(dst->GetColorDepth() == 32);
+
+    // APEG gives Y plane of the coded width, and U, V planes of a half of it
+    YUVImage img;
+    img.Planes[0] = src[0];
+    img.Planes[1] = src[1];
+    img.Planes[2] = src[2];
+    img.Strides[0] = _codedWidth;
+    img.Strides[1] = _codedWidth / 2;
+    img.Strides[2] = _codedWidth / 2;
+    img.Width = stream->w;
+    img.Height = stream->h;
+
+    // Split the frame in horizontal bands, one per thread
+    uint8_t *dst_data = dst->GetDataForWriting();
+    const int dst_pitch = dst->GetLineLength();
+    const int dst_w = dst->GetWidth();
+    const int dst_h = dst->GetHeight();
+    const int bands = static_cast<int>(std::min<size_t>(_convThreads.GetThreadCount(), dst_h));
+    const int band_h = (dst_h + bands - 1) / bands;
+    _convThreads.Run(bands, [&](size_t band)
+        {
+            const int row_from = static_cast<int>(band) * band_h;
+            YUVToARGB(img, dst_data, dst_pitch, dst_w, dst_h, row_from, row_from + band_h);
+        });
+}
+
 bool TheoraPlayer::NextAudioFrame(SoundBuffer &abuf)
 {
     assert(_apegStream);
@@ -20,6 +20,7 @@
 
 #include <apeg.h>
 #include "media/video/videoplayer.h"
+#include "util/thread_pool.h"
 
 namespace AGS
 {
@@ -47,8 +48,18 @@ private:
     float PeekVideoFrame() override;
     // Drop next video frame from stream.
     void DropVideoFrame() override;
+    // Tells if the frames are converted by us directly into the target bitmap
+    bool CanScaleFrames() const override { return _directFrames; }
 
     Common::HError OpenAPEGStream(Stream *data_stream, const String &name, int flags, int target_depth);
+    // Sets or resets APEG display callbacks, which let convert YUV frames
+    // ourselves; these must be set prior to opening or resetting APEG stream
+    void SetDisplayCallbacks(bool enable);
+    // APEG display callbacks
+    static int InitDisplayCallback(APEG_STREAM *stream, int coded_w, int coded_h, void *arg);
+    static void DisplayFrameCallback(APEG_STREAM *stream, unsigned char **src, void *arg);
+    // Converts decoded YUV frame into the currently assigned target bitmap
+    void ConvertFrame(APEG_STREAM *stream, unsigned char **src);
 
     std::unique_ptr<Stream> _dataStream;
     int _usedFlags = 0;
@@ -58,6 +69,13 @@ private:
     std::unique_ptr<Common::Bitmap> _theoraFullFrame;
     // Wrapper over portion of theora frame which we want to use
     std::unique_ptr<Common::Bitmap> _theoraSrcFrame;
+    // Whether the YUV frames are converted straight into the target 32-bit
+    // bitmaps of any size, instead of letting APEG convert them into its
+    // own bitmap of native size
+    bool _directFrames = false;
+    int _codedWidth = 0; // width of the decoded YUV planes
+    Common::Bitmap *_convTarget = nullptr; // bitmap to convert the next frame to
+    ThreadPool _convThreads; // threads for the frame conversion
     uint64_t _videoFramesDecodedTotal = 0u; // how many frames loaded and decoded total (includes rewinds!)
     uint64_t _videoFramesDecoded = 0u; // sequential count of video frames since the video beginning
     float _nextFrameTs = 0.f; // next frame presentation time
@@ -77,8 +77,7 @@ void VideoPlayer::SetTargetFrame(const Size &target_sz)
     _targetSize = target_sz.IsNull() ? _frameSize : target_sz;
 
     // Create helper bitmaps in case of stretching or color depth conversion
-    if ((_targetSize != _frameSize) || (_targetDepth != _frameDepth)
-        || ((_flags & kVideo_AccumFrame) != 0))
+    if (MustConvertFrame())
     {
         _vframeBuf.reset(new Bitmap(_frameSize.Width, _frameSize.Height, _frameDepth));
     }
@@ -89,7 +88,7 @@ void VideoPlayer::SetTargetFrame(const Size &target_sz)
 
     // If we are decoding a 8-bit frame in a hi-color game, and stretching,
     // then create a hi-color buffer, as bitmap lib cannot stretch with depth change
-    if ((_targetSize != _frameSize) && (_frameDepth == 8) && (_targetDepth > 8))
+    if (MustConvertFrame() && (_targetSize != _frameSize) && (_frameDepth == 8) && (_targetDepth > 8))
     {
         _hicolBuf.reset(BitmapHelper::CreateBitmap(_frameSize.Width, _frameSize.Height, _targetDepth));
     }
@@ -102,6 +101,12 @@ void VideoPlayer::SetTargetFrame(const Size &target_sz)
 
 }
 
+bool VideoPlayer::MustConvertFrame() const
+{
+    return (_targetDepth != _frameDepth) || ((_flags & kVideo_AccumFrame) != 0)
+        || ((_targetSize != _frameSize) && !CanScaleFrames());
+}
+
 void VideoPlayer::Stop()
 {
     if (IsPlaybackReady(_playState)) // keep any error state
@@ -403,23 +408,27 @@ void VideoPlayer::BufferVideo()
         }
     }
 
-    // Get one frame from the pool, if present, otherwise allocate a new one
+    // Get one frame from the pool, if present, otherwise allocate a new one;
+    // pooled frames left from before the target size change are discarded
     std::unique_ptr<Bitmap> target_frame;
-    if (_videoFramePool.empty())
-    {
-        target_frame.reset(new Bitmap(_targetSize.Width, _targetSize.Height, _targetDepth));
-    }
-    else
+    while (!_videoFramePool.empty() && !target_frame)
     {
         target_frame = std::move(_videoFramePool.top());
         _videoFramePool.pop();
+        if ((target_frame->GetSize() != _targetSize) || (target_frame->GetColorDepth() != _targetDepth))
+            target_frame.reset();
+    }
+    if (!target_frame)
+    {
+        target_frame.reset(new Bitmap(_targetSize.Width, _targetSize.Height, _targetDepth));
     }
 
     const auto input_start = Clock::now();
 
-    // Try to retrieve one video frame from decoder
-    const bool must_conv = (_targetSize != _frameSize || _targetDepth != _frameDepth
-        || ((_flags & kVideo_AccumFrame) != 0));
+    // Try to retrieve one video frame from decoder;
+    // if decoder can scale the frame itself, then it's retrieved directly
+    // into the target frame, otherwise into the native-sized buffer
+    const bool must_conv = MustConvertFrame();
     Bitmap *usebuf = must_conv ? _vframeBuf.get() : target_frame.get();
     float frame_ts = -1.f;
     if (!NextVideoFrame(usebuf, frame_ts))
@@ -148,6 +148,10 @@ protected:
     virtual bool RewindImpl() { return false; }
     // Retrieves next video frame, implementation-specific
     virtual bool NextVideoFrame(Common::Bitmap *dst, float &ts) { return false; };
+    // Tells if the implementation can retrieve video frames into a bitmap
+    // of any size, scaling the image; otherwise the frame must always be
+    // retrieved in its native size, and scaled by the player after.
+    virtual bool CanScaleFrames() const { return false; }
     // Retrieves next audio frame, implementation-specific
     // TODO: change return type to a proper allocated buffer
     // when we support a proper audio queue here.
@@ -204,6 +208,8 @@ private:
     bool Rewind();
     // Resume after pause
     void ResumeImpl();
+    // Tells if the decoded frame has to be converted to get the target frame
+    bool MustConvertFrame() const;
     // Read and queue video frames
     void BufferVideo();
     // Read and queue audio frames
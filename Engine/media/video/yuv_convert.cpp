@@ -0,0 +1,224 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "media/video/yuv_convert.h"
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define AGS_YUV_CONVERT_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace AGS
+{
+namespace Engine
+{
+
+namespace
+{
+
+// Conversion coefficients, in fixed point with 8 fractional bits:
+//  R = 1.164 * (Y - 16)                     + 1.596 * (V - 128)
+//  G = 1.164 * (Y - 16) - 0.391 * (U - 128) - 0.813 * (V - 128)
+//  B = 1.164 * (Y - 16) + 2.018 * (U - 128)
+const int CoefY  = 298;
+const int CoefRV = 409;
+const int CoefGU = -100;
+const int CoefGV = -208;
+const int CoefBU = 516;
+
+inline uint32_t Clamp8(int x)
+{
+    return x < 0 ? 0u : (x > 255 ? 255u : static_cast<uint32_t>(x));
+}
+
+inline uint32_t YUVToPixel(int y, int u, int v)
+{
+    const int c = CoefY * (y - 16) + 128; // + rounding
+    const int d = u - 128;
+    const int e = v - 128;
+    return 0xFF000000u
+        | (Clamp8((c + CoefRV * e) >> 8) << 16)
+        | (Clamp8((c + CoefGU * d + CoefGV * e) >> 8) << 8)
+        |  Clamp8((c + CoefBU * d) >> 8);
+}
+
+#if defined(AGS_YUV_CONVERT_SSE2)
+
+// Makes a vector of pairs of 16-bit values, for use with _mm_madd_epi16
+inline __m128i Pair16(int lo, int hi)
+{
+    return _mm_set1_epi32(static_cast<int>(
+        (static_cast<uint32_t>(static_cast<uint16_t>(hi)) << 16) | static_cast<uint16_t>(lo)));
+}
+
+// Loads 8 samples, extending them to 16-bit
+inline __m128i Load8(const uint8_t *p)
+{
+    return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)), _mm_setzero_si128());
+}
+
+// Loads 4 samples, and repeats each one twice, extending them to 16-bit
+inline __m128i Load4x2(const uint8_t *p)
+{
+    int32_t val;
+    memcpy(&val, p, sizeof(val));
+    const __m128i v = _mm_cvtsi32_si128(val);
+    return _mm_unpacklo_epi8(_mm_unpacklo_epi8(v, v), _mm_setzero_si128());
+}
+
+// Converts 8 pixels from the 16-bit Y, U and V samples; does exactly
+// the same arithmetic as YUVToPixel, summing products in 32-bit lanes
+inline void YUVToPixels8(uint32_t *dst, __m128i y, __m128i u, __m128i v)
+{
+    const __m128i yc = _mm_sub_epi16(y, _mm_set1_epi16(16));
+    const __m128i uc = _mm_sub_epi16(u, _mm_set1_epi16(128));
+    const __m128i vc = _mm_sub_epi16(v, _mm_set1_epi16(128));
+    // Pair Y with 1 to add the rounding with the same multiplication,
+    // and U with V to sum both chroma products at once
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i y_lo = _mm_unpacklo_epi16(yc, one);
+    const __m128i y_hi = _mm_unpackhi_epi16(yc, one);
+    const __m128i uv_lo = _mm_unpacklo_epi16(uc, vc);
+    const __m128i uv_hi = _mm_unpackhi_epi16(uc, vc);
+
+    const __m128i ky = Pair16(CoefY, 128);
+    const __m128i kr = Pair16(0, CoefRV);
+    const __m128i kg = Pair16(CoefGU, CoefGV);
+    const __m128i kb = Pair16(CoefBU, 0);
+    const __m128i c_lo = _mm_madd_epi16(y_lo, ky);
+    const __m128i c_hi = _mm_madd_epi16(y_hi, ky);
+    const __m128i r = _mm_packs_epi32(
+        _mm_srai_epi32(_mm_add_epi32(c_lo, _mm_madd_epi16(uv_lo, kr)), 8),
+        _mm_srai_epi32(_mm_add_epi32(c_hi, _mm_madd_epi16(uv_hi, kr)), 8));
+    const __m128i g = _mm_packs_epi32(
+        _mm_srai_epi32(_mm_add_epi32(c_lo, _mm_madd_epi16(uv_lo, kg)), 8),
+        _mm_srai_epi32(_mm_add_epi32(c_hi, _mm_madd_epi16(uv_hi, kg)), 8));
+    const __m128i b = _mm_packs_epi32(
+        _mm_srai_epi32(_mm_add_epi32(c_lo, _mm_madd_epi16(uv_lo, kb)), 8),
+        _mm_srai_epi32(_mm_add_epi32(c_hi, _mm_madd_epi16(uv_hi, kb)), 8));
+
+    // Saturate to 8-bit, and interleave into B, G, R, A bytes
+    const __m128i b8 = _mm_packus_epi16(b, b);
+    const __m128i g8 = _mm_packus_epi16(g, g);
+    const __m128i r8 = _mm_packus_epi16(r, r);
+    const __m128i bg = _mm_unpacklo_epi8(b8, g8);
+    const __m128i ra = _mm_unpacklo_epi8(r8, _mm_set1_epi8(-1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi16(bg, ra));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4), _mm_unpackhi_epi16(bg, ra));
+}
+
+#endif // AGS_YUV_CONVERT_SSE2
+
+} // namespace
+
+void YUVRowToARGBScalar(uint32_t *dst, const uint8_t *y, const uint8_t *u,
+    const uint8_t *v, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        dst[i] = YUVToPixel(y[i], u[i], v[i]);
+}
+
+void YUVRowToARGB(uint32_t *dst, const uint8_t *y, const uint8_t *u,
+    const uint8_t *v, size_t count)
+{
+    size_t i = 0;
+#if defined(AGS_YUV_CONVERT_SSE2)
+    for (; i + 8 <= count; i += 8)
+        YUVToPixels8(dst + i, Load8(y + i), Load8(u + i), Load8(v + i));
+#endif
+    YUVRowToARGBScalar(dst + i, y + i, u + i, v + i, count - i);
+}
+
+void YUVHalfRowToARGB(uint32_t *dst, const uint8_t *y, const uint8_t *u,
+    const uint8_t *v, size_t count)
+{
+    size_t i = 0;
+#if defined(AGS_YUV_CONVERT_SSE2)
+    for (; i + 8 <= count; i += 8)
+        YUVToPixels8(dst + i, Load8(y + i), Load4x2(u + i / 2), Load4x2(v + i / 2));
+#endif
+    for (; i < count; ++i)
+        dst[i] = YUVToPixel(y[i], u[i >> 1], v[i >> 1]);
+}
+
+void YUVToARGB(const YUVImage &src, uint8_t *dst, int dst_pitch,
+    int dst_w, int dst_h, int row_from, int row_to)
+{
+    if (src.Width <= 0 || src.Height <= 0 || dst_w <= 0 || dst_h <= 0)
+        return;
+    row_from = std::max(0, row_from);
+    row_to = std::min(dst_h, row_to);
+
+    // Without horizontal scaling the rows are converted straight from the
+    // source planes; otherwise the samples are first picked into the row
+    // buffer, which has one sample of each component per pixel
+    const bool direct_rows = (dst_w == src.Width) && (src.ChromaShiftX <= 1);
+    std::vector<uint8_t> row_buf;
+    std::vector<int> map_x;
+    if (!direct_rows)
+    {
+        row_buf.resize(dst_w * 3);
+        map_x.resize(dst_w);
+        const uint64_t step_x = (static_cast<uint64_t>(src.Width) << 16) / dst_w;
+        for (int x = 0; x < dst_w; ++x)
+            map_x[x] = static_cast<int>((x * step_x) >> 16);
+    }
+
+    const uint64_t step_y = (static_cast<uint64_t>(src.Height) << 16) / dst_h;
+    int last_sy = -1;
+    for (int dy = row_from; dy < row_to; ++dy)
+    {
+        uint8_t *dst_row = dst + dy * dst_pitch;
+        const int sy = static_cast<int>((dy * step_y) >> 16);
+        if (sy == last_sy)
+        {
+            // Stretching vertically, the row is same as the previous one
+            memcpy(dst_row, dst_row - dst_pitch, dst_w * sizeof(uint32_t));
+            continue;
+        }
+        last_sy = sy;
+
+        const int cy = sy >> src.ChromaShiftY;
+        const uint8_t *y = src.Planes[0] + sy * src.Strides[0];
+        const uint8_t *u = src.Planes[1] + cy * src.Strides[1];
+        const uint8_t *v = src.Planes[2] + cy * src.Strides[2];
+        uint32_t *dst_px = reinterpret_cast<uint32_t*>(dst_row);
+        if (direct_rows)
+        {
+            if (src.ChromaShiftX == 0)
+                YUVRowToARGB(dst_px, y, u, v, dst_w);
+            else
+                YUVHalfRowToARGB(dst_px, y, u, v, dst_w);
+            continue;
+        }
+
+        uint8_t *row_y = row_buf.data();
+        uint8_t *row_u = row_y + dst_w;
+        uint8_t *row_v = row_u + dst_w;
+        const int shift_x = src.ChromaShiftX;
+        for (int x = 0; x < dst_w; ++x)
+        {
+            const int sx = map_x[x];
+            row_y[x] = y[sx];
+            row_u[x] = u[sx >> shift_x];
+            row_v[x] = v[sx >> shift_x];
+        }
+        YUVRowToARGB(dst_px, row_y, row_u, row_v, dst_w);
+    }
+}
+
+} // namespace Engine
+} // namespace AGS
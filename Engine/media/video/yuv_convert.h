@@ -0,0 +1,72 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// Conversion of the decoded planar YUV video images to 32-bit ARGB pixels.
+//
+// The conversion may scale the image at the same time, using the nearest
+// neighbour method, which lets write a decoded frame straight into the
+// final bitmap, without intermediate buffers and extra passes.
+// Uses SSE2 instructions where available; the results are identical to
+// the scalar conversion.
+//
+// The conversion is done for a range of destination rows, so that a frame
+// may be split in bands, and converted by several threads in parallel.
+//
+//=============================================================================
+#ifndef __AGS_EE_MEDIA__YUVCONVERT_H
+#define __AGS_EE_MEDIA__YUVCONVERT_H
+
+#include <stddef.h>
+#include "core/types.h"
+
+namespace AGS
+{
+namespace Engine
+{
+
+// Description of a planar YUV image
+struct YUVImage
+{
+    const uint8_t *Planes[3] = {}; // Y, U (Cb) and V (Cr) planes
+    int Strides[3] = {}; // length of a plane row, in bytes
+    int Width = 0; // image size in pixels (and luma samples)
+    int Height = 0;
+    // Chroma subsampling, as a power of two: 1,1 for 4:2:0, 1,0 for 4:2:2,
+    // and 0,0 for 4:4:4
+    int ChromaShiftX = 1;
+    int ChromaShiftY = 1;
+};
+
+// Converts a row of pixels from Y, U and V samples, which have one sample
+// of each component per pixel, and writes ARGB pixels with opaque alpha.
+void YUVRowToARGB(uint32_t *dst, const uint8_t *y, const uint8_t *u,
+    const uint8_t *v, size_t count);
+// Same as YUVRowToARGB, but always uses the scalar code
+void YUVRowToARGBScalar(uint32_t *dst, const uint8_t *y, const uint8_t *u,
+    const uint8_t *v, size_t count);
+// Converts a row of pixels from Y samples, and the U and V samples
+// of a half horizontal resolution, as found in 4:2:0 and 4:2:2 images.
+void YUVHalfRowToARGB(uint32_t *dst, const uint8_t *y, const uint8_t *u,
+    const uint8_t *v, size_t count);
+
+// Converts the rows [row_from, row_to) of the destination image, which has
+// the size of dst_w x dst_h and the pitch of dst_pitch bytes, stretching
+// the source image to fit the destination size.
+void YUVToARGB(const YUVImage &src, uint8_t *dst, int dst_pitch,
+    int dst_w, int dst_h, int row_from, int row_to);
+
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_MEDIA__YUVCONVERT_H
@@ -33,7 +33,7 @@ struct SysMainInfo
 // INIT / SHUTDOWN
 // ----------------------------------------------------------------------------
 
-int sys_main_init(/*config*/) {
+int sys_main_init(bool headless) {
     SDL_version version;
     SDL_GetVersion(&version);
     Debug::Printf(kDbgMsg_Info, "SDL Version: %d.%d.%d", version.major, version.minor, version.patch);
@@ -45,6 +45,10 @@ int sys_main_init(/*config*/) {
 #elif defined (SDL_HINT_ANDROID_SEPARATE_MOUSE_AND_TOUCH)
     SDL_SetHint(SDL_HINT_ANDROID_SEPARATE_MOUSE_AND_TOUCH, "1");
 #endif
+    // Let run without display (e.g. on a build server), unless the user
+    // has chosen the video driver explicitly
+    if (headless)
+        SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
     // TODO: setup these subsystems in config rather than keep hardcoded?
     if (SDL_InitSubSystem(SDL_INIT_VIDEO | SDL_INIT_TIMER | SDL_INIT_EVENTS) != 0) {
         Debug::Printf(kDbgMsg_Error, "Unable to initialize SDL: %s", SDL_GetError());
@@ -26,8 +26,9 @@ using AGS::Common::String;
 
 // Initializes main backend system;
 // should be called before anything else backend related.
+// Headless mode selects the dummy video driver, which works without display.
 // Returns 0 on success, non-0 on failure.
-int  sys_main_init(/*config*/);
+int  sys_main_init(bool headless = false);
 // Shutdown main backend system;
 // should be called last, after everything else backend related is shutdown.
 void sys_main_shutdown();
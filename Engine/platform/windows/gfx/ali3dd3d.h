@@ -245,6 +245,7 @@ public:
     bool DoesSupportVsyncToggle() override { return _capsVsync; }
     void RenderSpritesAtScreenResolution(bool enabled) override { _renderAtScreenRes = enabled; };
     void UseSmoothScaling(bool enabled) override { _smoothScaling = enabled; }
+    void SetRenderThreads(int /*thread_count*/) override { }
     bool SupportsGammaControl() override;
     void SetGamma(int newGamma) override;
 
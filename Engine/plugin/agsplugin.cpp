@@ -18,6 +18,7 @@
 #include "platform/windows/windows.h"
 #endif
 
+#include "ac/character.h"
 #include "ac/common.h" // quit
 #include "ac/draw.h"
 #include "ac/dynamicsprite.h"
@@ -36,6 +37,7 @@
 #include "ac/string.h"
 #include "ac/sys_events.h"
 #include "ac/view.h"
+#include "ac/walkablearea.h"
 #include "ac/dynobj/dynobj_manager.h"
 #include "ac/dynobj/cc_dynamicarray.h"
 #include "ac/dynobj/scriptstring.h"
@@ -99,7 +101,7 @@ extern RoomStatus *croom;
 // **************** PLUGIN IMPLEMENTATION ****************
 
 
-const int PLUGIN_API_VERSION = 30;
+const int PLUGIN_API_VERSION = 31;
 struct EnginePlugin
 {
     EnginePlugin() {
@@ -130,6 +132,19 @@ struct EnginePlugin
 std::vector<EnginePlugin> plugins;
 int pluginsWantingDebugHooks = 0;
 
+// Tells that any plugin has got a direct access to characters,
+// and so may change their rooms during its event callbacks
+static bool plugins_have_characters = false;
+
+// Runs the plugin's event callback
+static intptr_t run_plugin_event(EnginePlugin &plugin, int event, intptr_t data)
+{
+    const intptr_t retval = plugin.onEvent(event, data);
+    if (plugins_have_characters)
+        invalidate_room_characters();
+    return retval;
+}
+
 //
 // Managed object unserializers
 //
@@ -393,6 +408,9 @@ AGSCharacter* IAGSEngine::GetCharacter (int32 charnum) {
     if (charnum >= game.numcharacters)
         quit("!AGSEngine::GetCharacter: invalid character request");
 
+    // plugin may change character's room by writing the field directly
+    plugins_have_characters = true;
+    expose_room_characters();
     return (AGSCharacter*)&game.chars[charnum];
 }
 AGSGameOptions* IAGSEngine::GetGameOptions () {
@@ -453,7 +471,12 @@ BITMAP *IAGSEngine::GetSpriteGraphic (int32 num) {
 }
 BITMAP *IAGSEngine::GetRoomMask (int32 index) {
     if (index == MASK_WALKABLE)
+    {
+        // plugin may modify the mask at any time, while keeping the pointer,
+        // so anything generated from it may not be reused
+        expose_walkable_areas();
         return (BITMAP*)thisroom.WalkAreaMask->GetAllegroBitmap();
+    }
     else if (index == MASK_WALKBEHIND)
         return (BITMAP*)thisroom.WalkBehindMask->GetAllegroBitmap();
     else if (index == MASK_HOTSPOT)
@@ -904,7 +927,7 @@ intptr_t pl_run_plugin_hooks(int event, intptr_t data)
     {
         if (plugin.wantHook & event)
         {
-            intptr_t retval = plugin.onEvent(event, data);
+            intptr_t retval = run_plugin_event(plugin, event, data);
             // FIXME: this is an inconvenient design: breaking out
             // should be done only for events that are claimable,
             // such as key press, but not any random event!
@@ -948,7 +971,7 @@ intptr_t pl_run_plugin_hook_by_index(uint32_t pl_index, int event, intptr_t data
     auto &plugin = plugins[pl_index];
     if (plugin.wantHook & event)
     {
-        return plugin.onEvent(event, data);
+        return run_plugin_event(plugin, event, data);
     }
     return 0;
 }
@@ -959,7 +982,7 @@ intptr_t pl_run_plugin_hook_by_name(Common::String &pl_name, int event, intptr_t
     {
         if ((plugin.wantHook & event) && plugin.filename.CompareNoCase(pl_name) == 0)
         {
-            return plugin.onEvent(event, data);
+            return run_plugin_event(plugin, event, data);
         }
     }
     return 0;
@@ -411,7 +411,12 @@ protected:
 #define AGSE_POSTRESTOREGAME 0x40000
 // Below are interface 26 and later
 #define AGSE_POSTROOMDRAW    0x80000
-#define AGSE_TOOHIGH         0x100000
+// Below are interface 31 and later
+// Sent when the game save was written, either right after saving,
+// or when the background save has completed; data is the save slot
+// number, or -1 if the save has failed
+#define AGSE_POSTSAVEGAME    0x100000
+#define AGSE_TOOHIGH         0x200000
 
 // Logging levels
 #define AGSLOG_LEVEL_NONE   0
@@ -12,6 +12,7 @@
 //
 //=============================================================================
 #include "script/cc_instance.h"
+#include <algorithm>
 #include <cstdio>
 #include <deque>
 #include <string.h>
@@ -338,6 +339,34 @@ void ccInstance::AbortAndDestroy()
         return kInstErr_Generic; \
     }
 
+// ASSERT_CODE_POS tests that the program counter points inside the bytecode;
+// used after dynamic jumps, as their target positions cannot be validated on load
+#define ASSERT_CODE_POS(PC) \
+    if (static_cast<uint32_t>(PC) >= codeInst->_codesize) \
+    { \
+        cc_error("code position out of range: %d (code size %u)", PC, codeInst->_codesize); \
+        return kInstErr_Generic; \
+    }
+
+// ASSERT_JUMP_POS tests that the jump by a literal offset leads inside the bytecode;
+// the position is tested before the jump instruction's arg is skipped
+#define ASSERT_JUMP_POS(PC) \
+    if (static_cast<uint32_t>((PC) + 2) >= codeInst->_codesize) \
+    { \
+        cc_error("jump leads out of code: %d (code size %u)", (PC) + 2, codeInst->_codesize); \
+        return kInstErr_Generic; \
+    }
+
+// CC_OP marks the instruction's case in the Run's main switch, and, if computed
+// goto is supported, a label which the instructions are dispatched to
+#if defined(__GNUC__) || defined(__clang__)
+#define CC_COMPUTED_GOTO 1
+#define CC_OP(OP) case OP: op_##OP
+#else
+#define CC_COMPUTED_GOTO 0
+#define CC_OP(OP) case OP
+#endif
+
 // ASSERT_STACK_UNWINDED tests that the stack pointer is at the expected position
 #define ASSERT_STACK_UNWINDED(STACK_VAL, DATA_PTR) \
     if ((_registers[SREG_SP].RValue > STACK_VAL.RValue) || \
@@ -581,7 +610,7 @@ ccInstError ccInstance::Run(int32_t curpc)
     thisbase[0] = 0;
     funcstart[0] = _pc;
     ccInstance *codeInst = _runningInst;
-    ScriptOperation codeOp;
+    ScriptOperation lazyOp; // for the code which was not decoded on load
     FunctionCallStack func_callstack;
 #if DEBUG_CC_EXEC
     const bool dump_opcodes = ccGetOption(SCOPT_DEBUGRUN) != 0;
@@ -593,6 +622,31 @@ ccInstError ccInstance::Run(int32_t curpc)
     const auto timeout = std::chrono::milliseconds(_timeoutCheckMs);
     _lastAliveTs = FastClock::now();
 
+#if CC_COMPUTED_GOTO
+    // Jump table for dispatching the instructions, in the order of instruction codes
+    static const void *const op_labels[CC_NUM_SCCMDS] = {
+        &&op_not_decoded,
+        &&op_SCMD_ADD, &&op_SCMD_SUB, &&op_SCMD_REGTOREG, &&op_SCMD_WRITELIT, &&op_SCMD_RET,
+        &&op_SCMD_LITTOREG, &&op_SCMD_MEMREAD, &&op_SCMD_MEMWRITE, &&op_SCMD_MULREG,
+        &&op_SCMD_DIVREG, &&op_SCMD_ADDREG, &&op_SCMD_SUBREG, &&op_SCMD_BITAND, &&op_SCMD_BITOR,
+        &&op_SCMD_ISEQUAL, &&op_SCMD_NOTEQUAL, &&op_SCMD_GREATER, &&op_SCMD_LESSTHAN, &&op_SCMD_GTE,
+        &&op_SCMD_LTE, &&op_SCMD_AND, &&op_SCMD_OR, &&op_SCMD_CALL, &&op_SCMD_MEMREADB,
+        &&op_SCMD_MEMREADW, &&op_SCMD_MEMWRITEB, &&op_SCMD_MEMWRITEW, &&op_SCMD_JZ,
+        &&op_SCMD_PUSHREG, &&op_SCMD_POPREG, &&op_SCMD_JMP, &&op_SCMD_MUL, &&op_SCMD_CALLEXT,
+        &&op_SCMD_PUSHREAL, &&op_SCMD_SUBREALSTACK, &&op_SCMD_LINENUM, &&op_SCMD_CALLAS,
+        &&op_SCMD_THISBASE, &&op_SCMD_NUMFUNCARGS, &&op_SCMD_MODREG, &&op_SCMD_XORREG,
+        &&op_SCMD_NOTREG, &&op_SCMD_SHIFTLEFT, &&op_SCMD_SHIFTRIGHT, &&op_SCMD_CALLOBJ,
+        &&op_SCMD_CHECKBOUNDS, &&op_SCMD_MEMWRITEPTR, &&op_SCMD_MEMREADPTR, &&op_SCMD_MEMZEROPTR,
+        &&op_SCMD_MEMINITPTR, &&op_SCMD_LOADSPOFFS, &&op_SCMD_CHECKNULL, &&op_SCMD_FADD,
+        &&op_SCMD_FSUB, &&op_SCMD_FMULREG, &&op_SCMD_FDIVREG, &&op_SCMD_FADDREG, &&op_SCMD_FSUBREG,
+        &&op_SCMD_FGREATER, &&op_SCMD_FLESSTHAN, &&op_SCMD_FGTE, &&op_SCMD_FLTE,
+        &&op_SCMD_ZEROMEMORY, &&op_SCMD_CREATESTRING, &&op_SCMD_STRINGSEQUAL,
+        &&op_SCMD_STRINGSNOTEQ, &&op_SCMD_CHECKNULLREG, &&op_SCMD_LOOPCHECKOFF,
+        &&op_SCMD_MEMZEROPTRND, &&op_SCMD_JNZ, &&op_SCMD_DYNAMICBOUNDS, &&op_SCMD_NEWARRAY,
+        &&op_SCMD_NEWUSEROBJECT,
+    };
+#endif
+
     /* Main bytecode execution loop */
     //=====================================================================
     while ((_flags & INSTF_ABORTED) == 0)
@@ -604,34 +658,14 @@ ccInstError ccInstance::Run(int32_t curpc)
         //
         /* Read operation */
         //=====================================================================
-        codeOp.Instruction.Code = codeInst->_code[_pc];
-        codeOp.Instruction.InstanceId = (codeOp.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
-        codeOp.Instruction.Code &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
-
-        CC_ERROR_IF_RETCODE((codeOp.Instruction.Code < 0 || codeOp.Instruction.Code >= CC_NUM_SCCMDS),
-            "invalid instruction %d found in code stream", codeOp.Instruction.Code);
-
-        codeOp.ArgCount = sccmd_info[codeOp.Instruction.Code].ArgCount;
-
-        CC_ERROR_IF_RETCODE(static_cast<uint32_t>(_pc + codeOp.ArgCount) >= codeInst->_codesize,
-            "unexpected end of code data (%u; %u)", static_cast<uint32_t>(_pc + codeOp.ArgCount), codeInst->_codesize);
-
-
-        // Read arguments; use switch as it proved to be faster than the loop
-        switch (codeOp.ArgCount)
-        {
-        case 3:
-            codeOp.Args[2].SetInt32(static_cast<int32_t>(codeInst->_code[_pc + 3]));
-            /* fall-through */
-        case 2:
-            codeOp.Args[1].SetInt32(static_cast<int32_t>(codeInst->_code[_pc + 2]));
-            /* fall-through */
-        case 1:
-            codeOp.Args[0].SetInt32(static_cast<int32_t>(codeInst->_code[_pc + 1]));
-            break;
-        default:
-            break;
-        }
+        // Instructions were decoded and their arguments resolved when the script
+        // was loaded, see DecodeInstructions(). Positions which were not decoded
+        // refer to the placeholder op with code 0, which is handled below.
+        // Code index has an extra trailing entry, so running past the last
+        // instruction lands on the placeholder too, and is reported as end of code.
+        const ScriptOperation *decodedOp = &codeInst->_code_ops[codeInst->_code_op_index[_pc]];
+    dispatch_op:
+        const ScriptOperation &codeOp = *decodedOp;
         //---------------------------------------------------------------------
         /* End read operation */
         //=====================================================================
@@ -645,15 +679,41 @@ ccInstError ccInstance::Run(int32_t curpc)
 
         /* Perform operation */
         //=====================================================================
+#if CC_COMPUTED_GOTO
+        goto *op_labels[codeOp.Instruction.Code];
+#endif
         switch (codeOp.Instruction.Code)
         {
-        case SCMD_LINENUM:
+        case 0:
+#if CC_COMPUTED_GOTO
+        op_not_decoded:
+#endif
+        {
+            // Not decoded on load: either a malformed code, or a position
+            // inside other instruction's args; try decoding it now
+            if (static_cast<uint32_t>(_pc) >= codeInst->_codesize)
+            {
+                cc_error("unexpected end of code data at %d (code size %u)", _pc, codeInst->_codesize);
+                return kInstErr_Generic;
+            }
+            if (!codeInst->DecodeOperation(_pc, lazyOp))
+            {
+                if (lazyOp.Instruction.Code <= 0 || lazyOp.Instruction.Code >= CC_NUM_SCCMDS)
+                    cc_error("invalid instruction %d found in code stream at %d", lazyOp.Instruction.Code, _pc);
+                else
+                    cc_error("unexpected end of code data (%u; %u)", static_cast<uint32_t>(_pc + lazyOp.ArgCount), codeInst->_codesize);
+                return kInstErr_Generic;
+            }
+            decodedOp = &lazyOp;
+            goto dispatch_op;
+        }
+        CC_OP(SCMD_LINENUM):
             _lineNumber = codeOp.Arg1i();
             currentline = _lineNumber;
             if (new_line_hook)
                 new_line_hook(this, currentline);
             break;
-        case SCMD_ADD:
+        CC_OP(SCMD_ADD):
         {
             const auto arg_reg = codeOp.Arg1i();
             const auto arg_lit = codeOp.Arg2i();
@@ -685,7 +745,7 @@ ccInstError ccInstance::Run(int32_t curpc)
             }
             break;
         }
-        case SCMD_SUB:
+        CC_OP(SCMD_SUB):
         {
             const auto arg_reg = codeOp.Arg1i();
             const auto arg_lit = codeOp.Arg2i();
@@ -715,14 +775,14 @@ ccInstError ccInstance::Run(int32_t curpc)
             }
             break;
         }
-        case SCMD_REGTOREG:
+        CC_OP(SCMD_REGTOREG):
         {
             const auto &reg1 = _registers[codeOp.Arg1i()];
             auto       &reg2 = _registers[codeOp.Arg2i()];
             reg2 = reg1;
             break;
         }
-        case SCMD_WRITELIT:
+        CC_OP(SCMD_WRITELIT):
         {
             // Take the data address from reg[MAR] and copy there arg1 bytes from arg2 address
             //
@@ -731,9 +791,12 @@ ccInstError ccInstance::Run(int32_t curpc)
             // be only up to 4 bytes large;
             // I guess that's an obsolete way to do WRITE, WRITEW and WRITEB
             const auto arg_size = codeOp.Arg1i();
-            FixupArgument(codeOp.Args[1], codeInst->_code_fixups[_pc + 2], codeInst->_code[_pc + 2], _stackBegin, codeInst->_strings);
-            ASSERT_CC_ERROR();
-            const auto &arg_value = codeOp.Arg2();
+            RuntimeScriptValue arg_value = codeOp.Arg2();
+            if (codeOp.RuntimeFixup != FIXUP_NOFIXUP)
+            {
+                FixupArgument(arg_value, codeOp.RuntimeFixup, static_cast<uint32_t>(arg_value.IValue), _stackBegin, codeInst->_strings);
+                ASSERT_CC_ERROR();
+            }
             switch (arg_size)
             {
             case sizeof(char) :
@@ -752,7 +815,7 @@ ccInstError ccInstance::Run(int32_t curpc)
             }
             break;
         }
-        case SCMD_RET:
+        CC_OP(SCMD_RET):
         {
             if (loopIterationCheckDisabled > 0)
                 loopIterationCheckDisabled--;
@@ -766,47 +829,55 @@ ccInstError ccInstance::Run(int32_t curpc)
                 _returnValue = _registers[SREG_AX].IValue;
                 return kInstErr_None;
             }
+            ASSERT_CODE_POS(_pc);
             POP_CALL_STACK();
             continue; // continue so that the PC doesn't get overwritten
         }
-        case SCMD_LITTOREG:
+        CC_OP(SCMD_LITTOREG):
         {
             auto &reg1 = _registers[codeOp.Arg1i()];
-            FixupArgument(codeOp.Args[1], codeInst->_code_fixups[_pc + 2], codeInst->_code[_pc + 2], _stackBegin, codeInst->_strings);
-            ASSERT_CC_ERROR();
-            const auto &arg_value = codeOp.Arg2();
-            reg1 = arg_value;
+            if (codeOp.RuntimeFixup != FIXUP_NOFIXUP)
+            {
+                RuntimeScriptValue arg_value = codeOp.Arg2();
+                FixupArgument(arg_value, codeOp.RuntimeFixup, static_cast<uint32_t>(arg_value.IValue), _stackBegin, codeInst->_strings);
+                ASSERT_CC_ERROR();
+                reg1 = arg_value;
+            }
+            else
+            {
+                reg1 = codeOp.Arg2();
+            }
             break;
         }
-        case SCMD_MEMREAD:
+        CC_OP(SCMD_MEMREAD):
         {
             // Take the data address from reg[MAR] and copy int32_t to reg[arg1]
             auto &reg1 = _registers[codeOp.Arg1i()];
             reg1 = _registers[SREG_MAR].ReadValue();
             break;
         }
-        case SCMD_MEMWRITE:
+        CC_OP(SCMD_MEMWRITE):
         {
             // Take the data address from reg[MAR] and copy there int32_t from reg[arg1]
             const auto &reg1 = _registers[codeOp.Arg1i()];
             _registers[SREG_MAR].WriteValue(reg1);
             break;
         }
-        case SCMD_LOADSPOFFS:
+        CC_OP(SCMD_LOADSPOFFS):
         {
             const auto arg_off = codeOp.Arg1i();
             _registers[SREG_MAR] = GetStackPtrOffsetRw(arg_off);
             ASSERT_CC_ERROR();
             break;
         }
-        case SCMD_MULREG:
+        CC_OP(SCMD_MULREG):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
             reg1.SetInt32(reg1.IValue * reg2.IValue);
             break;
         }
-        case SCMD_DIVREG:
+        CC_OP(SCMD_DIVREG):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
@@ -818,7 +889,7 @@ ccInstError ccInstance::Run(int32_t curpc)
             reg1.SetInt32(reg1.IValue / reg2.IValue);
             break;
         }
-        case SCMD_ADDREG:
+        CC_OP(SCMD_ADDREG):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
@@ -826,7 +897,7 @@ ccInstError ccInstance::Run(int32_t curpc)
             reg1.IValue += reg2.IValue;
             break;
         }
-        case SCMD_SUBREG:
+        CC_OP(SCMD_SUBREG):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
@@ -834,84 +905,84 @@ ccInstError ccInstance::Run(int32_t curpc)
             reg1.IValue -= reg2.IValue;
             break;
         }
-        case SCMD_BITAND:
+        CC_OP(SCMD_BITAND):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
             reg1.SetInt32(reg1.IValue & reg2.IValue);
             break;
         }
-        case SCMD_BITOR:
+        CC_OP(SCMD_BITOR):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
             reg1.SetInt32(reg1.IValue | reg2.IValue);
             break;
         }
-        case SCMD_ISEQUAL:
+        CC_OP(SCMD_ISEQUAL):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
             reg1.SetInt32AsBool(reg1 == reg2);
             break;
         }
-        case SCMD_NOTEQUAL:
+        CC_OP(SCMD_NOTEQUAL):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
             reg1.SetInt32AsBool(reg1 != reg2);
             break;
         }
-        case SCMD_GREATER:
+        CC_OP(SCMD_GREATER):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
             reg1.SetInt32AsBool(reg1.IValue > reg2.IValue);
             break;
         }
-        case SCMD_LESSTHAN:
+        CC_OP(SCMD_LESSTHAN):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
             reg1.SetInt32AsBool(reg1.IValue < reg2.IValue);
             break;
         }
-        case SCMD_GTE:
+        CC_OP(SCMD_GTE):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
             reg1.SetInt32AsBool(reg1.IValue >= reg2.IValue);
             break;
         }
-        case SCMD_LTE:
+        CC_OP(SCMD_LTE):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
             reg1.SetInt32AsBool(reg1.IValue <= reg2.IValue);
             break;
         }
-        case SCMD_AND:
+        CC_OP(SCMD_AND):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
             reg1.SetInt32AsBool(reg1.IValue && reg2.IValue);
             break;
         }
-        case SCMD_OR:
+        CC_OP(SCMD_OR):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
             reg1.SetInt32AsBool(reg1.IValue || reg2.IValue);
             break;
         }
-        case SCMD_XORREG:
+        CC_OP(SCMD_XORREG):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
             reg1.SetInt32(reg1.IValue ^ reg2.IValue);
             break;
         }
-        case SCMD_MODREG:
+        CC_OP(SCMD_MODREG):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
@@ -923,13 +994,13 @@ ccInstError ccInstance::Run(int32_t curpc)
             reg1.SetInt32(reg1.IValue % reg2.IValue);
             break;
         }
-        case SCMD_NOTREG:
+        CC_OP(SCMD_NOTREG):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             reg1 = !(reg1);
             break;
         }
-        case SCMD_CALL:
+        CC_OP(SCMD_CALL):
         {
             // Call another function within same script, just save PC
             // and continue from there
@@ -951,6 +1022,7 @@ ccInstError ccInstance::Run(int32_t curpc)
                 _pc = funcstart[curnest];
                 _pc += (reg1.IValue - thisbase[curnest]);
             }
+            ASSERT_CODE_POS(_pc);
 
             next_call_needs_object = 0;
 
@@ -962,49 +1034,55 @@ ccInstError ccInstance::Run(int32_t curpc)
             funcstart[curnest] = _pc;
             continue; // continue so that the PC doesn't get overwritten
         }
-        case SCMD_MEMREADB:
+        CC_OP(SCMD_MEMREADB):
         {
             // Take the data address from reg[MAR] and copy byte to reg[arg1]
             auto &reg1 = _registers[codeOp.Arg1i()];
             reg1.SetUInt8(_registers[SREG_MAR].ReadByte());
             break;
         }
-        case SCMD_MEMREADW:
+        CC_OP(SCMD_MEMREADW):
         {
             // Take the data address from reg[MAR] and copy int16_t to reg[arg1]
             auto &reg1 = _registers[codeOp.Arg1i()];
             reg1.SetInt16(_registers[SREG_MAR].ReadInt16());
             break;
         }
-        case SCMD_MEMWRITEB:
+        CC_OP(SCMD_MEMWRITEB):
         {
             // Take the data address from reg[MAR] and copy there byte from reg[arg1]
             const auto &reg1 = _registers[codeOp.Arg1i()];
             _registers[SREG_MAR].WriteByte(reg1.IValue);
             break;
         }
-        case SCMD_MEMWRITEW:
+        CC_OP(SCMD_MEMWRITEW):
         {
             // Take the data address from reg[MAR] and copy there int16_t from reg[arg1]
             const auto &reg1 = _registers[codeOp.Arg1i()];
             _registers[SREG_MAR].WriteInt16(reg1.IValue);
             break;
         }
-        case SCMD_JZ:
+        CC_OP(SCMD_JZ):
         {
             const auto arg_lit = codeOp.Arg1i();
             if (_registers[SREG_AX].IsNull())
+            {
                 _pc += arg_lit;
+                ASSERT_JUMP_POS(_pc);
+            }
             break;
         }
-        case SCMD_JNZ:
+        CC_OP(SCMD_JNZ):
         {
             const auto arg_lit = codeOp.Arg1i();
             if (!_registers[SREG_AX].IsNull())
+            {
                 _pc += arg_lit;
+                ASSERT_JUMP_POS(_pc);
+            }
             break;
         }
-        case SCMD_PUSHREG:
+        CC_OP(SCMD_PUSHREG):
         {
             // Push reg[arg1] value to the stack
             const auto &reg1 = _registers[codeOp.Arg1i()];
@@ -1012,17 +1090,18 @@ ccInstError ccInstance::Run(int32_t curpc)
             PushValueToStack(reg1);
             break;
         }
-        case SCMD_POPREG:
+        CC_OP(SCMD_POPREG):
         {
             auto &reg1 = _registers[codeOp.Arg1i()];
             ASSERT_STACK_SIZE(1);
             reg1 = PopValueFromStack();
             break;
         }
-        case SCMD_JMP:
+        CC_OP(SCMD_JMP):
         {
             const auto arg_lit = codeOp.Arg1i();
             _pc += arg_lit;
+            ASSERT_JUMP_POS(_pc);
 
             // Make sure it's not stuck in a While loop
             if (arg_lit < 0)
@@ -1052,14 +1131,14 @@ ccInstError ccInstance::Run(int32_t curpc)
             }
             break;
         }
-        case SCMD_MUL:
+        CC_OP(SCMD_MUL):
         {
             auto &reg1 = _registers[codeOp.Arg1i()];
             const auto arg_lit = codeOp.Arg2i();
             reg1.IValue *= arg_lit;
             break;
         }
-        case SCMD_CHECKBOUNDS:
+        CC_OP(SCMD_CHECKBOUNDS):
         {
             const auto &reg1 = _registers[codeOp.Arg1i()];
             const auto arg_lit = codeOp.Arg2i();
@@ -1071,7 +1150,7 @@ ccInstError ccInstance::Run(int32_t curpc)
             }
             break;
         }
-        case SCMD_DYNAMICBOUNDS:
+        CC_OP(SCMD_DYNAMICBOUNDS):
         {
             const auto &reg1 = _registers[codeOp.Arg1i()];
             void *arr_ptr = _registers[SREG_MAR].GetPtrWithOffset();
@@ -1093,7 +1172,7 @@ ccInstError ccInstance::Run(int32_t curpc)
             }
             break;
         }
-        case SCMD_MEMREADPTR:
+        CC_OP(SCMD_MEMREADPTR):
         {
             auto &reg1 = _registers[codeOp.Arg1i()];
             int32_t handle = _registers[SREG_MAR].ReadInt32();
@@ -1106,11 +1185,12 @@ ccInstError ccInstance::Run(int32_t curpc)
             ASSERT_CC_ERROR();
             break;
         }
-        case SCMD_MEMWRITEPTR:
+        CC_OP(SCMD_MEMWRITEPTR):
         {
             const auto &reg1 = _registers[codeOp.Arg1i()];
             int32_t handle = _registers[SREG_MAR].ReadInt32();
             void *address;
+            IScriptObject *manager = nullptr;
 
             switch (reg1.Type)
             {
@@ -1120,6 +1200,9 @@ ccInstError ccInstance::Run(int32_t curpc)
                 address = reg1.ArrMgr->GetElementPtr(reg1.Ptr, reg1.IValue);
                 break;
             case kScValScriptObject:
+                address = reg1.Ptr;
+                manager = reg1.ObjMgr;
+                break;
             case kScValPluginObject:
             case kScValPluginArgPtr:
                 address = reg1.Ptr;
@@ -1135,7 +1218,7 @@ ccInstError ccInstance::Run(int32_t curpc)
                 break;
             }
 
-            int32_t newHandle = ccGetObjectHandleFromAddress(address);
+            int32_t newHandle = ccGetObjectHandleFromAddress(address, manager);
             if (newHandle == -1)
                 return kInstErr_Generic;
 
@@ -1148,9 +1231,10 @@ ccInstError ccInstance::Run(int32_t curpc)
             _registers[SREG_MAR].WriteInt32(newHandle);
             break;
         }
-        case SCMD_MEMINITPTR:
+        CC_OP(SCMD_MEMINITPTR):
         {
             void *address;
+            IScriptObject *manager = nullptr;
             const auto &reg1 = _registers[codeOp.Arg1i()];
 
             switch (reg1.Type)
@@ -1161,6 +1245,9 @@ ccInstError ccInstance::Run(int32_t curpc)
                 address = reg1.ArrMgr->GetElementPtr(reg1.Ptr, reg1.IValue);
                 break;
             case kScValScriptObject:
+                address = reg1.Ptr;
+                manager = reg1.ObjMgr;
+                break;
             case kScValPluginObject:
             case kScValPluginArgPtr:
                 address = reg1.Ptr;
@@ -1177,7 +1264,7 @@ ccInstError ccInstance::Run(int32_t curpc)
             }
 
             // like memwriteptr, but doesn't attempt to free the old one
-            int32_t newHandle = ccGetObjectHandleFromAddress(address);
+            int32_t newHandle = ccGetObjectHandleFromAddress(address, manager);
             if (newHandle == -1)
                 return kInstErr_Generic;
 
@@ -1185,14 +1272,14 @@ ccInstError ccInstance::Run(int32_t curpc)
             _registers[SREG_MAR].WriteInt32(newHandle);
             break;
         }
-        case SCMD_MEMZEROPTR:
+        CC_OP(SCMD_MEMZEROPTR):
         {
             int32_t handle = _registers[SREG_MAR].ReadInt32();
             ccReleaseObjectReference(handle);
             _registers[SREG_MAR].WriteInt32(0);
             break;
         }
-        case SCMD_MEMZEROPTRND:
+        CC_OP(SCMD_MEMZEROPTRND):
         {
             int32_t handle = _registers[SREG_MAR].ReadInt32();
 
@@ -1207,14 +1294,14 @@ ccInstError ccInstance::Run(int32_t curpc)
             _registers[SREG_MAR].WriteInt32(0);
             break;
         }
-        case SCMD_CHECKNULL:
+        CC_OP(SCMD_CHECKNULL):
             if (_registers[SREG_MAR].IsNull())
             {
                 cc_error("!Null pointer referenced");
                 return kInstErr_Generic;
             }
             break;
-        case SCMD_CHECKNULLREG:
+        CC_OP(SCMD_CHECKNULLREG):
         {
             const auto &reg1 = _registers[codeOp.Arg1i()];
             if (reg1.IsNull())
@@ -1224,13 +1311,13 @@ ccInstError ccInstance::Run(int32_t curpc)
             }
             break;
         }
-        case SCMD_NUMFUNCARGS:
+        CC_OP(SCMD_NUMFUNCARGS):
         {
             const auto arg_lit = codeOp.Arg1i();
             num_args_to_func = arg_lit;
             break;
         }
-        case SCMD_CALLAS:
+        CC_OP(SCMD_CALLAS):
         {
             PUSH_CALL_STACK();
 
@@ -1287,7 +1374,7 @@ ccInstError ccInstance::Run(int32_t curpc)
             POP_CALL_STACK();
             break;
         }
-        case SCMD_CALLEXT:
+        CC_OP(SCMD_CALLEXT):
         {
             // Call to a real 'C' code function
             const auto &reg1 = _registers[codeOp.Arg1i()];
@@ -1357,13 +1444,13 @@ ccInstError ccInstance::Run(int32_t curpc)
             num_args_to_func = -1;
             break;
         }
-        case SCMD_PUSHREAL:
+        CC_OP(SCMD_PUSHREAL):
         {
             const auto &reg1 = _registers[codeOp.Arg1i()];
             PushToFuncCallStack(func_callstack, reg1);
             break;
         }
-        case SCMD_SUBREALSTACK:
+        CC_OP(SCMD_SUBREALSTACK):
         {
             const auto arg_lit = codeOp.Arg1i();
             PopFromFuncCallStack(func_callstack, arg_lit);
@@ -1375,7 +1462,7 @@ ccInstError ccInstance::Run(int32_t curpc)
             }
             break;
         }
-        case SCMD_CALLOBJ:
+        CC_OP(SCMD_CALLOBJ):
         {
             // set the OP register
             const auto &reg1 = _registers[codeOp.Arg1i()];
@@ -1412,27 +1499,27 @@ ccInstError ccInstance::Run(int32_t curpc)
             next_call_needs_object = 1;
             break;
         }
-        case SCMD_SHIFTLEFT:
+        CC_OP(SCMD_SHIFTLEFT):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
             reg1.SetInt32(reg1.IValue << reg2.IValue);
             break;
         }
-        case SCMD_SHIFTRIGHT:
+        CC_OP(SCMD_SHIFTRIGHT):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
             reg1.SetInt32(reg1.IValue >> reg2.IValue);
             break;
         }
-        case SCMD_THISBASE:
+        CC_OP(SCMD_THISBASE):
         {
             const auto arg_lit = codeOp.Arg1i();
             thisbase[curnest] = arg_lit;
             break;
         }
-        case SCMD_NEWARRAY:
+        CC_OP(SCMD_NEWARRAY):
         {
             auto &reg1 = _registers[codeOp.Arg1i()];
             const int arg_elnum = reg1.IValue;
@@ -1447,7 +1534,7 @@ ccInstError ccInstance::Run(int32_t curpc)
             reg1.SetScriptObject(ref.Obj, &globalDynamicArray);
             break;
         }
-        case SCMD_NEWUSEROBJECT:
+        CC_OP(SCMD_NEWUSEROBJECT):
         {
             auto &reg1 = _registers[codeOp.Arg1i()];
             const uint32_t arg_size = static_cast<uint32_t>(codeOp.Arg2i());
@@ -1460,28 +1547,28 @@ ccInstError ccInstance::Run(int32_t curpc)
             reg1.SetScriptObject(ref.Obj, ref.Mgr);
             break;
         }
-        case SCMD_FADD:
+        CC_OP(SCMD_FADD):
         {
             auto &reg1 = _registers[codeOp.Arg1i()];
             const auto arg_lit = codeOp.Arg2i();
             reg1.SetFloat(reg1.FValue + arg_lit); // arg2 was used as int here originally
             break;
         }
-        case SCMD_FSUB:
+        CC_OP(SCMD_FSUB):
         {
             auto &reg1 = _registers[codeOp.Arg1i()];
             const auto arg_lit = codeOp.Arg2i();
             reg1.SetFloat(reg1.FValue - arg_lit); // arg2 was used as int here originally
             break;
         }
-        case SCMD_FMULREG:
+        CC_OP(SCMD_FMULREG):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
             reg1.SetFloat(reg1.FValue * reg2.FValue);
             break;
         }
-        case SCMD_FDIVREG:
+        CC_OP(SCMD_FDIVREG):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
@@ -1493,49 +1580,49 @@ ccInstError ccInstance::Run(int32_t curpc)
             reg1.SetFloat(reg1.FValue / reg2.FValue);
             break;
         }
-        case SCMD_FADDREG:
+        CC_OP(SCMD_FADDREG):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
             reg1.SetFloat(reg1.FValue + reg2.FValue);
             break;
         }
-        case SCMD_FSUBREG:
+        CC_OP(SCMD_FSUBREG):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
             reg1.SetFloat(reg1.FValue - reg2.FValue);
             break;
         }
-        case SCMD_FGREATER:
+        CC_OP(SCMD_FGREATER):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
             reg1.SetFloatAsBool(reg1.FValue > reg2.FValue);
             break;
         }
-        case SCMD_FLESSTHAN:
+        CC_OP(SCMD_FLESSTHAN):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
             reg1.SetFloatAsBool(reg1.FValue < reg2.FValue);
             break;
         }
-        case SCMD_FGTE:
+        CC_OP(SCMD_FGTE):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
             reg1.SetFloatAsBool(reg1.FValue >= reg2.FValue);
             break;
         }
-        case SCMD_FLTE:
+        CC_OP(SCMD_FLTE):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
             reg1.SetFloatAsBool(reg1.FValue <= reg2.FValue);
             break;
         }
-        case SCMD_ZEROMEMORY:
+        CC_OP(SCMD_ZEROMEMORY):
         {
             const auto arg_size = codeOp.Arg1i();
             // Check if we are zeroing at stack tail
@@ -1556,15 +1643,15 @@ ccInstError ccInstance::Run(int32_t curpc)
             }
             break;
         }
-        case SCMD_CREATESTRING:
+        CC_OP(SCMD_CREATESTRING):
         {
             auto &reg1 = _registers[codeOp.Arg1i()];
             const char *ptr = reinterpret_cast<const char*>(reg1.GetDirectPtr());
-            DynObjectRef ref = ScriptString::Create(ptr);
+            DynObjectRef ref = ScriptString::CreateInterned(ptr);
             reg1.SetScriptObject(ref.Obj, &myScriptStringImpl);
             break;
         }
-        case SCMD_STRINGSEQUAL:
+        CC_OP(SCMD_STRINGSEQUAL):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
@@ -1581,7 +1668,7 @@ ccInstError ccInstance::Run(int32_t curpc)
             }
             break;
         }
-        case SCMD_STRINGSNOTEQ:
+        CC_OP(SCMD_STRINGSNOTEQ):
         {
             auto       &reg1 = _registers[codeOp.Arg1i()];
             const auto &reg2 = _registers[codeOp.Arg2i()];
@@ -1598,7 +1685,7 @@ ccInstError ccInstance::Run(int32_t curpc)
             }
             break;
         }
-        case SCMD_LOOPCHECKOFF:
+        CC_OP(SCMD_LOOPCHECKOFF):
             if (loopIterationCheckDisabled == 0)
                 loopIterationCheckDisabled++;
             break;
@@ -1762,6 +1849,8 @@ bool ccInstance::_Create(PScript scri, const ccInstance *joined)
         {
             _scriptData->code.resize(scri->code.size());
             _scriptData->code_fixups.resize(scri->code.size());
+            // one extra terminating entry, which always refers to the not decoded op
+            _scriptData->code_op_index.resize(scri->code.size() + 1);
             // 64 bit: Read code into 8 byte array, necessary for being able to perform
             // relocations on the references.
             for (size_t i = 0; i < scri->code.size(); ++i)
@@ -1791,6 +1880,8 @@ bool ccInstance::_Create(PScript scri, const ccInstance *joined)
     _code = _scriptData->code.data();
     _codesize = static_cast<int32_t>(_scriptData->code.size());
     _code_fixups = _scriptData->code_fixups.data();
+    _code_ops = _scriptData->code_ops.data();
+    _code_op_index = _scriptData->code_op_index.data();
 
     // If this is a primary script's instance:
     // * register it in the loadedInstances array,
@@ -1825,6 +1916,8 @@ bool ccInstance::_Create(PScript scri, const ccInstance *joined)
         {
             return false;
         }
+        DecodeInstructions(scri.get());
+        _code_ops = _scriptData->code_ops.data();
         if (!ResolveExports(scri.get()))
         {
             return false;
@@ -1876,6 +1969,8 @@ void ccInstance::Free()
     _scriptData = nullptr;
     _code = nullptr;
     _codesize = 0;
+    _code_ops = nullptr;
+    _code_op_index = nullptr;
     _strings = nullptr;
     _stringsize = 0u;
 
@@ -2113,6 +2208,81 @@ bool ccInstance::CreateRuntimeCodeFixups(const ccScript *scri)
     return true;
 }
 
+void ccInstance::DecodeInstructions(const ccScript *scri)
+{
+    auto &code_ops = _scriptData->code_ops;
+    uint32_t *code_op_index = _scriptData->code_op_index.data();
+    // Function entry points, where decoding may continue after malformed code
+    std::vector<uint32_t> func_starts;
+    for (size_t i = 0; i < scri->exports.size(); i++)
+    {
+        if (((scri->export_addr[i] >> 24L) & 0x000ff) == EXPORT_FUNCTION)
+            func_starts.push_back(scri->export_addr[i] & 0x00ffffff);
+    }
+    std::sort(func_starts.begin(), func_starts.end());
+
+    // First entry is a placeholder, referenced by all the positions we did not decode
+    code_ops.clear();
+    code_ops.reserve(_codesize / 2 + 1);
+    code_ops.push_back(ScriptOperation());
+    // Decode instructions in order; any positions we skip here are left
+    // as not decoded, and the interpreter decodes them if it ever reaches them.
+    ScriptOperation op;
+    for (uint32_t pc = 0; pc < _codesize; ++pc)
+    {
+        if (!DecodeOperation(pc, op))
+        {
+            // Don't fail here, as old scripts might have unreachable trash in them;
+            // the following code cannot be decoded reliably, so skip to the next function
+            Debug::Printf(kDbgMsg_Warn, "WARNING: script '%s': invalid instruction %d found in code stream at %u",
+                scri->GetScriptName().c_str(), op.Instruction.Code, pc);
+            const auto next_func = std::upper_bound(func_starts.begin(), func_starts.end(), pc);
+            if (next_func == func_starts.end())
+                break;
+            pc = *next_func - 1;
+            continue;
+        }
+        code_op_index[pc] = static_cast<uint32_t>(code_ops.size());
+        code_ops.push_back(op);
+        pc += op.ArgCount;
+    }
+    code_ops.shrink_to_fit();
+}
+
+bool ccInstance::DecodeOperation(uint32_t pc, ScriptOperation &op) const
+{
+    const int32_t code = static_cast<int32_t>(_code[pc]);
+    op.Instruction.Code = code & INSTANCE_ID_REMOVEMASK;
+    op.Instruction.InstanceId = (code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
+    op.ArgCount = 0;
+    op.RuntimeFixup = FIXUP_NOFIXUP;
+    if (op.Instruction.Code <= 0 || op.Instruction.Code >= CC_NUM_SCCMDS)
+        return false;
+    op.ArgCount = sccmd_info[op.Instruction.Code].ArgCount;
+    if (pc + op.ArgCount >= _codesize)
+        return false;
+
+    for (int i = 0; i < op.ArgCount; ++i)
+        op.Args[i].SetInt32(static_cast<int32_t>(_code[pc + 1 + i]));
+    // Only these instructions may have an argument which refers to
+    // script data or imports; resolve it unless it depends on the running instance
+    if ((op.Instruction.Code == SCMD_LITTOREG) || (op.Instruction.Code == SCMD_WRITELIT))
+    {
+        const int fixup = _code_fixups[pc + 2];
+        switch (fixup)
+        {
+        case FIXUP_IMPORT:
+        case FIXUP_STACK:
+            op.RuntimeFixup = fixup;
+            break;
+        default:
+            FixupArgument(op.Args[1], fixup, _code[pc + 2], nullptr, _strings);
+            break;
+        }
+    }
+    return true;
+}
+
 bool ccInstance::ResolveExports(const ccScript *scri)
 {
     auto &exports = _scriptData->exports;
@@ -2179,6 +2349,8 @@ bool ccInstance::ResolveImportFixups()
 
     const ccScript *scri = _instanceof.get();
     const auto &resolved_imports = _scriptData->resolved_imports;
+    auto &code_ops = _scriptData->code_ops;
+    const uint32_t *code_op_index = _scriptData->code_op_index.data();
     for (size_t fixup_idx = 0; fixup_idx < scri->fixups.size(); ++fixup_idx)
     {
         if (scri->fixuptypes[fixup_idx] != FIXUP_IMPORT)
@@ -2193,10 +2365,29 @@ bool ccInstance::ResolveImportFixups()
             return false;
         }
         _code[fixup] = import_index;
+        // Update the pre-decoded instruction which has this argument
+        for (uint32_t arg = 1; (arg <= MAX_SCMD_ARGS) && (arg <= fixup); ++arg)
+        {
+            ScriptOperation &op = code_ops[code_op_index[fixup - arg]];
+            if ((op.Instruction.Code != 0) && (static_cast<uint32_t>(op.ArgCount) >= arg))
+            {
+                op.Args[arg - 1].SetInt32(static_cast<int32_t>(import_index));
+                break;
+            }
+        }
         // If the call is to another script function next CALLEXT
         // must be replaced with CALLAS
         if (import->InstancePtr != nullptr && (_code[fixup + 1] & INSTANCE_ID_REMOVEMASK) == SCMD_CALLEXT)
+        {
             _code[fixup + 1] = SCMD_CALLAS | (import->InstancePtr->_loadedInstanceId << INSTANCE_ID_SHIFT);
+            // Update the pre-decoded instruction too (CALLAS has same number of args)
+            ScriptOperation &op = code_ops[code_op_index[fixup + 1]];
+            if (op.Instruction.Code == SCMD_CALLEXT)
+            {
+                op.Instruction.Code = SCMD_CALLAS;
+                op.Instruction.InstanceId = import->InstancePtr->_loadedInstanceId;
+            }
+        }
     }
     return true;
 }
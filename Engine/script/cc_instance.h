@@ -72,6 +72,9 @@ struct ScriptOperation
 	ScriptInstruction   Instruction;
 	RuntimeScriptValue	Args[MAX_SCMD_ARGS];
 	int				    ArgCount = 0;
+    // Fixup which has to be applied to the 2nd argument by the running
+    // instance (import or stack address); other fixups are applied on load
+    int                 RuntimeFixup = FIXUP_NOFIXUP;
 
     // Helper functions for clarity of intent:
     // returns argN, 1-based
@@ -200,6 +203,11 @@ private:
     bool    AddGlobalVar(const ScriptVariable &glvar);
     ScriptVariable *FindGlobalVar(int32_t var_addr);
     bool    CreateRuntimeCodeFixups(const ccScript *scri);
+    // Decodes and validates instructions in the whole bytecode
+    void    DecodeInstructions(const ccScript *scri);
+    // Decodes instruction at the given bytecode position, resolving its arguments;
+    // returns false if there's no valid instruction there
+    bool    DecodeOperation(uint32_t pc, ScriptOperation &op) const;
     bool    ResolveExports(const ccScript *scri);
     // Registers this script's resolved exports as imports in the symbol import table
     bool    ImportScriptExports(const ccScript *scri);
@@ -252,6 +260,12 @@ private:
         // performing fixups.
         std::vector<intptr_t>   code;
         std::vector<uint8_t>    code_fixups;
+        // Pre-decoded instructions, with their arguments resolved;
+        // the first entry is a placeholder for the code which was not decoded
+        std::vector<ScriptOperation> code_ops;
+        // Index of a pre-decoded instruction for each bytecode position,
+        // plus one extra terminating entry; 0 if the position was not decoded
+        std::vector<uint32_t>   code_op_index;
         // Resolved global variables
         std::unordered_map<int32_t, ScriptVariable> globalvars;
         // This script's exports
@@ -268,6 +282,8 @@ private:
     intptr_t   *_code = nullptr;
     uint32_t    _codesize = 0; // size of code is limited under 32-bit due to bytecode format
     const uint8_t *_code_fixups = nullptr;
+    const ScriptOperation *_code_ops = nullptr;
+    const uint32_t *_code_op_index = nullptr;
     const char *_strings = nullptr; // pointer to ccScript's string data
     size_t      _stringsize = 0u;
 
@@ -963,7 +963,7 @@ int run_interaction_commandlist(const ObjectEvent &obj_evt, InteractionCommandLi
       case 26: // Move NPC to different room
           if (!is_valid_character(IPARAM1))
               quit("!Move NPC to different room: invalid character specified");
-          game.chars[IPARAM1].room = IPARAM2;
+          set_character_room(&game.chars[IPARAM1], IPARAM2);
           break;
       case 27: // Set character view
           SetCharacterView (IPARAM1, IPARAM2);
@@ -0,0 +1,160 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <string.h>
+#include <memory>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "gfx/bitmap.h"
+#include "gfx/blend_kernels.h"
+#include "gfx/blender.h"
+
+extern "C" {
+    uint32_t _blender_trans24(uint32_t x, uint32_t y, uint32_t n);
+    uint32_t _blender_alpha32(uint32_t x, uint32_t y, uint32_t n);
+}
+
+using namespace AGS::Common;
+using namespace AGS::Engine;
+using namespace AGS::Engine::BlendKernels;
+
+typedef uint32_t (*BlenderFn)(uint32_t x, uint32_t y, uint32_t n);
+
+static uint32_t CopyBlender(uint32_t x, uint32_t /*y*/, uint32_t /*n*/)
+{
+    return x;
+}
+
+// Blender functions, which the kernels have to replicate, in BlendKernel order
+static const BlenderFn Blenders[kNumBlendKernels] = {
+    _blender_alpha32,
+    _trans_alpha_blender32,
+    _blender_trans24,
+    _myblender_alpha_trans24,
+    _argb2argb_blender,
+    _argb2rgb_blender,
+    _rgb2argb_blender,
+    _opaque_alpha_blender,
+    _additive_alpha_copysrc_blender,
+    CopyBlender
+};
+
+static const uint32_t MaskColor = 0xFF00FF;
+static const uint32_t TestAlphas[] = { 0, 1, 2, 127, 128, 200, 254, 255 };
+
+// Generates random pixels, with a share of transparent (mask) pixels,
+// and of pixels with the edge alpha values
+static std::vector<uint32_t> MakeTestPixels(size_t count, std::mt19937 &rng)
+{
+    std::vector<uint32_t> pixels(count);
+    for (auto &px : pixels)
+    {
+        px = rng();
+        switch (rng() % 8)
+        {
+        case 0: px = MaskColor; break;
+        case 1: px &= 0x00FFFFFF; break;
+        case 2: px |= 0xFF000000; break;
+        default: break;
+        }
+    }
+    return pixels;
+}
+
+TEST(BlendKernels, TransRowsMatchBlenders) {
+    std::mt19937 rng(12345);
+    for (int arch = 0; arch < kNumKernelArchs; ++arch)
+    {
+        const KernelSet *kernels = GetKernelSet(static_cast<KernelArch>(arch));
+        if (!kernels)
+            continue; // not supported here
+        for (int kernel = 0; kernel < kNumBlendKernels; ++kernel)
+        {
+            for (uint32_t alpha : TestAlphas)
+            {
+                // different lengths test both the vector and the remaining pixels
+                for (size_t count = 0; count < 40; count += 3)
+                {
+                    const std::vector<uint32_t> src = MakeTestPixels(count, rng);
+                    const std::vector<uint32_t> dst = MakeTestPixels(count, rng);
+                    std::vector<uint32_t> result = dst;
+                    kernels->Trans[kernel](result.data(), src.data(), count, alpha);
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        const uint32_t expect = (src[i] == MaskColor) ? dst[i] :
+                            Blenders[kernel](src[i], dst[i], alpha);
+                        ASSERT_EQ(result[i], expect) << kernels->Name << ", kernel " << kernel
+                            << ", alpha " << alpha << ", src " << src[i] << ", dst " << dst[i];
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(BlendKernels, LitRowsMatchBlenders) {
+    std::mt19937 rng(54321);
+    for (int arch = 0; arch < kNumKernelArchs; ++arch)
+    {
+        const KernelSet *kernels = GetKernelSet(static_cast<KernelArch>(arch));
+        if (!kernels)
+            continue; // not supported here
+        for (int kernel = 0; kernel < kNumBlendKernels; ++kernel)
+        {
+            for (uint32_t amount : TestAlphas)
+            {
+                const uint32_t color = rng() & 0x00FFFFFF;
+                const size_t count = 37;
+                const std::vector<uint32_t> src = MakeTestPixels(count, rng);
+                const std::vector<uint32_t> dst = MakeTestPixels(count, rng);
+                std::vector<uint32_t> result = dst;
+                kernels->Lit[kernel](result.data(), src.data(), count, amount, color);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const uint32_t expect = (src[i] == MaskColor) ? dst[i] :
+                        Blenders[kernel](color, src[i], amount);
+                    ASSERT_EQ(result[i], expect) << kernels->Name << ", kernel " << kernel
+                        << ", amount " << amount << ", src " << src[i];
+                }
+            }
+        }
+    }
+}
+
+TEST(BlendKernels, DrawClipped) {
+    std::mt19937 rng(777);
+    std::unique_ptr<Bitmap> sprite(BitmapHelper::CreateBitmap(21, 13, 32));
+    for (int y = 0; y < sprite->GetHeight(); ++y)
+    {
+        const std::vector<uint32_t> row = MakeTestPixels(sprite->GetWidth(), rng);
+        memcpy(sprite->GetScanLineForWriting(y), row.data(), row.size() * sizeof(uint32_t));
+    }
+    std::unique_ptr<Bitmap> expect(BitmapHelper::CreateBitmap(40, 30, 32));
+    std::unique_ptr<Bitmap> result(BitmapHelper::CreateBitmap(40, 30, 32));
+    // Positions partially or fully outside of the clipping rectangle
+    const Point positions[] = { Point(5, 5), Point(-7, -3), Point(30, 25), Point(-10, 20), Point(50, 5) };
+    for (const auto &pos : positions)
+    {
+        expect->Clear(0x80123456);
+        result->Clear(0x80123456);
+        expect->SetClip(Rect(2, 3, 35, 26));
+        result->SetClip(Rect(2, 3, 35, 26));
+        set_trans_blender(0, 0, 0, 100);
+        expect->TransBlendBlt(sprite.get(), pos.X, pos.Y);
+        ASSERT_TRUE(DrawTransSprite(result.get(), sprite.get(), pos.X, pos.Y, kBlendKernel_Trans24, 100));
+        for (int y = 0; y < expect->GetHeight(); ++y)
+            ASSERT_EQ(memcmp(expect->GetScanLine(y), result->GetScanLine(y), expect->GetLineLength()), 0)
+                << "position " << pos.X << "," << pos.Y << ", line " << y;
+    }
+}
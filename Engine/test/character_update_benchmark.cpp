@@ -0,0 +1,88 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// Character update benchmark.
+//
+// Sets up a number of animating characters in the current room, and runs
+// the engine's per-frame character update over them.
+//
+// Usage: character_update_benchmark [character count] [frame count]
+//
+//=============================================================================
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "ac/characterextras.h"
+#include "ac/gamesetupstruct.h"
+#include "ac/gamestate.h"
+#include "ac/view.h"
+#include "main/update.h"
+
+extern GameSetupStruct game;
+extern std::vector<ViewStruct> views;
+extern int displayed_room;
+
+typedef std::chrono::steady_clock Clock;
+
+static const int ViewLoops = 4;
+static const int LoopFrames = 8;
+
+int main(int argc, char *argv[])
+{
+    const int char_count = (argc > 1) ? std::max(1, atoi(argv[1])) : 1000;
+    const int frames = (argc > 2) ? std::max(1, atoi(argv[2])) : 2000;
+
+    views.resize(1);
+    views[0].Initialize(ViewLoops);
+    for (int loop = 0; loop < ViewLoops; ++loop)
+    {
+        views[0].loops[loop].Initialize(LoopFrames);
+        for (int frame = 0; frame < LoopFrames; ++frame)
+            views[0].loops[loop].frames[frame].speed = frame % 3;
+    }
+    game.numviews = 1;
+
+    displayed_room = 0;
+    game.numcharacters = char_count;
+    game.chars.resize(char_count);
+    charextra.resize(char_count);
+    for (int i = 0; i < char_count; ++i)
+    {
+        CharacterInfo &chi = game.chars[i];
+        chi.index_id = i;
+        chi.on = 1;
+        chi.room = 0;
+        chi.view = 0;
+        chi.loop = i % ViewLoops;
+        chi.idleview = 0;
+        chi.walking = 0;
+        chi.set_animating(true, (i % 2) == 0, i % 3);
+    }
+    printf("Characters: %d, frames: %d\n", char_count, frames);
+
+    std::vector<int> followingAsSheep;
+    const Clock::time_point start = Clock::now();
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        followingAsSheep.clear();
+        update_character_move_and_anim(followingAsSheep);
+    }
+    const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    printf("Update: %8.3f us per frame, %8.3f ns per character\n",
+        ms * 1000.0 / frames, ms * 1000000.0 / frames / char_count);
+    return 0;
+}
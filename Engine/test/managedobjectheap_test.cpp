@@ -0,0 +1,147 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <string.h>
+#include <vector>
+#include "gtest/gtest.h"
+#include "ac/dynobj/dynobj_manager.h"
+#include "ac/dynobj/managedobjectheap.h"
+#include "ac/dynobj/managedobjectpool.h"
+#include "ac/dynobj/scriptstring.h"
+#include "ac/dynobj/scriptuserobject.h"
+
+TEST(ManagedObjectHeap, AllocateFree) {
+    ManagedObjectHeap heap;
+    const size_t sizes[] = { 0, 1, 8, 12, 100, 500, 1016, 1017, 4000, 100000 };
+    std::vector<uint8_t*> blocks;
+    for (size_t sz : sizes)
+    {
+        uint8_t *ptr = static_cast<uint8_t*>(heap.Allocate(sz));
+        ASSERT_NE(ptr, nullptr);
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr) % sizeof(void*), 0u);
+        ASSERT_EQ(ManagedObjectHeap::GetHandle(ptr), 0);
+        memset(ptr, static_cast<int>(sz & 0xFF), sz);
+        blocks.push_back(ptr);
+    }
+    ASSERT_EQ(heap.GetStats().SmallBlocks, 7u);
+    ASSERT_EQ(heap.GetStats().LargeBlocks, 3u);
+    // Blocks must not overlap
+    for (size_t i = 0; i < blocks.size(); ++i)
+    {
+        for (size_t j = 0; j < sizes[i]; ++j)
+            ASSERT_EQ(blocks[i][j], static_cast<uint8_t>(sizes[i] & 0xFF));
+    }
+
+    ManagedObjectHeap::SetHandle(blocks[3], 123);
+    ASSERT_EQ(ManagedObjectHeap::GetHandle(blocks[3]), 123);
+
+    // Handles are found by any address inside the block
+    ManagedObjectHeap::SetHandle(blocks[8], 456);
+    ASSERT_EQ(heap.FindHandle(blocks[3]), 123);
+    ASSERT_EQ(heap.FindHandle(blocks[3] + sizes[3] - 1), 123);
+    ASSERT_EQ(heap.FindHandle(blocks[8] + 10), 456);
+    ASSERT_EQ(heap.FindHandle(blocks[4]), 0);
+    ASSERT_EQ(heap.FindHandle(&sizes[0]), 0);
+    heap.Free(blocks[3]);
+    ASSERT_EQ(heap.FindHandle(blocks[3]), 0);
+    blocks[3] = static_cast<uint8_t*>(heap.Allocate(sizes[3]));
+
+    // Freed small blocks are reused for the same size class
+    uint8_t *freed = blocks[4];
+    heap.Free(freed);
+    ASSERT_EQ(heap.Allocate(sizes[4]), freed);
+    for (uint8_t *ptr : blocks)
+        heap.Free(ptr);
+    ASSERT_EQ(heap.GetStats().SmallBlocks, 0u);
+    ASSERT_EQ(heap.GetStats().LargeBlocks, 0u);
+
+    // Slabs are reused too
+    const size_t slabs = heap.GetStats().SlabCount;
+    for (int i = 0; i < 1000; ++i)
+        heap.Free(heap.Allocate(100));
+    ASSERT_EQ(heap.GetStats().SlabCount, slabs);
+}
+
+TEST(ManagedObjectHeap, StoredHandle) {
+    DynObjectRef ref1 = ScriptUserObject::Create(16);
+    DynObjectRef ref2 = ScriptString::Create("test string");
+    ASSERT_TRUE(ref1);
+    ASSERT_TRUE(ref2);
+    ASSERT_EQ(ref1.Mgr->GetHandle(ref1.Obj), ref1.Handle);
+    ASSERT_EQ(ref2.Mgr->GetHandle(ref2.Obj), ref2.Handle);
+    // Lookup both with and without the manager
+    ASSERT_EQ(ccGetObjectHandleFromAddress(ref1.Obj, ref1.Mgr), ref1.Handle);
+    ASSERT_EQ(ccGetObjectHandleFromAddress(ref2.Obj, ref2.Mgr), ref2.Handle);
+    ASSERT_EQ(ccGetObjectHandleFromAddress(ref1.Obj), ref1.Handle);
+    ASSERT_EQ(ccGetObjectHandleFromAddress(ref2.Obj), ref2.Handle);
+    ASSERT_STREQ(static_cast<const char*>(ccGetObjectAddressFromHandle(ref2.Handle)), "test string");
+    // A new object, which reuses the freed block, is found by its new handle
+    ccAttemptDisposeObject(ref2.Handle);
+    ASSERT_EQ(ccGetObjectAddressFromHandle(ref2.Handle), nullptr);
+    DynObjectRef ref3 = ScriptString::Create("TEST STRING");
+    ASSERT_TRUE(ref3);
+    ASSERT_EQ(ref3.Obj, ref2.Obj);
+    ASSERT_EQ(ccGetObjectHandleFromAddress(ref3.Obj), ref3.Handle);
+    // Large objects are found too
+    DynObjectRef ref4 = ScriptUserObject::Create(4000);
+    ASSERT_TRUE(ref4);
+    ASSERT_EQ(ccGetObjectHandleFromAddress(ref4.Obj), ref4.Handle);
+    ccUnregisterAllObjects();
+}
+
+// Creates and disposes script strings, similar to a script loop that
+// builds a string by appending characters to it, and tests that the
+// heap memory is reused rather than grown
+TEST(ManagedObjectHeap, StringChurn) {
+    const int iterations = 2000;
+    const size_t max_len = 200;
+
+    DynObjectRef first = ScriptString::Create("");
+    int32_t handle = first.Handle;
+    const char *text = static_cast<const char*>(first.Obj);
+    ccAddObjectReference(handle);
+    const size_t blocks = objheap.GetStats().SmallBlocks;
+    size_t slabs = 0u;
+    for (int i = 0; i < iterations; ++i)
+    {
+        // by the time the string is reset for the second time,
+        // every size class used by the loop has its slab already
+        if (i == max_len + 1)
+            slabs = objheap.GetStats().SlabCount;
+        const size_t len = ScriptString::GetHeader(text).Length;
+        const size_t new_len = (len < max_len) ? len + 1 : 0u;
+        auto buf = ScriptString::CreateBuffer(new_len, new_len);
+        if (new_len > 0)
+        {
+            memcpy(buf.Get(), text, len);
+            buf.Get()[len] = static_cast<char>('a' + (i % 26));
+        }
+        DynObjectRef new_str = ScriptString::Create(std::move(buf));
+        ASSERT_TRUE(new_str);
+        ccAddObjectReference(new_str.Handle);
+        ccReleaseObjectReference(handle);
+        ASSERT_EQ(ccGetObjectAddressFromHandle(handle), nullptr);
+        ASSERT_EQ(objheap.GetStats().SmallBlocks, blocks);
+        handle = new_str.Handle;
+        text = static_cast<const char*>(new_str.Obj);
+        ASSERT_EQ(ScriptString::GetHeader(text).Length, new_len);
+        ASSERT_EQ(strlen(text), new_len);
+        if (new_len > 0)
+        {
+            ASSERT_EQ(text[new_len - 1], static_cast<char>('a' + (i % 26)));
+        }
+    }
+    ASSERT_EQ(objheap.GetStats().SlabCount, slabs);
+    ccReleaseObjectReference(handle);
+    ASSERT_EQ(objheap.GetStats().SmallBlocks, blocks - 1);
+}
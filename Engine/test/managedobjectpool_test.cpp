@@ -0,0 +1,70 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <vector>
+#include "gtest/gtest.h"
+#include "ac/dynobj/cc_agsdynamicobject.h"
+#include "ac/dynobj/managedobjectpool.h"
+
+namespace
+{
+
+struct TestObjectManager : CCBasicObject
+{
+    const char *GetType() override { return "TestObject"; }
+    int Dispose(void * /*address*/, bool /*force*/) override { Disposed++; return 1; }
+
+    int Disposed = 0;
+};
+
+} // namespace
+
+TEST(ManagedObjectPool, IncrementalGarbageCollection) {
+    TestObjectManager mgr;
+    ManagedObjectPool objpool;
+    // Create enough objects to trigger the collection, reference half of them
+    const int count = 2000;
+    std::vector<int> storage(count);
+    std::vector<int32_t> handles(count);
+    for (int i = 0; i < count; ++i)
+    {
+        handles[i] = objpool.AddObject(&storage[i], &mgr, kScValScriptObject);
+        ASSERT_GT(handles[i], 0);
+        if (i % 2 == 0)
+            objpool.AddRef(handles[i]);
+    }
+
+    // Zero budget still lets the collection make some progress on each step
+    objpool.RunGarbageCollectionIfAppropriate(std::chrono::microseconds(0));
+    ASSERT_GT(mgr.Disposed, 0);
+    ASSERT_LT(mgr.Disposed, count / 2);
+    ASSERT_EQ(objpool.GetGCStats().Cycles, 0u);
+    int steps = 1;
+    while (!objpool.RunGarbageCollectionStep(std::chrono::microseconds(0)))
+        steps++;
+    ASSERT_GT(steps, 1);
+
+    const auto &stats = objpool.GetGCStats();
+    ASSERT_EQ(stats.Cycles, 1u);
+    ASSERT_EQ(stats.LastCollected, static_cast<uint32_t>(count / 2));
+    ASSERT_EQ(stats.LastRetained, static_cast<uint32_t>(count / 2));
+    ASSERT_EQ(stats.TotalCollected, static_cast<uint64_t>(count / 2));
+    ASSERT_EQ(mgr.Disposed, count / 2);
+    for (int i = 0; i < count; ++i)
+        ASSERT_EQ(objpool.HandleToAddress(handles[i]), (i % 2 == 0) ? &storage[i] : nullptr);
+
+    // No new cycle until enough objects are created again
+    objpool.RunGarbageCollectionIfAppropriate(std::chrono::microseconds(0));
+    ASSERT_EQ(objpool.GetGCStats().Cycles, 1u);
+    objpool.reset();
+}
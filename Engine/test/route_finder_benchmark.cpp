@@ -0,0 +1,169 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// Route finder benchmark.
+//
+// Generates a fixed walkable mask, with rows of walls that have gaps at
+// alternating sides, and a few blocks in between, and a fixed set of routes
+// between random walkable points. Times finding all these routes with the
+// JPS pathfinder through Pathfinding::FindRoute: with the RouteCache cold,
+// where it's cleared before each run and every query is a search, and with
+// the cache warm, where every query is found in it.
+//
+// Usage: route_finder_benchmark [mask width] [mask height] [queries] [runs]
+//
+//=============================================================================
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+#include "ac/movelist.h"
+#include "ac/route_finder_impl.h"
+#include "gfx/bitmap.h"
+
+using namespace AGS::Common;
+using namespace AGS::Engine;
+
+typedef std::chrono::steady_clock Clock;
+
+static double ElapsedMs(const Clock::time_point &start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static std::unique_ptr<Bitmap> MakeWalkableMask(int width, int height, std::mt19937 &rng)
+{
+    std::unique_ptr<Bitmap> mask(BitmapHelper::CreateBitmap(width, height, 8));
+    mask->Clear(1);
+    // walls with a gap at the alternating sides, so that routes have to zigzag
+    const int wall_step = std::max(20, height / 6);
+    for (int y = wall_step, i = 0; y < height - 4; y += wall_step, ++i)
+    {
+        const int gap = width / 8;
+        if (i % 2 == 0)
+            mask->FillRect(Rect(0, y, width - gap - 1, y + 3), 0);
+        else
+            mask->FillRect(Rect(gap, y, width - 1, y + 3), 0);
+    }
+    // scattered blocks, e.g. furniture
+    for (int i = 0; i < width * height / 10000; ++i)
+    {
+        const int x = rng() % width, y = rng() % height;
+        mask->FillRect(RectWH(x, y, 5 + rng() % 30, 5 + rng() % 15), 0);
+    }
+    return mask;
+}
+
+static Point RandomWalkablePoint(const Bitmap *mask, std::mt19937 &rng)
+{
+    for (;;)
+    {
+        const int x = rng() % mask->GetWidth(), y = rng() % mask->GetHeight();
+        if (mask->GetScanLine(y)[x] != 0)
+            return Point(x, y);
+    }
+}
+
+struct Query
+{
+    Point Src, Dst;
+};
+
+// Finds all the routes, returns the number of found ones
+static int FindRoutes(MaskRouteFinder *finder, RouteCache *cache, const std::vector<Query> &queries,
+    std::vector<MoveList> &results)
+{
+    int found = 0;
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        const Query &q = queries[i];
+        results[i] = MoveList();
+        found += Pathfinding::FindRoute(results[i], finder, cache, 1u,
+            q.Src.X, q.Src.Y, q.Dst.X, q.Dst.Y, 4, 4, false, false);
+    }
+    return found;
+}
+
+int main(int argc, char *argv[])
+{
+    const int width = (argc > 1) ? std::max(160, atoi(argv[1])) : 640;
+    const int height = (argc > 2) ? std::max(100, atoi(argv[2])) : 400;
+    const int query_count = (argc > 3) ? std::max(1, atoi(argv[3])) : 100;
+    const int runs = (argc > 4) ? std::max(1, atoi(argv[4])) : 5;
+
+    std::mt19937 rng(42);
+    std::unique_ptr<Bitmap> mask = MakeWalkableMask(width, height, rng);
+    std::vector<Query> queries(query_count);
+    for (auto &q : queries)
+    {
+        q.Src = RandomWalkablePoint(mask.get(), rng);
+        q.Dst = RandomWalkablePoint(mask.get(), rng);
+    }
+    printf("Mask: %dx%d, %d queries, best of %d runs\n", width, height, query_count, runs);
+
+    JPSRouteFinder finder;
+    finder.SetWalkableArea(mask.get());
+    // large enough to never dispose anything in the warm runs
+    RouteCache cache(64 * 1024 * 1024);
+    std::vector<MoveList> cold_results(queries.size()), warm_results(queries.size());
+
+    double best_cold_ms = 0.0, best_warm_ms = 0.0;
+    int cold_found = 0, warm_found = 0;
+    for (int run = 0; run < runs; ++run)
+    {
+        cache.Clear();
+        Clock::time_point start = Clock::now();
+        cold_found = FindRoutes(&finder, &cache, queries, cold_results);
+        const double cold_ms = ElapsedMs(start);
+
+        cache.ResetStats();
+        start = Clock::now();
+        warm_found = FindRoutes(&finder, &cache, queries, warm_results);
+        const double warm_ms = ElapsedMs(start);
+        if (cache.GetMisses() > 0u)
+        {
+            printf("Error: unexpected cache misses in the warm run: %u of %d\n",
+                cache.GetMisses(), query_count);
+            return 1;
+        }
+
+        if ((run == 0) || (cold_ms < best_cold_ms))
+            best_cold_ms = cold_ms;
+        if ((run == 0) || (warm_ms < best_warm_ms))
+            best_warm_ms = warm_ms;
+    }
+
+    if (cold_found != warm_found)
+    {
+        printf("Error: found routes do not match: %d cold, %d warm\n", cold_found, warm_found);
+        return 1;
+    }
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        if (cold_results[i].pos != warm_results[i].pos)
+        {
+            printf("Error: cached route %zu does not match the searched one\n", i);
+            return 1;
+        }
+    }
+    printf("Routes found: %d of %d\n", cold_found, query_count);
+    printf("Cold cache: %8.3f ms, %8.2f us per query\n",
+        best_cold_ms, best_cold_ms * 1000.0 / query_count);
+    printf("Warm cache: %8.3f ms, %8.2f us per query\n",
+        best_warm_ms, best_warm_ms * 1000.0 / query_count);
+    return 0;
+}
@@ -0,0 +1,98 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <memory>
+#include "gtest/gtest.h"
+#include "ac/movelist.h"
+#include "ac/route_finder_impl.h"
+#include "gfx/bitmap.h"
+
+using namespace AGS::Common;
+using namespace AGS::Engine;
+
+// Creates a walkable mask with a vertical wall in the middle, leaving a gap at the bottom
+static Bitmap *CreateTestMask(int width, int height)
+{
+    Bitmap *mask = BitmapHelper::CreateBitmap(width, height, 8);
+    mask->Clear(1);
+    mask->FillRect(Rect(width / 2, 0, width / 2 + 1, height - 11), 0);
+    return mask;
+}
+
+TEST(RouteFinder, JPS_MaskChangedInPlace) {
+    std::unique_ptr<Bitmap> mask(CreateTestMask(100, 100));
+    JPSRouteFinder finder;
+    std::vector<Point> path;
+
+    finder.SetWalkableArea(mask.get());
+    ASSERT_FALSE(finder.CanSeeFrom(10, 10, 90, 10));
+    ASSERT_TRUE(finder.FindRoute(path, 10, 10, 90, 10, true));
+    ASSERT_GT(path.size(), 2u); // goes around the wall
+
+    // Close the gap: the change must be seen without reassigning the mask;
+    // pathfinder will only get as close as possible to the destination
+    mask->FillRect(Rect(50, 0, 51, 99), 0);
+    ASSERT_TRUE(finder.FindRoute(path, 10, 10, 90, 10, true));
+    ASSERT_LT(path.back().X, 50);
+
+    // Remove the wall completely
+    mask->Clear(1);
+    ASSERT_TRUE(finder.CanSeeFrom(10, 10, 90, 10));
+    ASSERT_TRUE(finder.FindRoute(path, 10, 10, 90, 10, true));
+    ASSERT_EQ(path.size(), 2u);
+}
+
+TEST(RouteFinder, JPS_MaskReassigned) {
+    std::unique_ptr<Bitmap> mask(CreateTestMask(100, 100));
+    JPSRouteFinder finder;
+    std::vector<Point> path;
+
+    finder.SetWalkableArea(mask.get());
+    ASSERT_TRUE(finder.FindRoute(path, 10, 10, 90, 10, true));
+
+    // Replace with a mask of another size, where destination is walled off
+    std::unique_ptr<Bitmap> mask2(BitmapHelper::CreateBitmap(200, 50, 8));
+    mask2->Clear(1);
+    mask2->FillRect(Rect(100, 0, 101, 49), 0);
+    mask.reset();
+    finder.SetWalkableArea(mask2.get());
+    ASSERT_TRUE(finder.FindRoute(path, 10, 10, 190, 10, true));
+    ASSERT_LT(path.back().X, 100);
+    ASSERT_TRUE(finder.FindRoute(path, 10, 10, 90, 40, true));
+    ASSERT_EQ(path.back(), Point(90, 40));
+}
+
+TEST(RouteFinder, RouteCache) {
+    std::unique_ptr<Bitmap> mask(CreateTestMask(100, 100));
+    JPSRouteFinder finder;
+    RouteCache cache;
+    MoveList mls1, mls2;
+
+    finder.SetWalkableArea(mask.get());
+    ASSERT_TRUE(Pathfinding::FindRoute(mls1, &finder, &cache, 1u, 10, 10, 90, 10, 2, 2, true, false));
+    ASSERT_EQ(cache.GetHits(), 0u);
+    ASSERT_EQ(cache.GetMisses(), 1u);
+    // Same query, but with different speeds, uses the cached path
+    ASSERT_TRUE(Pathfinding::FindRoute(mls2, &finder, &cache, 1u, 10, 10, 90, 10, 4, 4, true, false));
+    ASSERT_EQ(cache.GetHits(), 1u);
+    ASSERT_EQ(mls1.GetNumStages(), mls2.GetNumStages());
+    for (uint32_t i = 0; i < mls1.GetNumStages(); ++i)
+        ASSERT_EQ(mls1.pos[i], mls2.pos[i]);
+
+    // Different mask key must not use the cached path
+    mask->FillRect(Rect(50, 0, 51, 99), 0);
+    ASSERT_TRUE(Pathfinding::FindRoute(mls2, &finder, &cache, 2u, 10, 10, 90, 10, 2, 2, true, false));
+    ASSERT_EQ(cache.GetHits(), 1u);
+    ASSERT_EQ(cache.GetMisses(), 2u);
+    ASSERT_LT(mls2.pos[mls2.GetNumStages() - 1].X, 50);
+}
@@ -0,0 +1,72 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <memory>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "ac/game.h"
+#include "ac/gamestate.h"
+#include "ac/global_game.h"
+#include "game/savegame.h"
+#include "gfx/bitmap.h"
+#include "util/file.h"
+#include "util/stream.h"
+
+using namespace AGS::Common;
+using namespace AGS::Engine;
+
+static std::vector<uint8_t> ReadWholeFile(const String &filename)
+{
+    std::vector<uint8_t> data;
+    auto in = File::OpenFileRead(filename);
+    if (!in)
+        return data;
+    data.resize(static_cast<size_t>(in->GetLength()));
+    in->Read(data.data(), data.size());
+    return data;
+}
+
+TEST(Savegame, CopySlotDuringAsyncSave) {
+    const int slot = 901, copy_slot = 902;
+    play.cur_music_number = -1; // don't query the audio system
+
+    // A large, noisy screenshot, so that the background save
+    // is still compressing it when the slot is copied
+    std::unique_ptr<Bitmap> image(BitmapHelper::CreateBitmap(1024, 1024, 32));
+    std::mt19937 rng(42);
+    for (int y = 0; y < image->GetHeight(); ++y)
+    {
+        uint32_t *line = reinterpret_cast<uint32_t*>(image->GetScanLineForWriting(y));
+        for (int x = 0; x < image->GetWidth(); ++x)
+            line[x] = rng();
+    }
+
+    HSaveError err = SaveGameAsync(get_save_game_path(slot), "async save", std::move(image),
+        kSaveCmp_InvItems, true /* compress */);
+    ASSERT_TRUE(err);
+    CopySaveSlot(slot, copy_slot);
+    // The copy must have waited for the save to be completely written
+    ASSERT_FALSE(IsAsyncSaveRunning());
+    ASSERT_TRUE(GetAsyncSaveResult(err));
+    ASSERT_TRUE(err);
+    const std::vector<uint8_t> saved = ReadWholeFile(get_save_game_path(slot));
+    const std::vector<uint8_t> copied = ReadWholeFile(get_save_game_path(copy_slot));
+    ASSERT_GT(saved.size(), 0u);
+    ASSERT_EQ(saved, copied);
+
+    DeleteSaveSlot(slot);
+    DeleteSaveSlot(copy_slot);
+    ASSERT_FALSE(File::IsFile(get_save_game_path(slot)));
+    ASSERT_FALSE(File::IsFile(get_save_game_path(copy_slot)));
+}
@@ -0,0 +1,311 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// Script interpreter benchmark.
+//
+// Creates a script with the same bytecode as the compiler generates for
+// the following code, and runs Bench() through ccInstance:
+//
+//   int values[16];
+//   int counter;
+//   int Mix(int a, int b) { return (a * 31 + b) % 997; }
+//   int Bench(int iterations) {
+//     int sum = 0;
+//     for (int i = 0; i < iterations; i++) {
+//       int k = i & 15;
+//       values[k] += i & 255;
+//       if (values[k] > 10000) values[k] -= 10000;
+//       sum = Mix(sum, values[k]);
+//       counter++;
+//     }
+//     return sum;
+//   }
+//
+// Usage: script_benchmark [iterations] [runs]
+//
+//=============================================================================
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <initializer_list>
+#include "script/cc_common.h"
+#include "script/cc_instance.h"
+#include "script/cc_internal.h"
+#include "script/cc_script.h"
+
+typedef std::chrono::steady_clock Clock;
+
+// Appends instructions to the script's bytecode
+class BytecodeWriter
+{
+public:
+    BytecodeWriter(ccScript &script) : _script(script) {}
+
+    int32_t Pos() const { return static_cast<int32_t>(_script.code.size()); }
+
+    void Op(int32_t cmd, std::initializer_list<int32_t> args = {})
+    {
+        _script.code.push_back(cmd);
+        _script.code.insert(_script.code.end(), args.begin(), args.end());
+    }
+
+    // Puts a fixup on the last written argument
+    void Fixup(char type)
+    {
+        _script.fixups.push_back(Pos() - 1);
+        _script.fixuptypes.push_back(type);
+    }
+
+    // Writes a jump instruction, returns the position of its offset
+    int32_t Jump(int32_t cmd)
+    {
+        Op(cmd, { 0 });
+        return Pos() - 1;
+    }
+
+    // Makes the jump written at the given position lead to the current position
+    void JumpHere(int32_t offset_pos)
+    {
+        _script.code[offset_pos] = Pos() - (offset_pos + 1);
+    }
+
+    void JumpBack(int32_t cmd, int32_t target)
+    {
+        Op(cmd, { target - (Pos() + 2) });
+    }
+
+    void Export(const char *name, int type, int32_t addr)
+    {
+        _script.exports.push_back(name);
+        _script.export_addr.push_back((type << 24) | addr);
+    }
+
+private:
+    ccScript &_script;
+};
+
+static const int32_t ValuesAddr = 0;
+static const int32_t CounterAddr = 16 * sizeof(int32_t);
+
+// Writes the address of values[k] into MAR, where k is the local variable
+// at the given stack offset
+static void WriteValuesElementAddr(BytecodeWriter &w, int32_t k_offset)
+{
+    w.Op(SCMD_LOADSPOFFS, { k_offset });
+    w.Op(SCMD_MEMREAD, { SREG_AX });
+    w.Op(SCMD_CHECKBOUNDS, { SREG_AX, 16 });
+    w.Op(SCMD_MUL, { SREG_AX, sizeof(int32_t) });
+    w.Op(SCMD_REGTOREG, { SREG_AX, SREG_CX });
+    w.Op(SCMD_LITTOREG, { SREG_MAR, ValuesAddr }); w.Fixup(FIXUP_GLOBALDATA);
+    w.Op(SCMD_ADDREG, { SREG_MAR, SREG_CX });
+}
+
+static PScript CreateBenchScript()
+{
+    PScript script(new ccScript("bench"));
+    script->globaldata.resize(CounterAddr + sizeof(int32_t));
+    BytecodeWriter w(*script);
+
+    // int Mix(int a, int b)
+    const int32_t mix_addr = w.Pos();
+    w.Export("Mix$2", EXPORT_FUNCTION, mix_addr);
+    w.Op(SCMD_THISBASE, { mix_addr });
+    w.Op(SCMD_LOADSPOFFS, { 8 });
+    w.Op(SCMD_MEMREAD, { SREG_AX });
+    w.Op(SCMD_PUSHREG, { SREG_AX });
+    w.Op(SCMD_LITTOREG, { SREG_AX, 31 });
+    w.Op(SCMD_POPREG, { SREG_BX });
+    w.Op(SCMD_MULREG, { SREG_BX, SREG_AX });
+    w.Op(SCMD_REGTOREG, { SREG_BX, SREG_AX });
+    w.Op(SCMD_PUSHREG, { SREG_AX });
+    w.Op(SCMD_LOADSPOFFS, { 16 });
+    w.Op(SCMD_MEMREAD, { SREG_AX });
+    w.Op(SCMD_POPREG, { SREG_BX });
+    w.Op(SCMD_ADDREG, { SREG_BX, SREG_AX });
+    w.Op(SCMD_REGTOREG, { SREG_BX, SREG_AX });
+    w.Op(SCMD_PUSHREG, { SREG_AX });
+    w.Op(SCMD_LITTOREG, { SREG_AX, 997 });
+    w.Op(SCMD_POPREG, { SREG_BX });
+    w.Op(SCMD_MODREG, { SREG_BX, SREG_AX });
+    w.Op(SCMD_REGTOREG, { SREG_BX, SREG_AX });
+    w.Op(SCMD_RET);
+
+    // int Bench(int iterations)
+    const int32_t bench_addr = w.Pos();
+    w.Export("Bench$1", EXPORT_FUNCTION, bench_addr);
+    w.Op(SCMD_THISBASE, { bench_addr });
+    // int sum = 0; int i = 0;
+    for (int var = 0; var < 2; ++var)
+    {
+        w.Op(SCMD_LITTOREG, { SREG_AX, 0 });
+        w.Op(SCMD_REGTOREG, { SREG_SP, SREG_MAR });
+        w.Op(SCMD_MEMWRITE, { SREG_AX });
+        w.Op(SCMD_ADD, { SREG_SP, sizeof(int32_t) });
+    }
+    // i < iterations
+    const int32_t loop_start = w.Pos();
+    w.Op(SCMD_LOADSPOFFS, { 4 });
+    w.Op(SCMD_MEMREAD, { SREG_AX });
+    w.Op(SCMD_PUSHREG, { SREG_AX });
+    w.Op(SCMD_LOADSPOFFS, { 20 });
+    w.Op(SCMD_MEMREAD, { SREG_AX });
+    w.Op(SCMD_POPREG, { SREG_BX });
+    w.Op(SCMD_LESSTHAN, { SREG_BX, SREG_AX });
+    w.Op(SCMD_REGTOREG, { SREG_BX, SREG_AX });
+    const int32_t loop_exit = w.Jump(SCMD_JZ);
+    // int k = i & 15;
+    w.Op(SCMD_LOADSPOFFS, { 4 });
+    w.Op(SCMD_MEMREAD, { SREG_AX });
+    w.Op(SCMD_PUSHREG, { SREG_AX });
+    w.Op(SCMD_LITTOREG, { SREG_AX, 15 });
+    w.Op(SCMD_POPREG, { SREG_BX });
+    w.Op(SCMD_BITAND, { SREG_BX, SREG_AX });
+    w.Op(SCMD_REGTOREG, { SREG_BX, SREG_AX });
+    w.Op(SCMD_REGTOREG, { SREG_SP, SREG_MAR });
+    w.Op(SCMD_MEMWRITE, { SREG_AX });
+    w.Op(SCMD_ADD, { SREG_SP, sizeof(int32_t) });
+    // values[k] += i & 255;
+    w.Op(SCMD_LOADSPOFFS, { 8 });
+    w.Op(SCMD_MEMREAD, { SREG_AX });
+    w.Op(SCMD_PUSHREG, { SREG_AX });
+    w.Op(SCMD_LITTOREG, { SREG_AX, 255 });
+    w.Op(SCMD_POPREG, { SREG_BX });
+    w.Op(SCMD_BITAND, { SREG_BX, SREG_AX });
+    w.Op(SCMD_REGTOREG, { SREG_BX, SREG_AX });
+    w.Op(SCMD_PUSHREG, { SREG_AX });
+    WriteValuesElementAddr(w, 8);
+    w.Op(SCMD_MEMREAD, { SREG_AX });
+    w.Op(SCMD_POPREG, { SREG_BX });
+    w.Op(SCMD_ADDREG, { SREG_AX, SREG_BX });
+    w.Op(SCMD_PUSHREG, { SREG_AX });
+    WriteValuesElementAddr(w, 8);
+    w.Op(SCMD_POPREG, { SREG_AX });
+    w.Op(SCMD_MEMWRITE, { SREG_AX });
+    // if (values[k] > 10000)
+    WriteValuesElementAddr(w, 4);
+    w.Op(SCMD_MEMREAD, { SREG_AX });
+    w.Op(SCMD_PUSHREG, { SREG_AX });
+    w.Op(SCMD_LITTOREG, { SREG_AX, 10000 });
+    w.Op(SCMD_POPREG, { SREG_BX });
+    w.Op(SCMD_GREATER, { SREG_BX, SREG_AX });
+    w.Op(SCMD_REGTOREG, { SREG_BX, SREG_AX });
+    const int32_t skip_if = w.Jump(SCMD_JZ);
+    // values[k] -= 10000;
+    w.Op(SCMD_LITTOREG, { SREG_AX, 10000 });
+    w.Op(SCMD_PUSHREG, { SREG_AX });
+    WriteValuesElementAddr(w, 8);
+    w.Op(SCMD_MEMREAD, { SREG_AX });
+    w.Op(SCMD_POPREG, { SREG_BX });
+    w.Op(SCMD_SUBREG, { SREG_AX, SREG_BX });
+    w.Op(SCMD_PUSHREG, { SREG_AX });
+    WriteValuesElementAddr(w, 8);
+    w.Op(SCMD_POPREG, { SREG_AX });
+    w.Op(SCMD_MEMWRITE, { SREG_AX });
+    w.JumpHere(skip_if);
+    // sum = Mix(sum, values[k]);
+    WriteValuesElementAddr(w, 4);
+    w.Op(SCMD_MEMREAD, { SREG_AX });
+    w.Op(SCMD_PUSHREG, { SREG_AX });
+    w.Op(SCMD_LOADSPOFFS, { 16 });
+    w.Op(SCMD_MEMREAD, { SREG_AX });
+    w.Op(SCMD_PUSHREG, { SREG_AX });
+    w.Op(SCMD_LITTOREG, { SREG_AX, mix_addr }); w.Fixup(FIXUP_FUNCTION);
+    w.Op(SCMD_CALL, { SREG_AX });
+    w.Op(SCMD_SUB, { SREG_SP, 2 * sizeof(int32_t) });
+    w.Op(SCMD_LOADSPOFFS, { 12 });
+    w.Op(SCMD_MEMWRITE, { SREG_AX });
+    // counter++;
+    w.Op(SCMD_LITTOREG, { SREG_MAR, CounterAddr }); w.Fixup(FIXUP_GLOBALDATA);
+    w.Op(SCMD_MEMREAD, { SREG_AX });
+    w.Op(SCMD_ADD, { SREG_AX, 1 });
+    w.Op(SCMD_MEMWRITE, { SREG_AX });
+    // end of block: pop k; i++
+    w.Op(SCMD_SUB, { SREG_SP, sizeof(int32_t) });
+    w.Op(SCMD_LOADSPOFFS, { 4 });
+    w.Op(SCMD_MEMREAD, { SREG_AX });
+    w.Op(SCMD_ADD, { SREG_AX, 1 });
+    w.Op(SCMD_MEMWRITE, { SREG_AX });
+    w.JumpBack(SCMD_JMP, loop_start);
+    w.JumpHere(loop_exit);
+    // pop i; return sum;
+    w.Op(SCMD_SUB, { SREG_SP, sizeof(int32_t) });
+    w.Op(SCMD_LOADSPOFFS, { 4 });
+    w.Op(SCMD_MEMREAD, { SREG_AX });
+    w.Op(SCMD_SUB, { SREG_SP, sizeof(int32_t) });
+    w.Op(SCMD_RET);
+    return script;
+}
+
+// Same as the script's Bench(), for testing the result
+static int NativeBench(int iterations)
+{
+    static int values[16];
+    int sum = 0;
+    for (int i = 0; i < iterations; i++)
+    {
+        int k = i & 15;
+        values[k] += i & 255;
+        if (values[k] > 10000) values[k] -= 10000;
+        sum = (sum * 31 + values[k]) % 997;
+    }
+    return sum;
+}
+
+int main(int argc, char *argv[])
+{
+    const int iterations = (argc > 1) ? std::max(1, atoi(argv[1])) : 100000;
+    const int runs = (argc > 2) ? std::max(1, atoi(argv[2])) : 20;
+
+    const Clock::time_point create_start = Clock::now();
+    PScript script = CreateBenchScript();
+    std::unique_ptr<ccInstance> inst = ccInstance::CreateFromScript(script);
+    const double create_ms = std::chrono::duration<double, std::milli>(Clock::now() - create_start).count();
+    if (!inst)
+    {
+        printf("Error: failed to create script instance: %s\n", cc_get_error().ErrorString.GetCStr());
+        return 1;
+    }
+    // No loop iterations limit, and no polling system events while running
+    ccInstance::SetExecTimeout(UINT_MAX, 0u, 0u);
+    printf("Bytecode: %zu, iterations: %d, runs: %d, instance created in %.3f ms\n",
+        script->code.size(), iterations, runs, create_ms);
+
+    RuntimeScriptValue params[1];
+    params[0].SetInt32(iterations);
+    double best_ms = 0.0;
+    int result = 0;
+    for (int run = 0; run < runs; ++run)
+    {
+        const Clock::time_point start = Clock::now();
+        if (inst->CallScriptFunction("Bench", 1, params) != kInstErr_None)
+        {
+            printf("Error: script failed: %s\n", cc_get_error().ErrorString.GetCStr());
+            return 1;
+        }
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        if ((run == 0) || (ms < best_ms))
+            best_ms = ms;
+        result = inst->GetReturnValue();
+        if (result != NativeBench(iterations))
+        {
+            printf("Error: unexpected script result %d\n", result);
+            return 1;
+        }
+    }
+    printf("Best run: %8.3f ms, %8.2f ns per iteration (result %d)\n",
+        best_ms, best_ms * 1000000.0 / iterations, result);
+    return 0;
+}
@@ -0,0 +1,125 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// Script string allocation benchmark.
+//
+// Creates and disposes managed script strings, similar to a script loop
+// which builds a string by appending characters to it, while keeping
+// a number of other strings alive; then measures looking up the string
+// handles by their addresses, with and without knowing their manager.
+//
+// Usage: scriptstring_benchmark [iterations] [live strings] [runs]
+//
+//=============================================================================
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "ac/dynobj/dynobj_manager.h"
+#include "ac/dynobj/managedobjectheap.h"
+#include "ac/dynobj/scriptstring.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static double ElapsedNs(const Clock::time_point &start)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+// Appends a character to the string, or resets it after reaching max length;
+// releases the old string and returns the handle of the new one
+static int32_t AppendChar(int32_t handle, size_t max_len, int i)
+{
+    const char *text = static_cast<const char*>(ccGetObjectAddressFromHandle(handle));
+    const size_t len = ScriptString::GetHeader(text).Length;
+    const size_t new_len = (len < max_len) ? len + 1 : 0u;
+    auto buf = ScriptString::CreateBuffer(new_len, new_len);
+    if (new_len > 0)
+    {
+        memcpy(buf.Get(), text, len);
+        buf.Get()[len] = static_cast<char>('a' + (i % 26));
+    }
+    DynObjectRef new_str = ScriptString::Create(std::move(buf));
+    ccAddObjectReference(new_str.Handle);
+    ccReleaseObjectReference(handle);
+    return new_str.Handle;
+}
+
+int main(int argc, char *argv[])
+{
+    const int iterations = (argc > 1) ? std::max(1, atoi(argv[1])) : 1000000;
+    const int live_count = (argc > 2) ? std::max(1, atoi(argv[2])) : 10000;
+    const int runs = (argc > 3) ? std::max(1, atoi(argv[3])) : 5;
+    const size_t max_len = 64;
+
+    printf("Script string churn: %d iterations, %d live strings, best of %d runs\n",
+        iterations, live_count, runs);
+
+    // Strings which stay alive, so that the pool is not trivially small
+    std::vector<DynObjectRef> live;
+    for (int i = 0; i < live_count; ++i)
+    {
+        char text[32];
+        snprintf(text, sizeof(text), "live string %d", i);
+        live.push_back(ScriptString::Create(text));
+        ccAddObjectReference(live.back().Handle);
+    }
+
+    double best_churn = 0.0, best_lookup_mgr = 0.0, best_lookup = 0.0;
+    for (int run = 0; run < runs; ++run)
+    {
+        int32_t handle = ScriptString::Create("").Handle;
+        ccAddObjectReference(handle);
+        auto start = Clock::now();
+        for (int i = 0; i < iterations; ++i)
+            handle = AppendChar(handle, max_len, i);
+        const double churn = ElapsedNs(start) / iterations;
+        ccReleaseObjectReference(handle);
+
+        int64_t check = 0;
+        start = Clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            const DynObjectRef &ref = live[i % live_count];
+            check += ccGetObjectHandleFromAddress(ref.Obj, ref.Mgr);
+        }
+        const double lookup_mgr = ElapsedNs(start) / iterations;
+        start = Clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            const DynObjectRef &ref = live[i % live_count];
+            check -= ccGetObjectHandleFromAddress(ref.Obj);
+        }
+        const double lookup = ElapsedNs(start) / iterations;
+        if (check != 0)
+        {
+            printf("Error: address lookups returned different handles\n");
+            return 1;
+        }
+
+        if (run == 0 || churn < best_churn) best_churn = churn;
+        if (run == 0 || lookup_mgr < best_lookup_mgr) best_lookup_mgr = lookup_mgr;
+        if (run == 0 || lookup < best_lookup) best_lookup = lookup;
+    }
+
+    printf("Append and release:         %8.1f ns per string\n", best_churn);
+    printf("Address lookup, by manager: %8.1f ns\n", best_lookup_mgr);
+    printf("Address lookup, by address: %8.1f ns\n", best_lookup);
+    printf("Heap slabs: %zu\n", objheap.GetStats().SlabCount);
+
+    ccUnregisterAllObjects();
+    return 0;
+}
@@ -0,0 +1,66 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <string.h>
+#include "gtest/gtest.h"
+#include "ac/dynobj/dynobj_manager.h"
+#include "ac/dynobj/managedobjectpool.h"
+#include "ac/dynobj/scriptstring.h"
+
+TEST(ScriptString, Interned) {
+    char text1[] = "literal one";
+    const char *text2 = "literal two";
+
+    DynObjectRef ref1 = ScriptString::CreateInterned(text1);
+    DynObjectRef ref2 = ScriptString::CreateInterned(text2);
+    ASSERT_TRUE(ref1);
+    ASSERT_TRUE(ref2);
+    ASSERT_NE(ref1.Handle, ref2.Handle);
+    ASSERT_STREQ(static_cast<const char*>(ref1.Obj), "literal one");
+    ASSERT_STREQ(static_cast<const char*>(ref2.Obj), "literal two");
+    ASSERT_EQ(ScriptString::GetHeader(ref1.Obj).Length, strlen(text1));
+
+    // Same source gives same string, and it's not disposed when the script releases it
+    ccAddObjectReference(ref1.Handle);
+    ccReleaseObjectReference(ref1.Handle);
+    DynObjectRef ref1_again = ScriptString::CreateInterned(text1);
+    ASSERT_EQ(ref1_again.Handle, ref1.Handle);
+    ASSERT_EQ(ref1_again.Obj, ref1.Obj);
+
+    // Changed source text gives a new string
+    text1[0] = 'L';
+    DynObjectRef ref1_changed = ScriptString::CreateInterned(text1);
+    ASSERT_TRUE(ref1_changed);
+    ASSERT_STREQ(static_cast<const char*>(ref1_changed.Obj), "Literal one");
+    ASSERT_STREQ(static_cast<const char*>(ccGetObjectAddressFromHandle(ref1_changed.Handle)), "Literal one");
+    // the replaced string is left for the garbage collection
+    ASSERT_EQ(ccGetObjectAddressFromHandle(ref1.Handle), ref1.Obj);
+
+    // Releasing interned strings does not dispose them right away,
+    // as a running script may still be using them
+    ccAddObjectReference(ref2.Handle);
+    ScriptString::ReleaseInterned();
+    ASSERT_EQ(ccGetObjectAddressFromHandle(ref2.Handle), ref2.Obj);
+    ASSERT_EQ(ccGetObjectAddressFromHandle(ref1_changed.Handle), ref1_changed.Obj);
+    ccReleaseObjectReference(ref2.Handle);
+    ASSERT_EQ(ccGetObjectAddressFromHandle(ref2.Handle), nullptr);
+
+    // Pool reset invalidates interned strings
+    DynObjectRef ref3 = ScriptString::CreateInterned(text2);
+    ASSERT_TRUE(ref3);
+    ccUnregisterAllObjects();
+    DynObjectRef ref4 = ScriptString::CreateInterned(text2);
+    ASSERT_TRUE(ref4);
+    ASSERT_STREQ(static_cast<const char*>(ccGetObjectAddressFromHandle(ref4.Handle)), "literal two");
+    ccUnregisterAllObjects();
+}
@@ -0,0 +1,77 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <memory>
+#if !defined(AGS_DISABLE_THREADS)
+#include <thread>
+#endif
+#include "gtest/gtest.h"
+#include "util/spsc_queue.h"
+
+using namespace AGS::Engine;
+
+TEST(SpscQueue, PushPop) {
+    SpscQueue<std::unique_ptr<int>, 4> queue;
+    std::unique_ptr<int> item;
+    ASSERT_TRUE(queue.IsEmpty());
+    ASSERT_FALSE(queue.Pop(item));
+
+    // Fill up, and wrap around the ring several times
+    int next_push = 0, next_pop = 0;
+    for (int round = 0; round < 3; ++round)
+    {
+        while (queue.Push(std::unique_ptr<int>(new int(next_push))))
+            next_push++;
+        ASSERT_EQ(next_push - next_pop, 4);
+        std::unique_ptr<int> extra(new int(-1));
+        ASSERT_FALSE(queue.Push(std::move(extra)));
+        ASSERT_TRUE(extra); // not moved from on failure
+        for (int i = 0; i < 3; ++i)
+        {
+            ASSERT_TRUE(queue.Pop(item));
+            ASSERT_EQ(*item, next_pop++);
+        }
+    }
+    while (queue.Pop(item))
+        ASSERT_EQ(*item, next_pop++);
+    ASSERT_EQ(next_pop, next_push);
+    ASSERT_TRUE(queue.IsEmpty());
+}
+
+#if !defined(AGS_DISABLE_THREADS)
+TEST(SpscQueue, TwoThreads) {
+    SpscQueue<int, 16> queue;
+    const int count = 100000;
+    std::thread producer([&queue, count]() {
+        for (int i = 0; i < count; ++i)
+        {
+            int value = i;
+            while (!queue.Push(std::move(value)))
+                std::this_thread::yield();
+        }
+    });
+
+    // Items must arrive exactly once, in order
+    int expect = 0;
+    while (expect < count)
+    {
+        int value;
+        if (queue.Pop(value))
+            ASSERT_EQ(value, expect++);
+        else
+            std::this_thread::yield();
+    }
+    producer.join();
+    ASSERT_TRUE(queue.IsEmpty());
+}
+#endif
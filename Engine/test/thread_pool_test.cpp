@@ -0,0 +1,49 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <vector>
+#include "gtest/gtest.h"
+#include "util/thread_pool.h"
+
+using namespace AGS::Engine;
+
+TEST(ThreadPool, RunsAllJobs) {
+    ThreadPool pool(4);
+    std::vector<int> results(100, 0);
+    // Run several batches in a row, each job must be run exactly once
+    for (int batch = 1; batch <= 10; ++batch)
+    {
+        pool.Run(results.size(), [&results](size_t job) { results[job]++; });
+        for (size_t i = 0; i < results.size(); ++i)
+            ASSERT_EQ(results[i], batch);
+    }
+}
+
+TEST(ThreadPool, Restart) {
+    ThreadPool pool;
+    ASSERT_EQ(pool.GetThreadCount(), 1u);
+    std::vector<int> results(8, 0);
+    pool.Run(results.size(), [&results](size_t job) { results[job] = static_cast<int>(job); });
+    for (size_t i = 0; i < results.size(); ++i)
+        ASSERT_EQ(results[i], static_cast<int>(i));
+
+    pool.Start(3);
+#if !defined(AGS_DISABLE_THREADS)
+    ASSERT_EQ(pool.GetThreadCount(), 3u);
+#endif
+    pool.Run(results.size(), [&results](size_t job) { results[job] *= 2; });
+    for (size_t i = 0; i < results.size(); ++i)
+        ASSERT_EQ(results[i], static_cast<int>(i) * 2);
+    pool.Stop();
+    ASSERT_EQ(pool.GetThreadCount(), 1u);
+}
@@ -0,0 +1,234 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// Walk-behind benchmark.
+//
+// Generates a large scrolling room's walk-behind mask, with a number of
+// pillars, a foreground strip and a few irregular areas, and measures
+// building the spans, cutting walk-behinds out of character sprites which
+// walk across the room, and generating walk-behind sprites. Each operation
+// is compared to the per-column mask lookups which were used before.
+//
+// Usage: walkbehind_benchmark [room width] [room height] [sprite count]
+//
+//=============================================================================
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+#include "ac/walkbehind.h"
+#include "game/roomstruct.h"
+#include "gfx/bitmap.h"
+
+using namespace AGS::Common;
+
+typedef std::chrono::steady_clock Clock;
+
+static double ElapsedMs(const Clock::time_point &start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static std::unique_ptr<Bitmap> MakeRoomMask(int width, int height, std::mt19937 &rng)
+{
+    std::unique_ptr<Bitmap> mask(BitmapHelper::CreateBitmap(width, height, 8));
+    mask->Clear(0);
+    // pillars
+    for (int x = 100; x < width; x += 400)
+        mask->FillRect(RectWH(x, height / 4, 60, height * 3 / 4), 1 + (x / 400) % 4);
+    // foreground strip
+    mask->FillRect(RectWH(0, height - height / 8, width, height / 8), 5);
+    // irregular areas, e.g. bushes
+    for (int i = 0; i < width / 100; ++i)
+    {
+        const int cx = rng() % width, cy = height / 2 + rng() % (height / 2);
+        const int r = 20 + rng() % 60;
+        for (int y = std::max(0, cy - r); y < std::min(height, cy + r); ++y)
+        {
+            uint8_t *line = mask->GetScanLineForWriting(y);
+            for (int x = std::max(0, cx - r); x < std::min(width, cx + r); ++x)
+                if ((x - cx) * (x - cx) + (y - cy) * (y - cy) < r * r)
+                    line[x] = 6 + i % (MAX_WALK_BEHINDS - 6);
+        }
+    }
+    return mask;
+}
+
+// The former column-major walk-behind data and cropout
+struct WalkBehindColumn
+{
+    bool Exists = false;
+    int Y1 = 0, Y2 = 0;
+};
+
+static void LegacyRecalc(const Bitmap *mask, std::vector<WalkBehindColumn> &cols, Rect *aabb)
+{
+    cols.clear();
+    cols.resize(mask->GetWidth());
+    for (int wb = 0; wb < MAX_WALK_BEHINDS; ++wb)
+        aabb[wb] = Rect(INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN);
+    for (int col = 0; col < mask->GetWidth(); ++col)
+    {
+        auto &wbcol = cols[col];
+        for (int y = 0; y < mask->GetHeight(); ++y)
+        {
+            int wb = mask->GetScanLine(y)[col];
+            if ((wb >= 1) && (wb < MAX_WALK_BEHINDS))
+            {
+                if (!wbcol.Exists)
+                {
+                    wbcol.Y1 = y;
+                    wbcol.Exists = true;
+                }
+                wbcol.Y2 = y + 1;
+                aabb[wb].Left = std::min(col, aabb[wb].Left);
+                aabb[wb].Top = std::min(y, aabb[wb].Top);
+                aabb[wb].Right = std::max(col, aabb[wb].Right);
+                aabb[wb].Bottom = std::max(y, aabb[wb].Bottom);
+            }
+        }
+    }
+}
+
+static bool LegacyCropout(const Bitmap *mask, const std::vector<WalkBehindColumn> &cols,
+    Bitmap *sprit, int sprx, int spry, int basel, const short *baselines)
+{
+    const int maskcol = sprit->GetMaskColor();
+    bool pixels_changed = false;
+    for (int x = std::max(0, 0 - sprx);
+        (x < sprit->GetWidth()) && (x + sprx < mask->GetWidth()); ++x)
+    {
+        const auto &wbcol = cols[x + sprx];
+        if ((!wbcol.Exists) || (wbcol.Y2 <= spry) || (wbcol.Y1 > spry + sprit->GetHeight()))
+            continue;
+        for (int y = std::max(0, wbcol.Y1 - spry);
+            (y < sprit->GetHeight()) && (y + spry < wbcol.Y2); ++y)
+        {
+            const int wb = mask->GetScanLine(y + spry)[x + sprx];
+            if (wb < 1) continue;
+            if (baselines[wb] <= basel) continue;
+            pixels_changed = true;
+            reinterpret_cast<uint32_t*>(sprit->GetScanLineForWriting(y))[x] = maskcol;
+        }
+    }
+    return pixels_changed;
+}
+
+static void LegacyCopyArea(const Bitmap *mask, const Rect &pos, int wb, const Bitmap *bg, Bitmap *dst)
+{
+    for (int y = pos.Top; y <= pos.Bottom; ++y)
+    {
+        const uint8_t *check_line = mask->GetScanLine(y);
+        const uint32_t *src_line = reinterpret_cast<const uint32_t*>(bg->GetScanLine(y));
+        uint32_t *dst_line = reinterpret_cast<uint32_t*>(dst->GetScanLineForWriting(y - pos.Top));
+        for (int x = pos.Left; x <= pos.Right; ++x)
+        {
+            if (check_line[x] == wb)
+                dst_line[x - pos.Left] = src_line[x];
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const int width = (argc > 1) ? std::max(320, atoi(argv[1])) : 6400;
+    const int height = (argc > 2) ? std::max(200, atoi(argv[2])) : 1200;
+    const int sprite_count = (argc > 3) ? std::max(1, atoi(argv[3])) : 50;
+    const int frames = 200; // number of simulated frames
+
+    std::mt19937 rng(42);
+    std::unique_ptr<Bitmap> mask = MakeRoomMask(width, height, rng);
+    std::unique_ptr<Bitmap> bg(BitmapHelper::CreateBitmap(width, height, 32));
+    bg->Clear(0x00406080);
+    short baselines[MAX_WALK_BEHINDS];
+    for (int wb = 0; wb < MAX_WALK_BEHINDS; ++wb)
+        baselines[wb] = static_cast<short>(height / 2 + rng() % (height / 2));
+
+    // Sprites walking across the room, in a wide screen-sized area around the camera
+    struct Walker { int X, Y, Dx, Baseline; };
+    std::vector<Walker> walkers(sprite_count);
+    for (auto &w : walkers)
+    {
+        w.X = rng() % width;
+        w.Y = height / 3 + rng() % (height / 2);
+        w.Dx = (rng() % 2) ? 3 : -3;
+        w.Baseline = w.Y + 200;
+    }
+    std::unique_ptr<Bitmap> sprite(BitmapHelper::CreateBitmap(100, 200, 32));
+    printf("Room: %dx%d, %d sprites of %dx%d, %d frames\n",
+        width, height, sprite_count, sprite->GetWidth(), sprite->GetHeight(), frames);
+
+    // Mask preparation
+    std::vector<WalkBehindColumn> cols;
+    Rect aabb[MAX_WALK_BEHINDS];
+    Clock::time_point start = Clock::now();
+    LegacyRecalc(mask.get(), cols, aabb);
+    const double legacy_recalc_ms = ElapsedMs(start);
+    WalkBehindSpans spans;
+    start = Clock::now();
+    spans.Build(mask.get());
+    const double spans_build_ms = ElapsedMs(start);
+    printf("Prepare mask:      columns %8.2f ms, spans %8.2f ms\n", legacy_recalc_ms, spans_build_ms);
+
+    // Cropout of the walking sprites
+    double legacy_crop_ms = 0.0, spans_crop_ms = 0.0;
+    size_t legacy_changed = 0, spans_changed = 0;
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        for (auto &w : walkers)
+        {
+            w.X += w.Dx;
+            if ((w.X < -100) || (w.X > width))
+                w.Dx = -w.Dx;
+
+            sprite->Clear(0x00FFFFFF);
+            start = Clock::now();
+            legacy_changed += LegacyCropout(mask.get(), cols, sprite.get(), w.X, w.Y, w.Baseline, baselines);
+            legacy_crop_ms += ElapsedMs(start);
+
+            sprite->Clear(0x00FFFFFF);
+            start = Clock::now();
+            spans_changed += spans.Cropout(sprite.get(), w.X, w.Y, w.Baseline, baselines);
+            spans_crop_ms += ElapsedMs(start);
+        }
+    }
+    if (legacy_changed != spans_changed)
+    {
+        printf("Error: cropout results do not match\n");
+        return 1;
+    }
+    printf("Cropout per frame: columns %8.3f ms, spans %8.3f ms\n",
+        legacy_crop_ms / frames, spans_crop_ms / frames);
+
+    // Walk-behind sprites generation
+    double legacy_gen_ms = 0.0, spans_gen_ms = 0.0;
+    for (int wb = 1; wb < MAX_WALK_BEHINDS; ++wb)
+    {
+        const Rect pos = spans.GetAreaBounds(wb);
+        if (pos.Right < 0)
+            continue;
+        std::unique_ptr<Bitmap> area(BitmapHelper::CreateTransparentBitmap(pos.GetWidth(), pos.GetHeight(), 32));
+        start = Clock::now();
+        LegacyCopyArea(mask.get(), aabb[wb], wb, bg.get(), area.get());
+        legacy_gen_ms += ElapsedMs(start);
+        start = Clock::now();
+        spans.CopyArea(wb, bg.get(), area.get());
+        spans_gen_ms += ElapsedMs(start);
+    }
+    printf("Generate sprites:  columns %8.2f ms, spans %8.2f ms\n", legacy_gen_ms, spans_gen_ms);
+    return 0;
+}
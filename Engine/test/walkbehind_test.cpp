@@ -0,0 +1,139 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <string.h>
+#include <memory>
+#include <random>
+#include "gtest/gtest.h"
+#include "ac/walkbehind.h"
+#include "game/roomstruct.h"
+#include "gfx/bitmap.h"
+
+using namespace AGS::Common;
+
+// Makes a mask with overlapping rectangles and single pixels of random areas
+static std::unique_ptr<Bitmap> MakeTestMask(int width, int height, std::mt19937 &rng)
+{
+    std::unique_ptr<Bitmap> mask(BitmapHelper::CreateBitmap(width, height, 8));
+    mask->Clear(0);
+    for (int i = 0; i < 12; ++i)
+    {
+        const int x = rng() % width, y = rng() % height;
+        mask->FillRect(RectWH(x, y, 1 + rng() % (width / 2), 1 + rng() % (height / 2)),
+            rng() % MAX_WALK_BEHINDS);
+    }
+    for (int i = 0; i < 50; ++i)
+        mask->GetScanLineForWriting(rng() % height)[rng() % width] = rng() % MAX_WALK_BEHINDS;
+    return mask;
+}
+
+// Cuts out sprite pixels by testing each of them against the mask
+static bool CropoutPerPixel(const Bitmap *mask, Bitmap *sprit, int sprx, int spry, int basel,
+    const short *baselines)
+{
+    bool pixels_changed = false;
+    for (int y = 0; y < sprit->GetHeight(); ++y)
+    {
+        for (int x = 0; x < sprit->GetWidth(); ++x)
+        {
+            const int mx = x + sprx, my = y + spry;
+            if ((mx < 0) || (my < 0) || (mx >= mask->GetWidth()) || (my >= mask->GetHeight()))
+                continue;
+            const int wb = mask->GetScanLine(my)[mx];
+            if ((wb < 1) || (baselines[wb] <= basel))
+                continue;
+            sprit->PutPixel(x, y, sprit->GetMaskColor());
+            pixels_changed = true;
+        }
+    }
+    return pixels_changed;
+}
+
+TEST(WalkBehind, SpansBounds) {
+    std::unique_ptr<Bitmap> mask(BitmapHelper::CreateBitmap(40, 30, 8));
+    mask->Clear(0);
+    mask->FillRect(Rect(3, 4, 10, 12), 1);
+    mask->FillRect(Rect(8, 10, 39, 29), 2);
+    WalkBehindSpans spans;
+    spans.Build(mask.get());
+    ASSERT_FALSE(spans.IsEmpty());
+    ASSERT_EQ(spans.GetAreaBounds(1), Rect(3, 4, 10, 12));
+    ASSERT_EQ(spans.GetAreaBounds(2), Rect(8, 10, 39, 29));
+    ASSERT_LT(spans.GetAreaBounds(3).Right, 0);
+
+    mask->Clear(0);
+    spans.Build(mask.get());
+    ASSERT_TRUE(spans.IsEmpty());
+    ASSERT_LT(spans.GetAreaBounds(1).Right, 0);
+}
+
+TEST(WalkBehind, CropoutMatchesMask) {
+    std::mt19937 rng(1234);
+    std::unique_ptr<Bitmap> mask = MakeTestMask(160, 100, rng);
+    WalkBehindSpans spans;
+    spans.Build(mask.get());
+    short baselines[MAX_WALK_BEHINDS];
+    for (auto &base : baselines)
+        base = rng() % 100;
+
+    const int depths[] = { 8, 16, 32 };
+    for (int depth : depths)
+    {
+        std::unique_ptr<Bitmap> expect(BitmapHelper::CreateBitmap(37, 23, depth));
+        std::unique_ptr<Bitmap> result(BitmapHelper::CreateBitmap(37, 23, depth));
+        for (int i = 0; i < 200; ++i)
+        {
+            // include positions partially and fully outside of the mask
+            const int x = static_cast<int>(rng() % 240) - 40;
+            const int y = static_cast<int>(rng() % 160) - 30;
+            const int basel = rng() % 100;
+            expect->Clear(1);
+            result->Clear(1);
+            const bool expect_changed = CropoutPerPixel(mask.get(), expect.get(), x, y, basel, baselines);
+            const bool result_changed = spans.Cropout(result.get(), x, y, basel, baselines);
+            ASSERT_EQ(expect_changed, result_changed) << "position " << x << "," << y;
+            for (int row = 0; row < expect->GetHeight(); ++row)
+                ASSERT_EQ(memcmp(expect->GetScanLine(row), result->GetScanLine(row), expect->GetLineLength()), 0)
+                    << "depth " << depth << ", position " << x << "," << y << ", line " << row;
+        }
+    }
+}
+
+TEST(WalkBehind, CopyAreaMatchesMask) {
+    std::mt19937 rng(4321);
+    std::unique_ptr<Bitmap> mask = MakeTestMask(120, 90, rng);
+    WalkBehindSpans spans;
+    spans.Build(mask.get());
+    std::unique_ptr<Bitmap> bg(BitmapHelper::CreateBitmap(120, 90, 32));
+    for (int y = 0; y < bg->GetHeight(); ++y)
+        for (int x = 0; x < bg->GetWidth(); ++x)
+            bg->PutPixel(x, y, rng() & 0xFFFFFF);
+
+    for (int wb = 1; wb < MAX_WALK_BEHINDS; ++wb)
+    {
+        const Rect pos = spans.GetAreaBounds(wb);
+        if (pos.Right < 0)
+            continue;
+        std::unique_ptr<Bitmap> area(BitmapHelper::CreateTransparentBitmap(pos.GetWidth(), pos.GetHeight(), 32));
+        spans.CopyArea(wb, bg.get(), area.get());
+        for (int y = 0; y < area->GetHeight(); ++y)
+        {
+            for (int x = 0; x < area->GetWidth(); ++x)
+            {
+                const int expect = (mask->GetPixel(x + pos.Left, y + pos.Top) == wb) ?
+                    bg->GetPixel(x + pos.Left, y + pos.Top) : area->GetMaskColor();
+                ASSERT_EQ(area->GetPixel(x, y), expect) << "area " << wb << ", pixel " << x << "," << y;
+            }
+        }
+    }
+}
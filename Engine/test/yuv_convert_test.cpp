@@ -0,0 +1,137 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "media/video/yuv_convert.h"
+
+using namespace AGS::Engine;
+
+namespace
+{
+
+// Planar YUV 4:2:0 image with random contents
+struct TestYUVImage
+{
+    std::vector<uint8_t> Y, U, V;
+    YUVImage Image;
+
+    TestYUVImage(int width, int height, std::mt19937 &rng)
+    {
+        const int cw = (width + 1) / 2, ch = (height + 1) / 2;
+        Y.resize(width * height);
+        U.resize(cw * ch);
+        V.resize(cw * ch);
+        for (auto *plane : { &Y, &U, &V })
+            for (auto &s : *plane)
+                s = static_cast<uint8_t>(rng());
+        Image.Planes[0] = Y.data();
+        Image.Planes[1] = U.data();
+        Image.Planes[2] = V.data();
+        Image.Strides[0] = width;
+        Image.Strides[1] = cw;
+        Image.Strides[2] = cw;
+        Image.Width = width;
+        Image.Height = height;
+    }
+};
+
+// Converts the image pixel by pixel, using the scalar row conversion
+std::vector<uint32_t> ConvertReference(const YUVImage &src, int dst_w, int dst_h)
+{
+    std::vector<uint32_t> pixels(dst_w * dst_h);
+    for (int dy = 0; dy < dst_h; ++dy)
+    {
+        const int sy = static_cast<int>(((static_cast<uint64_t>(src.Height) << 16) / dst_h * dy) >> 16);
+        for (int dx = 0; dx < dst_w; ++dx)
+        {
+            const int sx = static_cast<int>(((static_cast<uint64_t>(src.Width) << 16) / dst_w * dx) >> 16);
+            const uint8_t *y = src.Planes[0] + sy * src.Strides[0] + sx;
+            const uint8_t *u = src.Planes[1] + (sy >> src.ChromaShiftY) * src.Strides[1] + (sx >> src.ChromaShiftX);
+            const uint8_t *v = src.Planes[2] + (sy >> src.ChromaShiftY) * src.Strides[2] + (sx >> src.ChromaShiftX);
+            YUVRowToARGBScalar(&pixels[dy * dst_w + dx], y, u, v, 1);
+        }
+    }
+    return pixels;
+}
+
+} // namespace
+
+TEST(YUVConvert, KnownColors) {
+    struct { uint8_t Y, U, V; uint32_t ARGB; } colors[] = {
+        { 16, 128, 128, 0xFF000000 },
+        { 235, 128, 128, 0xFFFFFFFF },
+        { 0, 128, 128, 0xFF000000 },
+        { 255, 128, 128, 0xFFFFFFFF },
+        { 126, 128, 128, 0xFF808080 },
+        { 81, 90, 240, 0xFFFF0000 },
+        { 145, 52, 32, 0xFF00FF00 },
+        { 41, 240, 110, 0xFF0000FF },
+    };
+    for (const auto &c : colors)
+    {
+        uint32_t px;
+        YUVRowToARGBScalar(&px, &c.Y, &c.U, &c.V, 1);
+        ASSERT_EQ(px, c.ARGB);
+    }
+}
+
+TEST(YUVConvert, RowMatchesScalar) {
+    std::mt19937 rng(1234);
+    const size_t max_count = 67;
+    std::vector<uint8_t> y(max_count), u(max_count), v(max_count), half_u(max_count), half_v(max_count);
+    for (size_t i = 0; i < max_count; ++i)
+    {
+        y[i] = static_cast<uint8_t>(rng());
+        half_u[i] = static_cast<uint8_t>(rng());
+        half_v[i] = static_cast<uint8_t>(rng());
+        u[i] = half_u[i / 2];
+        v[i] = half_v[i / 2];
+    }
+
+    for (size_t count = 0; count <= max_count; ++count)
+    {
+        std::vector<uint32_t> expect(count + 1, 0u), full(count + 1, 0u), half(count + 1, 0u);
+        YUVRowToARGBScalar(expect.data(), y.data(), u.data(), v.data(), count);
+        YUVRowToARGB(full.data(), y.data(), u.data(), v.data(), count);
+        YUVHalfRowToARGB(half.data(), y.data(), half_u.data(), half_v.data(), count);
+        ASSERT_EQ(full, expect);
+        ASSERT_EQ(half, expect);
+    }
+}
+
+TEST(YUVConvert, ScaledImage) {
+    std::mt19937 rng(4321);
+    TestYUVImage img(37, 21, rng);
+    const struct { int W, H; } sizes[] = {
+        { 37, 21 }, { 74, 42 }, { 100, 63 }, { 20, 11 }, { 37, 50 }, { 1, 1 }
+    };
+    for (const auto &sz : sizes)
+    {
+        const auto expect = ConvertReference(img.Image, sz.W, sz.H);
+        std::vector<uint32_t> pixels(sz.W * sz.H, 0u);
+        uint8_t *dst = reinterpret_cast<uint8_t*>(pixels.data());
+        const int pitch = sz.W * sizeof(uint32_t);
+        YUVToARGB(img.Image, dst, pitch, sz.W, sz.H, 0, sz.H);
+        ASSERT_EQ(pixels, expect);
+
+        // Same result when converting in bands
+        std::vector<uint32_t> banded(sz.W * sz.H, 0u);
+        dst = reinterpret_cast<uint8_t*>(banded.data());
+        const int band = 4;
+        for (int row = 0; row < sz.H; row += band)
+            YUVToARGB(img.Image, dst, pitch, sz.W, sz.H, row, row + band);
+        ASSERT_EQ(banded, expect);
+    }
+}
@@ -0,0 +1,90 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// SpscQueue: a fixed-size lock-free ring buffer for passing items from one
+// producer thread to one consumer thread. Neither side ever waits for
+// the other: Push fails when the queue is full, and Pop fails when it's empty.
+//
+// Only one thread may push and only one thread may pop at any time.
+//
+//=============================================================================
+#ifndef __AGS_EE_UTIL_SPSCQUEUE_H
+#define __AGS_EE_UTIL_SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace AGS
+{
+namespace Engine
+{
+
+template <typename T, size_t Capacity>
+class SpscQueue final
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+        "SpscQueue capacity must be a power of two");
+public:
+    SpscQueue() = default;
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue &operator =(const SpscQueue&) = delete;
+
+    // Gets the max number of items the queue may hold
+    static constexpr size_t GetCapacity() { return Capacity; }
+
+    // Tells if the queue is empty; the result is only reliable
+    // when called by the consumer
+    bool IsEmpty() const
+    {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+
+    // Puts an item to the queue; returns false if the queue is full,
+    // in which case the item is not moved from. Producer only.
+    bool Push(T &&item)
+    {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) == Capacity)
+            return false;
+        _items[tail & (Capacity - 1)] = std::move(item);
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Takes the oldest item from the queue; returns false if the queue
+    // is empty. Consumer only.
+    bool Pop(T &item)
+    {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+            return false;
+        item = std::move(_items[head & (Capacity - 1)]);
+        _items[head & (Capacity - 1)] = T(); // release any held resources
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T _items[Capacity];
+    // Positions only grow, and are wrapped when accessing the items;
+    // head is written by the consumer, and tail by the producer
+    std::atomic<size_t> _head{0u};
+    std::atomic<size_t> _tail{0u};
+};
+
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_UTIL_SPSCQUEUE_H
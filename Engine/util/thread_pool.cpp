@@ -0,0 +1,143 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+#include "util/thread_pool.h"
+
+namespace AGS
+{
+namespace Engine
+{
+
+ThreadPool::ThreadPool(size_t thread_count)
+{
+    Start(thread_count);
+}
+
+ThreadPool::~ThreadPool()
+{
+    Stop();
+}
+
+size_t ThreadPool::GetDefaultThreadCount()
+{
+#if !defined(AGS_DISABLE_THREADS)
+    const size_t hw_threads = std::thread::hardware_concurrency();
+    return hw_threads > 0 ? hw_threads : 1;
+#else
+    return 1;
+#endif
+}
+
+#if !defined(AGS_DISABLE_THREADS)
+
+size_t ThreadPool::GetThreadCount() const
+{
+    return _threads.size() + 1;
+}
+
+void ThreadPool::Start(size_t thread_count)
+{
+    Stop();
+    _exit = false;
+    for (size_t i = 1; i < thread_count; ++i)
+        _threads.emplace_back(&ThreadPool::WorkerProc, this);
+}
+
+void ThreadPool::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        _exit = true;
+    }
+    _workCv.notify_all();
+    for (auto &thread : _threads)
+        thread.join();
+    _threads.clear();
+}
+
+void ThreadPool::Run(size_t job_count, const JobFn &fn)
+{
+    if (job_count == 0)
+        return;
+    if (_threads.empty() || job_count == 1)
+    {
+        for (size_t i = 0; i < job_count; ++i)
+            fn(i);
+        return;
+    }
+
+    std::unique_lock<std::mutex> lk(_mutex);
+    _fn = &fn;
+    _jobCount = job_count;
+    _nextJob = 0u;
+    _jobsLeft = job_count;
+    _batchID++;
+    _workCv.notify_all();
+    RunJobs(lk);
+    _doneCv.wait(lk, [this]() { return _jobsLeft == 0u; });
+    _fn = nullptr;
+}
+
+void ThreadPool::RunJobs(std::unique_lock<std::mutex> &lk)
+{
+    while (_nextJob < _jobCount)
+    {
+        const size_t job = _nextJob++;
+        const JobFn &fn = *_fn;
+        lk.unlock();
+        fn(job);
+        lk.lock();
+        if (--_jobsLeft == 0u)
+            _doneCv.notify_all();
+    }
+}
+
+void ThreadPool::WorkerProc()
+{
+    std::unique_lock<std::mutex> lk(_mutex);
+    uint32_t last_batch = _batchID;
+    while (true)
+    {
+        _workCv.wait(lk, [this, last_batch]() { return _exit || (_batchID != last_batch); });
+        if (_exit)
+            return;
+        last_batch = _batchID;
+        RunJobs(lk);
+    }
+}
+
+#else // AGS_DISABLE_THREADS
+
+size_t ThreadPool::GetThreadCount() const
+{
+    return 1;
+}
+
+void ThreadPool::Start(size_t /*thread_count*/)
+{
+}
+
+void ThreadPool::Stop()
+{
+}
+
+void ThreadPool::Run(size_t job_count, const JobFn &fn)
+{
+    for (size_t i = 0; i < job_count; ++i)
+        fn(i);
+}
+
+#endif // AGS_DISABLE_THREADS
+
+} // namespace Engine
+} // namespace AGS
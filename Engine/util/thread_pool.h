@@ -0,0 +1,86 @@
+//=============================================================================
+//
+// Adventure Game Studio (AGS)
+//
+// Copyright (C) 1999-2011 Chris Jones and 2011-2025 various contributors
+// The full list of copyright holders can be found in the Copyright.txt
+// file, which is part of this source code distribution.
+//
+// The AGS source code is provided under the Artistic License 2.0.
+// A copy of this license can be found in the file License.txt and at
+// https://opensource.org/license/artistic-2-0/
+//
+//=============================================================================
+//
+// ThreadPool: a fixed set of worker threads which execute a number of
+// indexed jobs in parallel, and return only after all of them are done.
+// The calling thread participates in the work too, so a pool of N threads
+// runs N - 1 additional workers.
+//
+// When built with AGS_DISABLE_THREADS, all jobs are run on the calling thread.
+//
+//=============================================================================
+#ifndef __AGS_EE_UTIL_THREADPOOL_H
+#define __AGS_EE_UTIL_THREADPOOL_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#if !defined(AGS_DISABLE_THREADS)
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace AGS
+{
+namespace Engine
+{
+
+class ThreadPool final
+{
+public:
+    // A job function, receives the job index in range [0; job_count)
+    typedef std::function<void(size_t)> JobFn;
+
+    ThreadPool() = default;
+    ThreadPool(size_t thread_count);
+    ~ThreadPool();
+
+    // Gets the default number of threads suggested for this system
+    static size_t GetDefaultThreadCount();
+
+    // Gets the total number of threads, including the calling one
+    size_t GetThreadCount() const;
+    // Stops any existing workers and starts new ones, making a total of
+    // thread_count threads including the calling one; 0 or 1 disables workers
+    void Start(size_t thread_count);
+    // Stops and joins all worker threads
+    void Stop();
+    // Runs job_count jobs, distributing them among all threads,
+    // returns when all the jobs are complete. Not reentrant.
+    void Run(size_t job_count, const JobFn &fn);
+
+private:
+#if !defined(AGS_DISABLE_THREADS)
+    void WorkerProc();
+    // Takes and runs jobs from the current batch until there's none left
+    void RunJobs(std::unique_lock<std::mutex> &lk);
+
+    std::vector<std::thread> _threads;
+    std::mutex _mutex;
+    std::condition_variable _workCv; // signals that there's new work or exit
+    std::condition_variable _doneCv; // signals that all jobs are complete
+    bool _exit = false;
+    uint32_t _batchID = 0u; // incremented for each Run() call
+    const JobFn *_fn = nullptr;
+    size_t _jobCount = 0u; // total jobs in the current batch
+    size_t _nextJob = 0u; // next job to take
+    size_t _jobsLeft = 0u; // number of jobs not yet completed
+#endif
+};
+
+} // namespace Engine
+} // namespace AGS
+
+#endif // __AGS_EE_UTIL_THREADPOOL_H